@@ -75,10 +75,13 @@ void fbtest_run(void) {
     uint32_t pitch = st->active_mode.pitch;
     uint8_t bpp = st->active_mode.bpp;
 
+    // Deferred console text first: the pattern is drawn straight into the frame
+    console_flush();
     fb_patterns_configure_palette();
     fb_patterns_draw_demo(fb, width, height, pitch, bpp);
     
-    // VITAL: Upload shadow buffer to hardware VRAM
+    // VITAL: Upload shadow buffer to hardware VRAM (drawn directly, so mark it all)
+    fb_accel_mark_dirty(0, 0, width, height);
     fb_accel_sync();
 
     wait_for_keypress();
@@ -1,6 +1,7 @@
 #include "gfx_probe.h"
 #include "../console.h"
 #include "../drivers/gpu/gpu.h"
+#include "../drivers/gpu/fb_accel.h"
 #include "../display.h"
 #include "../keyboard.h"
 #include "../cpuidle.h"
@@ -58,8 +59,12 @@ void gfx_probe_run(void) {
     console_write_dec(bpp);
     console_writeln(".");
 
+    // Deferred console text first: the pattern is drawn straight into the frame
+    console_flush();
     fb_patterns_configure_palette();
     fb_patterns_draw_demo(fb, width, height, pitch, bpp);
+    fb_accel_mark_dirty(0, 0, width, height);
+    fb_accel_sync();
 
     console_writeln("gfxprobe: Testpattern gezeichnet. Taste drücken zum Zurückkehren in den Textmodus.");
     wait_for_keypress();
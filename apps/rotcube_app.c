@@ -1,5 +1,6 @@
 #include "../mezapi.h"
 #include "../fonts/font8x16.h"
+#include <stddef.h>
 #include <stdint.h>
 
 #define LUT_SIZE 256
@@ -103,7 +104,44 @@ static void rotate(vec3_t* v, uint32_t ax, uint32_t ay, uint32_t az) {
     v->x = (int16_t)x; v->y = (int16_t)y; v->z = (int16_t)z;
 }
 
-static void draw_cube(const fb_ctx_t* ctx, uint32_t phase, uint32_t fps, uint32_t msec) {
+// Screen area a frame drew into: the stats text and the cube
+typedef struct { mez_rect16_t text, cube; } frame_box_t;
+
+static mez_rect16_t clip_box(const fb_ctx_t* ctx, int x0, int y0, int x1, int y1) {
+    mez_rect16_t r = {0, 0, 0, 0};
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 > ctx->width) x1 = ctx->width;
+    if (y1 > ctx->height) y1 = ctx->height;
+    if (x1 <= x0 || y1 <= y0) return r;
+    r.x = (uint16_t)x0; r.y = (uint16_t)y0;
+    r.width = (uint16_t)(x1 - x0); r.height = (uint16_t)(y1 - y0);
+    return r;
+}
+
+static void clear_box(const fb_ctx_t* ctx, const mez_rect16_t* r) {
+    if (!r->width || !r->height) return;
+    if (ctx->api->video_fb_fill_rect) {
+        ctx->api->video_fb_fill_rect(r->x, r->y, r->width, r->height, 16);
+        return;
+    }
+    for (int y = r->y; y < r->y + r->height; y++)
+        for (int x = r->x; x < r->x + r->width; x++) ctx->base[(uint32_t)y * ctx->pitch + (uint32_t)x] = 16;
+}
+
+static int append_str(char* out, int len, const char* s) {
+    while (*s) out[len++] = *s++;
+    return len;
+}
+
+static int append_dec(char* out, int len, uint32_t val) {
+    char b[10]; int bi = 0;
+    do { b[bi++] = (char)('0' + (val % 10)); val /= 10; } while (val > 0);
+    while (bi > 0) out[len++] = b[--bi];
+    return len;
+}
+
+static void draw_cube(const fb_ctx_t* ctx, uint32_t phase, const char* stats, frame_box_t* box) {
     vec3_t vertices[8] = {
         {-64,-64,-64}, {64,-64,-64}, {64,64,-64}, {-64,64,-64},
         {-64,-64,64}, {64,-64,64}, {64,64,64}, {-64,64,64}
@@ -114,31 +152,9 @@ static void draw_cube(const fb_ctx_t* ctx, uint32_t phase, uint32_t fps, uint32_
     uint8_t face_colors[6] = {32, 48, 64, 80, 96, 112};
     vec2_t proj[8];
 
-    // Clear screen
-    if (ctx->api->video_fb_fill_rect) ctx->api->video_fb_fill_rect(0, 0, ctx->width, ctx->height, 16);
-    else {
-        for(int y=0; y<ctx->height; y++) 
-            for(int x=0; x<ctx->width; x++) ctx->base[y*ctx->pitch+x] = 16;
-    }
-
     // Display Benchmark Info
-    char stats[32];
     int slen = 0;
-    stats[slen++] = 'F'; stats[slen++] = 'P'; stats[slen++] = 'S'; stats[slen++] = ':'; stats[slen++] = ' ';
-    
-    auto void push_dec(uint32_t val) {
-        if (val == 0) { stats[slen++] = '0'; return; }
-        char b[10]; int bi = 0;
-        while(val > 0) { b[bi++] = (char)('0' + (val % 10)); val /= 10; }
-        while(bi > 0) stats[slen++] = b[--bi];
-    };
-
-    push_dec(fps);
-    stats[slen++] = ' '; stats[slen++] = '(';
-    push_dec(msec);
-    stats[slen++] = 'm'; stats[slen++] = 's'; stats[slen++] = ')';
-    stats[slen] = 0;
-
+    while (stats[slen]) slen++;
     for (int i = 0; i < slen; i++) {
         const uint8_t* glyph = font8x16_get((uint8_t)stats[i]);
         for (int gy = 0; gy < 16; gy++) {
@@ -148,13 +164,20 @@ static void draw_cube(const fb_ctx_t* ctx, uint32_t phase, uint32_t fps, uint32_
             }
         }
     }
+    box->text = clip_box(ctx, 8, 8, 8 + slen * 8, 24);
 
+    int min_x = ctx->width, min_y = ctx->height, max_x = -1, max_y = -1;
     for (int i = 0; i < 8; i++) {
         rotate(&vertices[i], phase, phase * 2, phase / 2);
         int z = vertices[i].z + 256;
         proj[i].x = (int16_t)(ctx->width / 2 + (vertices[i].x * 256) / z);
         proj[i].y = (int16_t)(ctx->height / 2 + (vertices[i].y * 256) / z);
+        if (proj[i].x < min_x) min_x = proj[i].x;
+        if (proj[i].x > max_x) max_x = proj[i].x;
+        if (proj[i].y < min_y) min_y = proj[i].y;
+        if (proj[i].y > max_y) max_y = proj[i].y;
     }
+    box->cube = clip_box(ctx, min_x, min_y, max_x + 1, max_y + 1);
 
     for (int i = 0; i < 6; i++) {
         vec2_t p[4] = {proj[faces[i][0]], proj[faces[i][1]], proj[faces[i][2]], proj[faces[i][3]]};
@@ -169,32 +192,114 @@ static void draw_cube(const fb_ctx_t* ctx, uint32_t phase, uint32_t fps, uint32_
     }
 }
 
+// Appended MezAPI member present in this kernel's table?
+#define API_HAS(api, member) \
+    ((api)->size >= offsetof(mez_api32_t, member) + sizeof((api)->member) && (api)->member)
+
+// Microseconds: the high-resolution clock where offered, else timer ticks
+static uint32_t now_us(const mez_api32_t* api, uint32_t hz) {
+    if (API_HAS(api, time_us_get)) return api->time_us_get();
+    return api->time_ticks_get() * (1000000u / hz);
+}
+
 int rotcube_app_main(const mez_api32_t* api) {
     if (!api || api->abi_version < MEZ_ABI32_V1) return -1;
-    const mez_fb_info32_t* fb = api->video_fb_get_info();
-    if (!fb || fb->bpp != 8 || !fb->framebuffer) return -1;
+    // Double buffering where the kernel offers it (appended API, size-guarded)
+    int buffered = API_HAS(api, video_fb_acquire) && API_HAS(api, video_fb_present);
+    const mez_fb_info32_t* fb = buffered ? api->video_fb_acquire() : api->video_fb_get_info();
+    if (!fb || fb->bpp != 8 || !fb->framebuffer) {
+        if (buffered && api->video_fb_release) api->video_fb_release();
+        return -1;
+    }
 
     fb_ctx_t ctx = {api, (volatile uint8_t*)(uintptr_t)fb->framebuffer, (int)fb->pitch, fb->width, fb->height};
     uint32_t phase = 0;
     uint32_t hz = api->time_timer_hz();
-    uint32_t fps = 0, msec = 0;
+    if (hz == 0) hz = 1;
+    uint32_t fps = 0, frame_us = 0;
+    uint32_t frames = 0, window_frames = 0;
+    uint32_t t_start = now_us(api, hz), t_window = t_start;
+    // Adapter counters at the start, for the summary on exit
+    const mez_gpu_stats32_t* gs = API_HAS(api, video_gpu_get_stats) ? api->video_gpu_get_stats() : NULL;
+    uint32_t syncs0 = gs ? gs->syncs : 0, sync_us0 = gs ? gs->sync_us : 0, kib0 = gs ? gs->upload_kib : 0;
+    uint32_t result = MEZ_PRESENT_NONE;
+    int vsync = 1;
+    // Boxes of the last two frames; the first frame clears everything
+    mez_rect16_t full = {0, 0, fb->width, fb->height};
+    frame_box_t box[2] = { { full, full }, { full, full } };
 
     for (;;) {
         int key = api->input_poll_key ? api->input_poll_key() : -1;
         if (key == 0x11 || key == 0x1b || key == 'q' || key == 'Q') break;
-        
-        uint32_t start = api->time_ticks_get();
-        draw_cube(&ctx, phase, fps, msec);
-        uint32_t end = api->time_ticks_get();
-        
-        uint32_t delta = end - start;
-        if (delta == 0) delta = 1;
-        msec = (delta * 1000) / hz;
-        fps = hz / delta;
+        if (key == 'v' || key == 'V') vsync = !vsync;
+
+        char stats[48];
+        int slen = append_str(stats, 0, "FPS: ");
+        slen = append_dec(stats, slen, fps);
+        slen = append_str(stats, slen, " (");
+        slen = append_dec(stats, slen, frame_us / 1000u);
+        slen = append_str(stats, slen, ".");
+        slen = append_dec(stats, slen, (frame_us / 100u) % 10u);
+        slen = append_str(stats, slen, "ms)");
+        if (buffered) {
+            slen = append_str(stats, slen, result == MEZ_PRESENT_FLIPPED ? " flip" : " upload");
+            if (vsync) slen = append_str(stats, slen, " vsync");
+        }
+        stats[slen] = 0;
 
+        // A flipped page still shows the frame before last: clear both boxes
+        frame_box_t cur;
+        clear_box(&ctx, &box[0].text); clear_box(&ctx, &box[0].cube);
+        clear_box(&ctx, &box[1].text); clear_box(&ctx, &box[1].cube);
+        draw_cube(&ctx, phase, stats, &cur);
         phase = (phase + 2) & LUT_MASK;
-        if (api->video_fb_sync) api->video_fb_sync();
+
+        if (buffered) {
+            // Changed since the last frame: its boxes and the new ones
+            mez_rect16_t dirty[4] = { box[0].text, box[0].cube, cur.text, cur.cube };
+            result = api->video_fb_present(dirty, 4, vsync ? MEZ_PRESENT_VSYNC : 0);
+            fb = api->video_fb_acquire();
+            if (!fb || !fb->framebuffer) break;
+            ctx.base = (volatile uint8_t*)(uintptr_t)fb->framebuffer;
+        } else if (api->video_fb_sync) {
+            api->video_fb_sync();
+        }
+        box[1] = box[0];
+        box[0] = cur;
+
+        // Achieved frame rate, updated once per second
+        frames++;
+        window_frames++;
+        uint32_t now = now_us(api, hz);
+        if (now - t_window >= 1000000u) {
+            fps = (window_frames * 1000000u) / (now - t_window);
+            frame_us = (now - t_window) / window_frames;
+            window_frames = 0;
+            t_window = now;
+        }
         // if (api->time_sleep_ms) api->time_sleep_ms(10); // Remove sleep for max benchmark speed
     }
+
+    uint32_t elapsed_ms = (now_us(api, hz) - t_start) / 1000u;
+    if (buffered && api->video_fb_release) api->video_fb_release();
+    char line[128];
+    int len = append_str(line, 0, "rotcube: ");
+    len = append_dec(line, len, frames);
+    len = append_str(line, len, " frames, ");
+    len = append_dec(line, len, elapsed_ms ? (frames * 1000u) / elapsed_ms : 0);
+    len = append_str(line, len, " fps (");
+    len = append_str(line, len, !buffered ? "direct" : (result == MEZ_PRESENT_FLIPPED ? "flip" : "upload"));
+    if (buffered && vsync) len = append_str(line, len, ", vsync");
+    len = append_str(line, len, ")");
+    gs = gs ? api->video_gpu_get_stats() : NULL;
+    if (gs && gs->syncs != syncs0) {
+        len = append_str(line, len, ", sync avg ");
+        len = append_dec(line, len, (gs->sync_us - sync_us0) / (gs->syncs - syncs0));
+        len = append_str(line, len, " us, ");
+        len = append_dec(line, len, gs->upload_kib - kib0);
+        len = append_str(line, len, " KiB uploaded");
+    }
+    line[len] = 0;
+    if (api->console_writeln) api->console_writeln(line);
     return 0;
 }
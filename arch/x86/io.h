@@ -33,6 +33,23 @@ static inline uint32_t inl(uint16_t port) {
     return ret;
 }
 
+// String I/O: move 'count' words/bytes between a port and memory (rep ins/outs)
+static inline void insw(uint16_t port, void* buf, uint32_t count) {
+    __asm__ volatile ("cld; rep insw" : "+D"(buf), "+c"(count) : "d"(port) : "memory");
+}
+
+static inline void outsw(uint16_t port, const void* buf, uint32_t count) {
+    __asm__ volatile ("cld; rep outsw" : "+S"(buf), "+c"(count) : "d"(port) : "memory");
+}
+
+static inline void insb(uint16_t port, void* buf, uint32_t count) {
+    __asm__ volatile ("cld; rep insb" : "+D"(buf), "+c"(count) : "d"(port) : "memory");
+}
+
+static inline void outsb(uint16_t port, const void* buf, uint32_t count) {
+    __asm__ volatile ("cld; rep outsb" : "+S"(buf), "+c"(count) : "d"(port) : "memory");
+}
+
 static inline void io_delay(void) {
     __asm__ volatile ("outb %%al, $0x80" : : "a"(0));
 }
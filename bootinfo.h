@@ -40,11 +40,11 @@ typedef struct boot_info {
     void*    prom;        // firmware/prom vector (e.g. SPARC OBP)
     uint32_t boot_device; // BIOS/firmware provided boot device identifier
     /* Framebuffer / VBE info (filled by bootloader if available) */
-    uint16_t vbe_mode;        // preferred 8bpp VBE mode (if detected)
+    uint16_t vbe_mode;        // preferred LFB VBE mode (if detected)
     uint16_t vbe_pitch;       // bytes per scanline for preferred mode
     uint16_t vbe_width;       // width in pixels for preferred mode
     uint16_t vbe_height;      // height in pixels for preferred mode
-    uint8_t  vbe_bpp;         // bits per pixel for preferred mode (expect 8)
+    uint8_t  vbe_bpp;         // bits per pixel for preferred mode (8, 15, 16 or 32)
     uint8_t  _pad0;
     uint32_t framebuffer_phys; // physical address of preferred LFB (0 = none)
 
@@ -64,6 +64,10 @@ typedef struct boot_info {
     uint32_t bios_conventional_kb; /* INT 12h */
     uint32_t bios_extended_kb;     /* INT 15h E801/88h: KiB above 1MiB */
     uint32_t bios_mem_flags;       /* see boot_shared.inc BOOTINFO_BIOS_MEM_FLAGS bits */
+
+    /* Where stage3 loaded the kernel from (0 = unknown, e.g. floppy preload or serial) */
+    uint32_t kernel_lba;
+    uint32_t kernel_sectors;
 } boot_info_t;
 
 #endif // BOOTINFO_H
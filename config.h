@@ -43,6 +43,78 @@
 #define CONFIG_NE2000_PIO_16BIT 1
 #endif
 
+// NE2000 transmit slots in NIC buffer RAM (6 pages each, taken from the RX ring).
+// 2 = double buffering: copy the next frame while the previous one is on the wire.
+#ifndef CONFIG_NE2000_TX_SLOTS
+#define CONFIG_NE2000_TX_SLOTS 2
+#endif
+
+// NE2000 RX: frames processed per service call before yielding back to the caller
+#ifndef CONFIG_NE2000_RX_BUDGET
+#define CONFIG_NE2000_RX_BUDGET 16
+#endif
+
+// RTL8139 (PCI, bus-master DMA). Probed before the NE2000 when enabled.
+// RX ring size must be 8192, 16384, 32768 or 65536 bytes.
+#ifndef CONFIG_RTL8139
+#define CONFIG_RTL8139 1
+#endif
+#ifndef CONFIG_RTL8139_RX_RING
+#define CONFIG_RTL8139_RX_RING 32768
+#endif
+#ifndef CONFIG_RTL8139_RX_BUDGET
+#define CONFIG_RTL8139_RX_BUDGET 32
+#endif
+
+// ARP cache: entries (power of two), lifetime, and outbound packets parked per
+// unresolved neighbour (shared pool of CONFIG_NET_ARP_QUEUE_FRAMES frames)
+#ifndef CONFIG_NET_ARP_ENTRIES
+#define CONFIG_NET_ARP_ENTRIES 32
+#endif
+#ifndef CONFIG_NET_ARP_TTL_SEC
+#define CONFIG_NET_ARP_TTL_SEC 300
+#endif
+#ifndef CONFIG_NET_ARP_QUEUE_FRAMES
+#define CONFIG_NET_ARP_QUEUE_FRAMES 8
+#endif
+#ifndef CONFIG_NET_ARP_QUEUE_PER_ENTRY
+#define CONFIG_NET_ARP_QUEUE_PER_ENTRY 3
+#endif
+
+// IPv4 fragments: largest datagram the stack reassembles or fragments (bytes,
+// IP header included), reassembly slots (buffers allocated on first use, so
+// the memory cap is SLOTS * MAX_DATAGRAM) and how long an incomplete datagram waits
+#ifndef CONFIG_NET_IP_MAX_DATAGRAM
+#define CONFIG_NET_IP_MAX_DATAGRAM 16384
+#endif
+#ifndef CONFIG_NET_IP_REASM_SLOTS
+#define CONFIG_NET_IP_REASM_SLOTS 4
+#endif
+#ifndef CONFIG_NET_IP_REASM_TIMEOUT_SEC
+#define CONFIG_NET_IP_REASM_TIMEOUT_SEC 10
+#endif
+
+// UDP: open sockets and per-socket receive ring (bytes, allocated on first open)
+#ifndef CONFIG_NET_UDP_SOCKETS
+#define CONFIG_NET_UDP_SOCKETS 8
+#endif
+#ifndef CONFIG_NET_UDP_RX_RING
+#define CONFIG_NET_UDP_RX_RING 8192
+#endif
+
+// NeeleFS streaming writer: blocks reserved when the final size is unknown
+#ifndef CONFIG_NEELEFS_STREAM_RESERVE
+#define CONFIG_NEELEFS_STREAM_RESERVE (4u * 1024u * 1024u)
+#endif
+
+// TFTP: requested block size (RFC 2348, capped to one Ethernet frame) and window (RFC 7440)
+#ifndef CONFIG_NET_TFTP_BLKSIZE
+#define CONFIG_NET_TFTP_BLKSIZE 1468
+#endif
+#ifndef CONFIG_NET_TFTP_WINDOW
+#define CONFIG_NET_TFTP_WINDOW 8
+#endif
+
 // Video params für Zeilenauflösung
 #define CONFIG_VGA_WIDTH 80
 #define CONFIG_VGA_HEIGHT 25
@@ -85,6 +157,13 @@
 #define CONFIG_VIDEO_ET4000_VRAM_OVERRIDE_KB 0
 #endif
 
+// ET4000/AX drawing engine behind fb_accel (copy, fill, pattern, line).
+// Its register window overlaps the VGA ports 0x3C0-0x3C8, so it stays off
+// until verified on real boards; the shadow path is used either way.
+#ifndef CONFIG_VIDEO_ET4000AX_ACCEL
+#define CONFIG_VIDEO_ET4000AX_ACCEL 0
+#endif
+
 #ifndef CONFIG_VIDEO_ET4000_DEBUG_DISABLE_NMI
 #define CONFIG_VIDEO_ET4000_DEBUG_DISABLE_NMI 0
 #endif
@@ -100,6 +179,21 @@
 #define CONFIG_VIDEO_CLEAR_ON_INIT 0
 #endif
 
+// Framebuffer console: text is drawn in batches, at most this many times per
+// second during bulk output and whenever the shell waits for input.
+// 0 = draw every character as it is written.
+#ifndef CONFIG_VIDEO_FLUSH_HZ
+#define CONFIG_VIDEO_FLUSH_HZ 25
+#endif
+
+// Colour depth the automatic mode selection asks linear framebuffer adapters
+// for (8, 15, 16 or 32). Direct colour needs no palette and no banking, but
+// MezAPI apps written for 8bpp (rotcube) only run at 8; adapters without
+// the depth fall back to 8bpp.
+#ifndef CONFIG_VIDEO_FB_DEPTH
+#define CONFIG_VIDEO_FB_DEPTH 8
+#endif
+
 // Keep VGA hardware cursor in sync with text output
 #ifndef CONFIG_VIDEO_HW_CURSOR
 #define CONFIG_VIDEO_HW_CURSOR 1
@@ -191,6 +285,36 @@
 #define CONFIG_NEELEFS_LBA 2048
 #endif
 
+// HTTP responder (tcp_min): receive ring, allocated on the first connection.
+// Its free space is the advertised window (scaled when the peer offers window
+// scaling). A connection with no segment for CONFIG_NET_TCP_IDLE_SEC is reset.
+#ifndef CONFIG_NET_TCP_RCVBUF
+#define CONFIG_NET_TCP_RCVBUF 65536
+#endif
+#ifndef CONFIG_NET_TCP_IDLE_SEC
+#define CONFIG_NET_TCP_IDLE_SEC 30
+#endif
+
+// TCP discard/chargen benchmark services: advertised receive window and
+// chargen bytes in flight
+#ifndef CONFIG_NET_TCPBENCH_WINDOW
+#define CONFIG_NET_TCPBENCH_WINDOW 16384
+#endif
+
+// Packet capture (pcap): ring bytes (allocated on first 'pcap start') and the
+// UART the capture is dumped to with 'pcap serial' (COM2, 115200 8N1, raw)
+#ifndef CONFIG_NET_PCAP_RING
+#define CONFIG_NET_PCAP_RING 262144
+#endif
+#ifndef CONFIG_NET_PCAP_SERIAL_PORT
+#define CONFIG_NET_PCAP_SERIAL_PORT 0x2F8
+#endif
+
+// Network interfaces registered by netface (eth0..ethN-1, probe order)
+#ifndef CONFIG_NET_IFACES
+#define CONFIG_NET_IFACES 2
+#endif
+
 // Network RX debug printing from background service
 #ifndef CONFIG_NET_RX_DEBUG
 #define CONFIG_NET_RX_DEBUG 0
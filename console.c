@@ -11,6 +11,8 @@ void console_writeln(const char* s)      { cback_writeln(s); debug_serial_plugin
 void console_write_hex16(uint16_t v)     { cback_write_hex16(v); debug_serial_plugin_write_hex16(v); }
 void console_write_hex32(uint32_t v)     { cback_write_hex32(v); debug_serial_plugin_write_hex32(v); }
 void console_write_dec(uint32_t v)       { cback_write_dec(v); debug_serial_plugin_write_dec(v); }
+void console_flush(void)                 { cback_flush(); }
+uint32_t console_set_flush_rate(uint32_t hz) { return cback_set_flush_rate(hz); }
 void console_draw_status_right(const char* buf, int len) {
     if (!buf || len <= 0) {
         statusbar_legacy_set_right("");
@@ -42,3 +44,19 @@ int console_fb_active(void) {
 const void* console_fb_get_info(uint32_t* pitch, uint16_t* width, uint16_t* height, uint8_t* bpp) {
     return cback_fb_get_info(pitch, width, height, bpp);
 }
+
+int console_fb_get_format(void) {
+    return cback_fb_get_format();
+}
+
+const void* console_fb_acquire(uint32_t* pitch, uint16_t* width, uint16_t* height, uint8_t* bpp) {
+    return cback_fb_acquire(pitch, width, height, bpp);
+}
+
+int console_fb_present(int vsync) {
+    return cback_fb_present(vsync);
+}
+
+void console_fb_release(void) {
+    cback_fb_release();
+}
@@ -11,6 +11,8 @@ void console_writeln(const char* s);
 void console_write_hex16(uint16_t v);
 void console_write_hex32(uint32_t v);
 void console_write_dec(uint32_t v);
+void console_flush(void);
+uint32_t console_set_flush_rate(uint32_t hz);
 void console_draw_status_right(const char* buf, int len);
 // Set left-aligned status text in the top status bar.
 void console_status_set_left(const char* s);
@@ -18,5 +20,11 @@ void console_status_set_mid(const char* s);
 void console_status_set_right(const char* s);
 int  console_fb_active(void);
 const void* console_fb_get_info(uint32_t* pitch, uint16_t* width, uint16_t* height, uint8_t* bpp);
+// Pixel format of the framebuffer (display_pixel_format_t, 0 = none)
+int  console_fb_get_format(void);
+// Double-buffered frames for full-screen apps (video_fb_acquire and friends)
+const void* console_fb_acquire(uint32_t* pitch, uint16_t* width, uint16_t* height, uint8_t* bpp);
+int  console_fb_present(int vsync);
+void console_fb_release(void);
 
 #endif // CONSOLE_H
@@ -11,9 +11,15 @@ void cback_writeln(const char* s);
 void cback_write_hex16(uint16_t v);
 void cback_write_hex32(uint32_t v);
 void cback_write_dec(uint32_t v);
+void cback_flush(void);
+uint32_t cback_set_flush_rate(uint32_t hz);
 void cback_status_draw_full(const char* text, int len);
 
 int cback_fb_active(void);
 const void* cback_fb_get_info(uint32_t* pitch, uint16_t* width, uint16_t* height, uint8_t* bpp);
+int cback_fb_get_format(void);
+const void* cback_fb_acquire(uint32_t* pitch, uint16_t* width, uint16_t* height, uint8_t* bpp);
+int cback_fb_present(int vsync);
+void cback_fb_release(void);
 
 #endif // CONSOLE_BACKEND_H
@@ -13,9 +13,18 @@ void cback_writeln(const char* s) { (void)s; }
 void cback_write_hex16(uint16_t v) { (void)v; }
 void cback_write_hex32(uint32_t v) { (void)v; }
 void cback_write_dec(uint32_t v) { (void)v; }
+void cback_flush(void) {}
+uint32_t cback_set_flush_rate(uint32_t hz) { (void)hz; return 0; }
 void cback_status_draw_full(const char* text, int len) { (void)text; (void)len; }
 int cback_fb_active(void) { return 0; }
 const void* cback_fb_get_info(uint32_t* pitch, uint16_t* width, uint16_t* height, uint8_t* bpp) {
     (void)pitch; (void)width; (void)height; (void)bpp;
     return NULL;
 }
+int cback_fb_get_format(void) { return 0; }
+const void* cback_fb_acquire(uint32_t* pitch, uint16_t* width, uint16_t* height, uint8_t* bpp) {
+    (void)pitch; (void)width; (void)height; (void)bpp;
+    return NULL;
+}
+int cback_fb_present(int vsync) { (void)vsync; return 0; }
+void cback_fb_release(void) {}
@@ -1,4 +1,5 @@
 #include <stdint.h>
+#include "display.h"
 
 // VGA textmode backend mapping to video.c
 extern void video_init();
@@ -10,8 +11,14 @@ extern void video_print_hex32(uint32_t v);
 extern void video_print_dec(uint32_t v);
 extern void video_putc(char c);
 extern void video_status_draw_full(const char* text, int len);
+extern void video_flush(void);
+extern uint32_t video_set_flush_rate(uint32_t hz);
 extern int video_fb_active(void);
 extern const void* video_fb_get_info(uint32_t* pitch, uint16_t* width, uint16_t* height, uint8_t* bpp);
+extern display_pixel_format_t video_fb_get_format(void);
+extern const void* video_fb_acquire(uint32_t* pitch, uint16_t* width, uint16_t* height, uint8_t* bpp);
+extern int video_fb_present(int vsync);
+extern void video_fb_release(void);
 
 #include "console_backend.h"
 
@@ -23,8 +30,16 @@ void cback_writeln(const char* s)      { video_println(s); }
 void cback_write_hex16(uint16_t v)     { video_print_hex16(v); }
 void cback_write_hex32(uint32_t v)     { video_print_hex32(v); }
 void cback_write_dec(uint32_t v)       { video_print_dec(v); }
+void cback_flush(void)                 { video_flush(); }
+uint32_t cback_set_flush_rate(uint32_t hz) { return video_set_flush_rate(hz); }
 void cback_status_draw_full(const char* text, int len) { video_status_draw_full(text, len); }
 int cback_fb_active(void) { return video_fb_active(); }
 const void* cback_fb_get_info(uint32_t* pitch, uint16_t* width, uint16_t* height, uint8_t* bpp) {
     return video_fb_get_info(pitch, width, height, bpp);
 }
+int cback_fb_get_format(void) { return (int)video_fb_get_format(); }
+const void* cback_fb_acquire(uint32_t* pitch, uint16_t* width, uint16_t* height, uint8_t* bpp) {
+    return video_fb_acquire(pitch, width, height, bpp);
+}
+int cback_fb_present(int vsync) { return video_fb_present(vsync); }
+void cback_fb_release(void) { video_fb_release(); }
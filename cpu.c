@@ -40,6 +40,15 @@ static inline void cpuid_raw(uint32_t leaf, uint32_t* a, uint32_t* b, uint32_t*
 static bool cpuid_supported(void) { return false; }
 #endif
 
+int cpu_has_tsc(void) {
+    if (!cpuid_supported()) return 0;
+    uint32_t max = 0, d = 0;
+    cpuid_raw(0, &max, 0, 0, 0);
+    if (max < 1) return 0;
+    cpuid_raw(1, 0, 0, 0, &d);
+    return (d & (1u << 4)) != 0;
+}
+
 static void print_hex32(uint32_t v) {
     static const char H[] = "0123456789ABCDEF";
     char buf[11];
@@ -4,5 +4,7 @@
 const char* cpu_arch_name(void);
 void cpuinfo_print(void);
 void cpu_bootinfo_print(void);
+// Non-zero if CPUID reports a time-stamp counter (rdtsc)
+int cpu_has_tsc(void);
 
 #endif // CPU_H
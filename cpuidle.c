@@ -1,6 +1,7 @@
 #include "cpuidle.h"
 #include "config.h"
 #include "interrupts.h"
+#include "console.h"
 
 static volatile uint32_t g_idle_wakeups = 0;
 
@@ -9,6 +10,8 @@ void cpuidle_init(void) {
 }
 
 void cpuidle_idle(void) {
+    // Waiting for something: show the console text that is still deferred
+    console_flush();
 #if defined(CONFIG_ARCH_X86) && (CONFIG_ARCH_X86)
     // HLT only makes sense when interrupts are enabled; otherwise we might never resume.
     if (interrupts_are_enabled()) {
@@ -108,6 +108,10 @@ void display_manager_set_framebuffer_candidate(const char* driver_name, const di
     }
     g_ctx.state.framebuffer_driver_name = driver_name;
     g_ctx.state.framebuffer_mode = *mode;
+    if (mode->pixel_format == DISPLAY_PIXEL_FORMAT_NONE) {
+        // Treiber ohne eigene Angabe: Standardformat der Farbtiefe
+        g_ctx.state.framebuffer_mode.pixel_format = display_pixel_format_for_bpp(mode->bpp);
+    }
 
     int should_auto_activate = 0;
     if (g_ctx.state.requested_target == DISPLAY_TARGET_FRAMEBUFFER) {
@@ -156,10 +160,60 @@ static const char* pixel_format_name(display_pixel_format_t fmt) {
         case DISPLAY_PIXEL_FORMAT_PAL_256: return "Palettenmodus (256 Farben)";
         case DISPLAY_PIXEL_FORMAT_RGB_565: return "RGB 5:6:5";
         case DISPLAY_PIXEL_FORMAT_RGB_888: return "RGB 8:8:8";
+        case DISPLAY_PIXEL_FORMAT_RGB_555: return "RGB 5:5:5";
+        case DISPLAY_PIXEL_FORMAT_XRGB_8888: return "XRGB 8:8:8:8";
         default: return "unbekannt";
     }
 }
 
+display_pixel_format_t display_pixel_format_for_bpp(uint8_t bpp) {
+    switch (bpp) {
+        case 4:  return DISPLAY_PIXEL_FORMAT_PAL_16;
+        case 8:  return DISPLAY_PIXEL_FORMAT_PAL_256;
+        case 15: return DISPLAY_PIXEL_FORMAT_RGB_555;
+        case 16: return DISPLAY_PIXEL_FORMAT_RGB_565;
+        case 24: return DISPLAY_PIXEL_FORMAT_RGB_888;
+        case 32: return DISPLAY_PIXEL_FORMAT_XRGB_8888;
+        default: return DISPLAY_PIXEL_FORMAT_NONE;
+    }
+}
+
+int display_pixel_layout(display_pixel_format_t format, display_pixel_layout_t* out) {
+    // bytes, rot, grün, blau (Position, Breite); VBE-Standardlagen
+    static const uint8_t layouts[4][7] = {
+        { 2, 10, 5, 5, 5, 0, 5 },   // RGB_555
+        { 2, 11, 5, 5, 6, 0, 5 },   // RGB_565
+        { 3, 16, 8, 8, 8, 0, 8 },   // RGB_888
+        { 4, 16, 8, 8, 8, 0, 8 },   // XRGB_8888
+    };
+    int i;
+    switch (format) {
+        case DISPLAY_PIXEL_FORMAT_RGB_555:   i = 0; break;
+        case DISPLAY_PIXEL_FORMAT_RGB_565:   i = 1; break;
+        case DISPLAY_PIXEL_FORMAT_RGB_888:   i = 2; break;
+        case DISPLAY_PIXEL_FORMAT_XRGB_8888: i = 3; break;
+        default: return 0;
+    }
+    if (out) {
+        out->bytes_per_pixel = layouts[i][0];
+        out->red_pos = layouts[i][1];
+        out->red_size = layouts[i][2];
+        out->green_pos = layouts[i][3];
+        out->green_size = layouts[i][4];
+        out->blue_pos = layouts[i][5];
+        out->blue_size = layouts[i][6];
+    }
+    return 1;
+}
+
+uint32_t display_pixel_pack(const display_pixel_layout_t* layout, uint8_t r8, uint8_t g8, uint8_t b8) {
+    if (!layout) return 0;
+    // Jeder Kanal behält seine obersten Bits
+    return ((uint32_t)(r8 >> (8u - layout->red_size)) << layout->red_pos) |
+           ((uint32_t)(g8 >> (8u - layout->green_size)) << layout->green_pos) |
+           ((uint32_t)(b8 >> (8u - layout->blue_size)) << layout->blue_pos);
+}
+
 void display_manager_log_state(void) {
     const display_state_t* st = &g_ctx.state;
     const char* dname = st->active_mode.driver_name[0] ? st->active_mode.driver_name : st->active_driver_name;
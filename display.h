@@ -19,8 +19,18 @@ typedef enum {
     DISPLAY_PIXEL_FORMAT_PAL_256,
     DISPLAY_PIXEL_FORMAT_RGB_565,
     DISPLAY_PIXEL_FORMAT_RGB_888,
+    DISPLAY_PIXEL_FORMAT_RGB_555,     // 15bpp in 16 Bit, Bit 15 frei
+    DISPLAY_PIXEL_FORMAT_XRGB_8888,   // 32bpp, oberstes Byte frei
 } display_pixel_format_t;
 
+// Lage der Farbkanäle in einem Direktfarb-Pixel (Bitposition und Breite)
+typedef struct {
+    uint8_t bytes_per_pixel;
+    uint8_t red_pos, red_size;
+    uint8_t green_pos, green_size;
+    uint8_t blue_pos, blue_size;
+} display_pixel_layout_t;
+
 // Beschreibung eines verfügbaren Modus (z.B. 80x25 Text oder 640x480 @ 8bpp)
 typedef struct {
     display_mode_kind_t kind;
@@ -68,4 +78,11 @@ const display_state_t* display_manager_state(void);
 void display_manager_log_state(void);
 void display_manager_apply_active_mode(void);
 
+// Pixelformat zu einer Farbtiefe eines Framebuffers (4, 8, 15, 16, 24, 32)
+display_pixel_format_t display_pixel_format_for_bpp(uint8_t bpp);
+// Kanallage eines Direktfarbformats; 0 bei Paletten- und Textformaten
+int display_pixel_layout(display_pixel_format_t format, display_pixel_layout_t* out);
+// 8-Bit-Kanäle in einen Pixelwert des Formats packen
+uint32_t display_pixel_pack(const display_pixel_layout_t* layout, uint8_t r8, uint8_t g8, uint8_t b8);
+
 #endif // DISPLAY_H
@@ -61,6 +61,12 @@ void ata_set_target(uint16_t io, uint16_t ctrl, bool slave){
     ATA_IO = io; ATA_CTRL = ctrl; ATA_SLAVE = slave;
 }
 
+void ata_get_target(uint16_t* io, uint16_t* ctrl, bool* slave){
+    if (io) *io = ATA_IO;
+    if (ctrl) *ctrl = ATA_CTRL;
+    if (slave) *slave = ATA_SLAVE;
+}
+
 bool ata_init(void){
     if (!ata_present()) return false;
     // Disable IRQs (nIEN=1)
@@ -18,6 +18,8 @@ typedef struct {
 
 // Select target device (default is primary master). Affects subsequent operations.
 void ata_set_target(uint16_t io, uint16_t ctrl, bool slave);
+// Current target (for callers that switch temporarily)
+void ata_get_target(uint16_t* io, uint16_t* ctrl, bool* slave);
 
 // Probe currently selected target and return type
 ata_type_t ata_detect(void);
@@ -55,15 +55,27 @@ typedef struct {
 } __attribute__((packed)) ne2_dirblk_hdr_t; // 16 bytes
 
 // crc32 (polynomial 0xEDB88320)
+// Table-driven (built on first use): streaming writers checksum every byte
+static uint32_t g_crc_table[256];
+static int g_crc_table_ok = 0;
 static uint32_t crc32_update(uint32_t crc, const uint8_t* p, uint32_t len){
-    crc = ~crc;
-    for (uint32_t i=0;i<len;i++){
-        crc ^= p[i];
-        for (int b=0;b<8;b++) crc = (crc>>1) ^ (0xEDB88320u & (-(int)(crc & 1)));
+    if (!g_crc_table_ok){
+        for (uint32_t n=0;n<256;n++){
+            uint32_t c=n;
+            for (int b=0;b<8;b++) c = (c>>1) ^ (0xEDB88320u & (-(int)(c & 1)));
+            g_crc_table[n]=c;
+        }
+        g_crc_table_ok = 1;
     }
+    crc = ~crc;
+    for (uint32_t i=0;i<len;i++) crc = (crc>>8) ^ g_crc_table[(crc ^ p[i]) & 0xFF];
     return ~crc;
 }
 
+uint32_t neelefs_crc32(uint32_t crc, const void* data, uint32_t len){
+    return crc32_update(crc, (const uint8_t*)data, len);
+}
+
 static void* memzero(void* dst, uint32_t n){ uint8_t* d=(uint8_t*)dst; while(n--) *d++=0; return dst; }
 static void* memcpy_small(void* dst, const void* src, uint32_t n){ uint8_t* d=(uint8_t*)dst; const uint8_t* s=(const uint8_t*)src; while(n--) *d++=*s++; return dst; }
 
@@ -191,13 +203,6 @@ static int path_next(const char** pp, char* out_name){
     out_name[i]=0; *pp = p; return i;
 }
 
-static int bitmap_get(uint32_t idx){
-    uint32_t byte = idx >> 3; uint8_t sec[512];
-    uint32_t lba = g_mount_lba + g_v2_bitmap_start + (byte >> 9);
-    uint16_t off = (uint16_t)(byte & 0x1FF);
-    if (!ata_read_lba28(lba,1,sec)) return 1; // assume used on error
-    return (sec[off] >> (idx & 7)) & 1;
-}
 static int bitmap_set(uint32_t idx, int used){
     uint32_t byte = idx >> 3; uint8_t sec[512];
     uint32_t lba = g_mount_lba + g_v2_bitmap_start + (byte >> 9);
@@ -206,17 +211,49 @@ static int bitmap_set(uint32_t idx, int used){
     if (used) sec[off] |= (uint8_t)(1u << (idx & 7)); else sec[off] &= (uint8_t)~(1u << (idx & 7));
     return ata_write_lba28(lba,1,sec);
 }
-static uint32_t alloc_contig(uint32_t nblocks){
-    // naive first-fit after bitmap start + 1 (skip super+bitmap region)
+// Set/clear a run of blocks, one read-modify-write per bitmap sector
+static int bitmap_set_range(uint32_t first, uint32_t n, int used){
+    uint8_t sec[512]; uint32_t cur=0xFFFFFFFFu;
+    for (uint32_t idx=first; idx<first+n; idx++){
+        uint32_t byte = idx >> 3; uint32_t s = byte >> 9;
+        if (s != cur){
+            if (cur != 0xFFFFFFFFu && !ata_write_lba28(g_mount_lba + g_v2_bitmap_start + cur,1,sec)) return 0;
+            if (!ata_read_lba28(g_mount_lba + g_v2_bitmap_start + s,1,sec)) return 0;
+            cur = s;
+        }
+        uint16_t off = (uint16_t)(byte & 0x1FF);
+        if (used) sec[off] |= (uint8_t)(1u << (idx & 7)); else sec[off] &= (uint8_t)~(1u << (idx & 7));
+    }
+    if (cur != 0xFFFFFFFFu && !ata_write_lba28(g_mount_lba + g_v2_bitmap_start + cur,1,sec)) return 0;
+    return 1;
+}
+
+// First-fit search for 'want' free blocks (skip super+bitmap region), reading each
+// bitmap sector once. Returns the first run that is long enough; with 'partial'
+// the longest run found instead when none is. Length in *got.
+static uint32_t find_free_run(uint32_t want, int partial, uint32_t* got){
     uint32_t start = g_v2_bitmap_start + ( (g_v2_total_blocks + 4095)/4096 );
-    uint32_t run=0, run_start=0;
+    uint32_t run=0, run_start=0, best=0, best_start=0;
+    uint8_t sec[512]; uint32_t cur=0xFFFFFFFFu;
     for (uint32_t i=start;i<g_v2_total_blocks;i++){
-        if (!bitmap_get(i)){ if (run==0) run_start=i; run++; if (run>=nblocks){
-                for (uint32_t b=0;b<nblocks;b++) bitmap_set(run_start+b,1);
-                return run_start;
-            }} else { run=0; }
+        uint32_t byte = i >> 3; uint32_t s = byte >> 9;
+        if (s != cur){ if (!ata_read_lba28(g_mount_lba + g_v2_bitmap_start + s,1,sec)) return 0; cur = s; }
+        if (!((sec[byte & 0x1FF] >> (i & 7)) & 1)){
+            if (run==0) run_start=i;
+            run++;
+            if (run>=want){ *got=run; return run_start; }
+            if (run>best){ best=run; best_start=run_start; }
+        } else { run=0; }
     }
-    return 0; // failure
+    if (partial && best){ *got=best; return best_start; }
+    return 0;
+}
+
+static uint32_t alloc_contig(uint32_t nblocks){
+    uint32_t got=0; uint32_t b = find_free_run(nblocks, 0, &got);
+    if (!b) return 0; // failure
+    if (!bitmap_set_range(b, nblocks, 1)) return 0;
+    return b;
 }
 
 static int dir_load_block(uint32_t block_idx, uint8_t* sec){
@@ -361,37 +398,140 @@ bool neelefs_mkdir(const char* path){
     return true;
 }
 
-bool neelefs_write_text(const char* path, const char* text){
+// Rewrite the entry called 'name' in a directory chain
+static int dir_replace_entry(uint32_t dir_block, const char* name, const ne2_dirent_disk_t* ent){
+    uint8_t sec[512]; uint32_t blk = dir_block;
+    while (1){
+        if (!dir_load_block(blk,sec)) return 0;
+        ne2_dirblk_hdr_t* h = (ne2_dirblk_hdr_t*)sec;
+        int hdr_ok = (h->magic == NE2_DIRBLK_MAGIC);
+        int entries = hdr_ok ? h->entries_per_blk : (512 / (int)sizeof(ne2_dirent_disk_t));
+        uint32_t base = hdr_ok ? (uint32_t)sizeof(ne2_dirblk_hdr_t) : 0u;
+        ne2_dirent_disk_t* e = (ne2_dirent_disk_t*)(sec + base);
+        for (int i=0;i<entries;i++){
+            if (e[i].name[0] && str_eq(e[i].name, name)){ e[i] = *ent; return dir_store_block(blk,sec); }
+        }
+        if (!hdr_ok || h->next_block==0) return 0;
+        blk = h->next_block;
+    }
+}
+
+// ===== Streaming writer/reader (bulk transfers, e.g. TFTP) =====
+
+static int writer_flush(neelefs_writer_t* w, uint32_t bytes){
+    // bytes is a multiple of 512 except for the final tail
+    uint32_t nsec = blocks_for_bytes(bytes);
+    if (w->written_blocks + nsec > w->reserved) return 0;
+    if (bytes & 511u) memzero(w->buf + bytes, (nsec << 9) - bytes);
+    if (!ata_write_lba28(g_mount_lba + w->first_block + w->written_blocks, (uint8_t)nsec, w->buf)) return 0;
+    w->written_blocks += nsec;
+    w->fill = 0;
+    return 1;
+}
+
+bool neelefs_writer_open(neelefs_writer_t* w, const char* path, uint32_t size_hint){
+    if (!w) return false;
+    w->active = 0;
     if (!g_mounted) { console_writeln("NeeleFS not mounted"); return false; }
     if (!g_is_v2)  { console_writeln("NeeleFS1 mounted (read-only); cannot write"); return false; }
-    uint32_t dirb; char leaf[33]; if (!resolve_path(path,&dirb,leaf) || !leaf[0]) { console_writeln("bad path"); return false; }
-    // measure text
-    uint32_t len=0; while (text && text[len]) len++;
-    uint32_t nb = blocks_for_bytes(len);
-    uint32_t b = alloc_contig(nb?nb:1); if (!b){ console_writeln("no space"); return false; }
-    // write content
-    const uint8_t* p=(const uint8_t*)text; uint8_t sec[512];
-    for (uint32_t i=0;i<nb;i++){
-        uint32_t chunk = (len>512)?512:len;
-        memzero(sec,512);
-        if (chunk) memcpy_small(sec,p,chunk);
-        if (!ata_write_lba28(g_mount_lba + b + i,1,sec)) return false;
-        if (len>chunk){ len-=chunk; p+=chunk; } else len=0;
+    if (!resolve_path(path,&w->dir_block,w->leaf) || !w->leaf[0]) { console_writeln("bad path"); return false; }
+    ne2_dirent_disk_t cur;
+    if (dir_find_entry(w->dir_block,w->leaf,&cur,0) && cur.type!=1) { console_writeln("exists (not a file)"); return false; }
+    // Known size: reserve exactly. Unknown: take the first run of CONFIG_NEELEFS_STREAM_RESERVE
+    // bytes, or the longest free run; the unused tail is released on close.
+    uint32_t want = size_hint ? blocks_for_bytes(size_hint) : blocks_for_bytes(CONFIG_NEELEFS_STREAM_RESERVE);
+    if (want==0) want=1;
+    uint32_t got=0; uint32_t b = find_free_run(want, size_hint ? 0 : 1, &got);
+    if (!b){ console_writeln("no space"); return false; }
+    if (got > want) got = want;
+    if (!bitmap_set_range(b, got, 1)) return false;
+    w->first_block=b; w->reserved=got; w->written_blocks=0; w->size=0; w->crc=0; w->fill=0;
+    w->active = 1;
+    return true;
+}
+
+bool neelefs_writer_write(neelefs_writer_t* w, const void* data, uint32_t len){
+    if (!w || !w->active) return false;
+    const uint8_t* p = (const uint8_t*)data;
+    w->crc = crc32_update(w->crc, p, len);
+    w->size += len;
+    while (len){
+        uint32_t room = (uint32_t)sizeof(w->buf) - w->fill;
+        uint32_t n = len < room ? len : room;
+        memcpy_small(w->buf + w->fill, p, n);
+        w->fill += n; p += n; len -= n;
+        if (w->fill == sizeof(w->buf) && !writer_flush(w, w->fill)) { neelefs_writer_abort(w); return false; }
     }
-    // add or replace entry
-    ne2_dirent_disk_t cur; uint32_t idx;
-    if (dir_find_entry(dirb,leaf,&cur,&idx)){
-        // replace by writing updated entry
-        uint8_t dirsec[512]; if (!dir_load_block(dirb,dirsec)) return false; ne2_dirent_disk_t* ents=(ne2_dirent_disk_t*)dirsec; ents[idx].first_block=b; ents[idx].size_bytes=(uint32_t)(len + (p?(uint32_t)0:0)); // we lost original len; recompute
-        // recompute len properly
-        uint32_t sl=0; while (text && text[sl]) sl++; ents[idx].size_bytes=sl; ents[idx].type=1; ents[idx].csum = crc32_update(0,(const uint8_t*)text,sl);
-        return dir_store_block(dirb,dirsec);
-    } else {
-        ne2_dirent_disk_t ne; memzero(&ne,sizeof(ne)); for (int i=0;i<32;i++){ ne.name[i] = (leaf[i]?leaf[i]:0); if(!leaf[i]) break; }
-        uint32_t sl=0; while (text && text[sl]) sl++;
-        ne.type=1; ne.first_block=b; ne.size_bytes=sl; ne.csum=crc32_update(0,(const uint8_t*)text,sl);
-        return dir_add_entry(dirb,&ne);
+    return true;
+}
+
+void neelefs_writer_abort(neelefs_writer_t* w){
+    if (!w || !w->active) return;
+    (void)bitmap_set_range(w->first_block, w->reserved, 0);
+    w->active = 0;
+}
+
+bool neelefs_writer_close(neelefs_writer_t* w){
+    if (!w || !w->active) return false;
+    if (w->fill && !writer_flush(w, w->fill)) { neelefs_writer_abort(w); return false; }
+    // Files keep at least one block (as neelefs_write_text always did)
+    uint32_t used = w->written_blocks ? w->written_blocks : 1;
+    if (used < w->reserved) (void)bitmap_set_range(w->first_block + used, w->reserved - used, 0);
+    w->active = 0;
+    ne2_dirent_disk_t ne; memzero(&ne,sizeof(ne));
+    for (int i=0;i<32;i++){ ne.name[i] = (w->leaf[i]?w->leaf[i]:0); if(!w->leaf[i]) break; }
+    ne.type=1; ne.first_block=w->first_block; ne.size_bytes=w->size; ne.csum=w->crc;
+    ne2_dirent_disk_t cur;
+    if (dir_find_entry(w->dir_block,w->leaf,&cur,0)){
+        if (!dir_replace_entry(w->dir_block,w->leaf,&ne)) return false;
+        // release the previous contents
+        uint32_t old_nb = blocks_for_bytes(cur.size_bytes); if (old_nb==0) old_nb=1;
+        (void)bitmap_set_range(cur.first_block, old_nb, 0);
+        return true;
+    }
+    return dir_add_entry(w->dir_block,&ne) ? true : false;
+}
+
+bool neelefs_reader_open(neelefs_reader_t* r, const char* path){
+    if (!r) return false;
+    if (!g_mounted || !g_is_v2) return false;
+    uint32_t dirb; char leaf[33]; if (!resolve_path(path,&dirb,leaf) || !leaf[0]) return false;
+    ne2_dirent_disk_t e; if (!dir_find_entry(dirb,leaf,&e,0) || e.type!=1) return false;
+    r->first_block=e.first_block; r->size=e.size_bytes; r->crc=e.csum;
+    r->cached_first=0xFFFFFFFFu; r->cached_count=0;
+    return true;
+}
+
+uint32_t neelefs_reader_read(neelefs_reader_t* r, uint32_t offset, void* out, uint32_t len){
+    if (!r || offset >= r->size) return 0;
+    if (len > r->size - offset) len = r->size - offset;
+    uint8_t* d = (uint8_t*)out; uint32_t done=0;
+    const uint32_t cache_blocks = (uint32_t)sizeof(r->buf) >> 9;
+    while (done < len){
+        uint32_t blk = (offset + done) >> 9;
+        if (r->cached_first==0xFFFFFFFFu || blk < r->cached_first || blk >= r->cached_first + r->cached_count){
+            // Refill: up to four sectors per ATA command
+            uint32_t file_blocks = blocks_for_bytes(r->size);
+            uint32_t n = file_blocks - blk; if (n > cache_blocks) n = cache_blocks;
+            if (!ata_read_lba28(g_mount_lba + r->first_block + blk, (uint8_t)n, r->buf)) return done;
+            r->cached_first = blk; r->cached_count = n;
+        }
+        uint32_t off = (offset + done) - (r->cached_first << 9);
+        uint32_t avail = (r->cached_count << 9) - off;
+        uint32_t n = len - done; if (n > avail) n = avail;
+        memcpy_small(d + done, r->buf + off, n);
+        done += n;
     }
+    return done;
+}
+
+bool neelefs_write_text(const char* path, const char* text){
+    // Same path as bulk transfers: exact reservation, CRC while writing, entry replaced in place
+    static neelefs_writer_t w;
+    uint32_t len=0; while (text && text[len]) len++;
+    if (!neelefs_writer_open(&w, path, len ? len : 1)) return false;
+    if (len && !neelefs_writer_write(&w, text, len)) return false;
+    return neelefs_writer_close(&w);
 }
 
 bool neelefs_cat_path(const char* path){
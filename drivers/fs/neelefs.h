@@ -25,6 +25,39 @@ bool neelefs_write_text(const char* path, const char* text);
 bool neelefs_cat_path(const char* path);
 bool neelefs_read_text(const char* path, char* out, uint32_t out_max, uint32_t* out_len);
 // Verify integrity (CRC32): if path is a file, checks that file; if directory or '/', checks recursively.
-// Verify integrity (CRC32): if path is a file, checks that file; if directory or '/', checks recursively.
 // When verbose!=0, prints CRCs even for OK files.
 bool neelefs_verify(const char* path, int verbose);
+
+// CRC32 as used for file checksums (zlib/binascii compatible, start with 0)
+uint32_t neelefs_crc32(uint32_t crc, const void* data, uint32_t len);
+
+// Streaming writer (v2): data is staged in 2 KiB and written with multi-sector
+// ATA commands into a contiguous reservation; CRC is computed on the fly.
+// size_hint 0 = unknown (reserves up to CONFIG_NEELEFS_STREAM_RESERVE bytes).
+// close() commits the directory entry (replacing an existing file), abort()
+// releases the reservation.
+typedef struct {
+    uint32_t dir_block;
+    char     leaf[33];
+    int      active;
+    uint32_t first_block, reserved, written_blocks;
+    uint32_t size, crc;
+    uint32_t fill;
+    uint8_t  buf[2048];
+} neelefs_writer_t;
+
+bool neelefs_writer_open(neelefs_writer_t* w, const char* path, uint32_t size_hint);
+bool neelefs_writer_write(neelefs_writer_t* w, const void* data, uint32_t len);
+bool neelefs_writer_close(neelefs_writer_t* w);
+void neelefs_writer_abort(neelefs_writer_t* w);
+
+// Random-access reader for v2 files (caches up to four sectors)
+typedef struct {
+    uint32_t first_block, size, crc;
+    uint32_t cached_first, cached_count;
+    uint8_t  buf[2048];
+} neelefs_reader_t;
+
+bool neelefs_reader_open(neelefs_reader_t* r, const char* path);
+// Returns bytes copied (0 at end of file or on read error)
+uint32_t neelefs_reader_read(neelefs_reader_t* r, uint32_t offset, void* out, uint32_t len);
@@ -1,6 +1,9 @@
 #include "avga2.h"
 #include "vga_hw.h"
 #include "fb_accel.h"
+#include "fb_dirty.h"
+#include "blit.h"
+#include "gpu_stats.h"
 #include "../../console.h"
 #include "../../config.h"
 #include "../../interrupts.h"
@@ -34,84 +37,41 @@ static void avga2_clear_vram(void) {
 static uint8_t* g_avga2_shadow = NULL;
 static uint16_t g_avga2_w, g_avga2_h;
 static uint8_t  g_avga2_bpp;
-static uint32_t g_avga2_dirty_mask[15]; 
+static fb_dirty_t g_avga2_dirty;
 static uint8_t  g_avga2_current_bank = 0xFF;
+static gpu_blit_scroll_t g_avga2_scroll;
 
 static void avga2_fb_mark_dirty(void* ctx, uint16_t x, uint16_t y, uint16_t width, uint16_t height) {
-    (void)ctx; (void)x; (void)width;
-    for (uint16_t i = 0; i < height; i++) {
-        uint16_t line = y + i;
-        if (line < 480) {
-            g_avga2_dirty_mask[line >> 5] |= (1u << (line & 31));
-        }
-    }
+    (void)ctx;
+    fb_dirty_mark(&g_avga2_dirty, x, y, width, height);
 }
 
 static void avga2_fb_sync(void* ctx) {
     (void)ctx;
-    if (!g_avga2_shadow) return;
+    if (!g_avga2_shadow || !fb_dirty_any(&g_avga2_dirty)) return;
 
-    uint32_t flags = interrupts_save_disable();
+    gpu_blit_target_t target = { g_avga2_shadow, g_avga2_w, (volatile uint8_t*)0xA0000, NULL, g_avga2_current_bank, 0 };
+    uint32_t lines = 0;
+    uint32_t bytes = 0;
+    uint32_t full_frame = 0;
+
+    uint32_t flags = gpu_stats_irq_save();
     
     if (g_avga2_bpp == 8) {
-        for (uint16_t y = 0; y < g_avga2_h; y++) {
-            if (!(g_avga2_dirty_mask[y >> 5] & (1u << (y & 31)))) continue;
-
-            uint32_t line_offset = (uint32_t)y * g_avga2_w;
-            uint8_t bank = (uint8_t)(line_offset >> 16);
-            uint16_t bank_off = (uint16_t)(line_offset & 0xFFFF);
-            
-            if (bank != g_avga2_current_bank) {
-                avga2_set_bank(bank);
-                g_avga2_current_bank = bank;
-            }
-
-            volatile uint8_t* vram = (volatile uint8_t*)0xA0000;
-            
-            if (bank_off + g_avga2_w <= 65536) {
-                const uint32_t* src32 = (const uint32_t*)(g_avga2_shadow + line_offset);
-                volatile uint32_t* dst32 = (volatile uint32_t*)(vram + bank_off);
-                for (uint16_t i = 0; i < 160; i++) {
-                    dst32[i] = src32[i];
-                }
-            } else {
-                for (uint16_t i = 0; i < g_avga2_w; i++) {
-                    uint32_t abs_off = line_offset + i;
-                    uint8_t b = (uint8_t)(abs_off >> 16);
-                    if (b != g_avga2_current_bank) {
-                        avga2_set_bank(b);
-                        g_avga2_current_bank = b;
-                    }
-                    vram[abs_off & 0xFFFF] = g_avga2_shadow[abs_off];
-                }
-            }
-            g_avga2_dirty_mask[y >> 5] &= ~(1u << (y & 31));
-        }
+        target.set_bank = avga2_set_bank;
+        target.origin = (uint32_t)g_avga2_scroll.top * g_avga2_w;
+        bytes = gpu_blit_chunky(&target, &g_avga2_dirty, &lines);
+        g_avga2_current_bank = target.bank;
+        full_frame = (uint32_t)g_avga2_w * g_avga2_h;
     } else if (g_avga2_bpp == 4) {
-        const uint32_t bytes_per_plane_line = g_avga2_w / 8;
-        for (uint8_t plane = 0; plane < 4; plane++) {
-            vga_seq_write(0x02, (uint8_t)(1u << plane));
-            vga_gc_write(0x04, plane);
-            for (uint16_t y = 0; y < g_avga2_h; y++) {
-                if (!(g_avga2_dirty_mask[y >> 5] & (1u << (y & 31)))) continue;
-                const uint8_t* src_line = g_avga2_shadow + (uint32_t)y * g_avga2_w;
-                volatile uint8_t* dst_line = (volatile uint8_t*)0xA0000 + (uint32_t)y * bytes_per_plane_line;
-                for (uint32_t b = 0; b < bytes_per_plane_line; b++) {
-                    uint8_t packed = 0;
-                    uint32_t px = b << 3;
-                    for (int i=0; i<8; i++) {
-                        if (src_line[px + i] & (1u << plane)) packed |= (uint8_t)(0x80 >> i);
-                    }
-                    dst_line[b] = packed;
-                }
-            }
-        }
-        for (int i=0; i<15; i++) g_avga2_dirty_mask[i] = 0;
-        vga_seq_write(0x02, 0x0F);
-        vga_gc_write(0x04, 0x00);
+        target.origin = (uint32_t)g_avga2_scroll.top * (g_avga2_w / 8u);
+        bytes = gpu_blit_planar4(&target, &g_avga2_dirty, &lines);
+        full_frame = (uint32_t)(g_avga2_w / 8u) * g_avga2_h * 4u;
     }
+    fb_dirty_clear(&g_avga2_dirty);
+    fb_dirty_account(lines, bytes, full_frame);
 
-    interrupts_restore(flags);
+    gpu_stats_irq_restore(flags);
 }
 
 static int avga2_fb_fill_rect(void* ctx, uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint8_t color) {
@@ -127,10 +87,32 @@ static int avga2_fb_fill_rect(void* ctx, uint16_t x, uint16_t y, uint16_t width,
     return 1;
 }
 
+// Hardware scrolling through the virtual buffer set up by avga2_set_mode()
+static int avga2_fb_scroll(void* ctx, uint16_t lines) {
+    (void)ctx;
+    if (!g_avga2_shadow || !g_avga2_scroll.lines) return 0;
+    avga2_fb_sync(NULL);
+    int moved = gpu_blit_scroll(&g_avga2_scroll, g_avga2_shadow, g_avga2_w, &g_avga2_dirty, lines);
+    if (!moved) return 0;
+    if (moved == 2) avga2_fb_sync(NULL);
+    uint32_t line_bytes = (g_avga2_bpp == 4) ? (uint32_t)g_avga2_w / 8u : g_avga2_w;
+    uint32_t flags = interrupts_save_disable();
+    vga_set_start_address((uint32_t)g_avga2_scroll.top * line_bytes);
+    interrupts_restore(flags);
+    return 1;
+}
+
 static const fb_accel_ops_t g_avga2_ops = {
     avga2_fb_fill_rect,
     avga2_fb_sync,
-    avga2_fb_mark_dirty
+    avga2_fb_mark_dirty,
+    avga2_fb_scroll,
+    NULL,   // copy, expand, pattern, line: fb_accel draws into the shadow
+    NULL,
+    NULL,
+    NULL,
+    NULL,   // set_page, show_page: one page, apps present by upload
+    NULL
 };
 
 int avga2_signature_present(void) {
@@ -233,11 +215,13 @@ int avga2_set_mode(gpu_info_t* gpu, display_mode_info_t* out_mode, uint16_t widt
         if (!g_avga2_shadow) return 0;
     }
     for (uint32_t i = 0; i < 640 * 480; i++) g_avga2_shadow[i] = 0;
-    for (int i=0; i<15; i++) g_avga2_dirty_mask[i] = 0xFFFFFFFF;
     
     g_avga2_w = width;
     g_avga2_h = height;
     g_avga2_bpp = bpp;
+    g_avga2_current_bank = 0xFF;
+    fb_dirty_init(&g_avga2_dirty, width, height);
+    fb_dirty_mark_all(&g_avga2_dirty);
 
     uint32_t irq_flags = interrupts_save_disable();
     if (width == 320 && height == 200 && bpp == 8) {
@@ -286,6 +270,15 @@ int avga2_set_mode(gpu_info_t* gpu, display_mode_info_t* out_mode, uint16_t widt
     }
 
     avga2_clear_vram();
+    // Virtual buffer for hardware scrolling (640-wide modes): 4bpp uses one
+    // plane's share of VRAM per line byte
+    g_avga2_scroll.top = 0;
+    g_avga2_scroll.lines = 0;
+    if (width == 640) {
+        uint32_t line_bytes = (bpp == 4) ? width / 8u : width;
+        uint32_t span = (bpp == 4) ? vram / 4u : vram;
+        g_avga2_scroll.lines = gpu_blit_scroll_lines(span, line_bytes, height, vga_start_address_unit());
+    }
     fb_accel_register(&g_avga2_ops, NULL);
 
     out_mode->kind = DISPLAY_MODE_KIND_FRAMEBUFFER;
@@ -0,0 +1,176 @@
+#include "blit.h"
+#include "vga_hw.h"
+#include "c2p.h"
+#include "gpu_stats.h"
+#include "../../memory.h"
+#include "../../config.h"
+#include <stddef.h>
+
+void gpu_blit_copy(volatile void* dst, const void* src, uint32_t len) {
+#if CONFIG_ARCH_X86
+    uint8_t* d = (uint8_t*)(uintptr_t)dst;
+    const uint8_t* s = (const uint8_t*)src;
+    uint32_t dwords = len >> 2;
+    uint32_t tail = len & 3u;
+    __asm__ volatile ("cld\n\t"
+                      "rep movsl\n\t"
+                      "mov %3, %%ecx\n\t"
+                      "rep movsb"
+                      : "+D"(d), "+S"(s), "+c"(dwords)
+                      : "r"(tail)
+                      : "memory");
+#else
+    volatile uint8_t* d = (volatile uint8_t*)dst;
+    const uint8_t* s = (const uint8_t*)src;
+    for (uint32_t i = 0; i < len; ++i) d[i] = s[i];
+#endif
+}
+
+uint32_t gpu_blit_chunky(gpu_blit_target_t* t, const fb_dirty_t* d, uint32_t* lines) {
+    uint32_t bytes = 0;
+    uint32_t count = 0;
+    if (!t || !t->shadow || !fb_dirty_any(d)) {
+        if (lines) *lines = 0;
+        return 0;
+    }
+    for (uint32_t y = d->y_min; y <= d->y_max; ++y) {
+        if (d->x1[y] == 0) continue;
+        // Whole dwords: the extra bytes at either end are unchanged shadow data
+        const uint32_t line = y * t->pitch;
+        uint32_t start = d->x0[y] & ~3u;
+        uint32_t end = ((uint32_t)d->x1[y] + 3u) & ~3u;
+        if (end > t->pitch) end = t->pitch;
+        uint32_t off = line + start;
+        uint32_t vram = t->origin + off;
+        uint32_t left = end - start;
+        bytes += left;
+        count++;
+        while (left) {
+            uint32_t in_bank = vram & (GPU_BLIT_WINDOW_SIZE - 1u);
+            uint32_t piece = GPU_BLIT_WINDOW_SIZE - in_bank;
+            if (piece > left) piece = left;
+            if (t->set_bank) {
+                uint8_t bank = (uint8_t)(vram >> 16);
+                if (bank != t->bank) {
+                    t->set_bank(bank);
+                    t->bank = bank;
+                    gpu_stats_bank_switch();
+                }
+                gpu_blit_copy(t->window + in_bank, t->shadow + off, piece);
+            } else {
+                gpu_blit_copy(t->window + vram, t->shadow + off, piece);
+            }
+            off += piece;
+            vram += piece;
+            left -= piece;
+        }
+    }
+    if (lines) *lines = count;
+    return bytes;
+}
+
+// Planar staging: a RAM copy of the four planes, filled in one conversion
+// pass so each plane is then selected once and written with plain copies
+#define GPU_BLIT_PLANAR_LINE_MAX 128u   // plane bytes per line, 1024 pixels
+static uint8_t* g_blit_planes = NULL;
+static uint32_t g_blit_planes_size = 0;
+
+// Without staging memory: convert each line into a small buffer once per
+// plane and keep only that plane's bytes
+static uint32_t gpu_blit_planar4_lines(gpu_blit_target_t* t, const fb_dirty_t* d, uint32_t* lines) {
+    uint8_t buf[4][GPU_BLIT_PLANAR_LINE_MAX];
+    const uint32_t bytes_per_line = t->pitch / 8u;
+    uint32_t bytes = 0;
+    uint32_t count = 0;
+    for (uint8_t plane = 0; plane < 4; ++plane) {
+        vga_seq_write(0x02, (uint8_t)(1u << plane));
+        vga_gc_write(0x04, plane);
+        for (uint32_t y = d->y_min; y <= d->y_max; ++y) {
+            if (d->x1[y] == 0) continue;
+            const uint32_t first = d->x0[y] / 8u;
+            uint32_t last = ((uint32_t)d->x1[y] + 7u) / 8u;
+            if (last - first > sizeof(buf[0])) last = first + sizeof(buf[0]);
+            gpu_c2p4(t->shadow + y * t->pitch + first * 8u, last - first,
+                     buf[0], buf[1], buf[2], buf[3]);
+            gpu_blit_copy(t->window + t->origin + y * bytes_per_line + first, buf[plane], last - first);
+            bytes += last - first;
+            if (plane == 0) count++;
+        }
+    }
+    vga_seq_write(0x02, 0x0F);
+    vga_gc_write(0x04, 0x00);
+    if (lines) *lines = count;
+    return bytes;
+}
+
+uint32_t gpu_blit_planar4(gpu_blit_target_t* t, const fb_dirty_t* d, uint32_t* lines) {
+    uint32_t bytes = 0;
+    uint32_t count = 0;
+    if (!t || !t->shadow || !fb_dirty_any(d)) {
+        if (lines) *lines = 0;
+        return 0;
+    }
+    const uint32_t bytes_per_line = t->pitch / 8u;
+    const uint32_t plane_size = bytes_per_line * d->height;
+    if (g_blit_planes_size < plane_size * 4u) {
+        uint8_t* planes = (uint8_t*)memory_alloc(plane_size * 4u);
+        if (!planes) return gpu_blit_planar4_lines(t, d, lines);
+        g_blit_planes = planes;
+        g_blit_planes_size = plane_size * 4u;
+    }
+
+    // Pass 1: all four plane bytes of every dirty 8-pixel group
+    for (uint32_t y = d->y_min; y <= d->y_max; ++y) {
+        if (d->x1[y] == 0) continue;
+        // Planar bytes cover 8 pixels: widen the span to whole bytes
+        const uint32_t first = d->x0[y] / 8u;
+        const uint32_t last = ((uint32_t)d->x1[y] + 7u) / 8u;
+        uint8_t* p0 = g_blit_planes + y * bytes_per_line + first;
+        gpu_c2p4(t->shadow + y * t->pitch + first * 8u, last - first,
+                 p0, p0 + plane_size, p0 + 2u * plane_size, p0 + 3u * plane_size);
+        count++;
+    }
+
+    // Pass 2: one map-mask/read-map selection per plane
+    for (uint8_t plane = 0; plane < 4; ++plane) {
+        vga_seq_write(0x02, (uint8_t)(1u << plane));
+        vga_gc_write(0x04, plane);
+        const uint8_t* src = g_blit_planes + plane * plane_size;
+        for (uint32_t y = d->y_min; y <= d->y_max; ++y) {
+            if (d->x1[y] == 0) continue;
+            const uint32_t first = d->x0[y] / 8u;
+            const uint32_t last = ((uint32_t)d->x1[y] + 7u) / 8u;
+            const uint32_t off = y * bytes_per_line + first;
+            gpu_blit_copy(t->window + t->origin + off, src + off, last - first);
+            bytes += last - first;
+        }
+    }
+    vga_seq_write(0x02, 0x0F);
+    vga_gc_write(0x04, 0x00);
+    if (lines) *lines = count;
+    return bytes;
+}
+
+uint16_t gpu_blit_scroll_lines(uint32_t vram, uint32_t line_bytes, uint16_t height, uint32_t unit) {
+    if (!line_bytes || !height) return 0;
+    uint32_t lines = vram / line_bytes;
+    uint32_t reach = height + (0xFFFFu * unit) / line_bytes;
+    if (lines > reach) lines = reach;
+    if (lines > 0xFFFFu) lines = 0xFFFFu;
+    return (lines > height) ? (uint16_t)lines : 0;
+}
+
+int gpu_blit_scroll(gpu_blit_scroll_t* s, uint8_t* shadow, uint32_t pitch, fb_dirty_t* d, uint16_t count) {
+    if (!s || !shadow || !d || count == 0 || count >= d->height) return 0;
+    if ((uint32_t)s->lines < (uint32_t)d->height + count) return 0;
+    // Forward copy: the destination lies below the source
+    gpu_blit_copy(shadow, shadow + (uint32_t)count * pitch, (uint32_t)(d->height - count) * pitch);
+    s->top = (uint16_t)(s->top + count);
+    if ((uint32_t)s->top + d->height > s->lines) {
+        s->top = 0;
+        fb_dirty_mark_all(d);
+        return 2;
+    }
+    fb_dirty_mark(d, 0, (uint16_t)(d->height - count), d->width, count);
+    return 1;
+}
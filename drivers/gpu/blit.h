@@ -0,0 +1,55 @@
+#ifndef DRIVERS_GPU_BLIT_H
+#define DRIVERS_GPU_BLIT_H
+
+#include <stdint.h>
+#include "fb_dirty.h"
+
+// Shadow-to-VRAM upload shared by the adapters that draw into a RAM shadow
+// and copy it through the 64 KiB window at 0xA0000 (AVGA2, ET4000, SMOS).
+//
+// Chunky modes (8bpp): every dirty span is widened to whole dwords, split
+// once at 64 KiB bank boundaries and each piece copied with rep movsd; the
+// adapter's set_bank callback is only called when the bank changes.
+// Planar modes (4bpp): spans are widened to 8-pixel bytes, converted in one
+// pass into a RAM copy of the four planes (c2p.h, allocated on first use),
+// then written plane by plane; 640x480x4 fits the window, so no banking.
+#define GPU_BLIT_WINDOW_SIZE 0x10000u
+
+typedef void (*gpu_blit_set_bank_fn)(uint8_t bank);
+
+typedef struct {
+    const uint8_t*      shadow;     // linear shadow, one byte per pixel
+    uint32_t            pitch;      // shadow bytes per line (= VRAM bytes per line in 8bpp)
+    volatile uint8_t*   window;     // CPU address of the VRAM window
+    gpu_blit_set_bank_fn set_bank;  // NULL: window holds the whole frame
+    uint8_t             bank;       // currently selected bank, 0xFF = unknown
+    uint32_t            origin;     // VRAM offset of shadow line 0 (hardware scrolling)
+} gpu_blit_target_t;
+
+// Hardware scrolling for shadow adapters: VRAM holds a virtual buffer of
+// 'lines' scanlines and the CRTC shows the frame from scanline 'top'. The
+// shadow keeps screen coordinates and is moved with the picture, so after a
+// scroll only the uncovered lines differ from VRAM.
+typedef struct {
+    uint16_t top;
+    uint16_t lines;     // virtual buffer height, 0 = no hardware scrolling
+} gpu_blit_scroll_t;
+
+// Copy len bytes to VRAM: rep movsd for the dwords, rep movsb for the tail
+void gpu_blit_copy(volatile void* dst, const void* src, uint32_t len);
+
+// Upload the dirty spans; return the VRAM bytes written, scanlines in *lines
+uint32_t gpu_blit_chunky(gpu_blit_target_t* t, const fb_dirty_t* d, uint32_t* lines);
+uint32_t gpu_blit_planar4(gpu_blit_target_t* t, const fb_dirty_t* d, uint32_t* lines);
+
+// Virtual buffer height for 'vram' bytes at 'line_bytes' per VRAM line, limited
+// to what a start address of 16 bits in 'unit' bytes can reach
+uint16_t gpu_blit_scroll_lines(uint32_t vram, uint32_t line_bytes, uint16_t height, uint32_t unit);
+
+// Move the shadow and the view up by 'count' scanlines. The shadow must have
+// been uploaded (d clean). Returns 0 if the virtual buffer is too small,
+// 1 if the view moved (uncovered lines marked dirty), 2 if it wrapped back
+// to scanline 0 (all lines marked dirty: upload before moving the CRTC).
+int gpu_blit_scroll(gpu_blit_scroll_t* s, uint8_t* shadow, uint32_t pitch, fb_dirty_t* d, uint16_t count);
+
+#endif // DRIVERS_GPU_BLIT_H
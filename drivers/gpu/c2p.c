@@ -0,0 +1,27 @@
+#include "c2p.h"
+
+// Colour bit n of a pixel -> bit 0 of byte n
+static const uint32_t g_c2p_spread[16] = {
+    0x00000000u, 0x00000001u, 0x00000100u, 0x00000101u,
+    0x00010000u, 0x00010001u, 0x00010100u, 0x00010101u,
+    0x01000000u, 0x01000001u, 0x01000100u, 0x01000101u,
+    0x01010000u, 0x01010001u, 0x01010100u, 0x01010101u,
+};
+
+void gpu_c2p4(const uint8_t* src, uint32_t count,
+              uint8_t* p0, uint8_t* p1, uint8_t* p2, uint8_t* p3) {
+    for (uint32_t i = 0; i < count; ++i, src += 8) {
+        uint32_t w = (g_c2p_spread[src[0] & 0x0Fu] << 7)
+                   | (g_c2p_spread[src[1] & 0x0Fu] << 6)
+                   | (g_c2p_spread[src[2] & 0x0Fu] << 5)
+                   | (g_c2p_spread[src[3] & 0x0Fu] << 4)
+                   | (g_c2p_spread[src[4] & 0x0Fu] << 3)
+                   | (g_c2p_spread[src[5] & 0x0Fu] << 2)
+                   | (g_c2p_spread[src[6] & 0x0Fu] << 1)
+                   |  g_c2p_spread[src[7] & 0x0Fu];
+        p0[i] = (uint8_t)w;
+        p1[i] = (uint8_t)(w >> 8);
+        p2[i] = (uint8_t)(w >> 16);
+        p3[i] = (uint8_t)(w >> 24);
+    }
+}
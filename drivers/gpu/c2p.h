@@ -0,0 +1,16 @@
+#ifndef DRIVERS_GPU_C2P_H
+#define DRIVERS_GPU_C2P_H
+
+#include <stdint.h>
+
+// Chunky-to-planar conversion for the 16-colour planar modes: one shadow
+// byte per pixel (colour in bits 0-3) in, one byte per plane and 8 pixels
+// out, leftmost pixel in bit 7. A 16-entry table spreads a pixel's four
+// colour bits over the four bytes of a 32-bit word, so 8 lookups produce
+// all four plane bytes at once.
+//
+// Converts 'count' groups of 8 pixels from src into p0..p3.
+void gpu_c2p4(const uint8_t* src, uint32_t count,
+              uint8_t* p0, uint8_t* p1, uint8_t* p2, uint8_t* p3);
+
+#endif // DRIVERS_GPU_C2P_H
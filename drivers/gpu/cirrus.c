@@ -1,6 +1,7 @@
 #include "cirrus.h"
 #include "../pci.h"
 #include "vga_hw.h"
+#include "../../config.h"
 #include "../../console.h"
 #include "../../interrupts.h"
 #include "../../paging.h"
@@ -89,6 +90,24 @@ static const uint16_t cirrus_seq_640x480x8[] = {
     0xFFFF
 };
 
+// Same timing; SR07 selects the pixel width (bits 1-3: 16bpp 0x06, 32bpp 0x08)
+// and the hidden DAC register the 16bpp layout (cirrus_hdr_for_bpp)
+static const uint16_t cirrus_seq_640x480x16[] = {
+    0x0300,0x2101,0x0F02,0x0003,0x0E04,0x1707,
+    0x580B,0x580C,0x580D,0x580E,
+    0x0412,0x0013,0x2017,
+    0x331B,0x331C,0x331D,0x331E,
+    0xFFFF
+};
+
+static const uint16_t cirrus_seq_640x480x32[] = {
+    0x0300,0x2101,0x0F02,0x0003,0x0E04,0x1907,
+    0x580B,0x580C,0x580D,0x580E,
+    0x0412,0x0013,0x2017,
+    0x331B,0x331C,0x331D,0x331E,
+    0xFFFF
+};
+
 static const uint16_t cirrus_graph_svgacolor[] = {
     0x0000,0x0001,0x0002,0x0003,0x0004,0x4005,0x0506,0x0F07,0xFF08,
     0x0009,0x000A,0x000B,
@@ -107,6 +126,9 @@ static const uint16_t cirrus_crtc_640x480x8[] = {
 const cirrus_mode_desc_t* cirrus_get_modes(size_t* count) {
     static const cirrus_mode_desc_t g_cirrus_modes[] = {
         {640, 480, 8,  cirrus_seq_640x480x8,  cirrus_graph_svgacolor, cirrus_crtc_640x480x8},
+        {640, 480, 15, cirrus_seq_640x480x16, cirrus_graph_svgacolor, cirrus_crtc_640x480x8},
+        {640, 480, 16, cirrus_seq_640x480x16, cirrus_graph_svgacolor, cirrus_crtc_640x480x8},
+        {640, 480, 32, cirrus_seq_640x480x32, cirrus_graph_svgacolor, cirrus_crtc_640x480x8},
     };
     if (count) {
         *count = sizeof(g_cirrus_modes) / sizeof(g_cirrus_modes[0]);
@@ -114,9 +136,13 @@ const cirrus_mode_desc_t* cirrus_get_modes(size_t* count) {
     return g_cirrus_modes;
 }
 
+static uint32_t cirrus_bytes_per_pixel(uint8_t bpp) {
+    return ((uint32_t)bpp + 7u) / 8u;
+}
+
 uint32_t cirrus_mode_vram_required(const cirrus_mode_desc_t* mode) {
     if (!mode) return 0;
-    return (uint32_t)mode->width * (uint32_t)mode->height * (uint32_t)mode->bpp / 8;
+    return (uint32_t)mode->width * (uint32_t)mode->height * cirrus_bytes_per_pixel(mode->bpp);
 }
 
 const cirrus_mode_desc_t* cirrus_find_mode(uint16_t width, uint16_t height, uint8_t bpp, uint32_t vram_bytes) {
@@ -133,7 +159,18 @@ const cirrus_mode_desc_t* cirrus_find_mode(uint16_t width, uint16_t height, uint
 }
 
 const cirrus_mode_desc_t* cirrus_default_mode(uint32_t vram_bytes) {
-    return cirrus_find_mode(640, 480, 8, vram_bytes);
+    const cirrus_mode_desc_t* mode = cirrus_find_mode(640, 480, CONFIG_VIDEO_FB_DEPTH, vram_bytes);
+    return mode ? mode : cirrus_find_mode(640, 480, 8, vram_bytes);
+}
+
+// Hidden DAC register: 0xC0/0xC1 = 16bpp as 5:5:5/5:6:5, 0xC5 = 32bpp
+static uint8_t cirrus_hdr_for_bpp(uint8_t bpp) {
+    switch (bpp) {
+        case 15: return 0xC0;
+        case 16: return 0xC1;
+        case 32: return 0xC5;
+        default: return 0x00;
+    }
 }
 
 static void vga_program_standard_mode(uint8_t misc, const uint8_t* seq, const uint8_t* crtc, const uint8_t* graph, const uint8_t* attr) {
@@ -164,6 +201,13 @@ int cirrus_gpu_detect(const pci_device_t* dev, gpu_info_t* out) {
     copy_name(out->name, sizeof(out->name), "Cirrus Logic GD5446 (PCI)");
     out->pci = *dev;
     out->capabilities = GPU_CAP_LINEAR_FB | GPU_CAP_HW_CURSOR;
+    // GD543x/GD5446: BitBLT engine (cirrus_accel.c)
+    if (dev->device_id == CIRRUS_DEVICE_ID_GD5430_GD5440 ||
+        dev->device_id == CIRRUS_DEVICE_ID_GD5434 ||
+        dev->device_id == CIRRUS_DEVICE_ID_GD5434_8 ||
+        dev->device_id == CIRRUS_DEVICE_ID_GD5446) {
+        out->capabilities |= GPU_CAP_ACCEL_2D;
+    }
     out->framebuffer_base = (uint32_t)dev->bars[0].base;
     out->framebuffer_size = cirrus_detect_vram_bytes();
     out->framebuffer_bar = 0;
@@ -184,11 +228,20 @@ int cirrus_set_mode_desc(const pci_device_t* dev, const cirrus_mode_desc_t* mode
     crt1D |= 0x08; // LFB
     vga_crtc_write(0x1D, crt1D);
 
+    // Line offset in 8-byte units: CR13, bit 8 in CR1B bit 4
+    uint32_t pitch = (uint32_t)mode->width * cirrus_bytes_per_pixel(mode->bpp);
+    vga_crtc_write(0x13, (uint8_t)((pitch >> 3) & 0xFFu));
+    uint8_t cr1b = (uint8_t)(vga_crtc_read(0x1B) & ~0x10u);
+    cr1b |= (uint8_t)(((pitch >> 11) & 0x01u) << 4);
+    vga_crtc_write(0x1B, cr1b);
+    vga_dac_write_hidden(cirrus_hdr_for_bpp(mode->bpp));
+
     out_mode->kind = DISPLAY_MODE_KIND_FRAMEBUFFER;
+    out_mode->pixel_format = display_pixel_format_for_bpp(mode->bpp);
     out_mode->width = mode->width;
     out_mode->height = mode->height;
     out_mode->bpp = mode->bpp;
-    out_mode->pitch = mode->width;
+    out_mode->pitch = pitch;
     out_mode->phys_base = gpu->framebuffer_base;
     out_mode->framebuffer = (volatile uint8_t*)(uintptr_t)gpu->framebuffer_base;
     out_mode->set_bank = NULL;
@@ -197,8 +250,25 @@ int cirrus_set_mode_desc(const pci_device_t* dev, const cirrus_mode_desc_t* mode
     return 1;
 }
 
+void cirrus_set_start_address(uint32_t byte_offset) {
+    uint32_t address = byte_offset >> 2;
+    vga_crtc_write(0x0C, (uint8_t)((address >> 8) & 0xFFu));
+    vga_crtc_write(0x0D, (uint8_t)(address & 0xFFu));
+    // CR1B bit 0 = bit 16, bits 2-3 = bits 17-18; CR1D bit 7 = bit 19
+    uint8_t cr1b = (uint8_t)(vga_crtc_read(0x1B) & ~0x0Du);
+    cr1b |= (uint8_t)((address >> 16) & 0x01u);
+    cr1b |= (uint8_t)(((address >> 17) & 0x03u) << 2);
+    vga_crtc_write(0x1B, cr1b);
+    uint8_t cr1d = (uint8_t)(vga_crtc_read(0x1D) & ~0x80u);
+    cr1d |= (uint8_t)(((address >> 19) & 0x01u) << 7);
+    vga_crtc_write(0x1D, cr1d);
+}
+
 int cirrus_restore_text_mode(const pci_device_t* dev) {
     (void)dev;
+    cirrus_set_start_address(0);    // clears the extended bits of a flipped page
+    vga_dac_write_hidden(0x00);     // back to 8-bit palette pixels
+    vga_crtc_write(0x1B, (uint8_t)(vga_crtc_read(0x1B) & ~0x10u));  // line offset bit 8
     vga_program_standard_mode(0x67, std_seq_text, std_crtc_text, std_graph_text, std_attr_text);
     vga_load_font_8x16();
     return 1;
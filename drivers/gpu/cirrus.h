@@ -32,5 +32,7 @@ int cirrus_set_mode_desc(const pci_device_t* dev,
                          display_mode_info_t* out_mode,
                          gpu_info_t* gpu);
 void cirrus_set_bank(uint8_t bank);
+// CRTC start address in the extended modes: dword units, 20 bits
+void cirrus_set_start_address(uint32_t byte_offset);
 
 #endif // DRIVERS_GPU_CIRRUS_H
@@ -1,4 +1,5 @@
 #include "cirrus_accel.h"
+#include "cirrus.h"
 #include "fb_accel.h"
 #include "vga_hw.h"
 #include "../../config.h"
@@ -29,6 +30,9 @@
 #define CIRRUS_GR_BLT_ROP            0x32
 
 #define CIRRUS_BLT_STATUS_BUSY       0x08
+#define CIRRUS_BLT_STATUS_START      0x02
+#define CIRRUS_BLT_MODE_BACKWARDS    0x01
+#define CIRRUS_BLT_MODE_MEMSYSSRC    0x04
 #define CIRRUS_BLT_MODE_PATTERNCOPY  0x40
 #define CIRRUS_BLT_MODE_COLOREXPAND  0x80
 #define CIRRUS_BLT_ROP_SRCCOPY       0x0D
@@ -42,9 +46,13 @@ typedef struct {
     uint32_t pitch;
     uint8_t  bpp;
     int      enabled;
+    volatile uint8_t* fb;   // LFB; host data for MEMSYSSRC blits goes here
+    uint32_t page_bytes;    // frame size rounded to the start address unit
+    uint8_t  pages;         // frames that fit into VRAM (at most 2)
+    uint32_t origin;        // VRAM offset of the page the ops draw into
 } cirrus_accel_ctx_t;
 
-static cirrus_accel_ctx_t g_ctx = {0, 0, 0, 0, 0};
+static cirrus_accel_ctx_t g_ctx = {0, 0, 0, 0, 0, NULL, 0, 1, 0};
 
 static void cirrus_wait_idle(void) {
 #if CONFIG_ARCH_X86
@@ -54,31 +62,24 @@ static void cirrus_wait_idle(void) {
 #endif
 }
 
-static int cirrus_fill_rect(void* ctx_ptr, uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint8_t color) {
-    (void)ctx_ptr;
-#if !CONFIG_ARCH_X86
-    (void)x; (void)y; (void)width; (void)height; (void)color;
-    return 0;
-#else
-    if (!g_ctx.enabled) return 0;
-    if (g_ctx.bpp != 8) return 0;
-    if (!width || !height) return 1;
+#if CONFIG_ARCH_X86
+static int cirrus_rect_ok(uint16_t x, uint16_t y, uint16_t width, uint16_t height) {
+    if (!g_ctx.enabled || g_ctx.bpp != 8) return 0;
+    if (g_ctx.pitch == 0 || g_ctx.pitch > 0xFFFFu) return 0;
     if (x >= g_ctx.width || y >= g_ctx.height) return 0;
     if ((uint32_t)x + (uint32_t)width > g_ctx.width) return 0;
     if ((uint32_t)y + (uint32_t)height > g_ctx.height) return 0;
+    return 1;
+}
 
+// Program size, pitches and addresses, then start the engine. Colour expand
+// takes the background from GR0 and the foreground from GR1.
+static void cirrus_blt_start(uint16_t width, uint16_t height, uint32_t dest, uint32_t src,
+                             uint8_t mode) {
     uint32_t pitch = g_ctx.pitch;
-    if (pitch == 0 || pitch > 0xFFFFu) return 0;
-
-    uint32_t dest = (uint32_t)y * pitch + (uint32_t)x;
     uint16_t w_minus = (uint16_t)(width - 1u);
     uint16_t h_minus = (uint16_t)(height - 1u);
 
-    cirrus_wait_idle();
-
-    vga_gc_write(VGA_GFX_SR_VALUE, color);
-    vga_gc_write(VGA_GFX_SR_ENABLE, color);
-
     vga_gc_write(CIRRUS_GR_BLT_DST_PITCH_LOW, (uint8_t)(pitch & 0xFFu));
     vga_gc_write(CIRRUS_GR_BLT_DST_PITCH_HIGH, (uint8_t)((pitch >> 8) & 0xFFu));
     vga_gc_write(CIRRUS_GR_BLT_SRC_PITCH_LOW, (uint8_t)(pitch & 0xFFu));
@@ -93,16 +94,134 @@ static int cirrus_fill_rect(void* ctx_ptr, uint16_t x, uint16_t y, uint16_t widt
     vga_gc_write(CIRRUS_GR_BLT_DST_START_MID, (uint8_t)((dest >> 8) & 0xFFu));
     vga_gc_write(CIRRUS_GR_BLT_DST_START_HIGH, (uint8_t)((dest >> 16) & 0xFFu));
 
-    vga_gc_write(CIRRUS_GR_BLT_SRC_START_LOW, 0);
-    vga_gc_write(CIRRUS_GR_BLT_SRC_START_MID, 0);
-    vga_gc_write(CIRRUS_GR_BLT_SRC_START_HIGH, 0);
+    vga_gc_write(CIRRUS_GR_BLT_SRC_START_LOW, (uint8_t)(src & 0xFFu));
+    vga_gc_write(CIRRUS_GR_BLT_SRC_START_MID, (uint8_t)((src >> 8) & 0xFFu));
+    vga_gc_write(CIRRUS_GR_BLT_SRC_START_HIGH, (uint8_t)((src >> 16) & 0xFFu));
 
-    vga_gc_write(CIRRUS_GR_BLT_MODE, (uint8_t)(CIRRUS_BLT_MODE_COLOREXPAND | CIRRUS_BLT_MODE_PATTERNCOPY));
+    vga_gc_write(CIRRUS_GR_BLT_MODE, mode);
     vga_gc_write(CIRRUS_GR_BLT_ROP, CIRRUS_BLT_ROP_SRCCOPY);
 
-    vga_gc_write(CIRRUS_GR_BLT_STATUS, 0x02u);
+    vga_gc_write(CIRRUS_GR_BLT_STATUS, CIRRUS_BLT_STATUS_START);
+}
+
+// GR0/GR1 double as set/reset for CPU writes: clear them once the engine is idle
+static void cirrus_blt_finish(void) {
+    cirrus_wait_idle();
+    vga_gc_write(VGA_GFX_SR_VALUE, 0);
+    vga_gc_write(VGA_GFX_SR_ENABLE, 0);
+}
+
+// Host data for a MEMSYSSRC blit: bytes in order, written as dwords to the
+// LFB (the engine ignores the address); the last dword is zero padded
+static void cirrus_blt_host_data(const uint8_t* bits, uint16_t stride, uint16_t row_bytes,
+                                 uint16_t height) {
+    volatile uint32_t* port = (volatile uint32_t*)g_ctx.fb;
+    uint32_t word = 0;
+    uint32_t shift = 0;
+    for (uint16_t row = 0; row < height; ++row, bits += stride) {
+        for (uint16_t i = 0; i < row_bytes; ++i) {
+            word |= (uint32_t)bits[i] << shift;
+            shift += 8u;
+            if (shift == 32u) {
+                *port = word;
+                word = 0;
+                shift = 0;
+            }
+        }
+    }
+    if (shift) *port = word;
+}
+#endif
+
+static int cirrus_fill_rect(void* ctx_ptr, uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint8_t color) {
+    (void)ctx_ptr;
+#if !CONFIG_ARCH_X86
+    (void)x; (void)y; (void)width; (void)height; (void)color;
+    return 0;
+#else
+    if (!width || !height) return g_ctx.enabled;
+    if (!cirrus_rect_ok(x, y, width, height)) return 0;
+
+    cirrus_wait_idle();
+    // Pattern colour expand with fg == bg: the pattern bits do not matter
+    vga_gc_write(VGA_GFX_SR_VALUE, color);
+    vga_gc_write(VGA_GFX_SR_ENABLE, color);
+    cirrus_blt_start(width, height, g_ctx.origin + (uint32_t)y * g_ctx.pitch + x, 0,
+                     (uint8_t)(CIRRUS_BLT_MODE_COLOREXPAND | CIRRUS_BLT_MODE_PATTERNCOPY));
+    cirrus_blt_finish();
+    return 1;
+#endif
+}
+
+static int cirrus_copy_rect(void* ctx_ptr, uint16_t sx, uint16_t sy, uint16_t dx, uint16_t dy,
+                            uint16_t width, uint16_t height) {
+    (void)ctx_ptr;
+#if !CONFIG_ARCH_X86
+    (void)sx; (void)sy; (void)dx; (void)dy; (void)width; (void)height;
+    return 0;
+#else
+    if (!width || !height) return g_ctx.enabled;
+    if (!cirrus_rect_ok(sx, sy, width, height) || !cirrus_rect_ok(dx, dy, width, height)) return 0;
+
+    uint32_t pitch = g_ctx.pitch;
+    uint32_t src = g_ctx.origin + (uint32_t)sy * pitch + sx;
+    uint32_t dest = g_ctx.origin + (uint32_t)dy * pitch + dx;
+    uint8_t mode = 0;
+    if (dest > src) {
+        // Overlap with the destination further on: run from the last pixel
+        uint32_t last = (uint32_t)(height - 1u) * pitch + (uint32_t)(width - 1u);
+        src += last;
+        dest += last;
+        mode = CIRRUS_BLT_MODE_BACKWARDS;
+    }
+    cirrus_wait_idle();
+    cirrus_blt_start(width, height, dest, src, mode);
+    cirrus_wait_idle();
+    return 1;
+#endif
+}
+
+static int cirrus_color_expand(void* ctx_ptr, uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                               const uint8_t* bits, uint16_t stride, uint8_t fg, uint8_t bg) {
+    (void)ctx_ptr;
+#if !CONFIG_ARCH_X86
+    (void)x; (void)y; (void)width; (void)height; (void)bits; (void)stride; (void)fg; (void)bg;
+    return 0;
+#else
+    if (!width || !height) return g_ctx.enabled;
+    if (!g_ctx.fb || !cirrus_rect_ok(x, y, width, height)) return 0;
+
+    cirrus_wait_idle();
+    vga_gc_write(VGA_GFX_SR_VALUE, bg);
+    vga_gc_write(VGA_GFX_SR_ENABLE, fg);
+    // Source rows start on byte boundaries
+    cirrus_blt_start(width, height, g_ctx.origin + (uint32_t)y * g_ctx.pitch + x, 0,
+                     (uint8_t)(CIRRUS_BLT_MODE_COLOREXPAND | CIRRUS_BLT_MODE_MEMSYSSRC));
+    cirrus_blt_host_data(bits, stride, (uint16_t)((width + 7u) >> 3), height);
+    cirrus_blt_finish();
+    return 1;
+#endif
+}
+
+static int cirrus_pattern_fill(void* ctx_ptr, uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                               const uint8_t pattern[8], uint8_t fg, uint8_t bg) {
+    (void)ctx_ptr;
+#if !CONFIG_ARCH_X86
+    (void)x; (void)y; (void)width; (void)height; (void)pattern; (void)fg; (void)bg;
+    return 0;
+#else
+    if (!width || !height) return g_ctx.enabled;
+    if (!g_ctx.fb || !cirrus_rect_ok(x, y, width, height)) return 0;
 
     cirrus_wait_idle();
+    vga_gc_write(VGA_GFX_SR_VALUE, bg);
+    vga_gc_write(VGA_GFX_SR_ENABLE, fg);
+    // The 8 pattern bytes come from the host, aligned to the rectangle
+    cirrus_blt_start(width, height, g_ctx.origin + (uint32_t)y * g_ctx.pitch + x, 0,
+                     (uint8_t)(CIRRUS_BLT_MODE_COLOREXPAND | CIRRUS_BLT_MODE_PATTERNCOPY |
+                               CIRRUS_BLT_MODE_MEMSYSSRC));
+    cirrus_blt_host_data(pattern, 8, 8, 1);
+    cirrus_blt_finish();
     return 1;
 #endif
 }
@@ -112,12 +231,33 @@ static void cirrus_sync(void* ctx_ptr) {
     cirrus_wait_idle();
 }
 
+// Page n starts at n * page_bytes in VRAM; the LFB maps all of it
+static volatile uint8_t* cirrus_set_page(void* ctx_ptr, uint8_t page) {
+    (void)ctx_ptr;
+    if (!g_ctx.enabled || !g_ctx.fb || page >= g_ctx.pages) return NULL;
+    cirrus_wait_idle();
+    g_ctx.origin = (uint32_t)page * g_ctx.page_bytes;
+    return g_ctx.fb + g_ctx.origin;
+}
+
+static void cirrus_show_page(void* ctx_ptr, uint8_t page) {
+    (void)ctx_ptr;
+    if (!g_ctx.enabled || page >= g_ctx.pages) return;
+    cirrus_set_start_address((uint32_t)page * g_ctx.page_bytes);
+}
+
+// No line engine on the GD54xx: fb_accel_draw_line() draws in software
 static const fb_accel_ops_t g_ops = {
     .fill_rect = cirrus_fill_rect,
     .sync = cirrus_sync,
+    .copy_rect = cirrus_copy_rect,
+    .color_expand = cirrus_color_expand,
+    .pattern_fill = cirrus_pattern_fill,
+    .set_page = cirrus_set_page,
+    .show_page = cirrus_show_page,
 };
 
-void cirrus_accel_enable(const display_mode_info_t* mode) {
+void cirrus_accel_enable(const display_mode_info_t* mode, uint32_t vram_bytes) {
     if (!mode) {
         g_ctx.enabled = 0;
         fb_accel_reset();
@@ -127,6 +267,10 @@ void cirrus_accel_enable(const display_mode_info_t* mode) {
     g_ctx.height = mode->height;
     g_ctx.pitch = mode->pitch;
     g_ctx.bpp = mode->bpp;
+    g_ctx.fb = mode->framebuffer;
+    g_ctx.origin = 0;
+    g_ctx.page_bytes = ((uint32_t)mode->pitch * mode->height + 3u) & ~3u;
+    g_ctx.pages = (g_ctx.page_bytes && vram_bytes >= 2u * g_ctx.page_bytes) ? 2 : 1;
     g_ctx.enabled = (mode->bpp == 8);
     if (g_ctx.enabled) {
         fb_accel_register(&g_ops, &g_ctx);
@@ -3,7 +3,8 @@
 
 #include "../../display.h"
 
-void cirrus_accel_enable(const display_mode_info_t* mode);
+// vram_bytes decides whether a second page for flipping fits
+void cirrus_accel_enable(const display_mode_info_t* mode, uint32_t vram_bytes);
 void cirrus_accel_disable(void);
 
 #endif // DRIVERS_GPU_CIRRUS_ACCEL_H
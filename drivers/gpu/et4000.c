@@ -1,9 +1,14 @@
 #include "et4000.h"
+#include "et4000ax.h"
 #include "vga_hw.h"
 #include "fb_accel.h"
+#include "fb_dirty.h"
+#include "blit.h"
+#include "gpu_stats.h"
 #include "et4000_common.h"
 #include "../../config.h"
 #include "../../console.h"
+#include "../../memory.h"
 #if CONFIG_ARCH_X86
 #include "../../arch/x86/io.h"
 #include "../../interrupts.h"
@@ -90,12 +95,21 @@ typedef struct {
     uint16_t height;
     uint32_t pitch;
     uint8_t  bpp;
-    int      dirty;
+    fb_dirty_t dirty;
+    gpu_blit_scroll_t scroll;
+    int      ax_engine;     // AX engine mirrors shadow drawing into VRAM
+    uint8_t  pages;         // 2: page flipping (8bpp with 1 MiB)
+    uint8_t  page;          // page the shadow is uploaded to
+    uint8_t  shown;         // page in the CRTC start address
+    uint8_t  flip_full;     // page 1 not uploaded yet in this session
+    fb_dirty_t flip_frame;  // spans of the frame being drawn while flipping
+    fb_dirty_t flip_prev;   // spans of the last shown frame, still due on the hidden page
 } et4k_fb_state_t;
 
-static uint8_t g_et4k_shadow[640u * 480u];
+// 300 KiB shadow comes from the heap so it stays out of the boot-loaded bss
+static uint8_t* g_et4k_shadow = NULL;
 static volatile uint8_t* g_et4k_vram_window = NULL;
-static et4k_fb_state_t g_et4k_fb = { NULL, 0, 0, 0, 0, 0 };
+static et4k_fb_state_t g_et4k_fb;
 
 static struct {
     int detected;
@@ -345,13 +359,18 @@ static int et4k_wait_status(uint8_t mask, uint8_t expected_bits) {
 }
 
 static void et4k_wait_vblank_window(void) {
+    uint32_t start = gpu_stats_now();
     if (!et4k_wait_status(ET4K_STATUS_VRETRACE, 0)) {
         et4k_log("wait_vblank: timeout waiting for display active (skipping sync)");
+        gpu_stats_vblank(start, 0);
         return;
     }
     if (!et4k_wait_status(ET4K_STATUS_VRETRACE, ET4K_STATUS_VRETRACE)) {
         et4k_log("wait_vblank: timeout waiting for retrace (skipping sync)");
+        gpu_stats_vblank(start, 0);
+        return;
     }
+    gpu_stats_vblank(start, 1);
 }
 
 static inline void et4k_misc_write(uint8_t value) {
@@ -527,12 +546,45 @@ static int et4k_fb_fill_rect(void* ctx, uint16_t x, uint16_t y,
 static void et4k_fb_sync(void* ctx);
 static void et4k_fb_mark_dirty(void* ctx, uint16_t x, uint16_t y,
                                uint16_t width, uint16_t height);
+static int et4k_fb_scroll(void* ctx, uint16_t lines);
+static volatile uint8_t* et4k_fb_set_page(void* ctx, uint8_t page);
+static void et4k_fb_show_page(void* ctx, uint8_t page);
 
 static const fb_accel_ops_t g_et4k_fb_ops = {
     et4k_fb_fill_rect,
     et4k_fb_sync,
-    et4k_fb_mark_dirty
+    et4k_fb_mark_dirty,
+    et4k_fb_scroll,
+    NULL,   // copy, expand, pattern, line: fb_accel draws into the shadow
+    NULL,
+    NULL,
+    NULL,
+    et4k_fb_set_page,
+    et4k_fb_show_page
+};
+
+#if CONFIG_VIDEO_ET4000AX_ACCEL
+static int et4k_ax_copy_rect(void* ctx, uint16_t sx, uint16_t sy, uint16_t dx, uint16_t dy,
+                             uint16_t width, uint16_t height);
+static int et4k_ax_pattern_fill(void* ctx, uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                                const uint8_t pattern[8], uint8_t fg, uint8_t bg);
+static int et4k_ax_draw_line(void* ctx, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1,
+                             uint8_t color);
+
+// No colour expand on the AX: glyphs keep going through the shadow
+static const fb_accel_ops_t g_et4k_ax_ops = {
+    et4k_fb_fill_rect,
+    et4k_fb_sync,
+    et4k_fb_mark_dirty,
+    et4k_fb_scroll,
+    et4k_ax_copy_rect,
+    NULL,
+    et4k_ax_pattern_fill,
+    et4k_ax_draw_line,
+    et4k_fb_set_page,
+    et4k_fb_show_page
 };
+#endif
 
 static int et4k_map_vram_window(uint32_t phys_base) {
     if (g_et4k_vram_window) {
@@ -553,7 +605,41 @@ static int et4k_map_vram_window(uint32_t phys_base) {
     return 1;
 }
 
-static void et4k_shadow_upload(const et4k_fb_state_t* state) {
+static void et4k_blit_set_bank(uint8_t bank) {
+    outb(ET4K_PORT_BANK, bank);
+}
+
+// Page flipping (8bpp, 1 MiB): page 1 lives above the 512 KiB that page 0
+// and its hardware-scrolling buffer use
+#define ET4K_PAGE1_OFFSET (512u * 1024u)
+
+static uint32_t et4k_page_origin(const et4k_fb_state_t* state, uint8_t page) {
+    return page ? ET4K_PAGE1_OFFSET : (uint32_t)state->scroll.top * state->pitch;
+}
+
+// CR33 bits 0-1 extend the start address to 18 bits (1 MiB in dword units)
+static void et4k_set_start_address(uint32_t byte_offset) {
+    uint32_t address = byte_offset / vga_start_address_unit();
+    uint8_t ext_before = inb(ET4K_EXT_PORT);
+    outb(ET4K_EXT_PORT, (uint8_t)(ext_before | 0x03u));
+    et4k_crtc_write(0x0C, (uint8_t)((address >> 8) & 0xFFu));
+    et4k_crtc_write(0x0D, (uint8_t)(address & 0xFFu));
+    uint8_t cr33 = (uint8_t)(et4k_crtc_read(0x33) & ~0x03u);
+    et4k_crtc_write(0x33, (uint8_t)(cr33 | ((address >> 16) & 0x03u)));
+    outb(ET4K_EXT_PORT, ext_before);
+}
+
+// CR37 bits 0-1: 128 KiB << n (the ET4000 addresses at most 1 MiB)
+static uint32_t et4k_detect_vram_bytes(void) {
+    uint8_t ext_before = inb(ET4K_EXT_PORT);
+    outb(ET4K_EXT_PORT, (uint8_t)(ext_before | 0x03u));
+    uint8_t cr37 = et4k_crtc_read(0x37);
+    outb(ET4K_EXT_PORT, ext_before);
+    return (128u * 1024u) << (cr37 & 0x03u);
+}
+
+// Upload the dirty spans of the shadow buffer and clear them
+static void et4k_shadow_upload(et4k_fb_state_t* state) {
     if (!state || !state->buffer || state->width == 0 || state->height == 0) {
         et4k_log("shadow_upload: skipped (invalid state)");
         return;
@@ -564,73 +650,39 @@ static void et4k_shadow_upload(const et4k_fb_state_t* state) {
         return;
     }
 
-    et4k_wait_vblank_window();
+    // A hidden page can be written at any time
+    if (state->page == state->shown) {
+        et4k_wait_vblank_window();
+    }
 
-    uint32_t irq_flags = et4k_irq_guard_acquire();
+    uint32_t irq_flags = gpu_stats_irq_save();
 
-    const uint16_t width = state->width;
-    const uint16_t height = state->height;
-    const uint32_t pitch = state->pitch;
-    volatile uint8_t* vram = g_et4k_vram_window;
+    gpu_blit_target_t target = { state->buffer, state->pitch, g_et4k_vram_window, NULL, 0xFF, 0 };
+    uint32_t lines = 0;
+    uint32_t bytes = 0;
+    uint32_t full_frame = 0;
 
     if (state->bpp == 4) {
-        const uint32_t bytes_per_line = width / 8u;
-        for (uint8_t plane = 0; plane < 4; ++plane) {
-            et4k_seq_write(0x02, (uint8_t)(1u << plane));
-            et4k_gc_write(0x04, plane);
-
-            for (uint16_t y = 0; y < height; ++y) {
-                const uint8_t* src_line = state->buffer + (uint32_t)y * pitch;
-                volatile uint8_t* dst_line = vram + (uint32_t)y * bytes_per_line;
-                for (uint32_t byte_index = 0; byte_index < bytes_per_line; ++byte_index) {
-                    uint8_t packed = 0;
-                    const uint32_t pixel_base = byte_index << 3;
-                    
-                    if (src_line[pixel_base + 0] & (1u << plane)) packed |= 0x80;
-                    if (src_line[pixel_base + 1] & (1u << plane)) packed |= 0x40;
-                    if (src_line[pixel_base + 2] & (1u << plane)) packed |= 0x20;
-                    if (src_line[pixel_base + 3] & (1u << plane)) packed |= 0x10;
-                    if (src_line[pixel_base + 4] & (1u << plane)) packed |= 0x08;
-                    if (src_line[pixel_base + 5] & (1u << plane)) packed |= 0x04;
-                    if (src_line[pixel_base + 6] & (1u << plane)) packed |= 0x02;
-                    if (src_line[pixel_base + 7] & (1u << plane)) packed |= 0x01;
-                    
-                    dst_line[byte_index] = packed;
-                }
-            }
-        }
-        et4k_seq_write(0x02, 0x0F);
-        et4k_gc_write(0x04, 0x00);
+        full_frame = (state->pitch / 8u) * state->height * 4u;
+        bytes = gpu_blit_planar4(&target, &state->dirty, &lines);
     } else if (state->bpp == 8) {
         // 8bpp mode (chained): 1 pixel per byte, uses banking
-        uint8_t current_bank = 0xFF;
         uint8_t ext_before = inb(ET4K_EXT_PORT);
         outb(ET4K_EXT_PORT, (uint8_t)(ext_before | 0x03u)); // Unlock Tseng extensions
-
-        for (uint16_t y = 0; y < height; ++y) {
-            const uint8_t* src_line = state->buffer + (uint32_t)y * pitch;
-            uint32_t vram_base_offset = (uint32_t)y * width;
-
-            for (uint16_t x = 0; x < width; ++x) {
-                uint32_t vram_offset = vram_base_offset + x;
-                uint8_t bank = (uint8_t)(vram_offset >> 16);
-                uint16_t window_offset = (uint16_t)(vram_offset & 0xFFFFu);
-
-                if (bank != current_bank) {
-                    outb(ET4K_PORT_BANK, bank);
-                    current_bank = bank;
-                }
-                vram[window_offset] = src_line[x];
-            }
-        }
+        full_frame = state->pitch * state->height;
+        target.set_bank = et4k_blit_set_bank;
+        target.origin = et4k_page_origin(state, state->page);
+        bytes = gpu_blit_chunky(&target, &state->dirty, &lines);
         outb(ET4K_PORT_BANK, 0);
         outb(ET4K_EXT_PORT, ext_before);
     }
 
     et4k_gc_write(0x08, 0xFF);
+    fb_dirty_clear(&state->dirty);
+    fb_dirty_account(lines, bytes, full_frame);
     et4k_log("shadow_upload: end");
 
-    et4k_irq_guard_release(irq_flags);
+    gpu_stats_irq_restore(irq_flags);
 }
 
 static int et4k_fb_fill_rect(void* ctx, uint16_t x, uint16_t y,
@@ -663,19 +715,103 @@ static int et4k_fb_fill_rect(void* ctx, uint16_t x, uint16_t y,
         console_write("\n");
     }
 
+    if (state->bpp != 8) color = (uint8_t)(color & 0x0F);
     for (uint16_t row = 0; row < height; ++row) {
         uint8_t* dst = state->buffer + (uint32_t)(y + row) * state->pitch + x;
         for (uint16_t col = 0; col < width; ++col) {
-            dst[col] = (uint8_t)(color & 0x0F);
+            dst[col] = color;
         }
     }
-    state->dirty = 1;
+#if CONFIG_VIDEO_ET4000AX_ACCEL
+    if (state->ax_engine && state->page == 0 && state->shown == 0) {
+        et4000ax_fill_rect(x, y + state->scroll.top, width, height, color);
+        if (state->ax_engine) return 1;
+    }
+#endif
+    fb_dirty_mark(&state->dirty, x, y, width, height);
+    return 1;
+}
+
+#if CONFIG_VIDEO_ET4000AX_ACCEL
+// AX ops: the shadow is updated in software and the engine draws the same
+// into VRAM (shifted by the scroll origin), so nothing is marked dirty. On a
+// timeout et4k_disable_ax_engine() drops the engine; the rectangle is then
+// marked dirty and later requests take the fb_accel software path.
+static int et4k_ax_rect_ok(const et4k_fb_state_t* state, uint16_t x, uint16_t y,
+                           uint16_t width, uint16_t height) {
+    if (!state || !state->buffer || !state->ax_engine || !width || !height) return 0;
+    // The engine draws page 0; while flipping, the shadow path takes over
+    if (state->page != 0 || state->shown != 0) return 0;
+    return ((uint32_t)x + width <= state->width && (uint32_t)y + height <= state->height);
+}
+
+static fb_accel_surface_t et4k_fb_surface(const et4k_fb_state_t* state) {
+    fb_accel_surface_t s;
+    s.base = state->buffer;
+    s.pitch = state->pitch;
+    s.width = state->width;
+    s.height = state->height;
+    s.bytes = 1;
+    s.pixels = NULL;
+    return s;
+}
+
+static int et4k_ax_copy_rect(void* ctx, uint16_t sx, uint16_t sy, uint16_t dx, uint16_t dy,
+                             uint16_t width, uint16_t height) {
+    et4k_fb_state_t* state = (et4k_fb_state_t*)ctx;
+    if (!et4k_ax_rect_ok(state, sx, sy, width, height) ||
+        !et4k_ax_rect_ok(state, dx, dy, width, height)) {
+        return 0;
+    }
+    // The engine copies VRAM: pending spans have to be there first
+    et4k_fb_sync(state);
+    fb_accel_surface_t s = et4k_fb_surface(state);
+    fb_accel_sw_copy_rect(&s, sx, sy, dx, dy, width, height);
+    et4000ax_bitblt(sx, sy + state->scroll.top, dx, dy + state->scroll.top,
+                    width, height, ET4K_AX_ROP_COPY);
+    if (!state->ax_engine) {
+        fb_dirty_mark(&state->dirty, dx, dy, width, height);
+    }
     return 1;
 }
 
+static int et4k_ax_pattern_fill(void* ctx, uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                                const uint8_t pattern[8], uint8_t fg, uint8_t bg) {
+    et4k_fb_state_t* state = (et4k_fb_state_t*)ctx;
+    if (!et4k_ax_rect_ok(state, x, y, width, height)) {
+        return 0;
+    }
+    fb_accel_surface_t s = et4k_fb_surface(state);
+    fb_accel_sw_pattern_fill(&s, x, y, width, height, pattern, fg, bg);
+    et4000ax_pattern_fill(x, y + state->scroll.top, width, height, pattern, fg, bg);
+    if (!state->ax_engine) {
+        fb_dirty_mark(&state->dirty, x, y, width, height);
+    }
+    return 1;
+}
+
+static int et4k_ax_draw_line(void* ctx, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1,
+                             uint8_t color) {
+    et4k_fb_state_t* state = (et4k_fb_state_t*)ctx;
+    if (!et4k_ax_rect_ok(state, x0, y0, 1, 1) || !et4k_ax_rect_ok(state, x1, y1, 1, 1)) {
+        return 0;
+    }
+    fb_accel_surface_t s = et4k_fb_surface(state);
+    fb_accel_sw_draw_line(&s, x0, y0, x1, y1, color);
+    et4000ax_draw_line(x0, y0 + state->scroll.top, x1, y1 + state->scroll.top, color);
+    if (!state->ax_engine) {
+        uint16_t left = (x0 < x1) ? x0 : x1;
+        uint16_t top = (y0 < y1) ? y0 : y1;
+        uint16_t w = (uint16_t)(((x0 < x1) ? x1 - x0 : x0 - x1) + 1);
+        uint16_t h = (uint16_t)(((y0 < y1) ? y1 - y0 : y0 - y1) + 1);
+        fb_dirty_mark(&state->dirty, left, top, w, h);
+    }
+    return 1;
+}
+#endif
+
 static void et4k_fb_mark_dirty(void* ctx, uint16_t x, uint16_t y,
                                uint16_t width, uint16_t height) {
-    (void)x; (void)y; (void)width; (void)height;
     et4k_fb_state_t* state = (et4k_fb_state_t*)ctx;
     if (!state) return;
     if (et4k_trace_enabled()) {
@@ -689,7 +825,7 @@ static void et4k_fb_mark_dirty(void* ctx, uint16_t x, uint16_t y,
         console_write_dec(height);
         console_write("\n");
     }
-    state->dirty = 1;
+    fb_dirty_mark(&state->dirty, x, y, width, height);
 }
 
 static void et4k_fb_sync(void* ctx) {
@@ -698,21 +834,90 @@ static void et4k_fb_sync(void* ctx) {
         et4k_log("fb_sync: skipped (null state)");
         return;
     }
-    if (!state->dirty) {
+    if (state->page != state->shown) {
+        // The hidden page still holds the frame before last: it also needs
+        // the spans of the last shown frame, or everything on a first visit
+        fb_dirty_merge(&state->flip_frame, &state->dirty);
+        fb_dirty_merge(&state->dirty, &state->flip_prev);
+        fb_dirty_clear(&state->flip_prev);
+        if (state->page == 1 && state->flip_full) {
+            fb_dirty_mark_all(&state->dirty);
+            state->flip_full = 0;
+        }
+    }
+    if (!fb_dirty_any(&state->dirty)) {
         et4k_log("fb_sync: skipped (clean)");
         return;
     }
     if (ET4K_NO_VRAM_TOUCH) {
         et4k_log("fb_sync: skipped (NO_VRAM_TOUCH)");
-        state->dirty = 0;
+        fb_dirty_clear(&state->dirty);
         return;
     }
-    et4k_log("fb_sync: uploading shadow buffer");
+    et4k_log("fb_sync: uploading dirty spans");
     et4k_shadow_upload(state);
-    state->dirty = 0;
     et4k_log("fb_sync: complete");
 }
 
+// Hardware scrolling (8bpp): the CRTC start address moves through a virtual
+// buffer of scroll.lines scanlines; only the uncovered lines are uploaded.
+static int et4k_fb_scroll(void* ctx, uint16_t lines) {
+    et4k_fb_state_t* state = (et4k_fb_state_t*)ctx;
+    if (!state || !state->buffer || !state->scroll.lines || ET4K_NO_VRAM_TOUCH ||
+        state->page != 0 || state->shown != 0) {
+        return 0;
+    }
+    // VRAM has to match the shadow before the picture moves
+    et4k_fb_sync(state);
+    int moved = gpu_blit_scroll(&state->scroll, state->buffer, state->pitch, &state->dirty, lines);
+    if (!moved) {
+        return 0;
+    }
+    if (moved == 2) {
+        et4k_shadow_upload(state);
+    }
+    uint32_t irq_flags = et4k_irq_guard_acquire();
+    et4k_set_start_address(et4k_page_origin(state, 0));
+    et4k_irq_guard_release(irq_flags);
+    if (et4k_trace_enabled()) {
+        et4k_log_dec("fb_scroll.top", state->scroll.top);
+    }
+    return 1;
+}
+
+// Flipping keeps drawing in the shadow; only the upload target changes
+static volatile uint8_t* et4k_fb_set_page(void* ctx, uint8_t page) {
+    et4k_fb_state_t* state = (et4k_fb_state_t*)ctx;
+    if (!state || !state->buffer || page >= state->pages || ET4K_NO_VRAM_TOUCH) {
+        return NULL;
+    }
+    if (page == 1 && state->page == 0 && state->shown == 0) {
+        // New session: page 1 holds nothing useful yet
+        fb_dirty_clear(&state->flip_frame);
+        fb_dirty_clear(&state->flip_prev);
+        state->flip_full = 1;
+    }
+    state->page = page;
+    return state->buffer;
+}
+
+static void et4k_fb_show_page(void* ctx, uint8_t page) {
+    et4k_fb_state_t* state = (et4k_fb_state_t*)ctx;
+    if (!state || !state->buffer || page >= state->pages || ET4K_NO_VRAM_TOUCH) {
+        return;
+    }
+    if (page == state->page && page != state->shown) {
+        // That frame is complete: its spans are now due on the other page
+        fb_dirty_clear(&state->flip_prev);
+        fb_dirty_merge(&state->flip_prev, &state->flip_frame);
+        fb_dirty_clear(&state->flip_frame);
+    }
+    state->shown = page;
+    uint32_t irq_flags = et4k_irq_guard_acquire();
+    et4k_set_start_address(et4k_page_origin(state, page));
+    et4k_irq_guard_release(irq_flags);
+}
+
 static void et4k_load_palette16(void) {
     et4k_log("load_palette16: begin");
     outb(0x3C8, 0x00);
@@ -1011,6 +1216,14 @@ int et4k_set_mode(gpu_info_t* gpu, display_mode_info_t* out_mode,
         return 0;
     }
 
+    if (!g_et4k_shadow) {
+        g_et4k_shadow = (uint8_t*)memory_alloc(640u * 480u);
+        if (!g_et4k_shadow) {
+            gpu_set_last_error("ERROR: no memory for Tseng shadow buffer");
+            return 0;
+        }
+    }
+
     if (width == 640 && height == 480 && bpp == 4) {
         et4k_log("set_mode: programming VGA mode 12h");
         et4k_program_mode12();
@@ -1025,6 +1238,9 @@ int et4k_set_mode(gpu_info_t* gpu, display_mode_info_t* out_mode,
         return 0;
     }
 
+    if (g_et4k_fb.shown != 0) {
+        et4k_set_start_address(0);
+    }
     et4k_log("set_mode: resetting Tseng window registers to bank 0");
     et4k_reset_window_registers();
 
@@ -1034,22 +1250,46 @@ int et4k_set_mode(gpu_info_t* gpu, display_mode_info_t* out_mode,
     }
 
     et4k_log("set_mode: initializing shadow framebuffer");
-    et4k_bzero(g_et4k_shadow, (uint32_t)sizeof(g_et4k_shadow));
+    g_et4k_fb.ax_engine = 0;
+    et4k_bzero(g_et4k_shadow, 640u * 480u);
     g_et4k_fb.buffer = g_et4k_shadow;
     g_et4k_fb.width = 640;
     g_et4k_fb.height = 480;
     g_et4k_fb.pitch = 640;
     g_et4k_fb.bpp = bpp; 
-    g_et4k_fb.dirty = 1;
+    fb_dirty_init(&g_et4k_fb.dirty, g_et4k_fb.width, g_et4k_fb.height);
+    fb_dirty_init(&g_et4k_fb.flip_frame, g_et4k_fb.width, g_et4k_fb.height);
+    fb_dirty_init(&g_et4k_fb.flip_prev, g_et4k_fb.width, g_et4k_fb.height);
+    // Mode 2Eh implies at least 512 KiB; the mode tables start the display at 0
+    g_et4k_fb.scroll.top = 0;
+    g_et4k_fb.scroll.lines = (bpp == 8)
+        ? gpu_blit_scroll_lines(512u * 1024u, g_et4k_fb.pitch, g_et4k_fb.height, vga_start_address_unit())
+        : 0;
+    // A second page above those 512 KiB needs the full 1 MiB
+    g_et4k_fb.page = 0;
+    g_et4k_fb.shown = 0;
+    g_et4k_fb.flip_full = 0;
+    g_et4k_fb.pages = (bpp == 8 && et4k_detect_vram_bytes() >= 1024u * 1024u) ? 2 : 1;
+    if (et4k_trace_enabled()) {
+        et4k_log_dec("set_mode.pages", g_et4k_fb.pages);
+    }
 
     et4k_fb_mark_dirty(&g_et4k_fb, 0, 0, g_et4k_fb.width, g_et4k_fb.height);
     if (ET4K_NO_VRAM_TOUCH) {
-        g_et4k_fb.dirty = 0;
+        fb_dirty_clear(&g_et4k_fb.dirty);
     } else {
         et4k_fb_sync(&g_et4k_fb);
     }
 
+#if CONFIG_VIDEO_ET4000AX_ACCEL
+    if (bpp == 8 && g_is_ax_variant && !ET4K_NO_VRAM_TOUCH) {
+        g_et4k_fb.ax_engine = et4kax_after_modeset_init();
+        et4k_log(g_et4k_fb.ax_engine ? "set_mode: AX engine active" : "set_mode: AX engine unavailable");
+    }
+    fb_accel_register(g_et4k_fb.ax_engine ? &g_et4k_ax_ops : &g_et4k_fb_ops, &g_et4k_fb);
+#else
     fb_accel_register(&g_et4k_fb_ops, &g_et4k_fb);
+#endif
 
     gpu->framebuffer_width = 640;
     gpu->framebuffer_height = 480;
@@ -1066,6 +1306,7 @@ int et4k_set_mode(gpu_info_t* gpu, display_mode_info_t* out_mode,
     out_mode->pitch = 640;
     out_mode->phys_base = VGA_WINDOW_PHYS;
     out_mode->framebuffer = g_et4k_shadow;
+    out_mode->set_bank = NULL;
 
     gpu_set_last_error("OK: Tseng mode active");
     return 1;
@@ -1099,6 +1340,9 @@ et4000_mode_t et4k_choose_default_mode(int is_ax_variant, uint32_t vram_bytes) {
 
 void et4000_restore_text_mode(void) {
     et4k_log("restore_text_mode: enter");
+    if (g_et4k_fb.shown != 0) {
+        et4k_set_start_address(0);  // CR33 is not part of the text mode tables
+    }
     et4k_program_text_mode();
     et4k_log("restore_text_mode: text core staged OK");
     g_et4k_vram_window = NULL;
@@ -1107,7 +1351,13 @@ void et4000_restore_text_mode(void) {
     g_et4k_fb.height = 0;
     g_et4k_fb.pitch = 0;
     g_et4k_fb.bpp = 0;
-    g_et4k_fb.dirty = 0;
+    g_et4k_fb.scroll.top = 0;
+    g_et4k_fb.scroll.lines = 0;
+    g_et4k_fb.ax_engine = 0;
+    g_et4k_fb.pages = 1;
+    g_et4k_fb.page = 0;
+    g_et4k_fb.shown = 0;
+    fb_dirty_init(&g_et4k_fb.dirty, 0, 0);
     fb_accel_reset();
     gpu_set_last_error("OK: VGA text mode restored");
     gpu_debug_log("INFO", "et4k: restored 80x25 text mode");
@@ -1244,7 +1494,8 @@ int et4k_debug_trace_enabled(void) {
 
 void et4k_disable_ax_engine(const char* reason) {
     (void)reason;
-    // No AX engine active in legacy mode.
+    // Back to shadow uploads; the AX ops decline once ax_engine is clear
+    g_et4k_fb.ax_engine = 0;
     if (et4k_trace_enabled()) {
         console_write("[et4k] disable_ax_engine: reason=");
         console_write(reason ? reason : "null");
@@ -199,11 +199,15 @@ void et4000ax_draw_line(int x1, int y1, int x2, int y2, uint8_t color) {
     wait_for_blitter();
 }
 
-void et4000ax_pattern_fill(int x, int y, int width, int height, const uint8_t* pattern) {
-    if (!pattern) return;
+void et4000ax_pattern_fill(int x, int y, int width, int height, const uint8_t* pattern,
+                           uint8_t fg, uint8_t bg) {
+    if (!pattern || width <= 0 || height <= 0) return;
     
     if (!wait_for_fifo()) return;
 
+    outb(ET4K_AX_FRGD_COLOR, fg);
+    outb(ET4K_AX_BKGD_COLOR, bg);
+
     for (int i = 0; i < 8; i++) {
         outb(ET4K_AX_PIXEL_MASK + i, pattern[i]);
     }
@@ -37,7 +37,8 @@
 void et4000ax_bitblt(int sx, int sy, int dx, int dy, int width, int height, uint8_t rop);
 void et4000ax_fill_rect(int x, int y, int width, int height, uint8_t color);
 void et4000ax_draw_line(int x1, int y1, int x2, int y2, uint8_t color);
-void et4000ax_pattern_fill(int x, int y, int width, int height, const uint8_t* pattern);
+void et4000ax_pattern_fill(int x, int y, int width, int height, const uint8_t* pattern,
+                           uint8_t fg, uint8_t bg);
 int  et4kax_after_modeset_init(void);
 
 #endif // DRIVERS_GPU_ET4000AX_H
@@ -1,37 +1,102 @@
 #include "fb_accel.h"
+#include "blit.h"
+#include "vga_hw.h"
+#include "gpu_stats.h"
 #include <stddef.h>
 
 typedef struct {
     const fb_accel_ops_t* ops;
     void* ctx;
+    fb_accel_surface_t surface;
+    int present;                        // FB_ACCEL_PRESENT_*
+    uint8_t back;                       // page being drawn while flipping
+    volatile uint8_t* frame;            // buffer of the upload path
+    volatile uint8_t* console_base;     // surface base outside presentation
 } fb_accel_state_t;
 
-static fb_accel_state_t g_fb_accel = { NULL, NULL };
+static fb_accel_state_t g_fb_accel = { NULL, NULL, { NULL, 0, 0, 0, 1, NULL }, FB_ACCEL_PRESENT_NONE, 0, NULL, NULL };
 
 void fb_accel_register(const fb_accel_ops_t* ops, void* ctx) {
     g_fb_accel.ops = ops;
     g_fb_accel.ctx = ctx;
+    g_fb_accel.present = FB_ACCEL_PRESENT_NONE;
 }
 
 void fb_accel_reset(void) {
     g_fb_accel.ops = NULL;
     g_fb_accel.ctx = NULL;
+    g_fb_accel.surface.base = NULL;
+    g_fb_accel.surface.bytes = 1;
+    g_fb_accel.surface.pixels = NULL;
+    g_fb_accel.present = FB_ACCEL_PRESENT_NONE;
+}
+
+// Drawing ops of the driver; they take 8bpp colour indices, so a direct
+// colour surface is always drawn in software
+static const fb_accel_ops_t* fb_accel_draw_ops(void) {
+    return (g_fb_accel.surface.bytes > 1) ? NULL : g_fb_accel.ops;
 }
 
 int fb_accel_available(void) {
-    return (g_fb_accel.ops && g_fb_accel.ops->fill_rect);
+    const fb_accel_ops_t* ops = fb_accel_draw_ops();
+    return (ops && ops->fill_rect);
+}
+
+uint32_t fb_accel_hw_ops(void) {
+    const fb_accel_ops_t* ops = fb_accel_draw_ops();
+    uint32_t mask = 0;
+    if (!ops) return 0;
+    if (ops->fill_rect)    mask |= FB_ACCEL_OP_FILL_RECT;
+    if (ops->scroll)       mask |= FB_ACCEL_OP_SCROLL;
+    if (ops->copy_rect)    mask |= FB_ACCEL_OP_COPY_RECT;
+    if (ops->color_expand) mask |= FB_ACCEL_OP_COLOR_EXPAND;
+    if (ops->pattern_fill) mask |= FB_ACCEL_OP_PATTERN_FILL;
+    if (ops->draw_line)    mask |= FB_ACCEL_OP_DRAW_LINE;
+    if (ops->set_page && ops->show_page) mask |= FB_ACCEL_OP_PAGE_FLIP;
+    return mask;
+}
+
+void fb_accel_set_surface(volatile uint8_t* base, uint32_t pitch, uint16_t width, uint16_t height,
+                          uint8_t bytes, const uint32_t* pixels) {
+    g_fb_accel.surface.base = base;
+    g_fb_accel.surface.pitch = pitch;
+    g_fb_accel.surface.width = width;
+    g_fb_accel.surface.height = height;
+    g_fb_accel.surface.bytes = (bytes > 1 && pixels) ? bytes : 1;
+    g_fb_accel.surface.pixels = pixels;
+}
+
+// Count a finished drawing call (timed from 'start' on the TSC clock)
+static int fb_accel_drawn(uint32_t start) {
+    gpu_stats_draw(start);
+    return 1;
+}
+
+// Software fallback possible for this rectangle?
+static int fb_accel_sw_ok(uint16_t x, uint16_t y, uint16_t width, uint16_t height) {
+    const fb_accel_surface_t* s = &g_fb_accel.surface;
+    if (!s->base) return 0;
+    return ((uint32_t)x + width <= s->width && (uint32_t)y + height <= s->height);
 }
 
 int fb_accel_fill_rect(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint8_t color) {
-    if (!g_fb_accel.ops || !g_fb_accel.ops->fill_rect) {
-        return 0;
+    uint32_t t = gpu_stats_draw_begin();
+    const fb_accel_ops_t* ops = fb_accel_draw_ops();
+    if (ops && ops->fill_rect &&
+        ops->fill_rect(g_fb_accel.ctx, x, y, width, height, color)) {
+        return fb_accel_drawn(t);
     }
-    return g_fb_accel.ops->fill_rect(g_fb_accel.ctx, x, y, width, height, color);
+    if (!fb_accel_sw_ok(x, y, width, height)) return 0;
+    fb_accel_sw_fill_rect(&g_fb_accel.surface, x, y, width, height, color);
+    fb_accel_mark_dirty(x, y, width, height);
+    return fb_accel_drawn(t);
 }
 
 void fb_accel_sync(void) {
     if (g_fb_accel.ops && g_fb_accel.ops->sync) {
+        uint32_t t = gpu_stats_now();
         g_fb_accel.ops->sync(g_fb_accel.ctx);
+        gpu_stats_sync(t);
     }
 }
 
@@ -40,3 +105,252 @@ void fb_accel_mark_dirty(uint16_t x, uint16_t y, uint16_t width, uint16_t height
         g_fb_accel.ops->mark_dirty(g_fb_accel.ctx, x, y, width, height);
     }
 }
+
+int fb_accel_scroll(uint16_t lines) {
+    const fb_accel_ops_t* ops = fb_accel_draw_ops();
+    if (!ops || !ops->scroll) {
+        return 0;
+    }
+    uint32_t t = gpu_stats_draw_begin();
+    return ops->scroll(g_fb_accel.ctx, lines) && fb_accel_drawn(t);
+}
+
+int fb_accel_copy_rect(uint16_t sx, uint16_t sy, uint16_t dx, uint16_t dy, uint16_t width, uint16_t height) {
+    uint32_t t = gpu_stats_draw_begin();
+    const fb_accel_ops_t* ops = fb_accel_draw_ops();
+    if (ops && ops->copy_rect &&
+        ops->copy_rect(g_fb_accel.ctx, sx, sy, dx, dy, width, height)) {
+        return fb_accel_drawn(t);
+    }
+    if (!fb_accel_sw_ok(sx, sy, width, height) || !fb_accel_sw_ok(dx, dy, width, height)) return 0;
+    fb_accel_sw_copy_rect(&g_fb_accel.surface, sx, sy, dx, dy, width, height);
+    fb_accel_mark_dirty(dx, dy, width, height);
+    return fb_accel_drawn(t);
+}
+
+int fb_accel_color_expand(uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                          const uint8_t* bits, uint16_t stride, uint8_t fg, uint8_t bg) {
+    uint32_t t = gpu_stats_draw_begin();
+    if (!bits) return 0;
+    const fb_accel_ops_t* ops = fb_accel_draw_ops();
+    if (ops && ops->color_expand &&
+        ops->color_expand(g_fb_accel.ctx, x, y, width, height, bits, stride, fg, bg)) {
+        return fb_accel_drawn(t);
+    }
+    if (!fb_accel_sw_ok(x, y, width, height)) return 0;
+    fb_accel_sw_color_expand(&g_fb_accel.surface, x, y, width, height, bits, stride, fg, bg);
+    fb_accel_mark_dirty(x, y, width, height);
+    return fb_accel_drawn(t);
+}
+
+int fb_accel_pattern_fill(uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                          const uint8_t pattern[8], uint8_t fg, uint8_t bg) {
+    uint32_t t = gpu_stats_draw_begin();
+    if (!pattern) return 0;
+    const fb_accel_ops_t* ops = fb_accel_draw_ops();
+    if (ops && ops->pattern_fill &&
+        ops->pattern_fill(g_fb_accel.ctx, x, y, width, height, pattern, fg, bg)) {
+        return fb_accel_drawn(t);
+    }
+    if (!fb_accel_sw_ok(x, y, width, height)) return 0;
+    fb_accel_sw_pattern_fill(&g_fb_accel.surface, x, y, width, height, pattern, fg, bg);
+    fb_accel_mark_dirty(x, y, width, height);
+    return fb_accel_drawn(t);
+}
+
+int fb_accel_draw_line(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t color) {
+    uint32_t t = gpu_stats_draw_begin();
+    const fb_accel_ops_t* ops = fb_accel_draw_ops();
+    if (ops && ops->draw_line &&
+        ops->draw_line(g_fb_accel.ctx, x0, y0, x1, y1, color)) {
+        return fb_accel_drawn(t);
+    }
+    if (!fb_accel_sw_ok(x0, y0, 1, 1) || !fb_accel_sw_ok(x1, y1, 1, 1)) return 0;
+    fb_accel_sw_draw_line(&g_fb_accel.surface, x0, y0, x1, y1, color);
+    uint16_t left = (x0 < x1) ? x0 : x1;
+    uint16_t top = (y0 < y1) ? y0 : y1;
+    uint16_t right = (x0 < x1) ? x1 : x0;
+    uint16_t bottom = (y0 < y1) ? y1 : y0;
+    fb_accel_mark_dirty(left, top, (uint16_t)(right - left + 1u), (uint16_t)(bottom - top + 1u));
+    return fb_accel_drawn(t);
+}
+
+// The software fallbacks follow the page being drawn
+static volatile uint8_t* fb_accel_select_page(uint8_t page) {
+    volatile uint8_t* p = g_fb_accel.ops->set_page(g_fb_accel.ctx, page);
+    if (p && g_fb_accel.console_base) g_fb_accel.surface.base = p;
+    return p;
+}
+
+volatile uint8_t* fb_accel_present_begin(volatile uint8_t* frame) {
+    const fb_accel_ops_t* ops = g_fb_accel.ops;
+    if (g_fb_accel.present == FB_ACCEL_PRESENT_FLIP) {
+        return ops->set_page(g_fb_accel.ctx, g_fb_accel.back);
+    }
+    if (g_fb_accel.present == FB_ACCEL_PRESENT_UPLOAD) return g_fb_accel.frame;
+    g_fb_accel.console_base = g_fb_accel.surface.base;
+    if (ops && ops->set_page && ops->show_page) {
+        volatile uint8_t* p = fb_accel_select_page(1);
+        if (p) {
+            g_fb_accel.present = FB_ACCEL_PRESENT_FLIP;
+            g_fb_accel.back = 1;
+            return p;
+        }
+    }
+    if (!frame) return NULL;
+    g_fb_accel.present = FB_ACCEL_PRESENT_UPLOAD;
+    g_fb_accel.frame = frame;
+    return frame;
+}
+
+static void fb_accel_wait_vretrace(void) {
+    uint32_t t = gpu_stats_now();
+    gpu_stats_vblank(t, vga_wait_vretrace());
+}
+
+volatile uint8_t* fb_accel_present(int vsync) {
+    if (g_fb_accel.present == FB_ACCEL_PRESENT_FLIP) {
+        fb_accel_sync();
+        g_fb_accel.ops->show_page(g_fb_accel.ctx, g_fb_accel.back);
+        // Until the retrace the old page is still being scanned out
+        if (vsync) fb_accel_wait_vretrace();
+        gpu_stats_present();
+        g_fb_accel.back ^= 1u;
+        return fb_accel_select_page(g_fb_accel.back);
+    }
+    if (g_fb_accel.present == FB_ACCEL_PRESENT_UPLOAD) {
+        if (vsync) fb_accel_wait_vretrace();
+        fb_accel_sync();
+        gpu_stats_present();
+        return g_fb_accel.frame;
+    }
+    return NULL;
+}
+
+void fb_accel_present_end(void) {
+    if (g_fb_accel.present == FB_ACCEL_PRESENT_FLIP) {
+        // Page 0 catches up with the last frame before it is shown again
+        fb_accel_select_page(0);
+        fb_accel_sync();
+        g_fb_accel.ops->show_page(g_fb_accel.ctx, 0);
+    }
+    if (g_fb_accel.present != FB_ACCEL_PRESENT_NONE) {
+        g_fb_accel.surface.base = g_fb_accel.console_base;
+    }
+    g_fb_accel.present = FB_ACCEL_PRESENT_NONE;
+}
+
+int fb_accel_present_mode(void) {
+    return g_fb_accel.present;
+}
+
+// Pixel value of a palette index on the surface
+static inline uint32_t fb_accel_sw_pixel(const fb_accel_surface_t* s, uint8_t color) {
+    return (s->bytes > 1) ? s->pixels[color] : color;
+}
+
+static inline void fb_accel_sw_put(const fb_accel_surface_t* s, volatile uint8_t* line,
+                                   uint32_t x, uint32_t pixel) {
+    if (s->bytes == 4) {
+        ((volatile uint32_t*)line)[x] = pixel;
+    } else if (s->bytes == 2) {
+        ((volatile uint16_t*)line)[x] = (uint16_t)pixel;
+    } else {
+        line[x] = (uint8_t)pixel;
+    }
+}
+
+void fb_accel_sw_fill_rect(const fb_accel_surface_t* s, uint16_t x, uint16_t y,
+                           uint16_t width, uint16_t height, uint8_t color) {
+    const uint32_t pixel = fb_accel_sw_pixel(s, color);
+    // Dword pattern and pixels per dword of the format
+    const uint32_t fill = (s->bytes == 4) ? pixel : (s->bytes == 2) ? pixel * 0x00010001u : pixel * 0x01010101u;
+    const uint32_t per_dword = 4u / s->bytes;
+    volatile uint8_t* line = s->base + (uint32_t)y * s->pitch + (uint32_t)x * s->bytes;
+    for (uint16_t row = 0; row < height; ++row, line += s->pitch) {
+        uint32_t col = 0;
+        // Pixel steps up to a dword boundary, then whole dwords
+        for (; col < width && ((uintptr_t)(line + col * s->bytes) & 3u); ++col) fb_accel_sw_put(s, line, col, pixel);
+        volatile uint32_t* dst = (volatile uint32_t*)(line + col * s->bytes);
+        for (; col + per_dword <= width; col += per_dword) *dst++ = fill;
+        for (; col < width; ++col) fb_accel_sw_put(s, line, col, pixel);
+    }
+}
+
+void fb_accel_sw_copy_rect(const fb_accel_surface_t* s, uint16_t sx, uint16_t sy,
+                           uint16_t dx, uint16_t dy, uint16_t width, uint16_t height) {
+    if (!width || !height) return;
+    // Byte offsets within a line
+    const uint32_t bytes = (uint32_t)width * s->bytes;
+    const uint32_t sx_bytes = (uint32_t)sx * s->bytes;
+    const uint32_t dx_bytes = (uint32_t)dx * s->bytes;
+    if (dy == sy && dx > sx) {
+        // Same lines, moving right: copy each line from its end
+        for (uint16_t row = 0; row < height; ++row) {
+            volatile uint8_t* line = s->base + (uint32_t)(sy + row) * s->pitch;
+            for (uint32_t col = bytes; col > 0; --col) {
+                line[dx_bytes + col - 1u] = line[sx_bytes + col - 1u];
+            }
+        }
+        return;
+    }
+    // Lines never overlap within a row copy; walk bottom-up when moving down.
+    // A forward copy is safe for the same line moving left.
+    int32_t step = (int32_t)s->pitch;
+    uint32_t first = 0;
+    if (dy > sy) {
+        first = height - 1u;
+        step = -step;
+    }
+    volatile uint8_t* src = s->base + (uint32_t)(sy + first) * s->pitch + sx_bytes;
+    volatile uint8_t* dst = s->base + (uint32_t)(dy + first) * s->pitch + dx_bytes;
+    for (uint16_t row = 0; row < height; ++row, src += step, dst += step) {
+        gpu_blit_copy(dst, (const void*)src, bytes);
+    }
+}
+
+void fb_accel_sw_color_expand(const fb_accel_surface_t* s, uint16_t x, uint16_t y,
+                              uint16_t width, uint16_t height, const uint8_t* bits,
+                              uint16_t stride, uint8_t fg, uint8_t bg) {
+    const uint32_t fgp = fb_accel_sw_pixel(s, fg);
+    const uint32_t bgp = fb_accel_sw_pixel(s, bg);
+    volatile uint8_t* line = s->base + (uint32_t)y * s->pitch + (uint32_t)x * s->bytes;
+    for (uint16_t row = 0; row < height; ++row, line += s->pitch, bits += stride) {
+        for (uint16_t col = 0; col < width; ++col) {
+            fb_accel_sw_put(s, line, col, (bits[col >> 3] & (0x80u >> (col & 7u))) ? fgp : bgp);
+        }
+    }
+}
+
+void fb_accel_sw_pattern_fill(const fb_accel_surface_t* s, uint16_t x, uint16_t y,
+                              uint16_t width, uint16_t height, const uint8_t pattern[8],
+                              uint8_t fg, uint8_t bg) {
+    const uint32_t fgp = fb_accel_sw_pixel(s, fg);
+    const uint32_t bgp = fb_accel_sw_pixel(s, bg);
+    volatile uint8_t* line = s->base + (uint32_t)y * s->pitch + (uint32_t)x * s->bytes;
+    for (uint16_t row = 0; row < height; ++row, line += s->pitch) {
+        const uint8_t bits = pattern[row & 7u];
+        for (uint16_t col = 0; col < width; ++col) {
+            fb_accel_sw_put(s, line, col, (bits & (0x80u >> (col & 7u))) ? fgp : bgp);
+        }
+    }
+}
+
+void fb_accel_sw_draw_line(const fb_accel_surface_t* s, uint16_t x0, uint16_t y0,
+                           uint16_t x1, uint16_t y1, uint8_t color) {
+    const uint32_t pixel = fb_accel_sw_pixel(s, color);
+    // Bresenham, both end points included
+    int32_t x = x0, y = y0;
+    int32_t dx = (x1 > x0) ? (int32_t)(x1 - x0) : (int32_t)(x0 - x1);
+    int32_t dy = (y1 > y0) ? -(int32_t)(y1 - y0) : -(int32_t)(y0 - y1);
+    int32_t sx = (x1 > x0) ? 1 : -1;
+    int32_t sy = (y1 > y0) ? 1 : -1;
+    int32_t err = dx + dy;
+    for (;;) {
+        fb_accel_sw_put(s, s->base + (uint32_t)y * s->pitch, (uint32_t)x, pixel);
+        if (x == (int32_t)x1 && y == (int32_t)y1) break;
+        int32_t e2 = 2 * err;
+        if (e2 >= dy) { err += dy; x += sx; }
+        if (e2 <= dx) { err += dx; y += sy; }
+    }
+}
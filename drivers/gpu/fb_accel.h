@@ -3,17 +3,107 @@
 
 #include <stdint.h>
 
+// Optional 2D operations of the active framebuffer driver. Every entry may be
+// NULL; the drawing ops return 0 when they cannot handle a request, and the
+// fb_accel_* front ends then draw in software on the registered surface.
 typedef struct fb_accel_ops {
     int  (*fill_rect)(void* ctx, uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint8_t color);
     void (*sync)(void* ctx);
     void (*mark_dirty)(void* ctx, uint16_t x, uint16_t y, uint16_t width, uint16_t height);
+    // Move the whole frame up by 'lines' scanlines (CRTC start address); the
+    // uncovered bottom lines are undefined. Returns 0 if unsupported.
+    int  (*scroll)(void* ctx, uint16_t lines);
+    // Screen-to-screen copy; source and destination may overlap
+    int  (*copy_rect)(void* ctx, uint16_t sx, uint16_t sy, uint16_t dx, uint16_t dy,
+                      uint16_t width, uint16_t height);
+    // Monochrome to colour: 'height' rows of 'stride' bytes, bit 7 of the
+    // first byte is the leftmost pixel; set bits get fg, clear bits bg
+    int  (*color_expand)(void* ctx, uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                         const uint8_t* bits, uint16_t stride, uint8_t fg, uint8_t bg);
+    // 8x8 monochrome pattern repeated over the rectangle; row 0, bit 7 sits
+    // at its top-left corner
+    int  (*pattern_fill)(void* ctx, uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                         const uint8_t pattern[8], uint8_t fg, uint8_t bg);
+    int  (*draw_line)(void* ctx, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t color);
+    // Page flipping where VRAM holds two frames. set_page makes page 0 or 1
+    // the target of the ops above and returns the CPU address to draw it
+    // (shadow drivers: the shadow), NULL if the page does not fit; page 0 is
+    // the console frame. show_page loads a page into the CRTC start address,
+    // which the hardware latches at the next vertical retrace.
+    volatile uint8_t* (*set_page)(void* ctx, uint8_t page);
+    void (*show_page)(void* ctx, uint8_t page);
 } fb_accel_ops_t;
 
+// Ops the registered driver implements (fb_accel_hw_ops)
+#define FB_ACCEL_OP_FILL_RECT    (1u << 0)
+#define FB_ACCEL_OP_SCROLL       (1u << 1)
+#define FB_ACCEL_OP_COPY_RECT    (1u << 2)
+#define FB_ACCEL_OP_COLOR_EXPAND (1u << 3)
+#define FB_ACCEL_OP_PATTERN_FILL (1u << 4)
+#define FB_ACCEL_OP_DRAW_LINE    (1u << 5)
+#define FB_ACCEL_OP_PAGE_FLIP    (1u << 6)
+
+// Linear surface for the software paths: one byte per pixel (8bpp, or the
+// 4bpp shadows that keep the colour in the low nibble), or a direct colour
+// LFB with 2 or 4 bytes per pixel. Colours stay palette indices throughout
+// the API; direct colour surfaces map them through 'pixels'.
+typedef struct {
+    volatile uint8_t* base;
+    uint32_t pitch;
+    uint16_t width;
+    uint16_t height;
+    uint8_t  bytes;             // bytes per pixel: 1, 2 or 4
+    const uint32_t* pixels;     // palette index -> pixel value (bytes > 1)
+} fb_accel_surface_t;
+
 void fb_accel_register(const fb_accel_ops_t* ops, void* ctx);
 void fb_accel_reset(void);
 int  fb_accel_available(void);
+uint32_t fb_accel_hw_ops(void);
+// Surface for the software fallbacks; base NULL disables them (banked modes).
+// The driver's ops only handle 8bpp: on a direct colour surface (bytes > 1)
+// the front ends always draw in software.
+void fb_accel_set_surface(volatile uint8_t* base, uint32_t pitch, uint16_t width, uint16_t height,
+                          uint8_t bytes, const uint32_t* pixels);
 int  fb_accel_fill_rect(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint8_t color);
 void fb_accel_sync(void);
 void fb_accel_mark_dirty(uint16_t x, uint16_t y, uint16_t width, uint16_t height);
+int  fb_accel_scroll(uint16_t lines);
+int  fb_accel_copy_rect(uint16_t sx, uint16_t sy, uint16_t dx, uint16_t dy, uint16_t width, uint16_t height);
+int  fb_accel_color_expand(uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                           const uint8_t* bits, uint16_t stride, uint8_t fg, uint8_t bg);
+int  fb_accel_pattern_fill(uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                           const uint8_t pattern[8], uint8_t fg, uint8_t bg);
+int  fb_accel_draw_line(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t color);
+
+// Double buffering for full-screen apps. present_begin returns the buffer for
+// the next frame: the hidden VRAM page where the driver can flip, else
+// 'frame' itself. present finishes the frame (engine idle, shadow uploaded),
+// shows it and returns the buffer for the frame after; with vsync it waits
+// for the retrace, so a flip has taken effect or an upload starts in the
+// blanking interval. present_end puts page 0 back on screen.
+#define FB_ACCEL_PRESENT_NONE    0
+#define FB_ACCEL_PRESENT_UPLOAD  1   // one buffer, dirty spans copied to VRAM
+#define FB_ACCEL_PRESENT_FLIP    2   // two VRAM pages, CRTC start address flipped
+volatile uint8_t* fb_accel_present_begin(volatile uint8_t* frame);
+volatile uint8_t* fb_accel_present(int vsync);
+void fb_accel_present_end(void);
+int  fb_accel_present_mode(void);
+
+// Software implementations on a surface (no dirty tracking); drivers with a
+// shadow use them to keep it in step with what their engine drew in VRAM.
+// Rectangles must lie inside the surface.
+void fb_accel_sw_fill_rect(const fb_accel_surface_t* s, uint16_t x, uint16_t y,
+                           uint16_t width, uint16_t height, uint8_t color);
+void fb_accel_sw_copy_rect(const fb_accel_surface_t* s, uint16_t sx, uint16_t sy,
+                           uint16_t dx, uint16_t dy, uint16_t width, uint16_t height);
+void fb_accel_sw_color_expand(const fb_accel_surface_t* s, uint16_t x, uint16_t y,
+                              uint16_t width, uint16_t height, const uint8_t* bits,
+                              uint16_t stride, uint8_t fg, uint8_t bg);
+void fb_accel_sw_pattern_fill(const fb_accel_surface_t* s, uint16_t x, uint16_t y,
+                              uint16_t width, uint16_t height, const uint8_t pattern[8],
+                              uint8_t fg, uint8_t bg);
+void fb_accel_sw_draw_line(const fb_accel_surface_t* s, uint16_t x0, uint16_t y0,
+                           uint16_t x1, uint16_t y1, uint8_t color);
 
 #endif // DRIVERS_GPU_FB_ACCEL_H
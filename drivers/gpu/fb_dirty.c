@@ -0,0 +1,96 @@
+#include "fb_dirty.h"
+#include "gpu_stats.h"
+#include "../../console.h"
+#include <stddef.h>
+
+static fb_dirty_stats_t g_fb_dirty_stats;
+
+void fb_dirty_init(fb_dirty_t* d, uint16_t width, uint16_t height) {
+    if (!d) return;
+    if (height > FB_DIRTY_MAX_LINES) height = FB_DIRTY_MAX_LINES;
+    d->width = width;
+    d->height = height;
+    for (uint32_t y = 0; y < FB_DIRTY_MAX_LINES; ++y) {
+        d->x0[y] = 0;
+        d->x1[y] = 0;
+    }
+    d->y_min = 1;
+    d->y_max = 0;
+}
+
+void fb_dirty_mark(fb_dirty_t* d, uint16_t x, uint16_t y, uint16_t width, uint16_t height) {
+    if (!d || width == 0 || height == 0 || x >= d->width || y >= d->height) return;
+    uint32_t x_end = (uint32_t)x + width;
+    uint32_t y_end = (uint32_t)y + height;
+    if (x_end > d->width) x_end = d->width;
+    if (y_end > d->height) y_end = d->height;
+
+    for (uint32_t line = y; line < y_end; ++line) {
+        if (d->x1[line] == 0) {
+            d->x0[line] = x;
+            d->x1[line] = (uint16_t)x_end;
+        } else {
+            if (x < d->x0[line]) d->x0[line] = x;
+            if (x_end > d->x1[line]) d->x1[line] = (uint16_t)x_end;
+        }
+    }
+    if (d->y_min > d->y_max) {
+        d->y_min = y;
+        d->y_max = (uint16_t)(y_end - 1u);
+    } else {
+        if (y < d->y_min) d->y_min = y;
+        if (y_end - 1u > d->y_max) d->y_max = (uint16_t)(y_end - 1u);
+    }
+}
+
+void fb_dirty_mark_all(fb_dirty_t* d) {
+    if (!d) return;
+    fb_dirty_mark(d, 0, 0, d->width, d->height);
+}
+
+void fb_dirty_clear(fb_dirty_t* d) {
+    if (!fb_dirty_any(d)) return;
+    for (uint32_t y = d->y_min; y <= d->y_max; ++y) {
+        d->x0[y] = 0;
+        d->x1[y] = 0;
+    }
+    d->y_min = 1;
+    d->y_max = 0;
+}
+
+void fb_dirty_merge(fb_dirty_t* d, const fb_dirty_t* src) {
+    if (!d || !fb_dirty_any(src)) return;
+    for (uint32_t y = src->y_min; y <= src->y_max; ++y) {
+        if (src->x1[y] == 0) continue;
+        fb_dirty_mark(d, src->x0[y], (uint16_t)y, (uint16_t)(src->x1[y] - src->x0[y]), 1);
+    }
+}
+
+void fb_dirty_account(uint32_t lines, uint32_t bytes, uint32_t full_frame) {
+    g_fb_dirty_stats.syncs++;
+    g_fb_dirty_stats.lines_last = lines;
+    g_fb_dirty_stats.bytes_last = bytes;
+    g_fb_dirty_stats.bytes_total += bytes;
+    g_fb_dirty_stats.full_frame = full_frame;
+    gpu_stats_upload(bytes);
+}
+
+void fb_dirty_stats_get(fb_dirty_stats_t* out) {
+    if (out) *out = g_fb_dirty_stats;
+}
+
+void fb_dirty_stats_print(void) {
+    const fb_dirty_stats_t* s = &g_fb_dirty_stats;
+    if (s->syncs == 0) return;
+    console_write("Shadow upload: syncs=");
+    console_write_dec(s->syncs);
+    console_write(" last=");
+    console_write_dec(s->bytes_last);
+    console_write("/");
+    console_write_dec(s->full_frame);
+    console_write(" bytes (");
+    console_write_dec(s->lines_last);
+    console_write(" lines) total=");
+    console_write_dec(s->bytes_total / 1024u);
+    console_write(" KiB\n");
+}
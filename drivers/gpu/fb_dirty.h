@@ -0,0 +1,46 @@
+#ifndef DRIVERS_GPU_FB_DIRTY_H
+#define DRIVERS_GPU_FB_DIRTY_H
+
+#include <stdint.h>
+
+// Dirty-region tracking for shadow-framebuffer drivers (ET4000, SMOS).
+// Each scanline keeps one changed span [x0, x1) in pixels; marks widen it,
+// so a console glyph dirties 16 short spans instead of the whole frame.
+// Lines y_min..y_max bound the dirty area, the rest is never looked at.
+#define FB_DIRTY_MAX_LINES 768u
+
+typedef struct {
+    uint16_t width;
+    uint16_t height;
+    uint16_t y_min;                    // y_min > y_max: clean
+    uint16_t y_max;
+    uint16_t x0[FB_DIRTY_MAX_LINES];
+    uint16_t x1[FB_DIRTY_MAX_LINES];   // x1 == 0: line clean
+} fb_dirty_t;
+
+// Upload statistics of the shadow drivers (all trackers together)
+typedef struct {
+    uint32_t syncs;         // uploads that found something dirty
+    uint32_t lines_last;    // scanlines touched by the last upload
+    uint32_t bytes_last;    // VRAM bytes written by the last upload
+    uint32_t bytes_total;
+    uint32_t full_frame;    // bytes a whole-frame upload would have written (last)
+} fb_dirty_stats_t;
+
+void fb_dirty_init(fb_dirty_t* d, uint16_t width, uint16_t height);
+void fb_dirty_mark(fb_dirty_t* d, uint16_t x, uint16_t y, uint16_t width, uint16_t height);
+void fb_dirty_mark_all(fb_dirty_t* d);
+void fb_dirty_clear(fb_dirty_t* d);
+// Widen d by every span of src (same geometry)
+void fb_dirty_merge(fb_dirty_t* d, const fb_dirty_t* src);
+
+static inline int fb_dirty_any(const fb_dirty_t* d) {
+    return d && d->y_min <= d->y_max;
+}
+
+// Record one upload: scanlines and VRAM bytes written, whole-frame equivalent
+void fb_dirty_account(uint32_t lines, uint32_t bytes, uint32_t full_frame);
+void fb_dirty_stats_get(fb_dirty_stats_t* out);
+void fb_dirty_stats_print(void);
+
+#endif // DRIVERS_GPU_FB_DIRTY_H
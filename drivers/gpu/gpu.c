@@ -11,6 +11,8 @@
 #include "../../paging.h"
 #include "cirrus_accel.h"
 #include "et4000_common.h"
+#include "fb_dirty.h"
+#include "gpu_stats.h"
 #include <stdint.h>
 #include <stddef.h>
 
@@ -37,7 +39,7 @@ typedef struct {
 
 static struct {
     vesa_mode_entry_t mode4;
-    vesa_mode_entry_t mode8;
+    vesa_mode_entry_t mode_lfb;   // bootloader LFB mode: 8, 15, 16 or 32bpp
     uint32_t vram_bytes;
 } g_vesa_state;
 
@@ -80,6 +82,8 @@ void gpu_set_last_mode(const char* name, uint16_t width, uint16_t height, uint8_
     g_gpu_last_mode_width = width;
     g_gpu_last_mode_height = height;
     g_gpu_last_mode_bpp = bpp;
+    // Counters follow the adapter that was switched on; text mode keeps the last one
+    if (bpp) gpu_stats_select(name);
 }
 
 void gpu_get_last_mode(char* out_name, size_t name_len, uint16_t* width, uint16_t* height, uint8_t* bpp) {
@@ -273,7 +277,7 @@ static void log_device(const gpu_info_t* gpu) {
 
 static void gpu_register_bootinfo_adapter(const boot_info_t* bootinfo) {
     g_vesa_state.mode4.available = 0;
-    g_vesa_state.mode8.available = 0;
+    g_vesa_state.mode_lfb.available = 0;
     g_vesa_state.vram_bytes = 0;
 
     if (!bootinfo) {
@@ -284,11 +288,13 @@ static void gpu_register_bootinfo_adapter(const boot_info_t* bootinfo) {
 
     if (bootinfo->framebuffer_phys &&
         bootinfo->vbe_width && bootinfo->vbe_height && bootinfo->vbe_pitch &&
-        bootinfo->vbe_bpp == 8) {
-        vesa_mode_entry_t* entry = &g_vesa_state.mode8;
+        (bootinfo->vbe_bpp == 8 || bootinfo->vbe_bpp == 15 ||
+         bootinfo->vbe_bpp == 16 || bootinfo->vbe_bpp == 32)) {
+        // Direct colour modes assume the VBE standard channel layout
+        vesa_mode_entry_t* entry = &g_vesa_state.mode_lfb;
         entry->available = 1;
         entry->mode.kind = DISPLAY_MODE_KIND_FRAMEBUFFER;
-        entry->mode.pixel_format = DISPLAY_PIXEL_FORMAT_PAL_256;
+        entry->mode.pixel_format = display_pixel_format_for_bpp(bootinfo->vbe_bpp);
         entry->mode.width = bootinfo->vbe_width;
         entry->mode.height = bootinfo->vbe_height;
         entry->mode.bpp = bootinfo->vbe_bpp;
@@ -334,7 +340,7 @@ static void gpu_register_bootinfo_adapter(const boot_info_t* bootinfo) {
         }
     }
 
-    if (!g_vesa_state.mode4.available && !g_vesa_state.mode8.available) {
+    if (!g_vesa_state.mode4.available && !g_vesa_state.mode_lfb.available) {
         return;
     }
 
@@ -343,12 +349,12 @@ static void gpu_register_bootinfo_adapter(const boot_info_t* bootinfo) {
     info.type = GPU_TYPE_VGA;
     gpu_copy_string(info.name, sizeof(info.name), "VESA/VGA");
     info.framebuffer_bar = 0xFF;
-    info.framebuffer_base = g_vesa_state.mode8.available ?
-        g_vesa_state.mode8.mode.phys_base : g_vesa_state.mode4.mode.phys_base;
+    info.framebuffer_base = g_vesa_state.mode_lfb.available ?
+        g_vesa_state.mode_lfb.mode.phys_base : g_vesa_state.mode4.mode.phys_base;
     info.framebuffer_size = g_vesa_state.vram_bytes;
     info.framebuffer_ptr = NULL;
     info.capabilities = GPU_CAP_VBE_BIOS;
-    if (g_vesa_state.mode8.available) {
+    if (g_vesa_state.mode_lfb.available) {
         info.capabilities |= GPU_CAP_LINEAR_FB;
     }
 
@@ -450,11 +456,11 @@ size_t gpu_get_mode_catalog(const gpu_info_t* gpu,
             break;
         }
         case GPU_TYPE_VGA: {
-            if (g_vesa_state.mode8.available) {
+            if (g_vesa_state.mode_lfb.available) {
                 if (out_modes && count < capacity) {
-                    out_modes[count].width = g_vesa_state.mode8.mode.width;
-                    out_modes[count].height = g_vesa_state.mode8.mode.height;
-                    out_modes[count].bpp = g_vesa_state.mode8.mode.bpp;
+                    out_modes[count].width = g_vesa_state.mode_lfb.mode.width;
+                    out_modes[count].height = g_vesa_state.mode_lfb.mode.height;
+                    out_modes[count].bpp = g_vesa_state.mode_lfb.mode.bpp;
                 }
                 ++count;
             }
@@ -585,6 +591,7 @@ void gpu_log_summary(void) {
     for (size_t i = 0; i < g_gpu_count; i++) {
         log_device(&g_gpu_infos[i]);
     }
+    fb_dirty_stats_print();
 }
 
 void gpu_dump_details(void) {
@@ -599,6 +606,12 @@ void gpu_dump_details(void) {
     }
 }
 
+// Native drivers whose whole frame is CPU-visible at once. GPU_CAP_LINEAR_FB
+// is also set for the ISA adapters, which reach VRAM through the 64 KiB window.
+static int gpu_fb_unbanked(const gpu_info_t* gpu) {
+    return gpu->type == GPU_TYPE_CIRRUS;
+}
+
 int gpu_request_framebuffer_mode(uint16_t width, uint16_t height, uint8_t bpp) {
     if (g_framebuffer_active && g_active_fb_gpu) {
         if (g_active_fb_gpu->framebuffer_width == width &&
@@ -611,21 +624,26 @@ int gpu_request_framebuffer_mode(uint16_t width, uint16_t height, uint8_t bpp) {
     int explicit_request = (width != 0 || height != 0 || bpp != 0);
 
     // AUTO/default selection policy:
-    //  1) Prefer verified native drivers.
+    //  1) Prefer verified native drivers, those with a linear framebuffer
+    //     before the banked ones (no window switching, no shadow upload).
     //  2) Try VESA/VBE (bootloader-provided LFB).
     //  3) As a last resort, try unverified native modesets (better than staying in text).
     //
     // Explicit requests should try the matching native driver immediately.
-    for (int pass = 0; pass < (explicit_request ? 1 : 3); ++pass) {
+    for (int pass = 0; pass < (explicit_request ? 1 : 4); ++pass) {
         for (size_t i = 0; i < g_gpu_count; i++) {
             gpu_info_t* gpu = &g_gpu_infos[i];
             int is_vesa = (gpu->type == GPU_TYPE_VGA);
+            int is_linear = gpu_fb_unbanked(gpu);
 
             if (!explicit_request) {
                 if (pass == 0) {
-                    // Verified native only, no VESA.
-                    if (is_vesa) continue;
+                    // Verified native with a linear framebuffer.
+                    if (is_vesa || !is_linear) continue;
                 } else if (pass == 1) {
+                    // Verified native, banked.
+                    if (is_vesa || is_linear) continue;
+                } else if (pass == 2) {
                     // VESA only.
                     if (!is_vesa) continue;
                 } else {
@@ -641,7 +659,7 @@ int gpu_request_framebuffer_mode(uint16_t width, uint16_t height, uint8_t bpp) {
             if (!explicit_request &&
                 gpu->pci.vendor_id == 0x1013 &&
                 gpu->pci.device_id != 0x00B8) {
-                if (pass == 0) {
+                if (pass < 2) {
                     console_writeln("gpu: Cirrus modeset unverified on this chip, trying VESA first.");
                     continue;
                 }
@@ -669,7 +687,7 @@ int gpu_request_framebuffer_mode(uint16_t width, uint16_t height, uint8_t bpp) {
                 display_manager_set_framebuffer_candidate("cirrus-lfb", &mode);
                 display_manager_activate_framebuffer();
                 if (gpu->capabilities & GPU_CAP_ACCEL_2D) {
-                    cirrus_accel_enable(&mode);
+                    cirrus_accel_enable(&mode, gpu->framebuffer_size);
                 }
                 display_manager_apply_active_mode();
                 gpu_set_last_mode(gpu->name[0] ? gpu->name : "Cirrus GD5446", mode.width, mode.height, mode.bpp);
@@ -1073,7 +1091,7 @@ static int activate_cirrus(uint16_t width, uint16_t height, uint8_t bpp) {
     display_manager_set_framebuffer_candidate("cirrus-lfb", &fb_mode);
     display_manager_activate_framebuffer();
     if (gpu->capabilities & GPU_CAP_ACCEL_2D) {
-        cirrus_accel_enable(&fb_mode);
+        cirrus_accel_enable(&fb_mode, gpu->framebuffer_size);
     }
     display_manager_apply_active_mode();
     g_active_fb_gpu = gpu;
@@ -1085,13 +1103,14 @@ static int activate_cirrus(uint16_t width, uint16_t height, uint8_t bpp) {
 }
 
 static int activate_vesa(uint16_t width, uint16_t height, uint8_t bpp) {
-    if (!g_vesa_state.mode4.available && !g_vesa_state.mode8.available) {
+    if (!g_vesa_state.mode4.available && !g_vesa_state.mode_lfb.available) {
         gpu_set_last_error("ERROR: no VESA framebuffer info");
         return 0;
     }
 
+    // The linear mode first: no planes, no banking
     const vesa_mode_entry_t* candidates[2] = {
-        &g_vesa_state.mode8,
+        &g_vesa_state.mode_lfb,
         &g_vesa_state.mode4
     };
 
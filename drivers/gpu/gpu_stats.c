@@ -0,0 +1,301 @@
+#include "gpu_stats.h"
+#include "../../console.h"
+#include "../../config.h"
+#include "../../cpu.h"
+#include "../../interrupts.h"
+#include "../../platform.h"
+#include <stddef.h>
+
+// Accumulated in clock units, converted to microseconds by gpu_stats_get
+typedef struct {
+    char     name[32];
+    uint32_t syncs, draws, uploads, upload_bytes_last, bank_switches;
+    uint32_t irq_off, vblank_waits, vblank_timeouts, presents;
+    uint64_t upload_bytes;
+    uint64_t sync_time, draw_time, irq_off_time, vblank_time;
+    uint32_t sync_max, irq_off_max;
+} gpu_stats_slot_t;
+
+static gpu_stats_slot_t g_slots[GPU_STATS_MAX_ADAPTERS];
+static int g_active = -1;
+
+static gpu_stats_clock_fn g_clock_read = platform_time_us;
+static uint32_t g_clock_per_ms = 1000u;
+static int g_clock_tsc = 0;
+static int g_clock_chosen = 0;
+
+static uint32_t g_irq_depth = 0;
+static uint32_t g_irq_start = 0;
+
+#if CONFIG_ARCH_X86
+static uint32_t gpu_stats_rdtsc(void) {
+    uint32_t lo, hi;
+    __asm__ volatile ("rdtsc" : "=a"(lo), "=d"(hi));
+    (void)hi;
+    return lo;
+}
+
+// TSC cycles per millisecond over 10 ms of PIT time; 0 if the PIT is not
+// running or interrupts are off (its clock would not advance)
+static uint32_t gpu_stats_calibrate_tsc(void) {
+    if (platform_timer_get_hz() == 0 || !interrupts_are_enabled()) return 0;
+    uint32_t t0 = platform_time_us();
+    uint32_t c0 = gpu_stats_rdtsc();
+    uint32_t spins = 0;
+    while (platform_time_us() - t0 < 10000u) {
+        if (++spins > 10000000u) return 0;
+    }
+    uint32_t cycles = gpu_stats_rdtsc() - c0;
+    uint32_t us = platform_time_us() - t0;
+    return us ? (uint32_t)((uint64_t)cycles * 1000u / us) : 0;
+}
+#endif
+
+static void gpu_stats_choose_clock(void) {
+    if (g_clock_chosen) return;
+#if CONFIG_ARCH_X86
+    if (cpu_has_tsc()) {
+        uint32_t per_ms = gpu_stats_calibrate_tsc();
+        if (per_ms == 0) return;    // try again at the next mode set
+        g_clock_read = gpu_stats_rdtsc;
+        g_clock_per_ms = per_ms;
+        g_clock_tsc = 1;
+    }
+#endif
+    g_clock_chosen = 1;
+}
+
+void gpu_stats_set_clock(gpu_stats_clock_fn read, uint32_t units_per_ms) {
+    if (read && units_per_ms) {
+        g_clock_read = read;
+        g_clock_per_ms = units_per_ms;
+        g_clock_tsc = 0;
+        g_clock_chosen = 1;
+    } else {
+        g_clock_read = platform_time_us;
+        g_clock_per_ms = 1000u;
+        g_clock_tsc = 0;
+        g_clock_chosen = 0;
+        gpu_stats_choose_clock();
+    }
+}
+
+const char* gpu_stats_clock_name(uint32_t* units_per_ms) {
+    if (units_per_ms) *units_per_ms = g_clock_per_ms;
+    if (g_clock_tsc) return "tsc";
+    return (g_clock_read == platform_time_us) ? "pit" : "hook";
+}
+
+static uint32_t gpu_stats_to_us(uint64_t units) {
+    return (uint32_t)(units * 1000u / g_clock_per_ms);
+}
+
+// Zero every counter of a slot, keeping its name
+static void gpu_stats_clear(gpu_stats_slot_t* s) {
+    uint8_t* p = (uint8_t*)s + sizeof(s->name);
+    for (size_t n = sizeof(s->name); n < sizeof(*s); ++n) *p++ = 0;
+}
+
+static int gpu_stats_name_eq(const char* a, const char* b) {
+    while (*a && *a == *b) { a++; b++; }
+    return *a == *b;
+}
+
+void gpu_stats_select(const char* adapter) {
+    if (!adapter || !adapter[0]) return;
+    gpu_stats_choose_clock();
+    uint32_t free_slot = GPU_STATS_MAX_ADAPTERS;
+    for (uint32_t i = 0; i < GPU_STATS_MAX_ADAPTERS; ++i) {
+        if (g_slots[i].name[0] == '\0') {
+            if (free_slot == GPU_STATS_MAX_ADAPTERS) free_slot = i;
+        } else if (gpu_stats_name_eq(g_slots[i].name, adapter)) {
+            g_active = (int)i;
+            return;
+        }
+    }
+    // All slots taken: the last one is reused
+    if (free_slot == GPU_STATS_MAX_ADAPTERS) free_slot = GPU_STATS_MAX_ADAPTERS - 1u;
+    gpu_stats_slot_t* s = &g_slots[free_slot];
+    gpu_stats_clear(s);
+    size_t n = 0;
+    while (adapter[n] && n + 1 < sizeof(s->name)) { s->name[n] = adapter[n]; n++; }
+    s->name[n] = '\0';
+    g_active = (int)free_slot;
+}
+
+void gpu_stats_reset(void) {
+    for (uint32_t i = 0; i < GPU_STATS_MAX_ADAPTERS; ++i) {
+        gpu_stats_clear(&g_slots[i]);
+    }
+}
+
+int gpu_stats_get(uint32_t index, gpu_stats_t* out) {
+    // Index 0 is the active adapter, the others follow in slot order
+    int slot = -1;
+    if (index == 0) {
+        slot = g_active;
+    } else {
+        uint32_t seen = 0;
+        for (uint32_t i = 0; i < GPU_STATS_MAX_ADAPTERS; ++i) {
+            if ((int)i == g_active || g_slots[i].name[0] == '\0') continue;
+            if (++seen == index) { slot = (int)i; break; }
+        }
+    }
+    if (slot < 0 || !out) return 0;
+    const gpu_stats_slot_t* s = &g_slots[slot];
+    for (size_t n = 0; n < sizeof(out->name); ++n) out->name[n] = s->name[n];
+    out->syncs = s->syncs;
+    out->sync_us = gpu_stats_to_us(s->sync_time);
+    out->sync_max_us = gpu_stats_to_us(s->sync_max);
+    out->draws = s->draws;
+    out->draw_us = gpu_stats_to_us(s->draw_time);
+    out->uploads = s->uploads;
+    out->upload_bytes_last = s->upload_bytes_last;
+    out->upload_bytes = s->upload_bytes;
+    out->bank_switches = s->bank_switches;
+    out->irq_off = s->irq_off;
+    out->irq_off_us = gpu_stats_to_us(s->irq_off_time);
+    out->irq_off_max_us = gpu_stats_to_us(s->irq_off_max);
+    out->vblank_waits = s->vblank_waits;
+    out->vblank_timeouts = s->vblank_timeouts;
+    out->vblank_us = gpu_stats_to_us(s->vblank_time);
+    out->presents = s->presents;
+    return 1;
+}
+
+// "<total> us (avg <a>, max <m>)"
+static void gpu_stats_print_time(uint32_t total_us, uint32_t count, int with_max, uint32_t max_us) {
+    console_write_dec(total_us);
+    console_write(" us");
+    if (count) {
+        console_write(" (avg ");
+        console_write_dec(total_us / count);
+        if (with_max) {
+            console_write(", max ");
+            console_write_dec(max_us);
+        }
+        console_write(")");
+    }
+}
+
+void gpu_stats_print(void) {
+    // Snapshot first: printing on a framebuffer console counts draws and syncs
+    gpu_stats_t snap[GPU_STATS_MAX_ADAPTERS];
+    uint32_t count = 0;
+    while (count < GPU_STATS_MAX_ADAPTERS && gpu_stats_get(count, &snap[count])) count++;
+
+    uint32_t per_ms = 0;
+    const char* clock = gpu_stats_clock_name(&per_ms);
+    console_write("gpustats: clock ");
+    console_write(clock);
+    if (g_clock_tsc) {
+        console_write(" ");
+        console_write_dec(per_ms / 1000u);
+        console_write(" MHz");
+    }
+    console_write("\n");
+
+    for (uint32_t i = 0; i < count; ++i) {
+        const gpu_stats_t* st = &snap[i];
+        console_write(st->name);
+        console_write(i == 0 ? " (active)\n" : "\n");
+        console_write("  sync:    ");
+        console_write_dec(st->syncs);
+        console_write(" calls, ");
+        gpu_stats_print_time(st->sync_us, st->syncs, 1, st->sync_max_us);
+        console_write("\n  draw:    ");
+        console_write_dec(st->draws);
+        console_write(" calls");
+        if (g_clock_tsc) {
+            console_write(", ");
+            gpu_stats_print_time(st->draw_us, 0, 0, 0);
+        }
+        console_write("\n  upload:  ");
+        console_write_dec(st->uploads);
+        console_write(" x, last ");
+        console_write_dec(st->upload_bytes_last);
+        console_write(" bytes, total ");
+        console_write_dec((uint32_t)(st->upload_bytes / 1024u));
+        console_write(" KiB, ");
+        console_write_dec(st->bank_switches);
+        console_write(" bank switches\n  irq off: ");
+        console_write_dec(st->irq_off);
+        console_write(" x, ");
+        gpu_stats_print_time(st->irq_off_us, st->irq_off, 1, st->irq_off_max_us);
+        console_write("\n  vblank:  ");
+        console_write_dec(st->vblank_waits);
+        console_write(" waits (");
+        console_write_dec(st->vblank_timeouts);
+        console_write(" timeouts), ");
+        gpu_stats_print_time(st->vblank_us, st->vblank_waits, 0, 0);
+        console_write("\n  present: ");
+        console_write_dec(st->presents);
+        console_write(" frames\n");
+    }
+    if (count == 0) console_writeln("gpustats: no framebuffer mode set yet");
+}
+
+uint32_t gpu_stats_now(void) {
+    return g_clock_read();
+}
+
+uint32_t gpu_stats_draw_begin(void) {
+    return g_clock_tsc ? g_clock_read() : 0;
+}
+
+void gpu_stats_draw(uint32_t start) {
+    if (g_active < 0) return;
+    gpu_stats_slot_t* s = &g_slots[g_active];
+    s->draws++;
+    if (g_clock_tsc) s->draw_time += g_clock_read() - start;
+}
+
+void gpu_stats_sync(uint32_t start) {
+    if (g_active < 0) return;
+    uint32_t dt = g_clock_read() - start;
+    gpu_stats_slot_t* s = &g_slots[g_active];
+    s->syncs++;
+    s->sync_time += dt;
+    if (dt > s->sync_max) s->sync_max = dt;
+}
+
+void gpu_stats_upload(uint32_t bytes) {
+    if (g_active < 0 || bytes == 0) return;
+    gpu_stats_slot_t* s = &g_slots[g_active];
+    s->uploads++;
+    s->upload_bytes_last = bytes;
+    s->upload_bytes += bytes;
+}
+
+void gpu_stats_bank_switch(void) {
+    if (g_active >= 0) g_slots[g_active].bank_switches++;
+}
+
+void gpu_stats_vblank(uint32_t start, int seen) {
+    if (g_active < 0) return;
+    gpu_stats_slot_t* s = &g_slots[g_active];
+    s->vblank_waits++;
+    if (!seen) s->vblank_timeouts++;
+    s->vblank_time += g_clock_read() - start;
+}
+
+void gpu_stats_present(void) {
+    if (g_active >= 0) g_slots[g_active].presents++;
+}
+
+uint32_t gpu_stats_irq_save(void) {
+    uint32_t flags = interrupts_save_disable();
+    if (g_irq_depth++ == 0) g_irq_start = g_clock_read();
+    return flags;
+}
+
+void gpu_stats_irq_restore(uint32_t flags) {
+    if (g_irq_depth && --g_irq_depth == 0 && g_active >= 0) {
+        uint32_t dt = g_clock_read() - g_irq_start;
+        gpu_stats_slot_t* s = &g_slots[g_active];
+        s->irq_off++;
+        s->irq_off_time += dt;
+        if (dt > s->irq_off_max) s->irq_off_max = dt;
+    }
+    interrupts_restore(flags);
+}
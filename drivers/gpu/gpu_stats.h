@@ -0,0 +1,65 @@
+#ifndef DRIVERS_GPU_GPU_STATS_H
+#define DRIVERS_GPU_GPU_STATS_H
+
+#include <stdint.h>
+
+// Per-adapter counters of the framebuffer stack. gpu_set_last_mode() selects
+// the slot of the adapter that was just switched on (by name); fb_accel, the
+// shadow uploads, the blitter and the retrace waits then count into it, so
+// switching adapters with gpuprobe keeps each one's numbers apart.
+//
+// Times come from a clock hook: the TSC when CPUID reports one (calibrated
+// against the PIT on first use), else platform_time_us(). The PIT clock
+// does not advance while interrupts are off, so without a TSC sections
+// longer than a timer tick are undercounted, and drawing calls are only
+// counted, not timed (reading the PIT costs several port accesses).
+#define GPU_STATS_MAX_ADAPTERS 4u
+
+typedef struct {
+    char     name[32];
+    uint32_t syncs;             // fb_accel_sync calls
+    uint32_t sync_us;           // time inside them
+    uint32_t sync_max_us;
+    uint32_t draws;             // fb_accel drawing calls (fill, copy, expand, pattern, line, scroll)
+    uint32_t draw_us;           // time inside them (TSC clock only)
+    uint32_t uploads;           // shadow uploads that wrote to VRAM
+    uint32_t upload_bytes_last;
+    uint64_t upload_bytes;
+    uint32_t bank_switches;     // 64 KiB window changes during uploads
+    uint32_t irq_off;           // interrupt-off sections of the upload paths
+    uint32_t irq_off_us;
+    uint32_t irq_off_max_us;
+    uint32_t vblank_waits;
+    uint32_t vblank_timeouts;   // waits that gave up without seeing a retrace
+    uint32_t vblank_us;
+    uint32_t presents;          // frames finished through fb_accel_present
+} gpu_stats_t;
+
+// Clock hook: read returns a free-running 32-bit counter, units_per_ms its
+// rate. Intervals are measured as unsigned differences, so they must stay
+// below 2^32 units. NULL restores the default clock.
+typedef uint32_t (*gpu_stats_clock_fn)(void);
+void gpu_stats_set_clock(gpu_stats_clock_fn read, uint32_t units_per_ms);
+// Name of the clock in use ("tsc" or "pit") and its rate
+const char* gpu_stats_clock_name(uint32_t* units_per_ms);
+
+void gpu_stats_select(const char* adapter);
+void gpu_stats_reset(void);
+// Snapshot of slot 'index' (0 = active adapter); 0 if the slot is unused
+int  gpu_stats_get(uint32_t index, gpu_stats_t* out);
+void gpu_stats_print(void);
+
+// Timestamp for the calls below
+uint32_t gpu_stats_now(void);
+uint32_t gpu_stats_draw_begin(void);    // 0 unless drawing is timed
+void gpu_stats_draw(uint32_t start);
+void gpu_stats_sync(uint32_t start);
+void gpu_stats_upload(uint32_t bytes);
+void gpu_stats_bank_switch(void);
+void gpu_stats_vblank(uint32_t start, int seen);
+void gpu_stats_present(void);
+// interrupts_save_disable/interrupts_restore that time the section
+uint32_t gpu_stats_irq_save(void);
+void gpu_stats_irq_restore(uint32_t flags);
+
+#endif // DRIVERS_GPU_GPU_STATS_H
@@ -1,6 +1,9 @@
 #include "smos.h"
 #include "vga_hw.h"
 #include "fb_accel.h"
+#include "fb_dirty.h"
+#include "blit.h"
+#include "gpu_stats.h"
 #include "../../console.h"
 #include "../../config.h"
 #include "../../interrupts.h"
@@ -13,7 +16,8 @@
 
 // Dynamically allocated to avoid clobbering low memory in BSS
 static uint8_t* g_smos_shadow = NULL;
-static int g_smos_dirty = 0;
+static fb_dirty_t g_smos_dirty;
+static gpu_blit_scroll_t g_smos_scroll;
 
 typedef struct {
     uint8_t* buffer;
@@ -40,55 +44,32 @@ static void smos_copy_string(char* dst, uint32_t dst_len, const char* src) {
     dst[i] = '\0';
 }
 
+// Planar upload of the dirty spans (drivers/gpu/blit.c)
 static void smos_shadow_upload(void) {
-    if (!g_smos_dirty || !g_smos_shadow) return;
+    if (!fb_dirty_any(&g_smos_dirty) || !g_smos_shadow) return;
 
-    const uint16_t width = 640;
-    const uint16_t height = 480;
-    const uint32_t pitch = 640;
-    const uint32_t bytes_per_line = width / 8u;
+    gpu_blit_target_t target = { g_smos_shadow, g_smos_fb.pitch, g_smos_vram_window, NULL, 0xFF,
+                                 (uint32_t)g_smos_scroll.top * (g_smos_fb.pitch / 8u) };
+    uint32_t lines = 0;
     
-    uint32_t flags = interrupts_save_disable();
-    
-    for (uint8_t plane = 0; plane < 4; ++plane) {
-        vga_seq_write(0x02, (uint8_t)(1u << plane));
-        vga_gc_write(0x04, plane);
-
-        for (uint16_t y = 0; y < height; ++y) {
-            const uint8_t* src_line = g_smos_shadow + (uint32_t)y * pitch;
-            volatile uint8_t* dst_line = g_smos_vram_window + (uint32_t)y * bytes_per_line;
-            for (uint32_t byte_index = 0; byte_index < bytes_per_line; ++byte_index) {
-                uint8_t packed = 0;
-                const uint32_t pixel_base = byte_index << 3;
-                
-                if (src_line[pixel_base + 0] & (1u << plane)) packed |= 0x80;
-                if (src_line[pixel_base + 1] & (1u << plane)) packed |= 0x40;
-                if (src_line[pixel_base + 2] & (1u << plane)) packed |= 0x20;
-                if (src_line[pixel_base + 3] & (1u << plane)) packed |= 0x10;
-                if (src_line[pixel_base + 4] & (1u << plane)) packed |= 0x08;
-                if (src_line[pixel_base + 5] & (1u << plane)) packed |= 0x04;
-                if (src_line[pixel_base + 6] & (1u << plane)) packed |= 0x02;
-                if (src_line[pixel_base + 7] & (1u << plane)) packed |= 0x01;
-                
-                dst_line[byte_index] = packed;
-            }
-        }
-    }
-    vga_seq_write(0x02, 0x0F);
-    vga_gc_write(0x04, 0x00);
-    
-    g_smos_dirty = 0;
-    interrupts_restore(flags);
+    uint32_t flags = gpu_stats_irq_save();
+    uint32_t bytes = gpu_blit_planar4(&target, &g_smos_dirty, &lines);
+    fb_dirty_clear(&g_smos_dirty);
+    fb_dirty_account(lines, bytes, (g_smos_fb.pitch / 8u) * g_smos_fb.height * 4u);
+    gpu_stats_irq_restore(flags);
 }
 
 static int smos_fb_fill_rect(void* ctx, uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint8_t color) {
-    if (!g_smos_shadow) return 0;
+    (void)ctx;
+    if (!g_smos_shadow || x >= g_smos_fb.width || y >= g_smos_fb.height) return 0;
+    if (width > g_smos_fb.width - x) width = (uint16_t)(g_smos_fb.width - x);
+    if (height > g_smos_fb.height - y) height = (uint16_t)(g_smos_fb.height - y);
     for (uint16_t i = 0; i < height; ++i) {
         for (uint16_t j = 0; j < width; ++j) {
-            g_smos_shadow[(y + i) * 640 + (x + j)] = color;
+            g_smos_shadow[(uint32_t)(y + i) * g_smos_fb.pitch + (x + j)] = color;
         }
     }
-    g_smos_dirty = 1;
+    fb_dirty_mark(&g_smos_dirty, x, y, width, height);
     return 1;
 }
 
@@ -98,14 +79,35 @@ static void smos_fb_sync(void* ctx) {
 }
 
 static void smos_fb_mark_dirty(void* ctx, uint16_t x, uint16_t y, uint16_t width, uint16_t height) {
-    (void)ctx; (void)x; (void)y; (void)width; (void)height;
-    g_smos_dirty = 1;
+    (void)ctx;
+    fb_dirty_mark(&g_smos_dirty, x, y, width, height);
+}
+
+// Hardware scrolling in mode 12h: 64 KiB per plane hold 819 lines of 80 bytes
+static int smos_fb_scroll(void* ctx, uint16_t lines) {
+    (void)ctx;
+    if (!g_smos_shadow || !g_smos_scroll.lines) return 0;
+    smos_shadow_upload();
+    int moved = gpu_blit_scroll(&g_smos_scroll, g_smos_shadow, g_smos_fb.pitch, &g_smos_dirty, lines);
+    if (!moved) return 0;
+    if (moved == 2) smos_shadow_upload();
+    uint32_t flags = interrupts_save_disable();
+    vga_set_start_address((uint32_t)g_smos_scroll.top * (g_smos_fb.pitch / 8u));
+    interrupts_restore(flags);
+    return 1;
 }
 
 static const fb_accel_ops_t g_smos_fb_ops = {
     smos_fb_fill_rect,
     smos_fb_sync,
-    smos_fb_mark_dirty
+    smos_fb_mark_dirty,
+    smos_fb_scroll,
+    NULL,   // copy, expand, pattern, line: fb_accel draws into the shadow
+    NULL,
+    NULL,
+    NULL,
+    NULL,   // set_page, show_page: one page, apps present by upload
+    NULL
 };
 
 int smos_detect(gpu_info_t* out) {
@@ -196,6 +198,13 @@ int smos_set_mode(gpu_info_t* gpu, display_mode_info_t* out_mode, uint16_t width
     g_smos_fb.height = target_h;
     g_smos_fb.pitch = target_w;
     g_smos_fb.bpp = bpp;
+    fb_dirty_init(&g_smos_dirty, target_w, target_h);
+    fb_dirty_mark_all(&g_smos_dirty);
+    g_smos_scroll.top = 0;
+    g_smos_scroll.lines = (bpp == 4)
+        ? gpu_blit_scroll_lines(64u * 1024u, target_w / 8u, target_h, vga_start_address_unit())
+        : 0;
+    vga_set_start_address(0);
     
     fb_accel_register(&g_smos_fb_ops, &g_smos_fb);
 
@@ -213,6 +222,7 @@ int smos_set_mode(gpu_info_t* gpu, display_mode_info_t* out_mode, uint16_t width
     out_mode->pitch = target_w;
     out_mode->phys_base = 0xA0000;
     out_mode->framebuffer = g_smos_shadow;
+    out_mode->set_bank = NULL;
     
     // Explicitly set driver name for the display manager
     for (int i=0; i<32; i++) out_mode->driver_name[i] = gpu->name[i];
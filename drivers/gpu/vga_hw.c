@@ -176,25 +176,45 @@ void vga_dac_reset_text_palette(void) {
 #endif
 }
 
+#if CONFIG_ARCH_X86
+// Status bar gradient, loaded over entries 240-255 of the default palette
+static const uint8_t kDarkRainbow[16][3] = {
+    {0x20,0x04,0x04}, {0x20,0x10,0x04}, {0x20,0x18,0x04}, {0x18,0x20,0x04},
+    {0x08,0x20,0x04}, {0x04,0x20,0x10}, {0x04,0x20,0x18}, {0x04,0x18,0x20},
+    {0x04,0x08,0x20}, {0x10,0x04,0x20}, {0x18,0x04,0x20}, {0x20,0x04,0x18},
+    {0x20,0x04,0x10}, {0x20,0x0C,0x04}, {0x20,0x14,0x04}, {0x18,0x20,0x04}
+};
+#endif
+
 void vga_dac_load_default_palette(void) {
 #if CONFIG_ARCH_X86
     for (uint16_t i = 0; i < 256; i++) {
-        vga_dac_set_entry((uint8_t)i,
-                          VGA_DEFAULT_PALETTE[i][0],
-                          VGA_DEFAULT_PALETTE[i][1],
-                          VGA_DEFAULT_PALETTE[i][2]);
+        uint8_t rgb[3];
+        vga_dac_default_entry((uint8_t)i, rgb);
+        vga_dac_set_entry((uint8_t)i, rgb[0], rgb[1], rgb[2]);
     }
+#endif
+}
 
-    static const uint8_t kDarkRainbow[16][3] = {
-        {0x20,0x04,0x04}, {0x20,0x10,0x04}, {0x20,0x18,0x04}, {0x18,0x20,0x04},
-        {0x08,0x20,0x04}, {0x04,0x20,0x10}, {0x04,0x20,0x18}, {0x04,0x18,0x20},
-        {0x04,0x08,0x20}, {0x10,0x04,0x20}, {0x18,0x04,0x20}, {0x20,0x04,0x18},
-        {0x20,0x04,0x10}, {0x20,0x0C,0x04}, {0x20,0x14,0x04}, {0x18,0x20,0x04}
-    };
-    for (uint8_t i = 0; i < 16; i++) {
-        uint8_t idx = (uint8_t)(240 + i);
-        vga_dac_set_entry(idx, kDarkRainbow[i][0], kDarkRainbow[i][1], kDarkRainbow[i][2]);
-    }
+void vga_dac_default_entry(uint8_t index, uint8_t rgb6[3]) {
+#if CONFIG_ARCH_X86
+    const uint8_t* src = (index >= 240) ? kDarkRainbow[index - 240] : VGA_DEFAULT_PALETTE[index];
+    rgb6[0] = src[0];
+    rgb6[1] = src[1];
+    rgb6[2] = src[2];
+#else
+    rgb6[0] = rgb6[1] = rgb6[2] = (uint8_t)(index >> 2);
+#endif
+}
+
+void vga_dac_write_hidden(uint8_t value) {
+#if CONFIG_ARCH_X86
+    (void)inb(0x3C8);           // resets the read counter
+    for (int i = 0; i < 4; i++) (void)inb(0x3C6);
+    outb(0x3C6, value);
+    (void)inb(0x3C8);
+#else
+    (void)value;
 #endif
 }
 
@@ -233,6 +253,32 @@ void vga_attr_index_write(uint8_t value) {
 #endif
 }
 
+uint32_t vga_start_address_unit(void) {
+    // CR14 bit 6: doubleword addressing, CR17 bit 6: byte (else word) mode
+    if (vga_crtc_read(0x14) & 0x40u) return 4u;
+    return (vga_crtc_read(0x17) & 0x40u) ? 1u : 2u;
+}
+
+void vga_set_start_address(uint32_t byte_offset) {
+    uint32_t address = byte_offset / vga_start_address_unit();
+    vga_crtc_write(0x0C, (uint8_t)((address >> 8) & 0xFFu));
+    vga_crtc_write(0x0D, (uint8_t)(address & 0xFFu));
+}
+
+// Input status 1 (0x3DA), bit 3: vertical retrace in progress
+#define VGA_VRETRACE_POLLS 1000000u
+
+int vga_wait_vretrace(void) {
+#if CONFIG_ARCH_X86
+    uint32_t n = 0;
+    while ((inb(0x3DA) & 0x08u) && ++n < VGA_VRETRACE_POLLS) { }
+    while (!(inb(0x3DA) & 0x08u) && ++n < VGA_VRETRACE_POLLS) { }
+    return n < VGA_VRETRACE_POLLS;
+#else
+    return 0;
+#endif
+}
+
 void vga_set_mode_640x400x256(void) {
 #if CONFIG_ARCH_X86
     vga_misc_write(0x63);
@@ -19,11 +19,24 @@ void    vga_dac_set_entry(uint8_t index, uint8_t r6, uint8_t g6, uint8_t b6);
 void    vga_dac_set_entry_rgb(uint8_t index, uint8_t r8, uint8_t g8, uint8_t b8);
 void    vga_dac_reset_text_palette(void);
 void    vga_dac_load_default_palette(void);
+// 6-bit RGB that vga_dac_load_default_palette() loads into 'index'; direct
+// colour modes draw the palette colours with it
+void    vga_dac_default_entry(uint8_t index, uint8_t rgb6[3]);
+// Hidden DAC command register of Sierra-compatible RAMDACs (Cirrus): four
+// reads of the pixel mask unlock it for the next write
+void    vga_dac_write_hidden(uint8_t value);
 uint8_t vga_pel_mask_read(void);
 void    vga_pel_mask_write(uint8_t value);
 void    vga_attr_mask(uint8_t index, uint8_t mask, uint8_t value);
 void    vga_attr_index_write(uint8_t value);
 void    vga_load_font_8x16(void);
+// CRTC start address (CR0C/CR0D) as a VRAM byte offset; the unit (1, 2 or 4
+// bytes) follows the programmed addressing mode, so 16 bits reach 64-256 KiB
+uint32_t vga_start_address_unit(void);
+void    vga_set_start_address(uint32_t byte_offset);
+// Wait for the start of the next vertical retrace, which also latches a new
+// start address; 0 if no retrace was seen within a bounded number of polls
+int     vga_wait_vretrace(void);
 void vga_set_mode3(void);
 void vga_set_mode13(void);
 
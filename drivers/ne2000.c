@@ -1,13 +1,26 @@
 #include "ne2000.h"
 #include "../arch/x86/io.h"
+#include "../interrupts.h"
 
 #include "../console.h"
+#include <stddef.h>
 
 static uint16_t ne2k_base_io = (uint16_t)CONFIG_NE2000_IO;
 static bool ne2k_use_16bit = (CONFIG_NE2000_PIO_16BIT != 0);
-static const uint8_t NE2K_RX_PSTART = 0x46; // leave 0x40.. for TX
+// NIC buffer RAM: CONFIG_NE2000_TX_SLOTS transmit slots from 0x40, RX ring behind them
+#define NE2K_TX_PSTART     0x40
+#define NE2K_TX_SLOT_PAGES 6    // 1536 bytes, fits a maximum-size Ethernet frame
+static const uint8_t NE2K_RX_PSTART = (uint8_t)(NE2K_TX_PSTART + CONFIG_NE2000_TX_SLOTS * NE2K_TX_SLOT_PAGES);
 static const uint8_t NE2K_RX_PSTOP  = 0x80; // end of 32KiB window
 
+// TX slot ring: 'head' is the slot on the wire (when busy) or next to start;
+// 'count' slots are occupied (in flight + queued).
+static uint16_t ne2k_tx_len[CONFIG_NE2000_TX_SLOTS];
+static uint8_t  ne2k_tx_head;
+static uint8_t  ne2k_tx_count;
+static bool     ne2k_tx_busy;
+static uint32_t ne2k_tx_ok, ne2k_tx_err, ne2k_tx_stalls;
+
 // Forward declarations for statics used before definition
 static bool ne2000_read_mac(uint8_t mac[6]);
 static inline void print_hex8(uint8_t v);
@@ -17,8 +30,11 @@ static volatile uint8_t ne2k_isr_latch;
 
 void ne2000_isr_latch_or(uint8_t bits) { ne2k_isr_latch |= bits; }
 uint8_t ne2000_isr_take(uint8_t mask) {
+    // Read-and-clear must not race IRQ3 or TX completions get lost
+    uint32_t flags = interrupts_save_disable();
     uint8_t v = (uint8_t)(ne2k_isr_latch & mask);
     ne2k_isr_latch = (uint8_t)(ne2k_isr_latch & ~mask);
+    interrupts_restore(flags);
     return v;
 }
 
@@ -102,6 +118,9 @@ bool ne2000_init(void) {
 #endif
     outb(ne2k_base_io + NE2K_REG_RCR, rcr);
 
+    // Reset TX slot bookkeeping
+    ne2k_tx_head = 0; ne2k_tx_count = 0; ne2k_tx_busy = false;
+
     // Program ring buffer boundaries
     outb(ne2k_base_io + NE2K_REG_PSTART, NE2K_RX_PSTART);
     outb(ne2k_base_io + NE2K_REG_PSTOP,  NE2K_RX_PSTOP);
@@ -185,78 +204,76 @@ static bool ne2000_wait_rdc(void) {
             outb(ne2k_base_io + NE2K_REG_ISR, NE2K_ISR_RDC); // ack
             return true;
         }
+        // IRQ3 may have acked RDC together with PTX/PRX; it is then in the latch
+        if (ne2000_isr_take(NE2K_ISR_RDC)) return true;
     }
     return false;
 }
 
-static void ne2000_remote_write(uint16_t dst, const uint8_t* buf, uint16_t len) {
-    // Program remote DMA registers
-    outb(ne2k_base_io + NE2K_REG_RSAR0, (uint8_t)(dst & 0xFF));
-    outb(ne2k_base_io + NE2K_REG_RSAR1, (uint8_t)((dst >> 8) & 0xFF));
+// Program a remote DMA transfer (cmd 0x12 = write, 0x0A = read) of 'count' bytes
+static void ne2000_rdma_start(uint16_t addr, uint16_t count, uint8_t cmd) {
+    outb(ne2k_base_io + NE2K_REG_RSAR0, (uint8_t)(addr & 0xFF));
+    outb(ne2k_base_io + NE2K_REG_RSAR1, (uint8_t)((addr >> 8) & 0xFF));
 
-    uint16_t count = len;
     if (ne2k_use_16bit && (count & 1)) count++; // pad to even bytes for 16-bit
 
     outb(ne2k_base_io + NE2K_REG_RBCR0, (uint8_t)(count & 0xFF));
     outb(ne2k_base_io + NE2K_REG_RBCR1, (uint8_t)((count >> 8) & 0xFF));
 
-    // Clear RDC
+    // Clear RDC (device and latch)
     outb(ne2k_base_io + NE2K_REG_ISR, NE2K_ISR_RDC);
+    (void)ne2000_isr_take(NE2K_ISR_RDC);
 
-    // Start remote DMA write (CR: STA=1, RD=010)
-    outb(ne2k_base_io + NE2K_REG_CMD, 0x12);
+    // Start remote DMA (CR: STA=1, RD=010 write / 001 read)
+    outb(ne2k_base_io + NE2K_REG_CMD, cmd);
+}
+
+// Abort a remote DMA that was programmed longer than what we consumed
+static void ne2000_rdma_abort(void) {
+    outb(ne2k_base_io + NE2K_REG_CMD, 0x22); // STA=1, RD=100
+    outb(ne2k_base_io + NE2K_REG_ISR, NE2K_ISR_RDC);
+    (void)ne2000_isr_take(NE2K_ISR_RDC);
+}
 
+// Read 'len' bytes from the running remote DMA stream.
+// Returns the number of bytes consumed from the NIC (even in 16-bit mode).
+static uint16_t ne2000_pio_in(uint8_t* buf, uint16_t len) {
     if (ne2k_use_16bit) {
-        const uint16_t* p = (const uint16_t*)buf;
         uint16_t words = len >> 1;
-        for (uint16_t i = 0; i < words; i++) {
-            outw(ne2k_base_io + NE2K_REG_DATA, p[i]);
-        }
+        if (words) insw(ne2k_base_io + NE2K_REG_DATA, buf, words);
         if (len & 1) {
-            outb(ne2k_base_io + NE2K_REG_DATA, buf[len - 1]);
-        }
-    } else {
-        for (uint16_t i = 0; i < len; i++) {
-            outb(ne2k_base_io + NE2K_REG_DATA, buf[i]);
+            // Odd tail inside a word stream: fetch the word, keep the low byte
+            buf[len - 1] = (uint8_t)inw(ne2k_base_io + NE2K_REG_DATA);
+            return (uint16_t)(len + 1);
         }
+        return len;
     }
-
-    (void)ne2000_wait_rdc();
+    if (len) insb(ne2k_base_io + NE2K_REG_DATA, buf, len);
+    return len;
 }
 
-static void ne2000_remote_read(uint16_t src, uint8_t* buf, uint16_t len) {
-    outb(ne2k_base_io + NE2K_REG_RSAR0, (uint8_t)(src & 0xFF));
-    outb(ne2k_base_io + NE2K_REG_RSAR1, (uint8_t)((src >> 8) & 0xFF));
-
-    uint16_t count = len;
-    if (ne2k_use_16bit && (count & 1)) count++;
-    outb(ne2k_base_io + NE2K_REG_RBCR0, (uint8_t)(count & 0xFF));
-    outb(ne2k_base_io + NE2K_REG_RBCR1, (uint8_t)((count >> 8) & 0xFF));
-
-    // Clear RDC
-    outb(ne2k_base_io + NE2K_REG_ISR, NE2K_ISR_RDC);
-
-    // Start remote DMA read (CR: STA=1, RD=001)
-    outb(ne2k_base_io + NE2K_REG_CMD, 0x0A);
+static void ne2000_remote_write(uint16_t dst, const uint8_t* buf, uint16_t len) {
+    ne2000_rdma_start(dst, len, 0x12);
 
     if (ne2k_use_16bit) {
-        uint16_t* p = (uint16_t*)buf;
         uint16_t words = len >> 1;
-        for (uint16_t i = 0; i < words; i++) {
-            p[i] = inw(ne2k_base_io + NE2K_REG_DATA);
-        }
+        if (words) outsw(ne2k_base_io + NE2K_REG_DATA, buf, words);
         if (len & 1) {
-            buf[len - 1] = inb(ne2k_base_io + NE2K_REG_DATA);
+            outb(ne2k_base_io + NE2K_REG_DATA, buf[len - 1]);
         }
     } else {
-        for (uint16_t i = 0; i < len; i++) {
-            buf[i] = inb(ne2k_base_io + NE2K_REG_DATA);
-        }
+        if (len) outsb(ne2k_base_io + NE2K_REG_DATA, buf, len);
     }
 
     (void)ne2000_wait_rdc();
 }
 
+static void ne2000_remote_read(uint16_t src, uint8_t* buf, uint16_t len) {
+    ne2000_rdma_start(src, len, 0x0A);
+    (void)ne2000_pio_in(buf, len);
+    (void)ne2000_wait_rdc();
+}
+
 static bool ne2000_read_mac(uint8_t mac[6]) {
     // Many NE2000 clones expose station PROM at 0x0000
     uint8_t tmp[12];
@@ -291,73 +308,149 @@ static void ne2000_dump_eth(const uint8_t* buf, uint16_t len) {
     console_write("\n");
 }
 
-// Upper-layer RX hook (netface will route to net stack)
-extern void netface_on_rx(const uint8_t* frame, uint16_t len);
+// Upper-layer RX hook: netface_on_rx() (netface will route to net stack)
 
-static void ne2000_drain_rx(int verbose) {
-    // Read boundary and current pointers
-    uint8_t bnry = inb(ne2k_base_io + NE2K_REG_BNRY);
-    // Switch to Page 1 to read CURR
+#define NE2K_RX_BUF_LEN 1600
+static uint8_t  ne2k_rxbuf[NE2K_RX_BUF_LEN];
+static uint32_t ne2k_rx_frames, ne2k_rx_bytes, ne2k_rx_batches, ne2k_rx_oversize, ne2k_rx_resync;
+
+static uint8_t ne2000_read_curr(void) {
+    // IRQ3 touches ISR (page 0, offset 7 == CURR on page 1): keep it out while on page 1
+    uint32_t flags = interrupts_save_disable();
     uint8_t cr = inb(ne2k_base_io + NE2K_REG_CMD);
-    outb(ne2k_base_io + NE2K_REG_CMD, (uint8_t)((cr & 0x3F) | (1u<<6)));
-    uint8_t curr = inb(ne2k_base_io + 0x07);
-    // Back to Page 0
-    outb(ne2k_base_io + NE2K_REG_CMD, (uint8_t)(cr & 0x3F));
+    outb(ne2k_base_io + NE2K_REG_CMD, (uint8_t)((cr & 0x3F) | (1u<<6))); // PS=1
+    uint8_t curr = inb(ne2k_base_io + NE2K_P1_CURR);
+    outb(ne2k_base_io + NE2K_REG_CMD, (uint8_t)(cr & 0x3F));             // back to Page 0
+    interrupts_restore(flags);
+    return curr;
+}
+
+// Receive the frame whose 4-byte header sits at 'page'. Header and payload
+// come out of one remote-DMA burst; a frame that wraps at PSTOP is finished
+// with a second burst from PSTART. Returns the next packet page, or 0 if the
+// header is corrupt.
+static uint8_t ne2000_rx_frame(uint8_t page, int verbose) {
+    uint16_t hdr_addr = ((uint16_t)page) << 8;
+    uint16_t to_wrap  = (uint16_t)(((uint16_t)(NE2K_RX_PSTOP - page)) << 8); // bytes until PSTOP
+
+    // Program the burst for the largest frame we accept, capped at the ring end
+    uint16_t want = (uint16_t)(4 + NE2K_RX_BUF_LEN);
+    if (want > to_wrap) want = to_wrap;
+    ne2000_rdma_start(hdr_addr, want, 0x0A);
+
+    uint8_t hdr[4];
+    uint16_t used = ne2000_pio_in(hdr, 4);
+    uint8_t next = hdr[1];
+    uint16_t count = (uint16_t)hdr[2] | ((uint16_t)hdr[3] << 8);
+    if (!(hdr[0] & 0x01) || next < NE2K_RX_PSTART || next >= NE2K_RX_PSTOP || count < 4) {
+        ne2000_rdma_abort();
+        return 0;
+    }
 
-    while (bnry != (uint8_t)(curr - 1 == 0xFF ? (NE2K_RX_PSTOP - 1) : (curr - 1))) {
-        uint8_t packet_page = (uint8_t)(bnry + 1);
-        if (packet_page >= NE2K_RX_PSTOP) packet_page = NE2K_RX_PSTART;
-        uint16_t hdr_addr = ((uint16_t)packet_page) << 8;
-
-        uint8_t hdr[4];
-        ne2000_remote_read(hdr_addr, hdr, 4);
-        uint8_t next = hdr[1];
-        uint16_t count = (uint16_t)hdr[2] | ((uint16_t)hdr[3] << 8);
-
-        // Read payload (data + CRC) minimally or fully and hand to stack
-        uint16_t payload_addr = hdr_addr + 4;
-        uint16_t total = count; // data + 4B FCS
-        uint16_t dlen = (total >= 4) ? (uint16_t)(total - 4) : total;
-        if (dlen >= 14) {
-            if (verbose || dlen <= 1600) {
-                uint16_t copy = dlen > 1600 ? 1600 : dlen;
-                static uint8_t rxbuf[1600];
-                ne2000_remote_read(payload_addr, rxbuf, copy);
-                if (verbose) ne2000_dump_eth(rxbuf, (uint16_t)(copy < 64 ? copy : 64));
-                // Pass full frame (without FCS) if small enough; else skip callback to avoid truncation
-                if (dlen <= 1600) {
-                    netface_on_rx(rxbuf, dlen);
-                }
-            }
+    uint16_t dlen = (uint16_t)(count - 4); // data after the header
+    if (dlen > NE2K_RX_BUF_LEN) {
+        ne2000_rdma_abort();
+        ne2k_rx_oversize++;
+        return next;
+    }
+
+    uint16_t first = dlen;
+    if ((uint32_t)4 + dlen > to_wrap) first = (uint16_t)(to_wrap - 4);
+    used = (uint16_t)(used + ne2000_pio_in(ne2k_rxbuf, first));
+    if (used >= want) (void)ne2000_wait_rdc(); else ne2000_rdma_abort();
+
+    if (first < dlen) {
+        // Wrapped: remainder starts at the beginning of the ring
+        ne2000_remote_read(((uint16_t)NE2K_RX_PSTART) << 8, ne2k_rxbuf + first, (uint16_t)(dlen - first));
+    }
+
+    if (dlen >= 14) {
+        ne2k_rx_frames++;
+        ne2k_rx_bytes += dlen;
+        if (verbose) ne2000_dump_eth(ne2k_rxbuf, (uint16_t)(dlen < 64 ? dlen : 64));
+        netface_on_rx(ne2k_rxbuf, dlen);
+    }
+    return next;
+}
+
+int ne2000_rx_batch(int budget, int verbose) {
+    uint8_t bnry = inb(ne2k_base_io + NE2K_REG_BNRY);
+    // Snapshot CURR once; only re-read it when the snapshot is used up
+    uint8_t curr = ne2000_read_curr();
+    int n = 0;
+
+    while (n < budget) {
+        uint8_t page = (uint8_t)(bnry + 1);
+        if (page >= NE2K_RX_PSTOP) page = NE2K_RX_PSTART;
+        if (page == curr) {
+            curr = ne2000_read_curr();
+            if (page == curr) break;
         }
 
-        // Advance BNRY to previous page of 'next'
-        uint8_t new_bnry = (next == NE2K_RX_PSTART) ? (NE2K_RX_PSTOP - 1) : (uint8_t)(next - 1);
-        outb(ne2k_base_io + NE2K_REG_BNRY, new_bnry);
-        bnry = new_bnry;
+        uint8_t next = ne2000_rx_frame(page, verbose);
+        if (!next) {
+            // Corrupt header: drop everything up to CURR and resynchronize
+            ne2k_rx_resync++;
+            curr = ne2000_read_curr();
+            next = curr;
+        }
+
+        // Advance BNRY to the page before 'next'
+        bnry = (next == NE2K_RX_PSTART) ? (uint8_t)(NE2K_RX_PSTOP - 1) : (uint8_t)(next - 1);
+        outb(ne2k_base_io + NE2K_REG_BNRY, bnry);
+        n++;
+    }
 
-        // Refresh CURR for looping
-        cr = inb(ne2k_base_io + NE2K_REG_CMD);
-        outb(ne2k_base_io + NE2K_REG_CMD, (uint8_t)((cr & 0x3F) | (1u<<6)));
-        curr = inb(ne2k_base_io + 0x07);
-        outb(ne2k_base_io + NE2K_REG_CMD, (uint8_t)(cr & 0x3F));
+    if (n) ne2k_rx_batches++;
+    if (n < budget) {
+        // Ring drained: ack PRX if set
+        uint8_t isr = inb(ne2k_base_io + NE2K_REG_ISR);
+        if (isr & NE2K_ISR_PRX) outb(ne2k_base_io + NE2K_REG_ISR, NE2K_ISR_PRX);
+    } else {
+        // Budget used up: keep PRX pending so the next service call continues
+        ne2000_isr_latch_or(NE2K_ISR_PRX);
     }
+    return n;
+}
 
-    // Ack PRX if set
-    uint8_t isr = inb(ne2k_base_io + NE2K_REG_ISR);
-    if (isr & NE2K_ISR_PRX) outb(ne2k_base_io + NE2K_REG_ISR, NE2K_ISR_PRX);
+void ne2000_rx_stats(uint32_t* frames, uint32_t* bytes, uint32_t* batches, uint32_t* oversize, uint32_t* resync) {
+    if (frames) *frames = ne2k_rx_frames;
+    if (bytes) *bytes = ne2k_rx_bytes;
+    if (batches) *batches = ne2k_rx_batches;
+    if (oversize) *oversize = ne2k_rx_oversize;
+    if (resync) *resync = ne2k_rx_resync;
 }
 
 void ne2000_poll_rx(void) { // verbose variant for netrxdump
-    ne2000_drain_rx(1);
+    (void)ne2000_rx_batch(CONFIG_NE2000_RX_BUDGET, 1);
 }
 
 void ne2000_service(void) {
+    // Retire finished transmissions and start queued slots
+    ne2000_tx_reap();
     // Take and clear latched IRQ bits from IRQ3
     uint8_t pending = ne2000_isr_take((uint8_t)(NE2K_ISR_PRX | NE2K_ISR_RXE | NE2K_ISR_OVW | NE2K_ISR_CNT));
     if (!pending) return;
-    // Drain RX ring; background printing depends on config
-    ne2000_drain_rx(CONFIG_NET_RX_DEBUG);
+    // Drain a bounded batch of the RX ring; background printing depends on config
+    (void)ne2000_rx_batch(CONFIG_NE2000_RX_BUDGET, CONFIG_NET_RX_DEBUG);
+}
+
+// RX interrupt gating for the netface poll scheduler (TX completions stay enabled)
+void ne2000_rx_irq_enable(bool on) {
+    uint8_t imr = (uint8_t)(NE2K_ISR_PTX | NE2K_ISR_TXE);
+    if (on) imr |= (uint8_t)(NE2K_ISR_PRX | NE2K_ISR_RXE);
+    outb(ne2k_base_io + NE2K_REG_IMR, imr);
+}
+
+bool ne2000_rx_irq_take(void) {
+    return ne2000_isr_take((uint8_t)(NE2K_ISR_PRX | NE2K_ISR_RXE | NE2K_ISR_OVW | NE2K_ISR_CNT)) != 0;
+}
+
+void ne2000_shutdown(void) {
+    if (!ne2k_base_io) return;
+    outb(ne2k_base_io + NE2K_REG_IMR, 0x00);
+    outb(ne2k_base_io + NE2K_REG_CMD, 0x21);            // STP=1, RD=100 (abort DMA)
+    outb(ne2k_base_io + NE2K_REG_ISR, 0xFF);
 }
 
 void ne2000_irq(void) {
@@ -373,12 +466,14 @@ void ne2000_irq(void) {
 
 bool ne2000_get_mac(uint8_t mac[6]) {
     if (!ne2k_base_io) return false;
+    uint32_t flags = interrupts_save_disable();
     uint8_t cr = inb(ne2k_base_io + NE2K_REG_CMD);
     outb(ne2k_base_io + NE2K_REG_CMD, (uint8_t)((cr & 0x3F) | (1u<<6))); // PS=1
     for (int i = 0; i < 6; i++) {
         mac[i] = inb(ne2k_base_io + NE2K_P1_PAR0 + i);
     }
     outb(ne2k_base_io + NE2K_REG_CMD, (uint8_t)(cr & 0x3F));
+    interrupts_restore(flags);
     // Basic sanity (not all 0x00)
     int sum = 0; for (int i=0;i<6;i++) sum |= mac[i];
     if (sum == 0) {
@@ -394,40 +489,85 @@ bool ne2000_is_promisc(void) {
     return (rcr & 0x10) != 0; // PRO bit
 }
 
-bool ne2000_send(const uint8_t* frame, uint16_t len) {
-    if (len < 60) len = 60; // Minimum Ethernet frame length (without FCS)
-
-    const uint8_t tpsr = 0x40;             // Transmit page start
-    const uint16_t dst = ((uint16_t)tpsr) << 8; // Memory address in NIC RAM
-
-    // Copy frame into NIC RAM via remote DMA write (waits for RDC)
-    ne2000_remote_write(dst, frame, len);
-
-    // Program transmitter
+static void ne2000_tx_start(uint8_t slot) {
+    uint8_t tpsr = (uint8_t)(NE2K_TX_PSTART + slot * NE2K_TX_SLOT_PAGES);
+    uint16_t len = ne2k_tx_len[slot];
     outb(ne2k_base_io + NE2K_REG_TPSR, tpsr);
     outb(ne2k_base_io + NE2K_REG_TBCR0, (uint8_t)(len & 0xFF));
     outb(ne2k_base_io + NE2K_REG_TBCR1, (uint8_t)((len >> 8) & 0xFF));
 
-    // Clear pending TX bits (ISR) and latch
+    // Clear stale TX bits (ISR) and latch; the next PTX/TXE belongs to this slot
     outb(ne2k_base_io + NE2K_REG_ISR, 0x0A); // PTX | TXE
     (void)ne2000_isr_take(NE2K_ISR_PTX | NE2K_ISR_TXE);
 
-    // Start transmitter (CR: STA=1, TXP=1)
-    outb(ne2k_base_io + NE2K_REG_CMD, 0x06);
+    // Start transmitter (CR: STA=1, TXP=1, RD=100 no remote DMA)
+    outb(ne2k_base_io + NE2K_REG_CMD, 0x26);
+    ne2k_tx_busy = true;
+}
 
-    // Wait for completion: prefer IRQ latch, fallback to polling NIC ISR
-    for (int i = 0; i < 65535; i++) {
-        uint8_t lat = ne2000_isr_take((uint8_t)(NE2K_ISR_PTX | NE2K_ISR_TXE));
-        if (lat) {
-            return (lat & NE2K_ISR_PTX) != 0;
-        }
+static void ne2000_tx_complete(uint8_t bits) {
+    if (!ne2k_tx_busy) return;
+    if (bits & NE2K_ISR_PTX) ne2k_tx_ok++; else ne2k_tx_err++;
+    ne2k_tx_busy = false;
+    ne2k_tx_head = (uint8_t)((ne2k_tx_head + 1) % CONFIG_NE2000_TX_SLOTS);
+    ne2k_tx_count--;
+    // Hand the next queued slot to the transmitter right away
+    if (ne2k_tx_count) ne2000_tx_start(ne2k_tx_head);
+}
+
+void ne2000_tx_reap(void) {
+    if (!ne2k_tx_busy) {
+        (void)ne2000_isr_take(NE2K_ISR_PTX | NE2K_ISR_TXE);
+        return;
+    }
+    // Prefer bits latched by IRQ3; fall back to NIC ISR when IRQs are masked
+    uint8_t bits = ne2000_isr_take((uint8_t)(NE2K_ISR_PTX | NE2K_ISR_TXE));
+    if (!bits) {
         uint8_t isr = inb(ne2k_base_io + NE2K_REG_ISR);
         if (isr & 0x0A) {
             outb(ne2k_base_io + NE2K_REG_ISR, (uint8_t)(isr & 0x0A));
-            return (isr & 0x02) != 0;
+            bits = (uint8_t)(isr & 0x0A);
         }
     }
-    return false;
+    if (bits) ne2000_tx_complete(bits);
+}
+
+uint8_t ne2000_tx_pending(void) { return ne2k_tx_count; }
+uint8_t ne2000_tx_capacity(void) { return (uint8_t)CONFIG_NE2000_TX_SLOTS; }
+
+void ne2000_tx_stats(uint32_t* ok, uint32_t* err, uint32_t* stalls) {
+    if (ok) *ok = ne2k_tx_ok;
+    if (err) *err = ne2k_tx_err;
+    if (stalls) *stalls = ne2k_tx_stalls;
+}
+
+bool ne2000_send(const uint8_t* frame, uint16_t len) {
+    if (len < 60) len = 60; // Minimum Ethernet frame length (without FCS)
+    if (len > NE2K_TX_SLOT_PAGES * 256) return false;
+
+    ne2000_tx_reap();
+    if (ne2k_tx_count >= CONFIG_NE2000_TX_SLOTS) {
+        // Every slot is occupied: wait (bounded) for the frame on the wire
+        ne2k_tx_stalls++;
+        for (int i = 0; i < 65535 && ne2k_tx_count >= CONFIG_NE2000_TX_SLOTS; i++) {
+            ne2000_tx_reap();
+        }
+        if (ne2k_tx_count >= CONFIG_NE2000_TX_SLOTS) {
+            // No PTX/TXE seen; if CR.TXP dropped the transmitter is done anyway
+            if (inb(ne2k_base_io + NE2K_REG_CMD) & 0x04) return false;
+            ne2000_tx_complete(NE2K_ISR_TXE);
+        }
+    }
+
+    // Copy into the next free slot; the previous frame may still be on the wire
+    uint8_t slot = (uint8_t)((ne2k_tx_head + ne2k_tx_count) % CONFIG_NE2000_TX_SLOTS);
+    uint16_t dst = (uint16_t)((NE2K_TX_PSTART + slot * NE2K_TX_SLOT_PAGES) << 8);
+    ne2000_remote_write(dst, frame, len);
+    ne2k_tx_len[slot] = len;
+    ne2k_tx_count++;
+
+    if (!ne2k_tx_busy) ne2000_tx_start(ne2k_tx_head);
+    return true;
 }
 
 bool ne2000_send_test(void) {
@@ -455,3 +595,84 @@ bool ne2000_send_test(void) {
     console_write(ok ? "Sent test frame.\n" : "Send failed.\n");
     return ok;
 }
+
+// --- netface glue ---
+
+static uint8_t ne2000_irq_line(void) { return (uint8_t)CONFIG_NE2000_IRQ; }
+
+static void ne2000_nf_stats(netface_stats_t* out) {
+    uint32_t oversize, resync;
+    ne2000_rx_stats(&out->rx_frames, &out->rx_bytes, NULL, &oversize, &resync);
+    out->rx_errors = oversize + resync;
+    ne2000_tx_stats(&out->tx_ok, &out->tx_err, &out->tx_stalls);
+}
+
+static void ne2000_nf_diag(void) {
+    console_write("io=");
+    console_write_hex16(ne2000_io_base());
+    console_write(" irq=");
+    console_write_dec(CONFIG_NE2000_IRQ);
+    console_write(" promisc=");
+    console_write(ne2000_is_promisc()?"on":"off");
+    // Link/Speed (NE2000 class)
+    console_write(" link=unknown speed=10Mbps (NE2000-class)\n");
+    // TX slot ring
+    uint32_t ok, err, stalls;
+    ne2000_tx_stats(&ok, &err, &stalls);
+    console_write("tx: slots=");
+    console_write_dec(ne2000_tx_capacity());
+    console_write(" pending=");
+    console_write_dec(ne2000_tx_pending());
+    console_write(" ok=");
+    console_write_dec(ok);
+    console_write(" err=");
+    console_write_dec(err);
+    console_write(" stalls=");
+    console_write_dec(stalls);
+    console_write("\n");
+    // RX ring
+    uint32_t frames, bytes, batches, oversize, resync;
+    ne2000_rx_stats(&frames, &bytes, &batches, &oversize, &resync);
+    console_write("rx: frames=");
+    console_write_dec(frames);
+    console_write(" bytes=");
+    console_write_dec(bytes);
+    console_write(" batches=");
+    console_write_dec(batches);
+    console_write(" oversize=");
+    console_write_dec(oversize);
+    console_write(" resync=");
+    console_write_dec(resync);
+    console_write("\n");
+}
+
+static void ne2000_nf_bootinfo(void) {
+    console_write(" promisc=");
+    console_write(ne2000_is_promisc()?"on":"off");
+    console_write(" io=");
+    console_write_hex16(ne2000_io_base());
+}
+
+const netface_ops_t ne2000_netface_ops = {
+    .name = "NE2000",
+    .caps = 0,
+    .rx_budget = CONFIG_NE2000_RX_BUDGET,
+    .present = ne2000_present,
+    .init = ne2000_init,
+    .send = ne2000_send,
+    .tx_reap = ne2000_tx_reap,
+    .tx_pending = ne2000_tx_pending,
+    .tx_capacity = ne2000_tx_capacity,
+    .rx_batch = ne2000_rx_batch,
+    .rx_irq_enable = ne2000_rx_irq_enable,
+    .rx_irq_take = ne2000_rx_irq_take,
+    .irq = ne2000_irq,
+    .irq_line = ne2000_irq_line,
+    .shutdown = ne2000_shutdown,
+    .get_mac = ne2000_get_mac,
+    .stats = ne2000_nf_stats,
+    .poll_rx = ne2000_poll_rx,
+    .send_test = ne2000_send_test,
+    .diag = ne2000_nf_diag,
+    .bootinfo = ne2000_nf_bootinfo,
+};
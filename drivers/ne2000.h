@@ -4,6 +4,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "../netface.h"
 
 // NE2000 (DP8390) register offsets relative to I/O base
 #define NE2K_REG_CMD    0x00
@@ -50,13 +51,22 @@ bool ne2000_send_test(void);
 void ne2000_poll_rx(void);
 // IRQ ack/latch (called from top-level IRQ handler via netface)
 void ne2000_irq(void);
+// STOP command with remote DMA aborted, all IRQs masked
+void ne2000_shutdown(void);
 
 // Diagnostics
 bool ne2000_get_mac(uint8_t mac[6]);
 bool ne2000_is_promisc(void);
-// Transmit a raw Ethernet frame (len >= 60, FCS appended by NIC). Returns true on success.
+// Queue a raw Ethernet frame (len >= 60, FCS appended by NIC) into a free TX slot.
+// Returns true once the frame is queued/on the wire; completion is reaped later.
 bool ne2000_send(const uint8_t* frame, uint16_t len);
 
+// TX completion (PTX/TXE from IRQ latch or ISR) and slot queue depth
+void ne2000_tx_reap(void);
+uint8_t ne2000_tx_pending(void);
+uint8_t ne2000_tx_capacity(void);
+void ne2000_tx_stats(uint32_t* ok, uint32_t* err, uint32_t* stalls);
+
 // IRQ cooperation: latch NIC ISR bits seen in IRQ3
 void ne2000_isr_latch_or(uint8_t bits);
 uint8_t ne2000_isr_take(uint8_t mask);
@@ -64,4 +74,15 @@ uint8_t ne2000_isr_take(uint8_t mask);
 // Background service: handle latched IRQ events, drain RX ring
 void ne2000_service(void);
 
+// Process up to 'budget' received frames (one remote-DMA burst each).
+// Returns the number of frames taken off the ring.
+int ne2000_rx_batch(int budget, int verbose);
+// RX interrupt gating (IMR.PRX/RXE) and "RX event latched since last take"
+void ne2000_rx_irq_enable(bool on);
+bool ne2000_rx_irq_take(void);
+void ne2000_rx_stats(uint32_t* frames, uint32_t* bytes, uint32_t* batches, uint32_t* oversize, uint32_t* resync);
+
+// netface driver table (netface.c probe list)
+extern const netface_ops_t ne2000_netface_ops;
+
 #endif // NE2000_H
@@ -0,0 +1,373 @@
+#include "rtl8139.h"
+#include "pci.h"
+#include "../arch/x86/io.h"
+#include "../interrupts.h"
+#include "../memory.h"
+#include "../console.h"
+#include <stddef.h>
+
+// RX ring: 8/16/32/64 KiB (RCR.RBLEN) plus 16 bytes the NIC requires and,
+// with RCR.WRAP set, room for one frame written past the end so every frame
+// is contiguous in memory.
+#define RTL_RX_RING     CONFIG_RTL8139_RX_RING
+#define RTL_RX_ALLOC    (RTL_RX_RING + 16u + 1536u)
+#define RTL_TX_DESC     4u
+#define RTL_TX_BUF      1536u
+#define RTL_RX_BITS     (RTL_INT_ROK | RTL_INT_RER | RTL_INT_RXOVW | RTL_INT_FOVW)
+#define RTL_TX_BITS     (RTL_INT_TOK | RTL_INT_TER)
+
+#if RTL_RX_RING == 8192
+#define RTL_RCR_RBLEN 0u
+#elif RTL_RX_RING == 16384
+#define RTL_RCR_RBLEN 1u
+#elif RTL_RX_RING == 32768
+#define RTL_RCR_RBLEN 2u
+#elif RTL_RX_RING == 65536
+#define RTL_RCR_RBLEN 3u
+#else
+#error "CONFIG_RTL8139_RX_RING must be 8192, 16384, 32768 or 65536"
+#endif
+
+static pci_device_t* rtl_dev;
+static uint16_t rtl_io;
+static uint8_t* rtl_rx;           // RX ring (identity mapped: virtual == physical)
+static uint8_t* rtl_tx;           // RTL_TX_DESC buffers of RTL_TX_BUF bytes
+static uint32_t rtl_rx_off;       // our read offset in the ring
+static uint8_t  rtl_tx_head, rtl_tx_count;
+static volatile uint16_t rtl_isr_latch;
+static uint32_t rtl_tx_ok, rtl_tx_err, rtl_tx_stalls;
+static uint32_t rtl_rx_frames, rtl_rx_bytes, rtl_rx_batches, rtl_rx_errors, rtl_rx_overflows;
+
+static uint16_t rtl8139_isr_take(uint16_t mask) {
+    uint32_t flags = interrupts_save_disable();
+    uint16_t v = (uint16_t)(rtl_isr_latch & mask);
+    rtl_isr_latch = (uint16_t)(rtl_isr_latch & ~mask);
+    interrupts_restore(flags);
+    return v;
+}
+
+static inline void print_hex8(uint8_t v) {
+    const char* hexd = "0123456789ABCDEF";
+    char s[3]; s[0]=hexd[(v>>4)&0xF]; s[1]=hexd[v&0xF]; s[2]=0; console_write(s);
+}
+
+bool rtl8139_present(void) {
+    if (!rtl_dev) rtl_dev = pci_find_device(RTL8139_VENDOR_ID, RTL8139_DEVICE_ID);
+    if (!rtl_dev) return false;
+    const pci_bar_info_t* bar = &rtl_dev->bars[0];
+    return (bar->raw & 0x1u) && bar->base != 0;   // BAR0 is the I/O window
+}
+
+uint16_t rtl8139_io_base(void) { return rtl_io; }
+uint8_t rtl8139_irq_line(void) {
+    if (!rtl_dev || rtl_dev->interrupt_line == 0 || rtl_dev->interrupt_line >= 16) return 0;
+    return rtl_dev->interrupt_line;
+}
+
+static void rtl8139_rx_program(void) {
+    rtl_rx_off = 0;
+    outl(rtl_io + RTL_REG_RBSTART, (uint32_t)(uintptr_t)rtl_rx);
+    outw(rtl_io + RTL_REG_CAPR, (uint16_t)(0u - 16u));
+    // AB|AM|APM (+AAP), WRAP, RBLEN, MXDMA unlimited, RXFTH none (whole frame)
+    uint32_t rcr = 0x0Eu | 0x80u | (RTL_RCR_RBLEN << 11) | (7u << 8) | (7u << 13);
+#if CONFIG_NET_PROMISC
+    rcr |= 0x01u;
+#endif
+    outl(rtl_io + RTL_REG_RCR, rcr);
+}
+
+bool rtl8139_init(void) {
+    if (!rtl8139_present()) {
+        console_write("RTL8139 not detected.\n");
+        return false;
+    }
+    rtl_io = (uint16_t)rtl_dev->bars[0].base;
+
+    // I/O decoding and bus mastering (the NIC DMAs into our rings)
+    uint16_t cmd = pci_config_read16(rtl_dev->bus, rtl_dev->device, rtl_dev->function, 0x04);
+    pci_config_write16(rtl_dev->bus, rtl_dev->device, rtl_dev->function, 0x04, (uint16_t)(cmd | 0x0005u));
+
+    console_write("RTL8139 at "); console_write_hex16(rtl_io);
+    console_write(" irq "); console_write_dec(rtl8139_irq_line()); console_write(".\n");
+
+    if (!rtl_rx) rtl_rx = (uint8_t*)memory_alloc_aligned(RTL_RX_ALLOC, 16);
+    if (!rtl_tx) rtl_tx = (uint8_t*)memory_alloc_aligned(RTL_TX_DESC * RTL_TX_BUF, 16);
+    if (!rtl_rx || !rtl_tx) {
+        console_write("RTL8139: no memory for DMA rings.\n");
+        return false;
+    }
+
+    outb(rtl_io + RTL_REG_CONFIG1, 0x00);          // wake from LWAKE/low power
+    outb(rtl_io + RTL_REG_CR, RTL_CR_RST);
+    for (int i = 0; i < 100000 && (inb(rtl_io + RTL_REG_CR) & RTL_CR_RST); i++) io_delay();
+    if (inb(rtl_io + RTL_REG_CR) & RTL_CR_RST) {
+        console_write("RTL8139: reset timeout.\n");
+        return false;
+    }
+
+    outw(rtl_io + RTL_REG_IMR, 0);
+    outw(rtl_io + RTL_REG_ISR, 0xFFFF);
+    for (uint32_t i = 0; i < RTL_TX_DESC; i++)
+        outl(rtl_io + RTL_REG_TSAD0 + i * 4u, (uint32_t)(uintptr_t)(rtl_tx + i * RTL_TX_BUF));
+    rtl_tx_head = 0; rtl_tx_count = 0;
+
+    outb(rtl_io + RTL_REG_CR, RTL_CR_RE | RTL_CR_TE);
+    rtl8139_rx_program();
+    outl(rtl_io + RTL_REG_TCR, 0x03000600u);       // standard IFG, MXDMA 1024 bytes
+    outl(rtl_io + RTL_REG_MPC, 0);
+    outw(rtl_io + RTL_REG_IMR, (uint16_t)(RTL_RX_BITS | RTL_TX_BITS));
+
+    uint8_t mac[6];
+    rtl8139_get_mac(mac);
+    console_write("NIC MAC: ");
+    for (int i = 0; i < 6; i++) { if (i) console_write(":"); print_hex8(mac[i]); }
+    console_write("\n");
+    return true;
+}
+
+// After RER/FOVW the ring position is not trustworthy: restart the receiver
+static void rtl8139_rx_reset(void) {
+    rtl_rx_errors++;
+    outb(rtl_io + RTL_REG_CR, RTL_CR_TE);
+    outb(rtl_io + RTL_REG_CR, RTL_CR_RE | RTL_CR_TE);
+    rtl8139_rx_program();
+}
+
+int rtl8139_rx_batch(int budget, int verbose) {
+    if (!rtl_io) return 0;
+    // Ack RX events first: frames arriving from here on raise ROK again
+    outw(rtl_io + RTL_REG_ISR, RTL_RX_BITS);
+    int n = 0;
+    while (n < budget && !(inb(rtl_io + RTL_REG_CR) & RTL_CR_BUFE)) {
+        volatile const uint8_t* h = rtl_rx + rtl_rx_off;
+        uint16_t status = (uint16_t)(h[0] | (h[1] << 8));
+        uint16_t count  = (uint16_t)(h[2] | (h[3] << 8));  // includes the 4-byte CRC
+        if (count == 0xFFF0u) break;                        // header written, DMA still running
+        if (!(status & 0x0001u) || count < 64u || count > 1518u) {
+            rtl8139_rx_reset();
+            break;
+        }
+        __asm__ volatile ("" ::: "memory");
+        uint16_t dlen = (uint16_t)(count - 4u);
+        rtl_rx_frames++;
+        rtl_rx_bytes += dlen;
+        const uint8_t* frame = rtl_rx + rtl_rx_off + 4u;   // contiguous thanks to RCR.WRAP
+        if (verbose) {
+            uint16_t eth = (uint16_t)((frame[12] << 8) | frame[13]);
+            console_write("RX eth=0x"); console_write_hex16(eth);
+            console_write(" len="); console_write_dec(dlen); console_write("\n");
+        }
+        netface_on_rx(frame, dlen);
+
+        rtl_rx_off = (rtl_rx_off + count + 4u + 3u) & ~3u;
+        if (rtl_rx_off >= RTL_RX_RING) rtl_rx_off -= RTL_RX_RING;
+        outw(rtl_io + RTL_REG_CAPR, (uint16_t)(rtl_rx_off - 16u));
+        n++;
+    }
+    if (n) rtl_rx_batches++;
+    return n;
+}
+
+void rtl8139_rx_stats(uint32_t* frames, uint32_t* bytes, uint32_t* batches, uint32_t* errors, uint32_t* overflows) {
+    if (frames) *frames = rtl_rx_frames;
+    if (bytes) *bytes = rtl_rx_bytes;
+    if (batches) *batches = rtl_rx_batches;
+    if (errors) *errors = rtl_rx_errors;
+    if (overflows) *overflows = rtl_rx_overflows;
+}
+
+void rtl8139_poll_rx(void) {
+    (void)rtl8139_rx_batch(CONFIG_RTL8139_RX_BUDGET, 1);
+}
+
+void rtl8139_rx_irq_enable(bool on) {
+    if (!rtl_io) return;
+    outw(rtl_io + RTL_REG_IMR, (uint16_t)(RTL_TX_BITS | (on ? RTL_RX_BITS : 0)));
+}
+
+bool rtl8139_rx_irq_take(void) {
+    uint16_t bits = rtl8139_isr_take(RTL_RX_BITS);
+    // Without a routed IRQ line nothing latches: look at the NIC directly
+    if (!bits && rtl_io) bits = (uint16_t)(inw(rtl_io + RTL_REG_ISR) & RTL_RX_BITS);
+    if (bits & (RTL_INT_RXOVW | RTL_INT_FOVW)) rtl_rx_overflows++;
+    return bits != 0;
+}
+
+void rtl8139_shutdown(void) {
+    if (!rtl_io) return;
+    outw(rtl_io + RTL_REG_IMR, 0);
+    outb(rtl_io + RTL_REG_CR, 0);
+    outb(rtl_io + RTL_REG_CR, RTL_CR_RST);
+    for (int i = 0; i < 100000 && (inb(rtl_io + RTL_REG_CR) & RTL_CR_RST); i++) io_delay();
+    outw(rtl_io + RTL_REG_ISR, 0xFFFF);
+}
+
+void rtl8139_irq(void) {
+    if (!rtl_io) return;
+    uint16_t isr = inw(rtl_io + RTL_REG_ISR);
+    if (isr && isr != 0xFFFFu) {
+        rtl_isr_latch |= isr;
+        outw(rtl_io + RTL_REG_ISR, isr);
+    }
+}
+
+bool rtl8139_get_mac(uint8_t mac[6]) {
+    if (!rtl_io) return false;
+    for (int i = 0; i < 6; i++) mac[i] = inb(rtl_io + RTL_REG_IDR0 + i);
+    return true;
+}
+
+bool rtl8139_is_promisc(void) {
+    if (!rtl_io) return false;
+    return (inl(rtl_io + RTL_REG_RCR) & 0x01u) != 0;
+}
+
+void rtl8139_tx_reap(void) {
+    (void)rtl8139_isr_take(RTL_TX_BITS);
+    while (rtl_tx_count) {
+        uint32_t tsd = inl(rtl_io + RTL_REG_TSD0 + rtl_tx_head * 4u);
+        if (!(tsd & (RTL_TSD_TOK | RTL_TSD_TUN | RTL_TSD_TABT))) break;
+        if (tsd & RTL_TSD_TOK) rtl_tx_ok++; else rtl_tx_err++;
+        rtl_tx_head = (uint8_t)((rtl_tx_head + 1u) % RTL_TX_DESC);
+        rtl_tx_count--;
+    }
+}
+
+uint8_t rtl8139_tx_pending(void) { return rtl_tx_count; }
+uint8_t rtl8139_tx_capacity(void) { return (uint8_t)RTL_TX_DESC; }
+
+void rtl8139_tx_stats(uint32_t* ok, uint32_t* err, uint32_t* stalls) {
+    if (ok) *ok = rtl_tx_ok;
+    if (err) *err = rtl_tx_err;
+    if (stalls) *stalls = rtl_tx_stalls;
+}
+
+bool rtl8139_send(const uint8_t* frame, uint16_t len) {
+    if (!rtl_io || len > 1514) return false;
+
+    rtl8139_tx_reap();
+    if (rtl_tx_count >= RTL_TX_DESC) {
+        // All four descriptors in flight: wait (bounded) for the oldest
+        rtl_tx_stalls++;
+        for (int i = 0; i < 65535 && rtl_tx_count >= RTL_TX_DESC; i++) rtl8139_tx_reap();
+        if (rtl_tx_count >= RTL_TX_DESC) return false;
+    }
+
+    uint8_t slot = (uint8_t)((rtl_tx_head + rtl_tx_count) % RTL_TX_DESC);
+    uint8_t* buf = rtl_tx + slot * RTL_TX_BUF;
+    uint16_t i = 0;
+    for (; i < len; i++) buf[i] = frame[i];
+    for (; i < 60; i++) buf[i] = 0;                 // pad runts (FCS added by the NIC)
+    if (len < 60) len = 60;
+    __asm__ volatile ("" ::: "memory");
+    // Writing the size with OWN=0 hands the buffer to the NIC; early-TX threshold 256 bytes
+    outl(rtl_io + RTL_REG_TSD0 + slot * 4u, (uint32_t)len | (8u << 16));
+    rtl_tx_count++;
+    return true;
+}
+
+bool rtl8139_send_test(void) {
+    uint8_t mac[6];
+    if (!rtl8139_get_mac(mac)) return false;
+    uint8_t frame[60];
+    for (int i=0;i<6;i++) frame[i] = 0xFF;
+    for (int i=0;i<6;i++) frame[6+i] = mac[i];
+    frame[12] = 0x88; frame[13] = 0xB5;
+    const char msg[] = "MEZEREON TEST";
+    uint16_t len = 14;
+    for (int i=0; msg[i]; i++) frame[len++] = (uint8_t)msg[i];
+    while (len < 60) frame[len++] = 0x00;
+    bool ok = rtl8139_send(frame, len);
+    console_write(ok ? "Sent test frame.\n" : "Send failed.\n");
+    return ok;
+}
+
+bool rtl8139_link(uint32_t* mbps) {
+    if (!rtl_io) return false;
+    uint8_t msr = inb(rtl_io + RTL_REG_MSR);
+    if (mbps) *mbps = (msr & 0x08u) ? 10u : 100u;
+    return (msr & 0x04u) == 0;   // LINKB is active low
+}
+
+// --- netface glue ---
+
+static void rtl8139_nf_stats(netface_stats_t* out) {
+    uint32_t errors, overflows;
+    rtl8139_rx_stats(&out->rx_frames, &out->rx_bytes, NULL, &errors, &overflows);
+    out->rx_errors = errors + overflows;
+    rtl8139_tx_stats(&out->tx_ok, &out->tx_err, &out->tx_stalls);
+}
+
+static void rtl8139_nf_diag(void) {
+    console_write("io=");
+    console_write_hex16(rtl_io);
+    console_write(" irq=");
+    console_write_dec(rtl8139_irq_line());
+    console_write(" promisc=");
+    console_write(rtl8139_is_promisc()?"on":"off");
+    // Link/Speed from the media status register
+    uint32_t mbps = 0;
+    bool up = rtl8139_link(&mbps);
+    console_write(" link=");
+    console_write(up ? "up" : "down");
+    console_write(" speed=");
+    console_write_dec(mbps);
+    console_write("Mbps (bus-master DMA)\n");
+    console_write("tx: slots=");
+    console_write_dec(RTL_TX_DESC);
+    console_write(" pending=");
+    console_write_dec(rtl_tx_count);
+    console_write(" ok=");
+    console_write_dec(rtl_tx_ok);
+    console_write(" err=");
+    console_write_dec(rtl_tx_err);
+    console_write(" stalls=");
+    console_write_dec(rtl_tx_stalls);
+    console_write("\n");
+    console_write("rx: frames=");
+    console_write_dec(rtl_rx_frames);
+    console_write(" bytes=");
+    console_write_dec(rtl_rx_bytes);
+    console_write(" batches=");
+    console_write_dec(rtl_rx_batches);
+    console_write(" errors=");
+    console_write_dec(rtl_rx_errors);
+    console_write(" overflows=");
+    console_write_dec(rtl_rx_overflows);
+    console_write(" ring=");
+    console_write_dec(RTL_RX_RING / 1024u);
+    console_write("K\n");
+}
+
+static void rtl8139_nf_bootinfo(void) {
+    console_write(" promisc=");
+    console_write(rtl8139_is_promisc()?"on":"off");
+    console_write(" io=");
+    console_write_hex16(rtl_io);
+    console_write(" irq=");
+    console_write_dec(rtl8139_irq_line());
+}
+
+const netface_ops_t rtl8139_netface_ops = {
+    .name = "RTL8139",
+    .caps = NETFACE_CAP_BUSMASTER | NETFACE_CAP_LINK,
+    .rx_budget = CONFIG_RTL8139_RX_BUDGET,
+    .present = rtl8139_present,
+    .init = rtl8139_init,
+    .send = rtl8139_send,
+    .tx_reap = rtl8139_tx_reap,
+    .tx_pending = rtl8139_tx_pending,
+    .tx_capacity = rtl8139_tx_capacity,
+    .rx_batch = rtl8139_rx_batch,
+    .rx_irq_enable = rtl8139_rx_irq_enable,
+    .rx_irq_take = rtl8139_rx_irq_take,
+    .irq = rtl8139_irq,
+    .irq_line = rtl8139_irq_line,
+    .shutdown = rtl8139_shutdown,
+    .get_mac = rtl8139_get_mac,
+    .stats = rtl8139_nf_stats,
+    .poll_rx = rtl8139_poll_rx,
+    .send_test = rtl8139_send_test,
+    .diag = rtl8139_nf_diag,
+    .bootinfo = rtl8139_nf_bootinfo,
+};
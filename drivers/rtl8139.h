@@ -0,0 +1,86 @@
+#include "../config.h"
+#ifndef RTL8139_H
+#define RTL8139_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../netface.h"
+
+// Realtek RTL8139 (PCI 10EC:8139). Bus-master DMA: the NIC writes received
+// frames into a host RX ring and fetches transmit frames from four
+// descriptor buffers; the CPU only moves register values.
+
+#define RTL8139_VENDOR_ID 0x10EC
+#define RTL8139_DEVICE_ID 0x8139
+
+// Register offsets (I/O BAR0)
+#define RTL_REG_IDR0    0x00   // MAC address (6 bytes)
+#define RTL_REG_MAR0    0x08   // multicast filter (8 bytes)
+#define RTL_REG_TSD0    0x10   // TX status of descriptor 0..3 (4 x 32 bit)
+#define RTL_REG_TSAD0   0x20   // TX buffer address of descriptor 0..3
+#define RTL_REG_RBSTART 0x30   // RX ring physical address
+#define RTL_REG_CR      0x37   // command
+#define RTL_REG_CAPR    0x38   // current address of packet read (16 bit)
+#define RTL_REG_CBR     0x3A   // current buffer address (NIC write pointer)
+#define RTL_REG_IMR     0x3C
+#define RTL_REG_ISR     0x3E
+#define RTL_REG_TCR     0x40
+#define RTL_REG_RCR     0x44
+#define RTL_REG_MPC     0x4C   // missed packet counter
+#define RTL_REG_9346CR  0x50
+#define RTL_REG_CONFIG1 0x52
+#define RTL_REG_MSR     0x58   // media status
+
+// CR bits
+#define RTL_CR_BUFE     0x01   // RX ring empty
+#define RTL_CR_TE       0x04
+#define RTL_CR_RE       0x08
+#define RTL_CR_RST      0x10
+
+// ISR/IMR bits
+#define RTL_INT_ROK     0x0001
+#define RTL_INT_RER     0x0002
+#define RTL_INT_TOK     0x0004
+#define RTL_INT_TER     0x0008
+#define RTL_INT_RXOVW   0x0010
+#define RTL_INT_LINK    0x0020
+#define RTL_INT_FOVW    0x0040
+#define RTL_INT_SERR    0x8000
+
+// TSD bits
+#define RTL_TSD_OWN     0x00002000u   // DMA to the FIFO finished
+#define RTL_TSD_TUN     0x00004000u
+#define RTL_TSD_TOK     0x00008000u
+#define RTL_TSD_TABT    0x40000000u
+
+bool rtl8139_present(void);
+bool rtl8139_init(void);
+uint16_t rtl8139_io_base(void);
+uint8_t rtl8139_irq_line(void);   // PCI interrupt line (0 = none)
+bool rtl8139_send_test(void);
+void rtl8139_poll_rx(void);       // verbose RX dump (netrxdump)
+void rtl8139_irq(void);           // ack/latch ISR bits (IRQ context)
+void rtl8139_shutdown(void);      // IMR/CR cleared, then soft reset: RX DMA stops
+
+bool rtl8139_get_mac(uint8_t mac[6]);
+bool rtl8139_is_promisc(void);
+// Link state from MSR; *mbps = 10 or 100
+bool rtl8139_link(uint32_t* mbps);
+
+// Copy the frame into the next free TX descriptor buffer and start DMA
+bool rtl8139_send(const uint8_t* frame, uint16_t len);
+void rtl8139_tx_reap(void);
+uint8_t rtl8139_tx_pending(void);
+uint8_t rtl8139_tx_capacity(void);
+void rtl8139_tx_stats(uint32_t* ok, uint32_t* err, uint32_t* stalls);
+
+// Same NAPI contract as the NE2000 driver (see netface.c)
+int  rtl8139_rx_batch(int budget, int verbose);
+void rtl8139_rx_irq_enable(bool on);
+bool rtl8139_rx_irq_take(void);
+void rtl8139_rx_stats(uint32_t* frames, uint32_t* bytes, uint32_t* batches, uint32_t* errors, uint32_t* overflows);
+
+// netface driver table (netface.c probe list)
+extern const netface_ops_t rtl8139_netface_ops;
+
+#endif // RTL8139_H
@@ -18,6 +18,10 @@ struct __attribute__((packed)) idt_ptr {
 extern void irq0_stub(void);
 extern void irq1_stub(void);
 extern void irq3_stub(void);
+extern void irq5_stub(void);
+extern void irq9_stub(void);
+extern void irq10_stub(void);
+extern void irq11_stub(void);
 extern void nmi_stub(void);
 extern void page_fault_stub(void);
 extern void gpf_stub(void);
@@ -61,8 +65,18 @@ void idt_init(void) {
     idt_set_gate(32, (uint32_t)irq0_stub, 0x08, 0x8E);
     idt_set_gate(33, (uint32_t)irq1_stub, 0x08, 0x8E);
     idt_set_gate(35, (uint32_t)irq3_stub, 0x08, 0x8E);
+    // Lines a PCI BIOS typically assigns (PCI NICs)
+    idt_set_gate(37, (uint32_t)irq5_stub, 0x08, 0x8E);
+    idt_set_gate(41, (uint32_t)irq9_stub, 0x08, 0x8E);
+    idt_set_gate(42, (uint32_t)irq10_stub, 0x08, 0x8E);
+    idt_set_gate(43, (uint32_t)irq11_stub, 0x08, 0x8E);
 
     idtp.limit = (uint16_t)(sizeof(idt) - 1);
     idtp.base  = (uint32_t)&idt[0];
     lidt(&idt[0], sizeof(idt)-1);
 }
+
+int idt_irq_routed(uint8_t irq) {
+    return irq == 0 || irq == 1 || irq == 3 || irq == 5 ||
+           irq == 9 || irq == 10 || irq == 11;
+}
@@ -64,14 +64,42 @@ static inline uint32_t statusbar_update_interval_ticks(void) {
 }
 uint32_t ticks_get(void){ return ticks; }
 
+// PIT input clocks: reload value and clocks accumulated by completed periods
+static volatile uint32_t s_pit_div = 0;
+static volatile uint64_t s_pit_clocks = 0;
+
 void pit_init(uint32_t hz) {
     if (hz == 0) hz = 100;
     uint32_t div = 1193182u / hz;
-    outb(0x43, 0x36); // ch0, lo/hi, mode 3 (square)
+    if (div > 65535u) div = 65535u;
+    if (div < 2u) div = 2u;
+    s_pit_div = div;
+    // Mode 2 (rate generator): the counter runs div..1 once per IRQ, so its
+    // value is a linear position inside the current tick (see pit_time_us)
+    outb(0x43, 0x34); // ch0, lo/hi, mode 2
     outb(0x40, (uint8_t)(div & 0xFF));
     outb(0x40, (uint8_t)((div >> 8) & 0xFF));
 }
 
+uint32_t pit_time_us(void) {
+    uint32_t flags = interrupts_save_disable();
+    outb(0x43, 0x00);               // latch channel 0
+    uint8_t lo = inb(0x40);
+    uint8_t hi = inb(0x40);
+    uint64_t clocks = s_pit_clocks;
+    outb(0x20, 0x0A);               // OCW3: read IRR
+    uint8_t irr = inb(0x20);
+    interrupts_restore(flags);
+    uint32_t div = s_pit_div;
+    if (div == 0) return (uint32_t)((uint64_t)ticks * 10000u);
+    uint32_t count = ((uint32_t)hi << 8) | lo;
+    if (count == 0 || count > div) count = div;
+    uint32_t done = div - count;
+    // Counter already reloaded but IRQ0 still pending: that period is complete
+    if ((irr & 0x01) && done < div / 2u) clocks += div;
+    return (uint32_t)((clocks + done) * 1000000u / 1193182u);
+}
+
 void interrupts_enable(void){ __asm__ volatile("sti" ::: "memory"); }
 void interrupts_disable(void){ __asm__ volatile("cli" ::: "memory"); }
 
@@ -105,9 +133,11 @@ void interrupts_restore(uint32_t flags) {
 #include "keyboard.h"
 // Top-level NIC IRQ handler
 #include "netface.h"
+#include "net/netstat.h"
 
 void irq0_handler_c(void) {
     ticks++;
+    s_pit_clocks += s_pit_div;
     debug_serial_plugin_timer_tick();
     uint32_t t = ticks;
     uint32_t interval = statusbar_update_interval_ticks();
@@ -117,6 +147,10 @@ void irq0_handler_c(void) {
     }
     // Acknowledge PIC
     outb(0x20, 0x20);
+    // Retire finished NIC transmissions; received frames wait for netface_poll()
+    netface_softirq();
+    // Per-second network rates
+    net_stats_tick();
 }
 
 static volatile uint32_t kbd_irq_count = 0;
@@ -138,8 +172,18 @@ void irq1_handler_c(void) {
 
 void irq3_handler_c(void) {
     // Delegate to netface (driver-specific ack/latch), then EOI
-    netface_irq();
+    netface_irq(3);
+    outb(0x20, 0x20);
+    // Retire finished transmissions; HLT returns and the idle loop polls RX
+    netface_softirq();
+}
+
+void irq_pci_handler_c(uint32_t irq) {
+    // PCI NIC on a BIOS-assigned line (level-triggered, ack at the NIC first)
+    netface_irq((uint8_t)irq);
+    if (irq >= 8) outb(0xA0, 0x20);
     outb(0x20, 0x20);
+    netface_softirq();
 }
 
 void interrupts_statusbar_poll(void) {
@@ -3,6 +3,8 @@
 #include <stdint.h>
 
 void idt_init(void);
+// Non-zero if the IRQ line has a handler stub installed in the IDT
+int idt_irq_routed(uint8_t irq);
 void pic_remap(uint8_t offset1, uint8_t offset2);
 void pic_set_mask(uint8_t irq, int masked);
 void pic_mask_all(void);
@@ -16,4 +18,7 @@ void interrupts_statusbar_poll(void);
 
 // Tick counter from PIT IRQ0
 uint32_t ticks_get(void);
+// Microseconds since the PIT was programmed, interpolated inside the current
+// tick from the channel-0 counter (~1 us resolution; wraps after ~71 min)
+uint32_t pit_time_us(void);
 uint32_t kbd_irq_count_get(void);
@@ -4,6 +4,10 @@ section .text
 global irq0_stub
 global irq1_stub
 global irq3_stub
+global irq5_stub
+global irq9_stub
+global irq10_stub
+global irq11_stub
 global nmi_stub
 global page_fault_stub
 global gpf_stub
@@ -12,6 +16,7 @@ global generic_exception_stub
 extern irq0_handler_c
 extern irq1_handler_c
 extern irq3_handler_c
+extern irq_pci_handler_c
 extern nmi_handler_c
 extern gpf_handler_c
 extern double_fault_handler_c
@@ -75,6 +80,35 @@ irq3_stub:
     popa
     iretd
 
+; PCI-routable lines (5, 9, 10, 11) share one C handler: push the IRQ number
+%macro PCI_IRQ_STUB 1
+irq%1_stub:
+    pusha
+    push ds
+    push es
+    push fs
+    push gs
+    mov ax, 0x10
+    mov ds, ax
+    mov es, ax
+    mov fs, ax
+    mov gs, ax
+    push dword %1
+    call irq_pci_handler_c
+    add esp, 4
+    pop gs
+    pop fs
+    pop es
+    pop ds
+    popa
+    iretd
+%endmacro
+
+PCI_IRQ_STUB 5
+PCI_IRQ_STUB 9
+PCI_IRQ_STUB 10
+PCI_IRQ_STUB 11
+
 nmi_stub:
     pusha
     push ds
@@ -247,10 +247,29 @@ void kmain(const boot_info_t* bootinfo)
     console_writeln("net: probing NIC...");
     if (netface_init()) {
         net_ipv4_init();
-        console_write("Network interface initialized. Selected: ");
+        console_write("Network interfaces initialized: ");
+        console_write_dec((uint32_t)netface_count());
+        console_write(". Default: ");
         console_write(netface_active_name());
         console_write("\n");
         netface_bootinfo_print();
+#if CONFIG_BOOT_ENABLE_INTERRUPTS
+        for (int n = 0; n < netface_count(); n++) {
+            uint8_t nic_irq = netface_if_irq_line(n);
+            if (nic_irq == 3 || nic_irq == 0) continue;
+            console_write("net: ");
+            console_write(netface_name(n));
+            console_write(" IRQ");
+            console_write_dec(nic_irq);
+            if (platform_irq_routed(nic_irq)) {
+                if (nic_irq >= 8) platform_irq_unmask(2); // cascade
+                platform_irq_unmask(nic_irq);
+                console_write(" unmasked\n");
+            } else {
+                console_write(" not routed, RX polled from timer ticks\n");
+            }
+        }
+#endif
         netface_send_test();
     } else {
         console_write("No network interface present. Selected: ");
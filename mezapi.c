@@ -6,10 +6,15 @@
 #include "drivers/sb16.h"
 #include "drivers/gpu/fb_accel.h"
 #include "drivers/gpu/gpu.h"
+#include "drivers/gpu/gpu_stats.h"
 #include "video_fb.h"
 #include <stddef.h>
 #include <stdint.h>
 #include "statusbar.h"
+#include "netface.h"
+#include "net/ipv4.h"
+#include "net/udp.h"
+#include "net/netstat.h"
 
 // Minimal backend wrappers (text-mode drawing via VGA text memory for now)
 
@@ -44,6 +49,9 @@ static void api_sound_tone_off(void){ pcspeaker_off(); }
 static mez_fb_info32_t g_fb_info;
 static mez_sound_info32_t g_sound_info;
 static mez_gpu_info32_t g_gpu_info;
+static mez_net_stats32_t g_net_info;
+static mez_gpu_stats32_t g_gpu_stats;
+static mez_fb_format32_t g_fb_format;
 
 static void mez_copy_string(char* dst, size_t len, const char* src)
 {
@@ -258,7 +266,7 @@ static void api_video_fb_fill_rect(uint16_t x, uint16_t y, uint16_t width, uint1
 {
     uint32_t pitch; uint16_t fb_w; uint16_t fb_h; uint8_t bpp;
     const void* ptr = console_fb_get_info(&pitch, &fb_w, &fb_h, &bpp);
-    if (!ptr || bpp != 8) return;
+    if (!ptr || bpp == 4) return;
     if (x >= fb_w || y >= fb_h) return;
 
     if ((uint32_t)x + width > fb_w) {
@@ -269,7 +277,8 @@ static void api_video_fb_fill_rect(uint16_t x, uint16_t y, uint16_t width, uint1
     }
     if (width == 0 || height == 0) return;
 
-    if (!fb_accel_fill_rect(x, y, width, height, color)) {
+    // Direct colour and banked modes rely on fb_accel (palette index -> pixel)
+    if (!fb_accel_fill_rect(x, y, width, height, color) && bpp == 8) {
         volatile uint8_t* fb = (volatile uint8_t*)(uintptr_t)ptr;
         for (uint16_t yy = 0; yy < height; yy++) {
             volatile uint8_t* line = fb + ((uint32_t)(y + yy) * pitch) + x;
@@ -312,11 +321,130 @@ static const mez_sound_info32_t* api_sound_get_info(void)
     return &g_sound_info;
 }
 
+// Apps draw straight into the framebuffer: the whole frame counts as changed
 static void api_video_fb_sync(void)
 {
+    uint32_t pitch; uint16_t width; uint16_t height; uint8_t bpp;
+    if (console_fb_get_info(&pitch, &width, &height, &bpp)) fb_accel_mark_dirty(0, 0, width, height);
     fb_accel_sync();
 }
 
+// Same frame description as video_fb_get_info, for the buffer of the next frame
+static const mez_fb_info32_t* api_video_fb_acquire(void)
+{
+    uint32_t pitch; uint16_t width; uint16_t height; uint8_t bpp;
+    const void* ptr = console_fb_acquire(&pitch, &width, &height, &bpp);
+    if (!ptr) return NULL;
+    g_fb_info.width = width;
+    g_fb_info.height = height;
+    g_fb_info.pitch = pitch;
+    g_fb_info.bpp = bpp;
+    g_fb_info.framebuffer = ptr;
+    g_fb_info.reserved0 = g_fb_info.reserved1 = g_fb_info.reserved2 = 0;
+    return &g_fb_info;
+}
+
+// Shadow adapters upload only the listed rectangles; a flip shows the page as is
+static uint32_t api_video_fb_present(const mez_rect16_t* dirty, uint32_t count, uint32_t flags)
+{
+    uint32_t pitch; uint16_t width; uint16_t height; uint8_t bpp;
+    if (!console_fb_get_info(&pitch, &width, &height, &bpp)) return MEZ_PRESENT_NONE;
+    if (!dirty || count == 0) {
+        fb_accel_mark_dirty(0, 0, width, height);
+    } else {
+        for (uint32_t i = 0; i < count; i++) {
+            fb_accel_mark_dirty(dirty[i].x, dirty[i].y, dirty[i].width, dirty[i].height);
+        }
+    }
+    switch (console_fb_present((flags & MEZ_PRESENT_VSYNC) != 0)) {
+        case FB_ACCEL_PRESENT_FLIP: return MEZ_PRESENT_FLIPPED;
+        case FB_ACCEL_PRESENT_UPLOAD: return MEZ_PRESENT_UPLOADED;
+        default: return MEZ_PRESENT_NONE;
+    }
+}
+
+// Apps run from the shell with network bottom halves held off: give the stack
+// a safe point before looking at the ring so polling loops make progress.
+static int api_net_udp_recvfrom(int sock, void* buf, uint16_t cap, uint32_t* src_ip, uint16_t* src_port)
+{
+    netface_poll();
+    return net_udp_recvfrom(sock, buf, cap, src_ip, src_port);
+}
+
+static uint32_t api_net_ipv4_addr(void)
+{
+    uint32_t ip = 0;
+    net_ipv4_config_get(&ip, NULL, NULL);
+    return ip;
+}
+
+static const mez_net_stats32_t* api_net_get_stats(void)
+{
+    if (netface_count() == 0) return NULL;
+    mez_net_stats32_t* o = &g_net_info;
+    const net_stats_t* s = &g_net_stats;
+    o->rx_frames = o->rx_bytes = o->tx_frames = o->tx_bytes = 0;
+    o->rx_fps = o->rx_Bps = o->tx_fps = o->tx_Bps = o->drops_ps = 0;
+    for (int i = 0; i < netface_count() && i < NETFACE_MAX; i++) {
+        o->rx_frames += s->nic[i].rx_frames; o->rx_bytes += s->nic[i].rx_bytes;
+        o->tx_frames += s->nic[i].tx_frames; o->tx_bytes += s->nic[i].tx_bytes;
+        net_stats_rate_t r;
+        if (net_stats_rate(i, &r)) {
+            o->rx_fps += r.rx_fps; o->rx_Bps += r.rx_Bps;
+            o->tx_fps += r.tx_fps; o->tx_Bps += r.tx_Bps;
+            o->drops_ps = r.drops_ps;
+        }
+    }
+    o->ip_rx = s->ip_rx; o->ip_tx = s->ip_tx;
+    o->icmp_rx = s->icmp_rx; o->tcp_rx = s->tcp_rx; o->tcp_tx = s->tcp_tx;
+    net_udp_stats_t u; net_udp_stats_get(&u);
+    o->udp_rx = u.rx; o->udp_tx = u.tx;
+    o->http_requests = s->http_req;
+    o->drops = net_stats_drops();
+    return o;
+}
+
+static const mez_gpu_stats32_t* api_video_gpu_get_stats(void)
+{
+    gpu_stats_t s;
+    if (!gpu_stats_get(0, &s)) return NULL;
+    mez_gpu_stats32_t* o = &g_gpu_stats;
+    o->syncs = s.syncs; o->sync_us = s.sync_us; o->sync_max_us = s.sync_max_us;
+    o->draws = s.draws; o->draw_us = s.draw_us;
+    o->uploads = s.uploads; o->upload_bytes_last = s.upload_bytes_last;
+    o->upload_kib = (uint32_t)(s.upload_bytes / 1024u);
+    o->bank_switches = s.bank_switches;
+    o->irq_off = s.irq_off; o->irq_off_us = s.irq_off_us; o->irq_off_max_us = s.irq_off_max_us;
+    o->vblank_waits = s.vblank_waits; o->vblank_timeouts = s.vblank_timeouts; o->vblank_us = s.vblank_us;
+    o->presents = s.presents;
+    mez_copy_string(o->name, sizeof(o->name), s.name);
+    return o;
+}
+
+static const mez_fb_format32_t* api_video_fb_get_format(void)
+{
+    uint32_t pitch; uint16_t width; uint16_t height; uint8_t bpp;
+    if (!console_fb_get_info(&pitch, &width, &height, &bpp)) return NULL;
+    mez_fb_format32_t* o = &g_fb_format;
+    display_pixel_format_t format = (display_pixel_format_t)console_fb_get_format();
+    display_pixel_layout_t layout = {0, 0, 0, 0, 0, 0, 0};
+    display_pixel_layout(format, &layout);
+    switch (format) {
+        case DISPLAY_PIXEL_FORMAT_PAL_16:    o->format = MEZ_PIXEL_FORMAT_PAL_16; break;
+        case DISPLAY_PIXEL_FORMAT_PAL_256:   o->format = MEZ_PIXEL_FORMAT_PAL_256; break;
+        case DISPLAY_PIXEL_FORMAT_RGB_555:   o->format = MEZ_PIXEL_FORMAT_RGB_555; break;
+        case DISPLAY_PIXEL_FORMAT_RGB_565:   o->format = MEZ_PIXEL_FORMAT_RGB_565; break;
+        case DISPLAY_PIXEL_FORMAT_XRGB_8888: o->format = MEZ_PIXEL_FORMAT_XRGB_8888; break;
+        default:                             o->format = MEZ_PIXEL_FORMAT_NONE; break;
+    }
+    o->bpp = bpp;
+    o->bytes_per_pixel = (bpp == 4) ? 0 : (uint8_t)((bpp + 7u) / 8u);
+    o->red_pos = layout.red_pos;     o->red_size = layout.red_size;
+    o->green_pos = layout.green_pos; o->green_size = layout.green_size;
+    o->blue_pos = layout.blue_pos;   o->blue_size = layout.blue_size;
+    return o;
+}
+
 static mez_api32_t g_api = {
     .abi_version     = MEZ_ABI32_V1,
     .size            = sizeof(mez_api32_t),
@@ -352,6 +480,21 @@ static mez_api32_t g_api = {
 
     .sound_get_info    = api_sound_get_info,
     .video_gpu_get_info = api_video_gpu_get_info,
+
+    .net_udp_open      = net_udp_open,
+    .net_udp_close     = net_udp_close,
+    .net_udp_sendto    = net_udp_sendto,
+    .net_udp_recvfrom  = api_net_udp_recvfrom,
+    .net_ipv4_addr     = api_net_ipv4_addr,
+    .net_get_stats     = api_net_get_stats,
+
+    .video_fb_acquire  = api_video_fb_acquire,
+    .video_fb_present  = api_video_fb_present,
+    .video_fb_release  = console_fb_release,
+
+    .time_us_get         = platform_time_us,
+    .video_gpu_get_stats = api_video_gpu_get_stats,
+    .video_fb_get_format = api_video_fb_get_format,
 };
 
 const mez_api32_t* mez_api_get(void)
@@ -371,6 +514,10 @@ const mez_api32_t* mez_api_get(void)
     if (api_video_gpu_get_info()) {
         caps |= MEZ_CAP_VIDEO_GPU_INFO;
     }
+    unsigned char mac[6];
+    if (netface_get_mac(mac)) {
+        caps |= MEZ_CAP_NET_UDP;
+    }
     g_api.capabilities = caps;
     return &g_api;
 }
@@ -11,6 +11,7 @@
 #define MEZ_CAP_VIDEO_FB_ACCEL  (1u << 1)
 #define MEZ_CAP_SOUND_SB16      (1u << 2)
 #define MEZ_CAP_VIDEO_GPU_INFO  (1u << 3)
+#define MEZ_CAP_NET_UDP         (1u << 4)
 
 #define MEZ_SOUND_BACKEND_NONE    0u
 #define MEZ_SOUND_BACKEND_PCSPK   (1u << 0)
@@ -27,6 +28,39 @@ typedef struct {
     const void* framebuffer;
 } mez_fb_info32_t;
 
+// Pixel layout of the framebuffer (video_fb_get_format). Palette modes have
+// no channel fields; in direct colour modes every channel is 'size' bits at
+// bit 'pos' of a little-endian pixel of bytes_per_pixel bytes.
+#define MEZ_PIXEL_FORMAT_NONE       0u
+#define MEZ_PIXEL_FORMAT_PAL_16     1u      // packed 4bpp, even pixel in the high nibble
+#define MEZ_PIXEL_FORMAT_PAL_256    2u
+#define MEZ_PIXEL_FORMAT_RGB_555    3u
+#define MEZ_PIXEL_FORMAT_RGB_565    4u
+#define MEZ_PIXEL_FORMAT_XRGB_8888  5u
+
+typedef struct {
+    uint32_t format;            // MEZ_PIXEL_FORMAT_*
+    uint8_t  bpp;               // as in mez_fb_info32_t (15 for RGB 5:5:5)
+    uint8_t  bytes_per_pixel;   // 0 for packed 4bpp
+    uint8_t  red_pos, red_size;
+    uint8_t  green_pos, green_size;
+    uint8_t  blue_pos, blue_size;
+} mez_fb_format32_t;
+
+// Rectangle in framebuffer pixels
+typedef struct {
+    uint16_t x;
+    uint16_t y;
+    uint16_t width;
+    uint16_t height;
+} mez_rect16_t;
+
+// video_fb_present flags and results
+#define MEZ_PRESENT_VSYNC       (1u << 0)   // wait for the vertical retrace
+#define MEZ_PRESENT_NONE        0u          // no frame acquired
+#define MEZ_PRESENT_UPLOADED    1u          // one buffer: changed area copied/uploaded, buffer keeps the frame
+#define MEZ_PRESENT_FLIPPED     2u          // CRTC page flip: the next buffer holds the frame before last
+
 typedef struct {
     uint32_t backends;      // Bitmask of MEZ_SOUND_BACKEND_* flags
     uint16_t sb16_base_port;
@@ -71,6 +105,33 @@ typedef struct {
     char     name[32];         // Adaptername (0-terminiert)
 } mez_gpu_info32_t;
 
+// Netzwerkstatistik (Summen über alle Interfaces); Zähler laufen bei 2^32 über
+typedef struct {
+    uint32_t rx_frames, rx_bytes;      // von den NICs an den Stack übergeben
+    uint32_t tx_frames, tx_bytes;      // von den NICs angenommen
+    uint32_t ip_rx, ip_tx;
+    uint32_t icmp_rx, tcp_rx, tcp_tx;
+    uint32_t udp_rx, udp_tx;
+    uint32_t http_requests;
+    uint32_t drops;                    // alle Verwerfungen (Treiber, ARP, IPv4, TCP, UDP)
+    uint32_t rx_fps, rx_Bps;           // Raten der letzten vollen Sekunde
+    uint32_t tx_fps, tx_Bps;
+    uint32_t drops_ps;
+} mez_net_stats32_t;
+
+// Zähler des aktiven Grafikadapters (drivers/gpu/gpu_stats.h); Zeiten in Mikrosekunden,
+// Zähler laufen bei 2^32 über
+typedef struct {
+    uint32_t syncs, sync_us, sync_max_us;        // video_fb_sync/fb_accel_sync
+    uint32_t draws, draw_us;                     // Zeichenaufrufe; draw_us nur mit TSC, sonst 0
+    uint32_t uploads, upload_bytes_last, upload_kib;   // Shadow-Übertragungen ins VRAM
+    uint32_t bank_switches;                      // Wechsel des 64-KiB-Fensters beim Übertragen
+    uint32_t irq_off, irq_off_us, irq_off_max_us;      // Abschnitte mit gesperrten Interrupts
+    uint32_t vblank_waits, vblank_timeouts, vblank_us;
+    uint32_t presents;                           // über video_fb_present abgeschlossene Frames
+    char     name[32];                           // Adaptername (0-terminiert)
+} mez_gpu_stats32_t;
+
 typedef enum {
     MEZ_STATUS_POS_LEFT = 0,
     MEZ_STATUS_POS_CENTER = 1,
@@ -126,6 +187,33 @@ typedef struct mez_api32 {
 
     // GPU metadata (detected adapters + featurelevel)
     const mez_gpu_info32_t* (*video_gpu_get_info)(void);
+
+    // UDP sockets (non-blocking; negative return = error, -1 = would block)
+    // Addresses are big-endian values (10.0.2.2 == 0x0A000202), ports host order.
+    int      (*net_udp_open)(uint16_t local_port);      // 0 = ephemeral; returns handle
+    void     (*net_udp_close)(int sock);
+    int      (*net_udp_sendto)(int sock, uint32_t dst_ip, uint16_t dst_port, const void* data, uint16_t len);
+    int      (*net_udp_recvfrom)(int sock, void* buf, uint16_t cap, uint32_t* src_ip, uint16_t* src_port);
+    uint32_t (*net_ipv4_addr)(void);                    // local address, 0 if unconfigured
+
+    // Network counters and per-second rates (snapshot, NULL without NIC)
+    const mez_net_stats32_t* (*net_get_stats)(void);
+
+    // Double buffering: acquire returns the buffer to draw the next frame in
+    // (console output is held back until release), present shows it. 'dirty'
+    // lists what changed since the last frame (NULL/0 = everything); the
+    // result says whether the next acquire gets a flipped page.
+    const mez_fb_info32_t* (*video_fb_acquire)(void);
+    uint32_t (*video_fb_present)(const mez_rect16_t* dirty, uint32_t count, uint32_t flags);
+    void     (*video_fb_release)(void);
+    // Microseconds with sub-tick resolution (wraps after ~71 min; use differences)
+    uint32_t (*time_us_get)(void);
+    // Counters of the active graphics adapter (NULL before the first framebuffer mode)
+    const mez_gpu_stats32_t* (*video_gpu_get_stats)(void);
+    // Pixel layout of the framebuffer (NULL in text mode). video_fb_fill_rect
+    // takes a palette index in every mode; direct colour modes draw it in the
+    // colour of the default 8bpp palette.
+    const mez_fb_format32_t* (*video_fb_get_format)(void);
 } mez_api32_t;
 
 // Provider from kernel
@@ -0,0 +1,380 @@
+#include "arp.h"
+#include "ipv4.h"
+#include "../config.h"
+#include "../netface.h"
+#include "../console.h"
+#include "../platform.h"
+#include "../memory.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#define ARP_N        CONFIG_NET_ARP_ENTRIES
+#define ARP_QN       CONFIG_NET_ARP_QUEUE_FRAMES
+#define ARP_FRAME_MAX 1514
+#define ARP_MAX_TRIES 3
+
+typedef char arp_entries_pow2_check[((ARP_N & (ARP_N - 1)) == 0 && ARP_N > 0) ? 1 : -1];
+
+enum { ARP_FREE = 0, ARP_INCOMPLETE, ARP_REACHABLE };
+
+typedef struct {
+    uint32_t ip;
+    uint32_t updated;   // tick of last confirmation (reachable) or creation
+    uint32_t last_req;  // tick of last request sent for this entry
+    int16_t  next;      // hash chain
+    int8_t   qhead;     // parked frames (index into pool, -1 = none)
+    uint8_t  qlen;
+    uint8_t  state;
+    uint8_t  tries;
+    uint8_t  ifx;       // netface interface the neighbour lives on
+    uint8_t  mac[6];
+} arp_entry_t;
+
+static arp_entry_t s_arp[ARP_N];
+static int16_t     s_bucket[ARP_N];
+static net_arp_stats_t s_stats;
+static uint8_t     s_mac[NETFACE_MAX][6];
+static uint32_t    s_last_scan;
+static uint32_t    s_conflicts_reported;
+
+// Parked frame pool (one shared allocation, singly-linked per entry)
+static uint8_t*  s_qbuf;
+static uint16_t  s_qbytes[ARP_QN];
+static int8_t    s_qnext[ARP_QN];
+static int8_t    s_qfree = -1;
+
+static const uint8_t s_bcast[6] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+
+static inline uint32_t arp_hash(uint32_t ip) { return ((ip * 0x9E3779B1u) >> 16) & (ARP_N - 1); }
+
+static uint32_t arp_hz(void) { uint32_t hz = platform_timer_get_hz(); return hz ? hz : 100u; }
+
+static uint32_t arp_local_ip(int ifx) { uint32_t ip = 0; (void)net_ipv4_if_config_get(ifx, &ip, NULL, NULL); return ip; }
+
+static uint32_t be32_at(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static void put_be32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24); p[1] = (uint8_t)(v >> 16); p[2] = (uint8_t)(v >> 8); p[3] = (uint8_t)v;
+}
+
+// Build and send an ARP frame on ifx. eth_dst NULL = broadcast, tha NULL = zeros.
+static void arp_send(int ifx, uint16_t op, const uint8_t* eth_dst, const uint8_t* tha, uint32_t sip, uint32_t tip) {
+    uint8_t f[42]; // 14 eth + 28 arp
+    const uint8_t* mac = s_mac[ifx];
+    for (int i = 0; i < 6; i++) f[i] = eth_dst ? eth_dst[i] : 0xFF;
+    for (int i = 0; i < 6; i++) f[6 + i] = mac[i];
+    f[12] = 0x08; f[13] = 0x06;
+    f[14] = 0x00; f[15] = 0x01;                 // HTYPE Ethernet
+    f[16] = 0x08; f[17] = 0x00;                 // PTYPE IPv4
+    f[18] = 6;    f[19] = 4;                    // HLEN, PLEN
+    f[20] = (uint8_t)(op >> 8); f[21] = (uint8_t)op;
+    for (int i = 0; i < 6; i++) f[22 + i] = mac[i];
+    put_be32(f + 28, sip);
+    for (int i = 0; i < 6; i++) f[32 + i] = tha ? tha[i] : 0x00;
+    put_be32(f + 38, tip);
+    (void)netface_if_send(ifx, f, 42);
+    if (op == 1) s_stats.requests++; else s_stats.replies++;
+}
+
+static void print_hex8(uint8_t v) {
+    const char* hx = "0123456789abcdef";
+    char s[3] = { hx[v >> 4], hx[v & 15], 0 };
+    console_write(s);
+}
+
+static int arp_find(int ifx, uint32_t ip) {
+    for (int i = s_bucket[arp_hash(ip)]; i >= 0; i = s_arp[i].next)
+        if (s_arp[i].ip == ip && s_arp[i].ifx == (uint8_t)ifx) return i;
+    return -1;
+}
+
+static void arp_queue_drop(arp_entry_t* e) {
+    while (e->qhead >= 0) {
+        int8_t q = e->qhead;
+        e->qhead = s_qnext[q];
+        s_qnext[q] = s_qfree; s_qfree = q;
+        s_stats.dropped++;
+    }
+    e->qlen = 0;
+}
+
+// Send everything parked on a freshly resolved entry, oldest first
+static void arp_queue_flush(arp_entry_t* e) {
+    while (e->qhead >= 0) {
+        int8_t q = e->qhead;
+        uint8_t* fr = s_qbuf + (uint32_t)q * ARP_FRAME_MAX;
+        for (int i = 0; i < 6; i++) fr[i] = e->mac[i];
+        (void)netface_if_send(e->ifx, fr, s_qbytes[q]);
+        s_stats.flushed++;
+        e->qhead = s_qnext[q];
+        s_qnext[q] = s_qfree; s_qfree = q;
+    }
+    e->qlen = 0;
+}
+
+static void arp_free(int idx) {
+    arp_entry_t* e = &s_arp[idx];
+    arp_queue_drop(e);
+    int16_t* pp = &s_bucket[arp_hash(e->ip)];
+    while (*pp >= 0 && *pp != idx) pp = &s_arp[*pp].next;
+    if (*pp == idx) *pp = e->next;
+    e->state = ARP_FREE;
+    e->next = -1;
+}
+
+// Take a free slot; when full recycle the oldest entry (resolved ones first)
+static int arp_alloc(int ifx, uint32_t ip) {
+    int victim = -1;
+    uint32_t now = platform_ticks_get();
+    for (int pass = 0; pass < 2 && victim < 0; pass++) {
+        uint32_t best_age = 0;
+        for (int i = 0; i < ARP_N; i++) {
+            if (s_arp[i].state == ARP_FREE) { victim = i; break; }
+            if (pass == 0 && (s_arp[i].state != ARP_REACHABLE || s_arp[i].qlen)) continue;
+            uint32_t age = now - s_arp[i].updated;
+            if (victim < 0 || age > best_age) { victim = i; best_age = age; }
+        }
+    }
+    if (s_arp[victim].state != ARP_FREE) { arp_free(victim); s_stats.evicted++; }
+    arp_entry_t* e = &s_arp[victim];
+    e->ip = ip; e->ifx = (uint8_t)ifx; e->state = ARP_INCOMPLETE; e->tries = 0; e->qhead = -1; e->qlen = 0;
+    e->updated = now; e->last_req = now;
+    uint32_t b = arp_hash(ip);
+    e->next = s_bucket[b]; s_bucket[b] = (int16_t)victim;
+    return victim;
+}
+
+static void arp_update(int idx, const uint8_t mac[6]) {
+    arp_entry_t* e = &s_arp[idx];
+    for (int i = 0; i < 6; i++) e->mac[i] = mac[i];
+    e->state = ARP_REACHABLE;
+    e->tries = 0;
+    e->updated = platform_ticks_get();
+    if (e->qlen) arp_queue_flush(e);
+}
+
+void net_arp_flush(void) {
+    for (int i = 0; i < ARP_N; i++) {
+        if (s_arp[i].state != ARP_FREE) arp_queue_drop(&s_arp[i]);
+        s_arp[i].state = ARP_FREE; s_arp[i].next = -1; s_arp[i].qhead = -1; s_arp[i].qlen = 0;
+        s_bucket[i] = -1;
+    }
+}
+
+void net_arp_flush_if(int ifx) {
+    for (int i = 0; i < ARP_N; i++)
+        if (s_arp[i].state != ARP_FREE && s_arp[i].ifx == (uint8_t)ifx) arp_free(i);
+}
+
+void net_arp_init(void) {
+    for (int i = 0; i < NETFACE_MAX; i++) (void)netface_if_get_mac(i, s_mac[i]);
+    if (!s_qbuf) s_qbuf = (uint8_t*)memory_alloc((size_t)ARP_QN * ARP_FRAME_MAX);
+    s_qfree = -1;
+    if (s_qbuf) {
+        for (int i = ARP_QN - 1; i >= 0; i--) { s_qnext[i] = s_qfree; s_qfree = (int8_t)i; }
+    }
+    for (int i = 0; i < ARP_N; i++) { s_arp[i].state = ARP_FREE; s_arp[i].qhead = -1; s_arp[i].qlen = 0; }
+    net_arp_flush();
+    s_last_scan = platform_ticks_get();
+}
+
+void net_arp_announce(int ifx) {
+    if (ifx < 0 || ifx >= netface_count() || ifx >= NETFACE_MAX) return;
+    uint32_t ip = arp_local_ip(ifx);
+    (void)netface_if_get_mac(ifx, s_mac[ifx]);
+    if (ip) arp_send(ifx, 1, NULL, NULL, ip, ip);
+}
+
+void net_arp_on_frame(int ifx, const uint8_t* frame, uint16_t len) {
+    if (ifx < 0 || ifx >= NETFACE_MAX) return;
+    s_stats.rx++;
+    if (len < 42) { s_stats.rx_bad++; return; }
+    const uint8_t* arp = frame + 14;
+    if (arp[0] != 0x00 || arp[1] != 0x01 || arp[2] != 0x08 || arp[3] != 0x00 || arp[4] != 6 || arp[5] != 4) { s_stats.rx_bad++; return; }
+    uint16_t op = (uint16_t)(((uint16_t)arp[6] << 8) | arp[7]);
+    const uint8_t* sha = arp + 8;
+    uint32_t sip = be32_at(arp + 14);
+    uint32_t tip = be32_at(arp + 24);
+    uint32_t me = arp_local_ip(ifx);
+
+    if (me && sip == me) {
+        // Someone else claims our address (our own announcements are not looped back)
+        int same = 1; for (int i = 0; i < 6; i++) if (sha[i] != s_mac[ifx][i]) same = 0;
+        if (!same) {
+            // Recorded only; net_arp_report() prints it from the shell loop
+            for (int i = 0; i < 6; i++) s_stats.conflict_mac[i] = sha[i];
+            s_stats.conflict_if = (uint8_t)ifx;
+            s_stats.conflicts++;
+        }
+        return;
+    }
+    if (sip == 0) {
+        // Address probe (RFC 5227): nothing to learn, answer if it is about us
+        if (op == 1 && me && tip == me) arp_send(ifx, 2, sha, sha, me, sip);
+        return;
+    }
+    if (sip == tip) s_stats.gratuitous++;
+
+    // RFC 826 merge: refresh a known sender; only create entries for traffic aimed at us
+    int idx = arp_find(ifx, sip);
+    if (idx >= 0) arp_update(idx, sha);
+    else if (me && tip == me) arp_update(arp_alloc(ifx, sip), sha);
+
+    if (op == 1 && me && tip == me) arp_send(ifx, 2, sha, sha, me, sip);
+}
+
+bool net_arp_output(int ifx, uint32_t next_hop, uint8_t* frame, uint16_t len) {
+    if (ifx < 0 || ifx >= NETFACE_MAX) return false;
+    if (next_hop == 0xFFFFFFFFu) {
+        for (int i = 0; i < 6; i++) frame[i] = s_bcast[i];
+        return netface_if_send(ifx, frame, len);
+    }
+    uint32_t now = platform_ticks_get();
+    uint32_t hz = arp_hz();
+    int idx = arp_find(ifx, next_hop);
+    if (idx >= 0 && s_arp[idx].state == ARP_REACHABLE) {
+        arp_entry_t* e = &s_arp[idx];
+        s_stats.hits++;
+        // Refresh in the last fifth of the lifetime with a unicast request, keep using the entry
+        uint32_t ttl = (uint32_t)CONFIG_NET_ARP_TTL_SEC * hz;
+        if (now - e->updated >= ttl - ttl / 5 && now - e->last_req >= hz) {
+            e->last_req = now;
+            arp_send(ifx, 1, e->mac, e->mac, arp_local_ip(ifx), next_hop);
+        }
+        for (int i = 0; i < 6; i++) frame[i] = e->mac[i];
+        return netface_if_send(ifx, frame, len);
+    }
+
+    s_stats.misses++;
+    if (idx < 0) {
+        idx = arp_alloc(ifx, next_hop);
+        s_arp[idx].tries = 1;
+        arp_send(ifx, 1, NULL, NULL, arp_local_ip(ifx), next_hop);
+    }
+    arp_entry_t* e = &s_arp[idx];
+    if (len > ARP_FRAME_MAX || s_qfree < 0 || e->qlen >= CONFIG_NET_ARP_QUEUE_PER_ENTRY) {
+        s_stats.dropped++;
+        return false;
+    }
+    int8_t q = s_qfree;
+    s_qfree = s_qnext[q];
+    uint8_t* dst = s_qbuf + (uint32_t)q * ARP_FRAME_MAX;
+    for (uint16_t i = 0; i < len; i++) dst[i] = frame[i];
+    s_qbytes[q] = len;
+    s_qnext[q] = -1;
+    // Append to keep transmit order
+    if (e->qhead < 0) e->qhead = q;
+    else { int8_t t = e->qhead; while (s_qnext[t] >= 0) t = s_qnext[t]; s_qnext[t] = q; }
+    e->qlen++;
+    s_stats.queued++;
+    return true;
+}
+
+bool net_arp_can_output(int ifx, uint32_t next_hop, uint16_t frames) {
+    if (ifx < 0 || ifx >= NETFACE_MAX) return false;
+    if (next_hop == 0xFFFFFFFFu) return true;
+    int idx = arp_find(ifx, next_hop);
+    if (idx >= 0 && s_arp[idx].state == ARP_REACHABLE) return true;
+    if (idx < 0) {
+        idx = arp_alloc(ifx, next_hop);
+        s_arp[idx].tries = 1;
+        arp_send(ifx, 1, NULL, NULL, arp_local_ip(ifx), next_hop);
+    }
+    uint16_t room = 0;
+    for (int8_t q = s_qfree; q >= 0 && room < frames; q = s_qnext[q]) room++;
+    if (room >= frames && s_arp[idx].qlen + frames <= CONFIG_NET_ARP_QUEUE_PER_ENTRY) return true;
+    s_stats.dropped += frames;
+    return false;
+}
+
+void net_arp_tick(void) {
+    uint32_t now = platform_ticks_get();
+    uint32_t hz = arp_hz();
+    // Scan at most four times per second
+    if (now - s_last_scan < hz / 4u) return;
+    s_last_scan = now;
+    uint32_t ttl = (uint32_t)CONFIG_NET_ARP_TTL_SEC * hz;
+    for (int i = 0; i < ARP_N; i++) {
+        arp_entry_t* e = &s_arp[i];
+        if (e->state == ARP_REACHABLE) {
+            if (now - e->updated >= ttl) { arp_free(i); s_stats.expired++; }
+        } else if (e->state == ARP_INCOMPLETE) {
+            if (now - e->last_req < hz) continue;
+            if (e->tries >= ARP_MAX_TRIES) { arp_free(i); s_stats.expired++; continue; }
+            e->tries++;
+            e->last_req = now;
+            arp_send(e->ifx, 1, NULL, NULL, arp_local_ip(e->ifx), e->ip);
+        }
+    }
+}
+
+static void print_ip_be(uint32_t be) {
+    for (int i = 3; i >= 0; i--) {
+        console_write_dec((be >> (i * 8)) & 0xFFu);
+        if (i) console_write(".");
+    }
+}
+
+// "<ethN> with <mac>" of the last conflict
+static void print_conflict(void) {
+    console_write(netface_name(s_stats.conflict_if));
+    console_write(" with ");
+    for (int i = 0; i < 6; i++) { print_hex8(s_stats.conflict_mac[i]); if (i < 5) console_write(":"); }
+    console_write("\n");
+}
+
+void net_arp_print(void) {
+    uint32_t now = platform_ticks_get();
+    uint32_t hz = arp_hz();
+    int n = 0;
+    for (int i = 0; i < ARP_N; i++) {
+        const arp_entry_t* e = &s_arp[i];
+        if (e->state == ARP_FREE) continue;
+        n++;
+        print_ip_be(e->ip);
+        console_write("  ");
+        console_write(netface_name(e->ifx));
+        console_write("  ");
+        if (e->state == ARP_REACHABLE) {
+            for (int j = 0; j < 6; j++) { print_hex8(e->mac[j]); if (j < 5) console_write(":"); }
+            console_write("  age=");
+            console_write_dec((now - e->updated) / hz);
+            console_write("s");
+        } else {
+            console_write("(incomplete) tries=");
+            console_write_dec(e->tries);
+        }
+        if (e->qlen) { console_write(" queued="); console_write_dec(e->qlen); }
+        console_write("\n");
+    }
+    console_write("arp: entries="); console_write_dec((uint32_t)n);
+    console_write("/"); console_write_dec(ARP_N);
+    console_write(" hits="); console_write_dec(s_stats.hits);
+    console_write(" misses="); console_write_dec(s_stats.misses);
+    console_write(" queued="); console_write_dec(s_stats.queued);
+    console_write(" flushed="); console_write_dec(s_stats.flushed);
+    console_write(" dropped="); console_write_dec(s_stats.dropped);
+    console_write("\n     req="); console_write_dec(s_stats.requests);
+    console_write(" rep="); console_write_dec(s_stats.replies);
+    console_write(" expired="); console_write_dec(s_stats.expired);
+    console_write(" evicted="); console_write_dec(s_stats.evicted);
+    console_write(" garp="); console_write_dec(s_stats.gratuitous);
+    console_write(" conflicts="); console_write_dec(s_stats.conflicts);
+    console_write("\n");
+    if (s_stats.conflicts) {
+        console_write("arp: last conflict ");
+        print_conflict();
+    }
+}
+
+void net_arp_report(void) {
+    uint32_t n = s_stats.conflicts;
+    if (n == s_conflicts_reported) return;
+    s_conflicts_reported = n;
+    console_write("arp: address conflict ");
+    print_conflict();
+}
+
+void net_arp_stats_get(net_arp_stats_t* out) { if (out) *out = s_stats; }
@@ -0,0 +1,57 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+// ARP neighbour cache (IPv4 over Ethernet).
+//
+// Entries live in a hashed table of CONFIG_NET_ARP_ENTRIES slots, expire after
+// CONFIG_NET_ARP_TTL_SEC and are refreshed with a unicast request shortly
+// before that while still in use. Frames sent to an unresolved neighbour are
+// parked on the entry and transmitted as soon as the reply arrives.
+// Each entry belongs to one netface interface (ifx); the same address may be
+// cached on several interfaces. All addresses are big-endian (network-order)
+// 32-bit values.
+
+typedef struct {
+    uint32_t hits, misses;          // lookups from the IPv4 send path
+    uint32_t requests, replies;     // ARP frames sent
+    uint32_t queued, flushed;       // parked frames and frames sent after resolution
+    uint32_t dropped;               // parked frames lost (queue full or no reply)
+    uint32_t expired, evicted;      // entries aged out / recycled while full
+    uint32_t gratuitous, conflicts; // gratuitous ARPs seen / our address claimed by another MAC
+    uint32_t rx, rx_bad;            // ARP frames received / not Ethernet-IPv4 or truncated
+    uint8_t  conflict_mac[6];       // sender of the last conflict
+    uint8_t  conflict_if;           // interface it was seen on
+} net_arp_stats_t;
+
+void net_arp_init(void);
+
+// Drop all entries and parked frames (of every interface / of one interface)
+void net_arp_flush(void);
+void net_arp_flush_if(int ifx);
+
+// Announce the interface address (gratuitous ARP request); called after address changes
+void net_arp_announce(int ifx);
+
+// RX entry point for EtherType 0x0806 (full Ethernet frame received on ifx)
+void net_arp_on_frame(int ifx, const uint8_t* frame, uint16_t len);
+
+// Fill the destination MAC of a complete Ethernet frame for 'next_hop' and send
+// it on interface ifx, or park a copy until the neighbour answers. Returns
+// false only when the frame had to be dropped.
+bool net_arp_output(int ifx, uint32_t next_hop, uint8_t* frame, uint16_t len);
+
+// True when 'frames' frames for 'next_hop' can all be sent or parked right
+// now (fragmented datagrams). Otherwise the neighbour is requested, the
+// frames are counted as dropped and the caller must not emit any of them.
+bool net_arp_can_output(int ifx, uint32_t next_hop, uint16_t frames);
+
+// Periodic work: request retries, refresh and expiry (cheap when nothing is due)
+void net_arp_tick(void);
+
+// Shell helpers
+void net_arp_print(void);
+// Print address conflicts seen since the last call. The RX path only counts
+// them; call this from the shell idle loop.
+void net_arp_report(void);
+void net_arp_stats_get(net_arp_stats_t* out);
@@ -0,0 +1,89 @@
+#include "csum.h"
+#include <stdint.h>
+
+// Word views that may alias any buffer; x86 tolerates unaligned loads, so the
+// hot loops read 32 bits at a time regardless of buffer alignment.
+typedef uint32_t __attribute__((may_alias)) csum_u32_t;
+typedef uint16_t __attribute__((may_alias)) csum_u16_t;
+
+static inline uint32_t csum_swap16(uint32_t v) { return ((v & 0xFFu) << 8) | ((v >> 8) & 0xFFu); }
+
+// 64-bit accumulator compiles to add/adc on i386; fold the carries back in
+// (end-around carry) so the result stays a valid 32-bit partial sum.
+static inline uint32_t csum_fold64(uint64_t acc) {
+    acc = (acc & 0xFFFFFFFFu) + (acc >> 32);
+    acc = (acc & 0xFFFFFFFFu) + (acc >> 32);
+    return (uint32_t)acc;
+}
+
+uint32_t net_csum_partial(const void* data, uint32_t len, uint32_t sum) {
+    const csum_u32_t* w = (const csum_u32_t*)data;
+    uint64_t acc = sum;
+    // 32 bytes per iteration; 2^16 == 1 (mod 0xFFFF), so summing 32-bit words
+    // is equivalent to summing their two 16-bit halves.
+    while (len >= 32) {
+        acc += w[0]; acc += w[1]; acc += w[2]; acc += w[3];
+        acc += w[4]; acc += w[5]; acc += w[6]; acc += w[7];
+        w += 8; len -= 32;
+    }
+    while (len >= 4) { acc += *w++; len -= 4; }
+    const uint8_t* p = (const uint8_t*)w;
+    if (len >= 2) { acc += *(const csum_u16_t*)p; p += 2; len -= 2; }
+    if (len) acc += p[0]; // odd byte: high half of a network-order word, low half of a LE load
+    return csum_fold64(acc);
+}
+
+uint32_t net_csum_copy(void* dst, const void* src, uint32_t len, uint32_t sum) {
+    const csum_u32_t* s = (const csum_u32_t*)src;
+    csum_u32_t* d = (csum_u32_t*)dst;
+    uint64_t acc = sum;
+    while (len >= 32) {
+        uint32_t a0 = s[0], a1 = s[1], a2 = s[2], a3 = s[3];
+        uint32_t a4 = s[4], a5 = s[5], a6 = s[6], a7 = s[7];
+        d[0] = a0; d[1] = a1; d[2] = a2; d[3] = a3;
+        d[4] = a4; d[5] = a5; d[6] = a6; d[7] = a7;
+        acc += a0; acc += a1; acc += a2; acc += a3;
+        acc += a4; acc += a5; acc += a6; acc += a7;
+        s += 8; d += 8; len -= 32;
+    }
+    while (len >= 4) { uint32_t a = *s++; *d++ = a; acc += a; len -= 4; }
+    const uint8_t* ps = (const uint8_t*)s;
+    uint8_t* pd = (uint8_t*)d;
+    if (len >= 2) {
+        uint16_t a = *(const csum_u16_t*)ps;
+        *(csum_u16_t*)pd = a; acc += a;
+        ps += 2; pd += 2; len -= 2;
+    }
+    if (len) { pd[0] = ps[0]; acc += ps[0]; }
+    return csum_fold64(acc);
+}
+
+uint32_t net_csum_pseudo_ipv4(uint32_t src_be, uint32_t dst_be, uint8_t proto, uint16_t len) {
+    // Same word order as net_csum_partial(): network-order words seen through LE loads
+    uint32_t sum = 0;
+    sum += csum_swap16(src_be >> 16); sum += csum_swap16(src_be & 0xFFFFu);
+    sum += csum_swap16(dst_be >> 16); sum += csum_swap16(dst_be & 0xFFFFu);
+    sum += csum_swap16(proto);
+    sum += csum_swap16(len);
+    return sum;
+}
+
+uint16_t net_csum_fold(uint32_t sum) {
+    sum = (sum & 0xFFFFu) + (sum >> 16);
+    sum = (sum & 0xFFFFu) + (sum >> 16);
+    return (uint16_t)csum_swap16((uint16_t)~sum);
+}
+
+uint16_t net_csum_update16(uint16_t csum, uint16_t old_be, uint16_t new_be) {
+    uint32_t sum = (uint16_t)~csum;
+    sum += (uint16_t)~old_be;
+    sum += new_be;
+    sum = (sum & 0xFFFFu) + (sum >> 16);
+    sum = (sum & 0xFFFFu) + (sum >> 16);
+    return (uint16_t)~sum;
+}
+
+uint16_t net_csum_update32(uint16_t csum, uint32_t old_be, uint32_t new_be) {
+    csum = net_csum_update16(csum, (uint16_t)(old_be >> 16), (uint16_t)(new_be >> 16));
+    return net_csum_update16(csum, (uint16_t)old_be, (uint16_t)new_be);
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <stdint.h>
+
+// Internet checksum (RFC 1071) helpers shared by IPv4/ICMP/TCP.
+//
+// Partial sums are 32-bit accumulators over the data as it sits in memory
+// (little-endian word loads on x86). Chain several chunks by passing the
+// previous result as 'sum'; every chunk except the last must have an even
+// length. net_csum_fold() turns an accumulator into the final checksum as a
+// host-order value in network numeric form, i.e. store it as (c>>8, c).
+
+// Accumulate 'len' bytes at 'data' onto 'sum' (start with 0).
+uint32_t net_csum_partial(const void* data, uint32_t len, uint32_t sum);
+
+// Copy 'len' bytes from 'src' to 'dst' and accumulate them in the same pass.
+uint32_t net_csum_copy(void* dst, const void* src, uint32_t len, uint32_t sum);
+
+// IPv4 pseudo-header (addresses big-endian values, length in host order).
+uint32_t net_csum_pseudo_ipv4(uint32_t src_be, uint32_t dst_be, uint8_t proto, uint16_t len);
+
+// Fold an accumulator to 16 bits and complement it.
+uint16_t net_csum_fold(uint32_t sum);
+
+// One-shot checksum over a buffer (IPv4 header, ICMP message, ...).
+static inline uint16_t net_csum(const void* data, uint32_t len) {
+    return net_csum_fold(net_csum_partial(data, len, 0));
+}
+
+// Incremental update (RFC 1624, eqn. 3) when a 16-bit field changes from
+// old_be to new_be: HC' = ~(~HC + ~m + m'). All values in network numeric form.
+uint16_t net_csum_update16(uint16_t csum, uint16_t old_be, uint16_t new_be);
+// Same for a 32-bit field (e.g. an IPv4 address rewrite).
+uint16_t net_csum_update32(uint16_t csum, uint32_t old_be, uint32_t new_be);
@@ -0,0 +1,166 @@
+#include "ipfrag.h"
+#include "csum.h"
+#include "netstat.h"
+#include "../config.h"
+#include "../memory.h"
+#include "../platform.h"
+#include <stddef.h>
+
+#define RA_HDR     60u                                  // room for the largest IPv4 header
+#define RA_DATA    (CONFIG_NET_IP_MAX_DATAGRAM - 20u)   // payload bytes per datagram
+#define RA_BLOCKS  ((RA_DATA + 7u) / 8u)
+
+enum { RA_FREE = 0, RA_BUSY, RA_DELIVER };
+
+typedef struct {
+    uint8_t  state;
+    uint8_t  proto;
+    uint8_t  hdr_len;       // header of the offset-0 fragment, 0 until it arrived
+    uint16_t id;
+    uint32_t src, dst;
+    uint32_t started;       // ticks at the first fragment
+    uint16_t total;         // payload length, known once the last fragment is in
+    uint8_t* buf;           // RA_HDR + RA_DATA, header ends where the payload starts
+    uint8_t  map[(RA_BLOCKS + 7u) / 8u];
+} ra_slot_t;
+
+static ra_slot_t s_ra[CONFIG_NET_IP_REASM_SLOTS];
+
+static uint32_t be32_at(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static uint32_t ra_hz(void) { uint32_t hz = platform_timer_get_hz(); return hz ? hz : 100u; }
+
+void net_ipfrag_init(void) {
+    for (int i = 0; i < CONFIG_NET_IP_REASM_SLOTS; i++) s_ra[i].state = RA_FREE;
+}
+
+static void ra_reset(ra_slot_t* s) {
+    s->hdr_len = 0;
+    s->total = 0;
+    for (uint32_t i = 0; i < sizeof(s->map); i++) s->map[i] = 0;
+}
+
+static ra_slot_t* ra_lookup(uint32_t src, uint32_t dst, uint16_t id, uint8_t proto) {
+    for (int i = 0; i < CONFIG_NET_IP_REASM_SLOTS; i++) {
+        ra_slot_t* s = &s_ra[i];
+        if (s->state == RA_BUSY && s->id == id && s->src == src && s->dst == dst && s->proto == proto) return s;
+    }
+    return NULL;
+}
+
+static ra_slot_t* ra_alloc(uint32_t src, uint32_t dst, uint16_t id, uint8_t proto) {
+    ra_slot_t* victim = NULL;
+    for (int i = 0; i < CONFIG_NET_IP_REASM_SLOTS; i++) {
+        ra_slot_t* s = &s_ra[i];
+        if (s->state == RA_FREE) { victim = s; break; }
+        if (s->state == RA_BUSY && (!victim || (int32_t)(s->started - victim->started) < 0)) victim = s;
+    }
+    if (!victim) return NULL;
+    if (victim->state == RA_BUSY) NET_STAT_INC(ip_reasm_evicted);
+    if (!victim->buf) victim->buf = (uint8_t*)memory_alloc(RA_HDR + RA_DATA);
+    if (!victim->buf) { victim->state = RA_FREE; return NULL; }
+    ra_reset(victim);
+    victim->state = RA_BUSY;
+    victim->src = src; victim->dst = dst; victim->id = id; victim->proto = proto;
+    victim->started = platform_ticks_get();
+    return victim;
+}
+
+uint8_t* net_ipfrag_input(const uint8_t* ip, uint16_t ip_total, uint16_t* out_total) {
+    uint8_t ihl = (uint8_t)((ip[0] & 0x0F) * 4);
+    uint32_t off = ((((uint32_t)ip[6] & 0x1Fu) << 8) | ip[7]) * 8u;
+    bool more = (ip[6] & 0x20) != 0;
+    uint32_t dlen = (uint32_t)ip_total - ihl;
+    uint32_t src = be32_at(ip + 12), dst = be32_at(ip + 16);
+    uint16_t id = (uint16_t)(((uint16_t)ip[4] << 8) | ip[5]);
+
+    ra_slot_t* s = ra_lookup(src, dst, id, ip[9]);
+    // Every fragment but the last carries a multiple of 8 bytes
+    if (dlen == 0 || (more && (dlen & 7u))) { NET_STAT_INC(ip_reasm_bad); return NULL; }
+    if (off + dlen > RA_DATA) {
+        NET_STAT_INC(ip_too_big);
+        if (s) s->state = RA_FREE;
+        return NULL;
+    }
+    if (!more && s && s->total && s->total != off + dlen) {
+        // Two different ends: the datagram cannot be trusted
+        NET_STAT_INC(ip_reasm_bad);
+        s->state = RA_FREE;
+        return NULL;
+    }
+    if (more && s && s->total && off + dlen > s->total) {
+        // A middle fragment reaching past the known end
+        NET_STAT_INC(ip_reasm_bad);
+        s->state = RA_FREE;
+        return NULL;
+    }
+    if (!s) s = ra_alloc(src, dst, id, ip[9]);
+    if (!s) { NET_STAT_INC(ip_reasm_bad); return NULL; }
+
+    if (!more && !s->total) {
+        // Blocks already received at or past the end came from fragments
+        // that contradict it
+        for (uint32_t b = (off + dlen) / 8u; b < RA_BLOCKS; b++) {
+            if (s->map[b >> 3] & (1u << (b & 7u))) {
+                NET_STAT_INC(ip_reasm_bad);
+                s->state = RA_FREE;
+                return NULL;
+            }
+        }
+        s->total = (uint16_t)(off + dlen);
+    }
+    if (off == 0) {
+        s->hdr_len = ihl;
+        uint8_t* h = s->buf + RA_HDR - ihl;
+        for (uint8_t i = 0; i < ihl; i++) h[i] = ip[i];
+    }
+    uint8_t* d = s->buf + RA_HDR + off;
+    for (uint32_t i = 0; i < dlen; i++) d[i] = ip[ihl + i];
+    for (uint32_t b = off / 8u; b < (off + dlen + 7u) / 8u; b++) s->map[b >> 3] |= (uint8_t)(1u << (b & 7u));
+
+    // Complete only when every block inside [0, total) is present
+    if (!s->total || !s->hdr_len) return NULL;
+    for (uint32_t b = 0; b < (s->total + 7u) / 8u; b++) {
+        if (!(s->map[b >> 3] & (1u << (b & 7u)))) return NULL;
+    }
+
+    // Complete: turn the first fragment's header into the datagram header
+    uint8_t* h = s->buf + RA_HDR - s->hdr_len;
+    uint16_t tot = (uint16_t)(s->hdr_len + s->total);
+    h[2] = (uint8_t)(tot >> 8); h[3] = (uint8_t)tot;
+    h[6] &= 0x40; h[7] = 0;     // keep DF, clear MF/offset
+    h[10] = 0; h[11] = 0;
+    uint16_t c = net_csum(h, s->hdr_len);
+    h[10] = (uint8_t)(c >> 8); h[11] = (uint8_t)c;
+    s->state = RA_DELIVER;
+    NET_STAT_INC(ip_reasm_ok);
+    if (out_total) *out_total = tot;
+    return h;
+}
+
+void net_ipfrag_release(const uint8_t* dgram) {
+    for (int i = 0; i < CONFIG_NET_IP_REASM_SLOTS; i++) {
+        ra_slot_t* s = &s_ra[i];
+        if (s->state == RA_DELIVER && dgram >= s->buf && dgram < s->buf + RA_HDR) s->state = RA_FREE;
+    }
+}
+
+void net_ipfrag_tick(void) {
+    uint32_t now = platform_ticks_get();
+    uint32_t tmo = (uint32_t)CONFIG_NET_IP_REASM_TIMEOUT_SEC * ra_hz();
+    for (int i = 0; i < CONFIG_NET_IP_REASM_SLOTS; i++) {
+        ra_slot_t* s = &s_ra[i];
+        if (s->state == RA_BUSY && now - s->started >= tmo) {
+            s->state = RA_FREE;
+            NET_STAT_INC(ip_reasm_timeout);
+        }
+    }
+}
+
+int net_ipfrag_pending(void) {
+    int n = 0;
+    for (int i = 0; i < CONFIG_NET_IP_REASM_SLOTS; i++) if (s_ra[i].state == RA_BUSY) n++;
+    return n;
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+// IPv4 fragment reassembly (RFC 791, hole tracking as in RFC 815).
+//
+// CONFIG_NET_IP_REASM_SLOTS datagrams, keyed by (src, dst, id, protocol), are
+// reassembled at once. Each slot owns a buffer of CONFIG_NET_IP_MAX_DATAGRAM
+// bytes (allocated on first use) and a bitmap of received 8-byte blocks, so
+// fragments may arrive in any order, duplicated or overlapping. A datagram
+// missing pieces after CONFIG_NET_IP_REASM_TIMEOUT_SEC is dropped; when every
+// slot is busy, the oldest incomplete datagram makes room. Counters live in
+// g_net_stats (netstat.h). Runs from netface_poll() only.
+
+void net_ipfrag_init(void);
+
+// Feed one fragment (ip = validated header, ip_total = its total length).
+// Returns the complete datagram (header without fragment bits + payload,
+// total length in *out_total) when this fragment finishes it, else NULL.
+// The buffer stays valid until net_ipfrag_release().
+uint8_t* net_ipfrag_input(const uint8_t* ip, uint16_t ip_total, uint16_t* out_total);
+void net_ipfrag_release(const uint8_t* dgram);
+
+// Expire incomplete datagrams (netface scheduler via net_ipv4_poll)
+void net_ipfrag_tick(void);
+
+// Incomplete datagrams held right now
+int net_ipfrag_pending(void);
@@ -1,4 +1,13 @@
 #include "ipv4.h"
+#include "arp.h"
+#include "csum.h"
+#include "udp.h"
+#include "tftp.h"
+#include "ping.h"
+#include "tcpbench.h"
+#include "tcp_min.h"
+#include "netstat.h"
+#include "ipfrag.h"
 #include "../netface.h"
 #include "../console.h"
 #include "../platform.h"
@@ -6,44 +15,58 @@
 #include <stddef.h>
 
 // Utilities
-static uint16_t csum16(const void* data, uint16_t len) {
-    const uint8_t* p = (const uint8_t*)data;
-    uint32_t sum = 0;
-    while (len > 1) { sum += ((uint16_t)p[0] << 8) | p[1]; p += 2; len -= 2; }
-    if (len) sum += ((uint16_t)p[0] << 8);
-    // fold
-    while (sum >> 16) sum = (sum & 0xFFFF) + (sum >> 16);
-    return (uint16_t)~sum;
-}
-
 static __attribute__((unused)) uint16_t htons16(uint16_t v){ return (uint16_t)((v<<8) | (v>>8)); }
 static uint32_t htonl32(uint32_t v){ return ((v&0xFF)<<24)|((v&0xFF00)<<8)|((v&0xFF0000)>>8)|((v>>24)&0xFF); }
 
-// Local config (stored big-endian/network order)
-static uint32_t g_ip, g_mask, g_gw;
-static uint8_t  g_mac[6];
+// Per-interface config (stored big-endian/network order)
+typedef struct { uint32_t ip, mask, gw; uint8_t mac[6]; } ipv4_if_t;
+static ipv4_if_t g_if[NETFACE_MAX];
 
-// ARP cache: store IPv4 in network byte order (big-endian value)
-typedef struct { uint32_t ip; uint8_t mac[6]; uint32_t ts; int used; } arp_entry_t;
-static arp_entry_t g_arp[8];
+static ipv4_if_t* if_cfg(int ifx){ return (ifx>=0 && ifx<netface_count() && ifx<NETFACE_MAX) ? &g_if[ifx] : NULL; }
 
-static void arp_cache_learn(uint32_t ip, const uint8_t mac[6]){
-    int slot = -1;
-    for (int i=0;i<8;i++){ if (g_arp[i].used && g_arp[i].ip==ip){ slot=i; break; } if (!g_arp[i].used && slot<0) slot=i; }
-    if (slot<0) slot=0;
-    g_arp[slot].ip=ip; for (int i=0;i<6;i++) g_arp[slot].mac[i]=mac[i]; g_arp[slot].used=1; g_arp[slot].ts=platform_ticks_get();
+void net_ipv4_if_config_set(int ifx, uint32_t ip_be, uint32_t mask_be, uint32_t gw_be){
+    ipv4_if_t* c=if_cfg(ifx); if (!c) return;
+    c->ip=ip_be; c->mask=mask_be; c->gw=gw_be; (void)netface_if_get_mac(ifx, c->mac);
+    // Old neighbours may sit on another subnet now; announce the new address
+    net_arp_flush_if(ifx);
+    net_arp_announce(ifx);
 }
 
-static int arp_cache_lookup(uint32_t ip, uint8_t mac[6]){
-    for (int i=0;i<8;i++){ if (g_arp[i].used && g_arp[i].ip==ip){ for (int j=0;j<6;j++) mac[j]=g_arp[i].mac[j]; return 1; } }
-    return 0;
+bool net_ipv4_if_config_get(int ifx, uint32_t* ip_be, uint32_t* mask_be, uint32_t* gw_be){
+    ipv4_if_t* c=if_cfg(ifx);
+    if (ip_be) *ip_be=c?c->ip:0;
+    if (mask_be) *mask_be=c?c->mask:0;
+    if (gw_be) *gw_be=c?c->gw:0;
+    return c!=NULL;
 }
 
-void net_ipv4_config_set(uint32_t ip_be, uint32_t mask_be, uint32_t gw_be){
-    g_ip=ip_be; g_mask=mask_be; g_gw=gw_be; (void)netface_get_mac(g_mac);
+void net_ipv4_config_set(uint32_t ip_be, uint32_t mask_be, uint32_t gw_be){ net_ipv4_if_config_set(0, ip_be, mask_be, gw_be); }
+void net_ipv4_config_get(uint32_t* ip_be, uint32_t* mask_be, uint32_t* gw_be){ (void)net_ipv4_if_config_get(0, ip_be, mask_be, gw_be); }
+
+bool net_ipv4_route(uint32_t dst, int* ifx_out, uint32_t* next_hop, uint32_t* src){
+    int n=netface_count(); if (n>NETFACE_MAX) n=NETFACE_MAX;
+    if (n<=0) return false;
+    int best=-1; uint32_t best_mask=0;
+    // Directly connected: longest matching prefix
+    for (int i=0;i<n;i++){
+        const ipv4_if_t* c=&g_if[i];
+        if (!c->ip || !c->mask) continue;
+        if ((dst & c->mask)!=(c->ip & c->mask)) continue;
+        if (best<0 || c->mask>best_mask){ best=i; best_mask=c->mask; }
+    }
+    uint32_t hop=dst;
+    if (best<0 && dst!=0xFFFFFFFFu){
+        // Default route: first interface with a gateway
+        for (int i=0;i<n;i++) if (g_if[i].ip && g_if[i].gw){ best=i; hop=g_if[i].gw; break; }
+    }
+    if (best<0) best=0; // unconfigured/limited broadcast: default interface on-link
+    if (ifx_out) *ifx_out=best;
+    if (next_hop) *next_hop=hop;
+    if (src) *src=g_if[best].ip;
+    return true;
 }
 
-void net_ipv4_config_get(uint32_t* ip_be, uint32_t* mask_be, uint32_t* gw_be){ if (ip_be) *ip_be=g_ip; if (mask_be) *mask_be=g_mask; if (gw_be) *gw_be=g_gw; }
+uint32_t net_ipv4_source_for(uint32_t dst){ uint32_t src=0; (void)net_ipv4_route(dst, NULL, NULL, &src); return src; }
 
 static uint32_t parse_ipv4_str(const char* s, int* ok){
     uint32_t a=0; int part=0; uint32_t v=0; int d=0; *ok=0;
@@ -64,11 +87,18 @@ static uint32_t parse_ipv4_str(const char* s, int* ok){
     a=(a<<8)|v; *ok=1; return a; // return big-endian/network-order value
 }
 
-bool net_ipv4_set_from_strings(const char* ip, const char* mask, const char* gw){
+bool net_ipv4_parse_addr(const char* s, uint32_t* out_be){
+    int ok=0; uint32_t a=parse_ipv4_str(s,&ok);
+    if (!ok) return false;
+    if (out_be) *out_be=a;
+    return true;
+}
+
+bool net_ipv4_set_from_strings(int ifx, const char* ip, const char* mask, const char* gw){
     int ok1=0, ok2=0, ok3=1; uint32_t a=parse_ipv4_str(ip,&ok1), m=parse_ipv4_str(mask,&ok2), g=0;
     if (gw && *gw){ g=parse_ipv4_str(gw,&ok3); }
-    if (!ok1||!ok2||!ok3) return false;
-    net_ipv4_config_set(a,m,g);
+    if (!ok1||!ok2||!ok3 || !if_cfg(ifx)) return false;
+    net_ipv4_if_config_set(ifx,a,m,g);
     return true;
 }
 
@@ -82,130 +112,163 @@ static void print_ip(uint32_t be){
 }
 
 void net_ipv4_print_config(void){
-    console_write("ip="); print_ip(g_ip); console_write(" mask="); print_ip(g_mask); console_write(" gw="); if (g_gw) print_ip(g_gw); else console_write("0.0.0.0"); console_write("\n");
+    int n=netface_count(); if (n>NETFACE_MAX) n=NETFACE_MAX;
+    if (n<=0) { console_write("ip: no interface\n"); return; }
+    for (int i=0;i<n;i++){
+        const ipv4_if_t* c=&g_if[i];
+        console_write(netface_name(i)); console_write(": ");
+        console_write("ip="); print_ip(c->ip); console_write(" mask="); print_ip(c->mask); console_write(" gw="); if (c->gw) print_ip(c->gw); else console_write("0.0.0.0");
+        const netface_ops_t* ops=netface_ops(i);
+        console_write(" ("); console_write(ops?ops->name:"?"); console_write(")\n");
+    }
+}
+
+void net_ipv4_print_route(uint32_t dst){
+    int ifx=0; uint32_t hop=0, src=0;
+    print_ip(dst);
+    if (!net_ipv4_route(dst, &ifx, &hop, &src)) { console_write(": no route\n"); return; }
+    console_write(hop==dst ? " on-link" : " via "); if (hop!=dst) print_ip(hop);
+    console_write(" dev "); console_write(netface_name(ifx));
+    console_write(" src "); print_ip(src); console_write("\n");
 }
 
-void net_ipv4_init(void){ (void)netface_get_mac(g_mac); g_ip=0; g_mask=0; g_gw=0; for(int i=0;i<8;i++) g_arp[i].used=0; }
-
-// Build and send ARP reply or request
-// sip/tip are big-endian (network-order) 32-bit values
-static void send_arp_reply(const uint8_t* sha, const uint8_t* tha, uint32_t sip_be, uint32_t tip_be, int is_reply){
-    uint8_t f[42]; // 14 eth + 28 arp
-    (void)sha; // quiet unused
-    // Ethernet
-    for(int i=0;i<6;i++) f[i] = tha ? tha[i] : 0xFF; // dst (reply to THA or broadcast for request)
-    for(int i=0;i<6;i++) f[6+i] = g_mac[i];
-    f[12]=0x08; f[13]=0x06; // ARP
-    // ARP
-    f[14]=0x00; f[15]=0x01; // HTYPE Ethernet
-    f[16]=0x08; f[17]=0x00; // PTYPE IPv4
-    f[18]=0x06; f[19]=0x04; // HLEN=6, PLEN=4
-    f[20]= is_reply ? 0x00 : 0x00; f[21]= is_reply ? 0x02 : 0x01; // OPER reply/request
-    // SHA,SIP,THA,TIP
-    for(int i=0;i<6;i++) f[22+i] = g_mac[i];
-    // Emit IPv4 addresses from big-endian 32-bit: high→low bytes
-    f[28]= (uint8_t)(sip_be>>24); f[29]=(uint8_t)(sip_be>>16); f[30]=(uint8_t)(sip_be>>8); f[31]=(uint8_t)(sip_be);
-    for(int i=0;i<6;i++) f[32+i] = tha ? tha[i] : 0x00;
-    f[38]=(uint8_t)(tip_be>>24); f[39]=(uint8_t)(tip_be>>16); f[40]=(uint8_t)(tip_be>>8); f[41]=(uint8_t)(tip_be);
-    netface_send(f, 42);
+void net_ipv4_init(void){
+    for (int i=0;i<NETFACE_MAX;i++){ g_if[i].ip=0; g_if[i].mask=0; g_if[i].gw=0; (void)netface_if_get_mac(i, g_if[i].mac); }
+    net_arp_init(); net_ipfrag_init(); net_udp_init();
 }
 
-static void send_arp_request(uint32_t target_ip){ send_arp_reply(NULL, NULL, g_ip, target_ip, 0); }
+void net_ipv4_poll(void){ net_arp_tick(); net_ipfrag_tick(); net_tftp_tick(); net_tcpbench_tick(); net_tcp_min_tick(); }
 
-// Send Ethernet+IPv4 payload
+// Identification for outgoing datagrams (needed once they are fragmented)
+static uint16_t s_ip_id = 1;
+
+// Send Ethernet+IPv4 payload; datagrams beyond one frame leave as fragments
 bool net_ipv4_send(uint32_t dst_ip, uint8_t proto, const uint8_t* payload, uint16_t plen){
-    uint8_t dst_mac[6]; uint32_t target = dst_ip;
-    // Choose next-hop (gateway if outside subnet)
-    if (g_mask && g_ip && ((dst_ip & g_mask) != (g_ip & g_mask)) && g_gw) target = g_gw;
-    if (!arp_cache_lookup(target, dst_mac)) { send_arp_request(target); return false; }
-
-    // Build frame: Ethernet + IPv4 + payload
-    uint8_t buf[14+20+1500]; if (plen>1500) plen=1500;
-    for (int i=0;i<6;i++){ buf[i]=dst_mac[i]; buf[6+i]=g_mac[i]; }
-    buf[12]=0x08; buf[13]=0x00; // IPv4
-    // IPv4 header
-    uint8_t* ip = buf+14;
-    ip[0]=0x45;                 // Version 4, IHL=5 (no options)
-    ip[1]=0;                    // DSCP/ECN
-    uint16_t tot= (uint16_t)(20+plen);
-    ip[2]=(uint8_t)(tot>>8);    // Total length (BE)
-    ip[3]=(uint8_t)tot;
-    ip[4]=0; ip[5]=0;           // Identification
-    ip[6]=0x40; ip[7]=0;        // Flags/fragment offset: DF set, offset 0
-    ip[8]=64;                   // TTL
-    ip[9]=proto;                // Protocol
-    ip[10]=0; ip[11]=0;         // Header checksum (zero for calc)
-    // Source/Destination IPv4 (big-endian values → high byte first)
-    ip[12]=(uint8_t)(g_ip>>24); ip[13]=(uint8_t)(g_ip>>16); ip[14]=(uint8_t)(g_ip>>8); ip[15]=(uint8_t)g_ip;
-    ip[16]=(uint8_t)(dst_ip>>24); ip[17]=(uint8_t)(dst_ip>>16); ip[18]=(uint8_t)(dst_ip>>8); ip[19]=(uint8_t)dst_ip;
-    // Compute header checksum
-    uint16_t c=csum16(ip,20); ip[10]=(uint8_t)(c>>8); ip[11]=(uint8_t)c;
-    // payload
-    for (uint16_t i=0;i<plen;i++) buf[14+20+i]=payload[i];
-    return netface_send(buf, (uint16_t)(14+20+plen));
+    // Choose interface and next hop (gateway if outside every subnet)
+    int ifx=0; uint32_t target=dst_ip, src=0;
+    if (!net_ipv4_route(dst_ip, &ifx, &target, &src)) { NET_STAT_INC(ip_no_route); return false; }
+    if (plen > NET_IPV4_MAX_PAYLOAD) { NET_STAT_INC(ip_too_big); return false; }
+    const uint8_t* mac = g_if[ifx].mac;
+    uint16_t id = s_ip_id++;
+    bool frag = plen > NET_IPV4_FRAME_PAYLOAD;
+    // All fragments or none: a partial datagram would only block a reassembly slot
+    if (frag && !net_arp_can_output(ifx, target, (uint16_t)((plen + NET_IPV4_FRAME_PAYLOAD - 1u) / NET_IPV4_FRAME_PAYLOAD))) {
+        NET_STAT_INC(ip_tx_fail);
+        return false;
+    }
+
+    uint8_t buf[14+20+NET_IPV4_FRAME_PAYLOAD];
+    uint16_t off = 0;
+    do {
+        uint16_t n = (uint16_t)(plen - off);
+        bool more = false;
+        if (n > NET_IPV4_FRAME_PAYLOAD) { n = NET_IPV4_FRAME_PAYLOAD; more = true; }
+        // Build frame: Ethernet + IPv4 + payload (destination MAC filled in by ARP)
+        for (int i=0;i<6;i++){ buf[i]=0; buf[6+i]=mac[i]; }
+        buf[12]=0x08; buf[13]=0x00; // IPv4
+        // IPv4 header
+        uint8_t* ip = buf+14;
+        ip[0]=0x45;                 // Version 4, IHL=5 (no options)
+        ip[1]=0;                    // DSCP/ECN
+        uint16_t tot= (uint16_t)(20+n);
+        ip[2]=(uint8_t)(tot>>8);    // Total length (BE)
+        ip[3]=(uint8_t)tot;
+        ip[4]=(uint8_t)(id>>8); ip[5]=(uint8_t)id; // Identification
+        // Flags/fragment offset: DF on single-frame datagrams, else MF + offset in 8-byte units
+        if (!frag) { ip[6]=0x40; ip[7]=0; }
+        else { ip[6]=(uint8_t)((more?0x20:0) | ((off>>11)&0x1F)); ip[7]=(uint8_t)(off>>3); }
+        ip[8]=64;                   // TTL
+        ip[9]=proto;                // Protocol
+        ip[10]=0; ip[11]=0;         // Header checksum (zero for calc)
+        // Source/Destination IPv4 (big-endian values → high byte first)
+        ip[12]=(uint8_t)(src>>24); ip[13]=(uint8_t)(src>>16); ip[14]=(uint8_t)(src>>8); ip[15]=(uint8_t)src;
+        ip[16]=(uint8_t)(dst_ip>>24); ip[17]=(uint8_t)(dst_ip>>16); ip[18]=(uint8_t)(dst_ip>>8); ip[19]=(uint8_t)dst_ip;
+        // Compute header checksum
+        uint16_t c=net_csum(ip,20); ip[10]=(uint8_t)(c>>8); ip[11]=(uint8_t)c;
+        // payload
+        for (uint16_t i=0;i<n;i++) buf[14+20+i]=payload[off+i];
+        // Sent now if the neighbour is known, otherwise parked until the ARP reply
+        if (!net_arp_output(ifx, target, buf, (uint16_t)(14+tot))) { NET_STAT_INC(ip_tx_fail); return false; }
+        if (frag) NET_STAT_INC(ip_frag_tx);
+        off = (uint16_t)(off + n);
+    } while (off < plen);
+    if (frag) NET_STAT_INC(ip_frag_dgrams);
+    NET_STAT_INC(ip_tx); NET_STAT_ADD(ip_tx_bytes, 20u + plen);
+    return true;
 }
 
 // ICMP echo reply to incoming
 static void icmp_reply(const uint8_t* ip, const uint8_t* icmp, uint16_t icmp_len){
-    uint8_t rep[1500]; if (icmp_len>1500) icmp_len=1500;
+    // netface_poll() only, so one static buffer serves reassembled echoes too
+    static uint8_t rep[NET_IPV4_MAX_PAYLOAD];
+    int truncated=0; if (icmp_len>NET_IPV4_MAX_PAYLOAD) { icmp_len=NET_IPV4_MAX_PAYLOAD; truncated=1; }
     for (uint16_t i=0;i<icmp_len;i++) rep[i]=icmp[i];
-    rep[0]=0; rep[1]=0; rep[2]=0; rep[3]=0; // type=0 code=0 csum=0 for calc
-    uint16_t c = csum16(rep, icmp_len); rep[2]=(uint8_t)(c>>8); rep[3]=(uint8_t)c;
+    // Only type/code change (8/0 -> 0/0): patch the sender's checksum (RFC 1624)
+    // instead of re-summing the whole echo payload.
+    uint16_t c_in = (uint16_t)(((uint16_t)icmp[2]<<8) | icmp[3]);
+    uint16_t tc_in = (uint16_t)(((uint16_t)icmp[0]<<8) | icmp[1]);
+    rep[0]=0; rep[1]=0; // type=0 code=0
+    uint16_t c;
+    if (!truncated) c = net_csum_update16(c_in, tc_in, 0x0000);
+    else { rep[2]=0; rep[3]=0; c = net_csum(rep, icmp_len); }
+    rep[2]=(uint8_t)(c>>8); rep[3]=(uint8_t)c;
     // destination for reply is the original source IP (big-endian 32-bit)
     uint32_t src = ((uint32_t)ip[12]<<24)|((uint32_t)ip[13]<<16)|((uint32_t)ip[14]<<8)|((uint32_t)ip[15]);
-    (void)net_ipv4_send(src, 1, rep, icmp_len);
+    if (net_ipv4_send(src, 1, rep, icmp_len)) NET_STAT_INC(icmp_echo_rep_tx);
+}
+
+// Hand a complete datagram (ip_total bytes, header validated) to its protocol
+static void ipv4_deliver(const uint8_t* ip, uint8_t ihl, uint16_t ip_total){
+    uint8_t proto = ip[9];
+    if (proto == 1) { // ICMP
+        const uint8_t* icmp = ip+ihl; uint16_t icmp_len = (uint16_t)(ip_total - ihl);
+        NET_STAT_INC(ip_rx); NET_STAT_ADD(ip_rx_bytes, ip_total);
+        NET_STAT_INC(icmp_rx);
+        if (icmp_len < 8) NET_STAT_INC(icmp_short);
+        else if (icmp[0]==8) { NET_STAT_INC(icmp_echo_req); icmp_reply(ip, icmp, icmp_len); }
+        else if (icmp[0]==0) {
+            uint32_t src = ((uint32_t)ip[12]<<24)|((uint32_t)ip[13]<<16)|((uint32_t)ip[14]<<8)|((uint32_t)ip[15]);
+            NET_STAT_INC(icmp_echo_rep_rx);
+            net_ping_on_reply(src, icmp, icmp_len);
+        } else NET_STAT_INC(icmp_other);
+    } else if (proto == 6) { // TCP (route to minimal TCP)
+        NET_STAT_INC(ip_rx); NET_STAT_ADD(ip_rx_bytes, ip_total);
+        NET_STAT_INC(tcp_rx);
+        if (!net_tcpbench_on_ipv4(ip, ip_total)) net_tcp_on_ipv4(ip, ip_total);
+    } else if (proto == 17) { // UDP
+        NET_STAT_INC(ip_rx); NET_STAT_ADD(ip_rx_bytes, ip_total);
+        net_udp_on_ipv4(ip, ip_total);
+    } else NET_STAT_INC(ip_unknown_proto);
 }
 
-void net_ipv4_on_frame(const uint8_t* frame, uint16_t len){
-    if (len < 14) return;
+void net_ipv4_on_frame(int ifx, const uint8_t* frame, uint16_t len){
+    if (!if_cfg(ifx)) return;
+    net_stats_nic_t* nic = &g_net_stats.nic[ifx];
+    if (len < 14) { nic->rx_runt++; return; }
     uint16_t eth = ((uint16_t)frame[12] << 8) | frame[13];
     if (eth == 0x0806) {
-        if (len < 42) return; // ARP
-        const uint8_t* arp = frame+14;
-        uint16_t op = ((uint16_t)arp[6]<<8)|arp[7];
-        // Parse sender/target IPv4 as big-endian 32-bit
-        uint32_t sip = ((uint32_t)arp[14]<<24)|((uint32_t)arp[15]<<16)|((uint32_t)arp[16]<<8)|((uint32_t)arp[17]);
-        uint32_t tip = ((uint32_t)arp[24]<<24)|((uint32_t)arp[25]<<16)|((uint32_t)arp[26]<<8)|((uint32_t)arp[27]);
-        // learn sender
-        arp_cache_learn(sip, arp+8);
-        // if ARP request for us, reply to sender MAC (ARP SHA)
-        if (op==1 && tip==g_ip) send_arp_reply(NULL, arp+8, g_ip, sip, 1);
+        net_arp_on_frame(ifx, frame, len);
         return;
     } else if (eth == 0x0800) {
-        if (len < 34) return; // IPv4
         const uint8_t* ip = frame+14;
-        if ((ip[0]>>4)!=4) return;
+        if (len < 34 || (ip[0]>>4)!=4) { NET_STAT_INC(ip_hdr_err); return; }
         uint8_t ihl = (uint8_t)((ip[0]&0x0F)*4);
-        if (len < 14+ihl) return;
+        uint16_t ip_total = (uint16_t)(((uint16_t)ip[2]<<8) | ip[3]);
+        if (ihl < 20 || len < 14+ihl || ip_total < ihl || ip_total > len - 14) { NET_STAT_INC(ip_hdr_err); return; }
+        if (net_csum(ip, ihl) != 0) { NET_STAT_INC(ip_csum_err); return; }
         uint32_t dst = ((uint32_t)ip[16]<<24)|((uint32_t)ip[17]<<16)|((uint32_t)ip[18]<<8)|((uint32_t)ip[19]);
-        if (dst != g_ip && g_ip!=0) return; // not for us (ignore broadcast handling for now)
-        uint8_t proto = ip[9];
-        if (proto == 1) { // ICMP
-            const uint8_t* icmp = ip+ihl; uint16_t icmp_len = (uint16_t)(len - 14 - ihl);
-            if (icmp_len >= 8 && icmp[0]==8) { icmp_reply(ip, icmp, icmp_len); }
-        } else if (proto == 6) { // TCP (route to minimal TCP)
-            extern void net_tcp_on_ipv4(const uint8_t* ip, uint16_t ip_len);
-            uint16_t ip_total = (uint16_t)(((uint16_t)ip[2]<<8) | ip[3]);
-            if (ip_total >= ihl) net_tcp_on_ipv4(ip, ip_total);
+        uint32_t me = g_if[ifx].ip;
+        if (dst != me && me!=0) { NET_STAT_INC(ip_not_local); return; } // not for this interface (ignore broadcast handling for now)
+        if ((ip[6] & 0x3F) || ip[7]) {
+            // MF set or non-zero offset: collect until the datagram is complete
+            NET_STAT_INC(ip_frag_rx);
+            uint16_t tot = 0;
+            uint8_t* d = net_ipfrag_input(ip, ip_total, &tot);
+            if (!d) return;
+            ipv4_deliver(d, (uint8_t)((d[0]&0x0F)*4), tot);
+            net_ipfrag_release(d);
+            return;
         }
-    }
-}
-
-bool net_icmp_ping(uint32_t dst_ip_be, int count, uint32_t timeout_ms){
-    if (count<=0) count=1;
-    if (timeout_ms==0) timeout_ms=1000;
-    static uint16_t ident=0x4242; uint16_t seq=0;
-    for (int n=0;n<count;n++){
-        // build echo request
-        uint8_t pkt[64]; for (int i=0;i<64;i++) pkt[i]=0;
-        pkt[0]=8; pkt[1]=0; pkt[2]=0; pkt[3]=0; pkt[4]=(uint8_t)(ident>>8); pkt[5]=(uint8_t)ident; pkt[6]=(uint8_t)(seq>>8); pkt[7]=(uint8_t)seq;
-        for (int i=8;i<16;i++) pkt[i]=(uint8_t)i;
-        uint16_t c=csum16(pkt, 16); pkt[2]=(uint8_t)(c>>8); pkt[3]=(uint8_t)c;
-        (void)net_ipv4_send(dst_ip_be, 1, pkt, 16);
-        // wait for reply by monitoring ARP cache and status bar? Simplify: spin delay.
-        uint32_t start=platform_ticks_get(); uint32_t hz = platform_timer_get_hz(); (void)hz;
-        uint32_t elapsed_ms=0; while (elapsed_ms < timeout_ms){ netface_poll(); elapsed_ms = (platform_ticks_get()-start) * (1000u / (hz?hz:1u)); }
-        seq++;
-    }
-    return true;
+        ipv4_deliver(ip, ihl, ip_total);
+    } else nic->rx_unknown++;
 }
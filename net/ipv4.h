@@ -1,22 +1,50 @@
 #pragma once
 #include <stdint.h>
 #include <stdbool.h>
+#include "../config.h"
+
+// Payload of one Ethernet frame / of the largest datagram (fragmented on send,
+// reassembled on receive, see ipfrag.h)
+#define NET_IPV4_FRAME_PAYLOAD 1480
+#define NET_IPV4_MAX_PAYLOAD   (CONFIG_NET_IP_MAX_DATAGRAM - 20)
 
 void net_ipv4_init(void);
 
-// Configure local address, netmask, and optional gateway (0 to clear)
+// Periodic protocol work (ARP retries/aging, TFTP server timeouts); called from the netface scheduler
+void net_ipv4_poll(void);
+
+// Per-interface address, netmask, and optional gateway (0 to clear).
+// ifx is the netface interface index (0 = eth0, the default interface).
+void net_ipv4_if_config_set(int ifx, uint32_t ip_be, uint32_t mask_be, uint32_t gw_be);
+bool net_ipv4_if_config_get(int ifx, uint32_t* ip_be, uint32_t* mask_be, uint32_t* gw_be);
+
+// Same for the default interface
 void net_ipv4_config_set(uint32_t ip_be, uint32_t mask_be, uint32_t gw_be);
 void net_ipv4_config_get(uint32_t* ip_be, uint32_t* mask_be, uint32_t* gw_be);
 
-// RX entry point from netface (Ethernet frame without FCS)
-void net_ipv4_on_frame(const uint8_t* frame, uint16_t len);
+// Routing decision for dst: the interface whose subnet holds dst (longest
+// mask wins), else the first interface with a gateway, else the default
+// interface on-link. Fills interface, next hop and source address.
+// Returns false if no interface exists.
+bool net_ipv4_route(uint32_t dst_be, int* ifx, uint32_t* next_hop_be, uint32_t* src_be);
+
+// Source address the stack uses towards dst (pseudo-header checksums)
+uint32_t net_ipv4_source_for(uint32_t dst_be);
+
+// RX entry point from netface (Ethernet frame without FCS) received on interface ifx
+void net_ipv4_on_frame(int ifx, const uint8_t* frame, uint16_t len);
+
+// Parse a dotted quad into a big-endian value
+bool net_ipv4_parse_addr(const char* s, uint32_t* out_be);
 
-// Shell helpers
-bool net_ipv4_set_from_strings(const char* ip, const char* mask, const char* gw);
+// Shell helpers (ifx as above)
+bool net_ipv4_set_from_strings(int ifx, const char* ip, const char* mask, const char* gw);
 void net_ipv4_print_config(void);
+void net_ipv4_print_route(uint32_t dst_be);
 
-// ICMP ping
-bool net_icmp_ping(uint32_t dst_ip_be, int count, uint32_t timeout_ms);
+// ICMP ping: see ping.h
 
-// Send an IPv4 packet with given proto and payload (payload length <=1500). Returns true on success.
+// Send an IPv4 packet with given proto and payload (up to NET_IPV4_MAX_PAYLOAD;
+// more than NET_IPV4_FRAME_PAYLOAD goes out as fragments), routed per
+// net_ipv4_route(). Returns true on success.
 bool net_ipv4_send(uint32_t dst_ip_be, uint8_t proto, const uint8_t* payload, uint16_t plen);
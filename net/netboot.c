@@ -0,0 +1,262 @@
+#include "netboot.h"
+#include "../config.h"
+#include "../console.h"
+#include "../memory.h"
+#include "../platform.h"
+#include "../bootinfo.h"
+#include "../netface.h"
+#include "../stage3_params.h"
+#include "../drivers/ata.h"
+#include "../drivers/fs/neelefs.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#define NB_HDR        ((uint32_t)sizeof(net_netboot_hdr_t))
+#define NB_SLOT_BYTES (STAGE3_KERNEL_SLOT_SECTORS * 512u)
+#define NB_STUB_ROOM  64u
+#define NB_LOAD_ADDR  0x00008000u   // KERNEL_LOAD_LINEAR (Makefile), kernel linked at 0x8000
+#define NB_BOOTINFO   0x00005000u   // BOOTINFO_ADDR (boot_shared.inc)
+
+typedef char nb_hdr_size_check[(sizeof(net_netboot_hdr_t) == 16) ? 1 : -1];
+typedef char nb_record_size_check[(sizeof(stage3_kernel_record_t) <= 512) ? 1 : -1];
+
+enum { NB_EMPTY = 0, NB_PARTIAL, NB_VERIFIED };
+
+// Staging buffer: header + kernel slot + room for the restart stub. Allocated
+// on first use and kept (bump allocator).
+static uint8_t* s_buf;
+static uint32_t s_fill;
+static uint8_t  s_state;
+static uint8_t  s_too_big;
+static char     s_source[72];
+static uint8_t  s_sec[2048];
+
+static const net_netboot_hdr_t* nb_hdr(void) { return (const net_netboot_hdr_t*)s_buf; }
+
+static bool nb_alloc(void) {
+    if (!s_buf) s_buf = (uint8_t*)memory_alloc(NB_HDR + NB_SLOT_BYTES + NB_STUB_ROOM);
+    return s_buf != NULL;
+}
+
+static void nb_reset(const char* what, const char* name) {
+    s_fill = 0; s_state = NB_EMPTY; s_too_big = 0;
+    int j = 0;
+    while (*what && j < (int)sizeof(s_source) - 1) s_source[j++] = *what++;
+    while (name && *name && j < (int)sizeof(s_source) - 1) s_source[j++] = *name++;
+    s_source[j] = 0;
+}
+
+static bool nb_append(const uint8_t* data, uint32_t len) {
+    if (len > NB_HDR + NB_SLOT_BYTES - s_fill) { s_too_big = 1; return false; }
+    for (uint32_t i = 0; i < len; i++) s_buf[s_fill + i] = data[i];
+    s_fill += len;
+    s_state = NB_PARTIAL;
+    return true;
+}
+
+static int nb_verify(void) {
+    if (s_fill < NB_HDR) return NET_NETBOOT_EFORMAT;
+    const net_netboot_hdr_t* h = nb_hdr();
+    if (h->magic != NET_NETBOOT_MAGIC || h->hdr_size != NB_HDR || h->size == 0) return NET_NETBOOT_EFORMAT;
+    if (h->size > NB_SLOT_BYTES) return NET_NETBOOT_ESIZE;
+    if (s_fill != NB_HDR + h->size) return NET_NETBOOT_EFORMAT;
+    if (neelefs_crc32(0, s_buf + NB_HDR, h->size) != h->crc32) return NET_NETBOOT_ECRC;
+    // Zero the tail of the last sector so disk writes never carry stale bytes
+    uint32_t end = NB_HDR + ((h->size + 511u) & ~511u);
+    for (uint32_t i = s_fill; i < end; i++) s_buf[i] = 0;
+    s_state = NB_VERIFIED;
+    return 0;
+}
+
+// ---- sources ----
+
+static bool tftp_begin(void* ctx, uint32_t size) {
+    (void)ctx;
+    s_fill = 0;
+    if (size > NB_HDR + NB_SLOT_BYTES) { s_too_big = 1; return false; }   // tsize lets us refuse early
+    return true;
+}
+static bool tftp_write(void* ctx, const uint8_t* data, uint32_t len) {
+    (void)ctx;
+    return nb_append(data, len);
+}
+static const net_tftp_io_t s_ram_sink = { tftp_begin, tftp_write, NULL, NULL };
+
+int net_netboot_fetch_tftp(uint32_t server_be, const char* remote, net_tftp_result_t* res, bool (*abort)(void)) {
+    if (!nb_alloc()) return NET_NETBOOT_ENOMEM;
+    nb_reset("tftp:", remote);
+    if (net_tftp_get(server_be, remote, &s_ram_sink, NULL, res, abort) != 0) {
+        // A sink refusal (image too large) surfaces as EIO from the TFTP engine
+        return s_too_big ? NET_NETBOOT_ESIZE : NET_NETBOOT_EFETCH;
+    }
+    return nb_verify();
+}
+
+int net_netboot_load_file(const char* path) {
+    if (!nb_alloc()) return NET_NETBOOT_ENOMEM;
+    static neelefs_reader_t r;
+    nb_reset("file:", path);
+    if (!neelefs_reader_open(&r, path)) return NET_NETBOOT_EFETCH;
+    if (r.size > NB_HDR + NB_SLOT_BYTES) return NET_NETBOOT_ESIZE;
+    while (s_fill < r.size) {
+        uint32_t n = neelefs_reader_read(&r, s_fill, s_sec, sizeof(s_sec));
+        if (n == 0 || !nb_append(s_sec, n)) return NET_NETBOOT_EFETCH;
+    }
+    return nb_verify();
+}
+
+// ---- disk ----
+
+// Point the ATA driver at the BIOS boot drive (same mapping as stage3)
+static void nb_select_boot_drive(uint32_t bios_drive) {
+    bool secondary = (bios_drive & 0x02u) != 0;
+    ata_set_target(secondary ? 0x170 : (uint16_t)CONFIG_ATA_PRIMARY_IO,
+                   secondary ? 0x376 : (uint16_t)CONFIG_ATA_PRIMARY_CTRL,
+                   (bios_drive & 0x01u) != 0);
+}
+
+static bool nb_write_and_check(uint32_t lba, const uint8_t* data, uint32_t bytes, uint32_t* crc_out) {
+    uint32_t sectors = (bytes + 511u) / 512u;
+    for (uint32_t s = 0; s < sectors; s += 4u) {
+        uint8_t n = (uint8_t)((sectors - s) > 4u ? 4u : (sectors - s));
+        if (!ata_write_lba28(lba + s, n, data + s * 512u)) return false;
+        if ((s & 63u) == 0) console_putc('.');
+    }
+    // Read back and checksum what actually landed on the disk
+    uint32_t crc = 0;
+    for (uint32_t s = 0; s < sectors; s += 4u) {
+        uint8_t n = (uint8_t)((sectors - s) > 4u ? 4u : (sectors - s));
+        if (!ata_read_lba28(lba + s, n, s_sec)) return false;
+        uint32_t take = bytes - s * 512u;
+        if (take > (uint32_t)n * 512u) take = (uint32_t)n * 512u;
+        crc = neelefs_crc32(crc, s_sec, take);
+    }
+    *crc_out = crc;
+    return true;
+}
+
+int net_netboot_write_disk(void) {
+    if (s_state != NB_VERIFIED) return NET_NETBOOT_ENOIMG;
+    const boot_info_t* bi = memory_boot_info();
+    if (!bi || !(bi->flags & BOOTINFO_FLAG_BOOT_DEVICE_IS_HDD) || bi->kernel_lba == 0) return NET_NETBOOT_ENODISK;
+
+    const net_netboot_hdr_t* h = nb_hdr();
+    uint32_t lba = bi->kernel_lba;
+    uint32_t sectors = (h->size + 511u) / 512u;
+    uint16_t io, ctrl; bool slave;
+    ata_get_target(&io, &ctrl, &slave);
+    nb_select_boot_drive(bi->boot_device);
+
+    console_write("netboot: writing "); console_write_dec(sectors);
+    console_write(" sectors at LBA "); console_write_dec(lba); console_write(" ");
+    uint32_t t0 = platform_ticks_get();
+    uint32_t crc = 0;
+    int rc = 0;
+    if (!nb_write_and_check(lba, s_buf + NB_HDR, h->size, &crc)) rc = NET_NETBOOT_EDISK;
+    else if (crc != h->crc32) rc = NET_NETBOOT_ECRC;
+    console_write("\n");
+
+    // Record behind the slot so stage3 loads the new sector count
+    uint32_t gen = 0;
+    if (rc == 0) {
+        const stage3_kernel_record_t* old = (const stage3_kernel_record_t*)s_sec;
+        if (ata_read_lba28(lba + STAGE3_KERNEL_SLOT_SECTORS, 1, s_sec) &&
+            old->magic == STAGE3_KERNEL_RECORD_MAGIC && old->kernel_lba == lba) gen = old->generation + 1u;
+        for (uint32_t i = 0; i < 512u; i++) s_sec[i] = 0;
+        stage3_kernel_record_t* rec = (stage3_kernel_record_t*)s_sec;
+        rec->magic = STAGE3_KERNEL_RECORD_MAGIC;
+        rec->kernel_lba = lba;
+        rec->kernel_sectors = sectors;
+        rec->kernel_bytes = h->size;
+        rec->kernel_crc32 = h->crc32;
+        rec->generation = gen;
+        if (!ata_write_lba28(lba + STAGE3_KERNEL_SLOT_SECTORS, 1, s_sec)) rc = NET_NETBOOT_EDISK;
+    }
+    ata_set_target(io, ctrl, slave);
+    if (rc != 0) return rc;
+
+    uint32_t hz = platform_timer_get_hz(); if (!hz) hz = 100u;
+    uint32_t ms = (uint32_t)(((uint64_t)(platform_ticks_get() - t0) * 1000u) / hz);
+    console_write("netboot: kernel written and verified (crc=0x"); console_write_hex32(crc);
+    console_write(", gen "); console_write_dec(gen);
+    console_write(", "); console_write_dec(ms); console_write(" ms); reboot to start it\n");
+    return 0;
+}
+
+// ---- warm restart ----
+
+// Position-independent tail copied next to the image: with interrupts and
+// paging off (identity map, so the next fetch stays valid) it moves
+// ecx bytes from esi to edi and jumps to eax. Source lies above the
+// destination, so a forward copy is safe even when the two overlap.
+static const uint8_t s_restart_stub[] = {
+    0xFA,                               // cli
+    0x0F, 0x20, 0xC3,                   // mov ebx, cr0
+    0x81, 0xE3, 0xFF, 0xFF, 0xFF, 0x7F, // and ebx, ~CR0.PG
+    0x0F, 0x22, 0xC3,                   // mov cr0, ebx
+    0xFC,                               // cld
+    0xF3, 0xA4,                         // rep movsb
+    0xFF, 0xE0,                         // jmp eax
+};
+typedef char nb_stub_size_check[(sizeof(s_restart_stub) <= NB_STUB_ROOM) ? 1 : -1];
+
+int net_netboot_run(void) {
+    if (s_state != NB_VERIFIED) return NET_NETBOOT_ENOIMG;
+    const net_netboot_hdr_t* h = nb_hdr();
+    uint8_t* src = s_buf + NB_HDR;
+    uint8_t* stub = s_buf + NB_HDR + NB_SLOT_BYTES;
+    if ((uintptr_t)src <= NB_LOAD_ADDR) return NET_NETBOOT_ENOMEM;   // must copy downwards
+    for (uint32_t i = 0; i < sizeof(s_restart_stub); i++) stub[i] = s_restart_stub[i];
+
+    console_write("netboot: starting new kernel ("); console_write_dec(h->size);
+    console_write(" bytes, crc=0x"); console_write_hex32(h->crc32); console_write(")\n");
+
+    // Bus-master NICs would keep writing frames into the old RX rings,
+    // which lie in memory the new kernel reuses
+    netface_shutdown();
+    platform_interrupts_disable();
+    platform_irq_mask_all();
+    // The console name points into stage3 memory that the old kernel's BSS may
+    // have overwritten; the boot info block itself at 0x5000 is still intact.
+    ((boot_info_t*)(uintptr_t)NB_BOOTINFO)->console = NULL;
+
+    __asm__ volatile ("jmp *%%edx"
+                      :: "S"(src), "D"((uintptr_t)NB_LOAD_ADDR), "c"(h->size),
+                         "a"((uintptr_t)NB_LOAD_ADDR), "d"(stub)
+                      : "ebx", "memory");
+    __builtin_unreachable();
+}
+
+const char* net_netboot_strerror(int rc) {
+    switch (rc) {
+    case NET_NETBOOT_ENOMEM:  return "no staging memory";
+    case NET_NETBOOT_EFETCH:  return "transfer failed";
+    case NET_NETBOOT_EFORMAT: return "not a kernel.net image";
+    case NET_NETBOOT_ECRC:    return "crc mismatch";
+    case NET_NETBOOT_ESIZE:   return "kernel larger than slot";
+    case NET_NETBOOT_ENOIMG:  return "no verified image staged";
+    case NET_NETBOOT_ENODISK: return "kernel location unknown (not an HDD boot)";
+    case NET_NETBOOT_EDISK:   return "disk write/read-back failed";
+    default:                  return "error";
+    }
+}
+
+void net_netboot_status(void) {
+    console_write("netboot: ");
+    if (s_state == NB_VERIFIED) {
+        console_write("staged "); console_write(s_source);
+        console_write(" size="); console_write_dec(nb_hdr()->size);
+        console_write(" crc=0x"); console_write_hex32(nb_hdr()->crc32);
+    } else if (s_state == NB_PARTIAL) {
+        console_write("incomplete "); console_write(s_source);
+        console_write(" ("); console_write_dec(s_fill); console_write(" bytes)");
+    } else console_write("nothing staged");
+    console_write("\n");
+    const boot_info_t* bi = memory_boot_info();
+    console_write("  boot kernel: ");
+    if (bi && bi->kernel_lba) {
+        console_write("LBA "); console_write_dec(bi->kernel_lba);
+        console_write(" sectors="); console_write_dec(bi->kernel_sectors);
+    } else console_write("location unknown");
+    console_write(" slot="); console_write_dec(STAGE3_KERNEL_SLOT_SECTORS); console_write(" sectors\n");
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "tftp.h"
+
+// Network kernel update: stage a kernel image in RAM (TFTP download or a file
+// already on NeeleFS), verify its CRC32, then either write it into the boot
+// disk's kernel slot or warm-restart into it without touching the disk.
+//
+// Image format ("kernel.net", built by tools/mknetimg.py): a 16-byte header
+// followed by kernel_payload.bin. All fields little endian.
+
+#define NET_NETBOOT_MAGIC 0x494B5A4Du   // "MZKI"
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint32_t hdr_size;   // sizeof(net_netboot_hdr_t), room for later fields
+    uint32_t size;       // kernel bytes following the header
+    uint32_t crc32;      // zlib CRC32 of those bytes
+} net_netboot_hdr_t;
+
+// Return codes (negative)
+#define NET_NETBOOT_ENOMEM   (-1)   // staging buffer could not be allocated
+#define NET_NETBOOT_EFETCH   (-2)   // transfer or file read failed
+#define NET_NETBOOT_EFORMAT  (-3)   // bad magic/header or truncated image
+#define NET_NETBOOT_ECRC     (-4)   // CRC32 mismatch
+#define NET_NETBOOT_ESIZE    (-5)   // kernel larger than the disk slot
+#define NET_NETBOOT_ENOIMG   (-6)   // nothing verified is staged
+#define NET_NETBOOT_ENODISK  (-7)   // kernel location unknown (floppy/serial boot, old stage3)
+#define NET_NETBOOT_EDISK    (-8)   // ATA write or read-back failed
+
+// Stage an image; both verify it before returning 0
+int  net_netboot_fetch_tftp(uint32_t server_be, const char* remote, net_tftp_result_t* res, bool (*abort)(void));
+int  net_netboot_load_file(const char* path);
+
+// Write the staged kernel to the boot disk (kernel slot + record sector) and
+// read it back. The next cold boot loads the new kernel.
+int  net_netboot_write_disk(void);
+
+// Copy the staged kernel over the running one and jump to its entry point.
+// Returns only on error.
+int  net_netboot_run(void);
+
+const char* net_netboot_strerror(int rc);
+void net_netboot_status(void);
@@ -0,0 +1,149 @@
+#include "netstat.h"
+#include "arp.h"
+#include "udp.h"
+#include "ipfrag.h"
+#include "../console.h"
+#include "../platform.h"
+#include <stddef.h>
+
+net_stats_t g_net_stats;
+
+// Rate sampler state (IRQ0): totals at the start of the current second and
+// the deltas of the last complete one
+typedef struct { uint32_t rx_frames, rx_bytes, tx_frames, tx_bytes; } nic_sample_t;
+static nic_sample_t s_prev[NETFACE_MAX];
+static net_stats_rate_t s_rate[NETFACE_MAX];
+static uint32_t s_prev_drops, s_drops_ps;
+static uint32_t s_tick_count;
+
+uint32_t net_stats_drops(void) {
+    const net_stats_t* s = &g_net_stats;
+    uint32_t d = 0;
+    for (int i = 0; i < NETFACE_MAX; i++)
+        d += s->nic[i].tx_drops + s->nic[i].rx_runt + s->nic[i].rx_unknown;
+    for (int i = 0; i < netface_count() && i < NETFACE_MAX; i++) {
+        netface_stats_t st;
+        if (netface_if_stats(i, &st)) d += st.rx_errors;
+    }
+    d += s->ip_hdr_err + s->ip_csum_err + s->ip_not_local + s->ip_too_big
+       + s->ip_unknown_proto + s->ip_no_route
+       + s->ip_reasm_timeout + s->ip_reasm_evicted + s->ip_reasm_bad;
+    d += s->icmp_short + s->tcp_bad + s->tcp_csum + s->tcp_no_listener + s->tcp_not_peer + s->tcp_ooo;
+    net_udp_stats_t u; net_udp_stats_get(&u);
+    d += u.rx_noport + u.rx_csum + u.rx_short + u.rx_full;
+    net_arp_stats_t a; net_arp_stats_get(&a);
+    d += a.dropped + a.rx_bad;
+    return d;
+}
+
+bool net_stats_rate(int ifx, net_stats_rate_t* out) {
+    if (ifx < 0 || ifx >= netface_count() || ifx >= NETFACE_MAX || !out) return false;
+    *out = s_rate[ifx];
+    out->drops_ps = s_drops_ps;
+    return true;
+}
+
+void net_stats_tick(void) {
+    uint32_t hz = platform_timer_get_hz();
+    if (hz == 0 || ++s_tick_count < hz) return;
+    s_tick_count = 0;
+    for (int i = 0; i < NETFACE_MAX; i++) {
+        const net_stats_nic_t* n = &g_net_stats.nic[i];
+        nic_sample_t* p = &s_prev[i];
+        net_stats_rate_t* r = &s_rate[i];
+        r->rx_fps = n->rx_frames - p->rx_frames;
+        r->rx_Bps = n->rx_bytes - p->rx_bytes;
+        r->tx_fps = n->tx_frames - p->tx_frames;
+        r->tx_Bps = n->tx_bytes - p->tx_bytes;
+        p->rx_frames = n->rx_frames; p->rx_bytes = n->rx_bytes;
+        p->tx_frames = n->tx_frames; p->tx_bytes = n->tx_bytes;
+    }
+    uint32_t d = net_stats_drops();
+    s_drops_ps = d - s_prev_drops;
+    s_prev_drops = d;
+}
+
+void net_stats_reset(void) {
+    uint8_t* p = (uint8_t*)&g_net_stats;
+    for (uint32_t i = 0; i < sizeof(g_net_stats); i++) p[i] = 0;
+    for (int i = 0; i < NETFACE_MAX; i++) {
+        s_prev[i].rx_frames = s_prev[i].rx_bytes = 0;
+        s_prev[i].tx_frames = s_prev[i].tx_bytes = 0;
+    }
+    s_prev_drops = net_stats_drops();
+}
+
+static void kv(const char* key, uint32_t v) {
+    console_write(" ");
+    console_write(key);
+    console_write("=");
+    console_write_dec(v);
+}
+
+void net_stats_print(void) {
+    const net_stats_t* s = &g_net_stats;
+    for (int i = 0; i < netface_count() && i < NETFACE_MAX; i++) {
+        const net_stats_nic_t* n = &s->nic[i];
+        netface_stats_t st;
+        console_write(netface_name(i));
+        console_write(":");
+        kv("rx", n->rx_frames); kv("rx_bytes", n->rx_bytes);
+        kv("tx", n->tx_frames); kv("tx_bytes", n->tx_bytes);
+        console_write("\n     drops:");
+        kv("tx", n->tx_drops); kv("runt", n->rx_runt); kv("ethertype", n->rx_unknown);
+        if (netface_if_stats(i, &st)) { kv("driver", st.rx_errors); kv("tx_err", st.tx_err); }
+        console_write("\n");
+    }
+    console_write("ip:");
+    kv("rx", s->ip_rx); kv("rx_bytes", s->ip_rx_bytes);
+    kv("tx", s->ip_tx); kv("tx_bytes", s->ip_tx_bytes); kv("tx_fail", s->ip_tx_fail);
+    console_write("\n     drops:");
+    kv("hdr", s->ip_hdr_err); kv("csum", s->ip_csum_err); kv("not_local", s->ip_not_local);
+    kv("too_big", s->ip_too_big); kv("proto", s->ip_unknown_proto);
+    kv("no_route", s->ip_no_route);
+    console_write("\n     frag:");
+    kv("rx", s->ip_frag_rx); kv("reasm", s->ip_reasm_ok); kv("tx", s->ip_frag_tx);
+    kv("fragmented", s->ip_frag_dgrams); kv("pending", (uint32_t)net_ipfrag_pending());
+    console_write("\n     frag drops:");
+    kv("timeout", s->ip_reasm_timeout); kv("evicted", s->ip_reasm_evicted); kv("bad", s->ip_reasm_bad);
+    console_write("\n");
+
+    console_write("icmp:");
+    kv("rx", s->icmp_rx); kv("echo_req", s->icmp_echo_req); kv("echo_rep_tx", s->icmp_echo_rep_tx);
+    kv("echo_rep_rx", s->icmp_echo_rep_rx); kv("short", s->icmp_short); kv("other", s->icmp_other);
+    console_write("\n");
+
+    console_write("tcp:");
+    kv("rx", s->tcp_rx); kv("tx", s->tcp_tx); kv("conns", s->tcp_conns);
+    kv("wnd_upd", s->tcp_wnd_upd); kv("timeouts", s->tcp_timeouts);
+    console_write("\n     drops:");
+    kv("bad", s->tcp_bad); kv("csum", s->tcp_csum); kv("no_listener", s->tcp_no_listener); kv("not_peer", s->tcp_not_peer);
+    kv("ooo", s->tcp_ooo);
+    console_write("\n");
+
+    console_write("http:");
+    kv("req", s->http_req); kv("200", s->http_200); kv("404", s->http_404);
+    kv("put", s->http_put); kv("201", s->http_201); kv("err", s->http_err);
+    kv("tx_bytes", s->http_tx_bytes); kv("rx_bytes", s->http_rx_bytes);
+    console_write("\n");
+
+    net_udp_print();
+    net_arp_stats_t a; net_arp_stats_get(&a);
+    console_write("arp:");
+    kv("rx", a.rx); kv("bad", a.rx_bad); kv("misses", a.misses); kv("dropped", a.dropped);
+    console_write("\n");
+    console_write("drops total="); console_write_dec(net_stats_drops()); console_write("\n");
+}
+
+void net_stats_print_rates(void) {
+    for (int i = 0; i < netface_count() && i < NETFACE_MAX; i++) {
+        net_stats_rate_t r;
+        if (!net_stats_rate(i, &r)) continue;
+        console_write(netface_name(i));
+        console_write(":");
+        kv("rx/s", r.rx_fps); kv("rxB/s", r.rx_Bps);
+        kv("tx/s", r.tx_fps); kv("txB/s", r.tx_Bps);
+        console_write("\n");
+    }
+    console_write("drops/s="); console_write_dec(s_drops_ps); console_write("\n");
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "../netface.h"
+
+// Per-protocol network counters ("netstat").
+//
+// Every accept and drop point of the stack bumps one field of g_net_stats.
+// The counters are plain aligned 32-bit words without locks: each one is only
+// written from netface_poll() (or main context with bottom halves
+// disabled), and aligned 32-bit loads are atomic on x86, so readers see every
+// counter whole (a snapshot may mix values a packet apart). ARP and UDP keep
+// their counters in net_arp_stats_t / net_udp_stats_t; driver-level drops
+// (oversize frames, ring overflows) are the NIC's netface_stats_t.rx_errors.
+//
+// Once per second the timer tick turns the per-interface totals into rates.
+
+typedef struct {
+    uint32_t rx_frames, rx_bytes;  // delivered by the driver to the stack
+    uint32_t tx_frames, tx_bytes;  // accepted by the driver
+    uint32_t tx_drops;             // refused by the driver (no TX slot, bad length)
+    uint32_t rx_runt;              // shorter than an Ethernet header
+    uint32_t rx_unknown;           // EtherType neither ARP nor IPv4
+} net_stats_nic_t;
+
+typedef struct {
+    net_stats_nic_t nic[NETFACE_MAX];
+
+    // IPv4
+    uint32_t ip_rx, ip_rx_bytes;   // datagrams for us, handed to a protocol
+    uint32_t ip_hdr_err;           // bad version/IHL/length
+    uint32_t ip_csum_err;          // header checksum mismatch
+    uint32_t ip_not_local;         // destination is not the interface address
+    uint32_t ip_frag_rx;           // fragments received
+    uint32_t ip_reasm_ok;          // datagrams reassembled from them
+    uint32_t ip_reasm_timeout;     // incomplete datagrams expired
+    uint32_t ip_reasm_evicted;     // incomplete datagrams pushed out (all slots busy)
+    uint32_t ip_reasm_bad;         // malformed fragment, conflicting end, no buffer
+    uint32_t ip_too_big;           // beyond CONFIG_NET_IP_MAX_DATAGRAM (received or sent)
+    uint32_t ip_frag_tx, ip_frag_dgrams;  // fragments sent / datagrams fragmented
+    uint32_t ip_unknown_proto;     // protocol other than ICMP/TCP/UDP
+    uint32_t ip_tx, ip_tx_bytes;   // datagrams sent or parked for ARP
+    uint32_t ip_no_route;          // no interface to send on
+    uint32_t ip_tx_fail;           // refused below (ARP queue, driver); the cause is counted there
+
+    // ICMP
+    uint32_t icmp_rx;
+    uint32_t icmp_echo_req, icmp_echo_rep_tx;  // requests answered
+    uint32_t icmp_echo_rep_rx;                 // replies (ping)
+    uint32_t icmp_short, icmp_other;           // truncated / unhandled type
+
+    // TCP (HTTP responder and the benchmark services)
+    uint32_t tcp_rx, tcp_tx;
+    uint32_t tcp_bad;              // malformed header
+    uint32_t tcp_csum;             // checksum mismatch (benchmark services)
+    uint32_t tcp_no_listener;      // closed/other port
+    uint32_t tcp_not_peer;         // segment from someone other than the connected peer
+    uint32_t tcp_conns;            // handshakes started (SYN accepted)
+    uint32_t tcp_ooo;              // data not at the expected sequence or past the window
+    uint32_t tcp_timeouts;         // idle connections reset
+    uint32_t tcp_wnd_upd;          // window updates sent as the receive ring drained
+
+    // HTTP
+    uint32_t http_req, http_200, http_404;
+    uint32_t http_put, http_201;   // uploads received / stored
+    uint32_t http_err;             // 4xx/5xx other than 404
+    uint32_t http_tx_bytes;        // response headers + body
+    uint32_t http_rx_bytes;        // PUT bodies
+} net_stats_t;
+
+// Per-second rates of one interface, sampled by the timer tick
+typedef struct {
+    uint32_t rx_fps, rx_Bps;
+    uint32_t tx_fps, tx_Bps;
+    uint32_t drops_ps;             // all stack drops per second (every interface)
+} net_stats_rate_t;
+
+extern net_stats_t g_net_stats;
+
+#define NET_STAT_INC(f)    (g_net_stats.f++)
+#define NET_STAT_ADD(f, n) (g_net_stats.f += (uint32_t)(n))
+
+// Sum of every drop counter (stack, ARP, UDP, drivers)
+uint32_t net_stats_drops(void);
+
+// Rates over the last full second; false if ifx is not registered
+bool net_stats_rate(int ifx, net_stats_rate_t* out);
+
+// Timer tick hook (IRQ0): samples the totals once per second
+void net_stats_tick(void);
+
+// Zero all counters of this module (ARP/UDP/driver counters are untouched)
+void net_stats_reset(void);
+
+// Shell output: per-interface and per-protocol counters, or rates only
+void net_stats_print(void);
+void net_stats_print_rates(void);
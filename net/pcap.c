@@ -0,0 +1,174 @@
+#include "pcap.h"
+#include "../config.h"
+#include "../console.h"
+#include "../memory.h"
+#include "../platform.h"
+#include "../arch/x86/io.h"
+#include "../drivers/fs/neelefs.h"
+#include <stddef.h>
+
+#define PCAP_REC_HDR 16u
+#define PCAP_LINKTYPE_ETHERNET 1u
+
+volatile bool g_net_pcap_on = false;
+
+static uint8_t* s_ring;
+static uint32_t s_used;
+static net_pcap_filter_t s_filter;
+static net_pcap_stats_t s_st;
+
+// Capture clock: seconds/microseconds since start, advanced by deltas of the
+// 32-bit platform_time_us() (no 64-bit division on the packet path)
+static uint32_t s_clk_last, s_clk_sec, s_clk_usec;
+
+static void put32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); p[2] = (uint8_t)(v >> 16); p[3] = (uint8_t)(v >> 24);
+}
+
+void net_pcap_filter_default(net_pcap_filter_t* f) {
+    if (!f) return;
+    f->ifx = -1;
+    f->ethertype = 0;
+    f->proto = 0;
+    f->port = 0;
+    f->snaplen = 0;
+}
+
+bool net_pcap_start(const net_pcap_filter_t* f) {
+    g_net_pcap_on = false;
+    if (!s_ring) s_ring = (uint8_t*)memory_alloc(CONFIG_NET_PCAP_RING);
+    if (!s_ring) return false;
+    if (f) s_filter = *f; else net_pcap_filter_default(&s_filter);
+    s_used = 0;
+    s_st.captured = s_st.filtered = s_st.dropped = 0;
+    s_clk_last = platform_time_us();
+    s_clk_sec = s_clk_usec = 0;
+    s_st.running = true;
+    g_net_pcap_on = true;
+    return true;
+}
+
+void net_pcap_stop(void) {
+    g_net_pcap_on = false;
+    s_st.running = false;
+}
+
+static bool pcap_match(int ifx, const uint8_t* frame, uint16_t len) {
+    const net_pcap_filter_t* f = &s_filter;
+    if (f->ifx >= 0 && f->ifx != ifx) return false;
+    if (len < 14) return f->ethertype == 0 && f->proto == 0 && f->port == 0;
+    uint16_t type = (uint16_t)(((uint16_t)frame[12] << 8) | frame[13]);
+    if (f->ethertype && type != f->ethertype) return false;
+    if (!f->proto && !f->port) return true;
+    if (type != 0x0800 || len < 34) return false;
+    const uint8_t* ip = frame + 14;
+    if (f->proto && ip[9] != f->proto) return false;
+    if (f->port) {
+        uint16_t ihl = (uint16_t)((ip[0] & 0x0F) * 4);
+        if ((ip[9] != 6 && ip[9] != 17) || len < 14 + ihl + 4) return false;
+        const uint8_t* l4 = ip + ihl;
+        uint16_t sp = (uint16_t)(((uint16_t)l4[0] << 8) | l4[1]);
+        uint16_t dp = (uint16_t)(((uint16_t)l4[2] << 8) | l4[3]);
+        if (sp != f->port && dp != f->port) return false;
+    }
+    return true;
+}
+
+void net_pcap_hook(int ifx, const uint8_t* frame, uint16_t len) {
+    if (!g_net_pcap_on) return;
+    uint32_t now = platform_time_us();
+    s_clk_usec += now - s_clk_last;
+    s_clk_last = now;
+    while (s_clk_usec >= 1000000u) { s_clk_usec -= 1000000u; s_clk_sec++; }
+
+    if (!pcap_match(ifx, frame, len)) { s_st.filtered++; return; }
+    uint16_t cap = len;
+    if (s_filter.snaplen && cap > s_filter.snaplen) cap = s_filter.snaplen;
+    if (s_used + PCAP_REC_HDR + cap > CONFIG_NET_PCAP_RING) { s_st.dropped++; return; }
+
+    uint8_t* r = s_ring + s_used;
+    put32(r, s_clk_sec);
+    put32(r + 4, s_clk_usec);
+    put32(r + 8, cap);
+    put32(r + 12, len);
+    for (uint16_t i = 0; i < cap; i++) r[PCAP_REC_HDR + i] = frame[i];
+    s_used += PCAP_REC_HDR + cap;
+    s_st.captured++;
+}
+
+// pcap global header, little-endian, microsecond timestamps
+static void pcap_global_header(uint8_t h[24]) {
+    put32(h, 0xA1B2C3D4u);
+    h[4] = 2; h[5] = 0;          // version 2.4
+    h[6] = 4; h[7] = 0;
+    put32(h + 8, 0);             // thiszone
+    put32(h + 12, 0);            // sigfigs
+    put32(h + 16, s_filter.snaplen ? s_filter.snaplen : 65535u);
+    put32(h + 20, PCAP_LINKTYPE_ETHERNET);
+}
+
+bool net_pcap_save(const char* path) {
+    if (!s_ring || !path) return false;
+    net_pcap_stop();
+    static neelefs_writer_t w;
+    uint8_t h[24];
+    pcap_global_header(h);
+    if (!neelefs_writer_open(&w, path, 24u + s_used)) return false;
+    if (!neelefs_writer_write(&w, h, 24) || (s_used && !neelefs_writer_write(&w, s_ring, s_used))) {
+        neelefs_writer_abort(&w);
+        return false;
+    }
+    return neelefs_writer_close(&w);
+}
+
+static void uart_put(uint16_t port, uint8_t b) {
+    while ((inb((uint16_t)(port + 5u)) & 0x20u) == 0u) { }
+    outb(port, b);
+}
+
+bool net_pcap_serial(void) {
+    if (!s_ring) return false;
+    net_pcap_stop();
+    const uint16_t port = CONFIG_NET_PCAP_SERIAL_PORT;
+    // Scratch register check: no UART there
+    outb((uint16_t)(port + 7u), 0x5A);
+    if (inb((uint16_t)(port + 7u)) != 0x5A) return false;
+    outb((uint16_t)(port + 1u), 0x00);   // no UART interrupts
+    outb((uint16_t)(port + 3u), 0x80);   // DLAB
+    outb(port, 1);                       // 115200 baud
+    outb((uint16_t)(port + 1u), 0);
+    outb((uint16_t)(port + 3u), 0x03);   // 8N1
+    outb((uint16_t)(port + 2u), 0xC7);   // FIFO on, cleared
+    outb((uint16_t)(port + 4u), 0x03);   // DTR/RTS
+    uint8_t h[24];
+    pcap_global_header(h);
+    for (int i = 0; i < 24; i++) uart_put(port, h[i]);
+    for (uint32_t i = 0; i < s_used; i++) uart_put(port, s_ring[i]);
+    return true;
+}
+
+void net_pcap_stats_get(net_pcap_stats_t* out) {
+    if (!out) return;
+    *out = s_st;
+    out->used = s_used;
+    out->size = CONFIG_NET_PCAP_RING;
+}
+
+void net_pcap_status(void) {
+    net_pcap_stats_t st;
+    net_pcap_stats_get(&st);
+    console_write("pcap: ");
+    console_write(st.running ? "running" : "stopped");
+    console_write(" frames="); console_write_dec(st.captured);
+    console_write(" filtered="); console_write_dec(st.filtered);
+    console_write(" dropped="); console_write_dec(st.dropped);
+    console_write(" ring="); console_write_dec(st.used / 1024u);
+    console_write("/"); console_write_dec(st.size / 1024u); console_write(" KiB\n");
+    console_write("      filter: if=");
+    if (s_filter.ifx < 0) console_write("any"); else console_write_dec((uint32_t)s_filter.ifx);
+    console_write(" type="); if (s_filter.ethertype) console_write_hex16(s_filter.ethertype); else console_write("any");
+    console_write(" proto="); if (s_filter.proto) console_write_dec(s_filter.proto); else console_write("any");
+    console_write(" port="); if (s_filter.port) console_write_dec(s_filter.port); else console_write("any");
+    console_write(" snap="); if (s_filter.snaplen) console_write_dec(s_filter.snaplen); else console_write("all");
+    console_write("\n");
+}
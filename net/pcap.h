@@ -0,0 +1,51 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+// In-kernel packet capture.
+//
+// netface hands every received frame (before the stack sees it) and every
+// frame accepted for transmit to net_pcap_hook() while a capture runs. Frames
+// that pass the filter are appended to a linear ring of CONFIG_NET_PCAP_RING
+// bytes already in pcap record format (16-byte record header + data), so the
+// export is the pcap global header followed by the ring as is. A full ring
+// stops recording (counted as dropped) rather than overwriting the start.
+//
+// Timestamps are microseconds since 'pcap start' (platform_time_us()); the
+// capture is exported after the fact, to NeeleFS or raw over a second UART,
+// so nothing slow runs on the packet path.
+
+typedef struct {
+    int      ifx;        // interface index, -1 = all
+    uint16_t ethertype;  // 0 = any
+    uint8_t  proto;      // IPv4 protocol (1/6/17...), 0 = any
+    uint16_t port;       // TCP/UDP source or destination port, 0 = any
+    uint16_t snaplen;    // bytes kept per frame, 0 = whole frame
+} net_pcap_filter_t;
+
+typedef struct {
+    uint32_t captured;   // records in the ring
+    uint32_t filtered;   // frames rejected by the filter
+    uint32_t dropped;    // frames lost because the ring was full
+    uint32_t used, size; // ring bytes
+    bool     running;
+} net_pcap_stats_t;
+
+// Fast-path guard for the netface hooks (no call while idle)
+extern volatile bool g_net_pcap_on;
+
+void net_pcap_filter_default(net_pcap_filter_t* f);
+
+// Start a capture (clears the ring); false if the ring cannot be allocated
+bool net_pcap_start(const net_pcap_filter_t* f);
+void net_pcap_stop(void);
+
+// netface RX/TX hook (netface_poll() or bh-disabled main context)
+void net_pcap_hook(int ifx, const uint8_t* frame, uint16_t len);
+
+// Export the ring as a pcap file (stops a running capture)
+bool net_pcap_save(const char* path);   // NeeleFS
+bool net_pcap_serial(void);             // raw bytes on CONFIG_NET_PCAP_SERIAL_PORT
+
+void net_pcap_stats_get(net_pcap_stats_t* out);
+void net_pcap_status(void);
@@ -0,0 +1,193 @@
+#include "ping.h"
+#include "ipv4.h"
+#include "csum.h"
+#include "../netface.h"
+#include "../console.h"
+#include "../platform.h"
+#include "../cpuidle.h"
+#include <stddef.h>
+
+enum { SLOT_FREE = 0, SLOT_SENT, SLOT_REPLIED, SLOT_DONE };
+
+typedef struct {
+    uint16_t seq;
+    volatile uint8_t state;
+    uint32_t t_send;        // platform_time_us() before the send
+    uint32_t rtt;           // set by the RX hook
+} ping_slot_t;
+
+// Session state shared with the RX hook (netface_poll RX path)
+static ping_slot_t s_slot[NET_PING_WINDOW];
+static volatile bool s_active;
+static uint16_t s_ident = 0x4d5a;
+static uint32_t s_dst;
+static volatile uint32_t s_dups, s_late;
+
+static uint8_t s_pkt[8 + NET_PING_MAX_DATA];
+
+static void print_ip(uint32_t be) {
+    for (int i = 3; i >= 0; i--) {
+        console_write_dec((be >> (i * 8)) & 0xFFu);
+        if (i) console_write(".");
+    }
+}
+
+// Microseconds as milliseconds with three decimals
+static void print_ms(uint32_t us) {
+    console_write_dec(us / 1000u);
+    console_write(".");
+    uint32_t f = us % 1000u;
+    console_putc((char)('0' + f / 100u));
+    console_putc((char)('0' + (f / 10u) % 10u));
+    console_putc((char)('0' + f % 10u));
+}
+
+void net_ping_defaults(net_ping_opts_t* o) {
+    if (!o) return;
+    o->count = 4;
+    o->interval_ms = 1000;
+    o->size = 56;
+    o->timeout_ms = 1000;
+    o->quiet = false;
+}
+
+void net_ping_on_reply(uint32_t src, const uint8_t* icmp, uint16_t len) {
+    uint32_t now = platform_time_us();
+    if (!s_active || len < 8 || icmp[0] != 0) return;
+    uint16_t id = (uint16_t)(((uint16_t)icmp[4] << 8) | icmp[5]);
+    uint16_t seq = (uint16_t)(((uint16_t)icmp[6] << 8) | icmp[7]);
+    if (id != s_ident || src != s_dst) { s_late++; return; }
+    ping_slot_t* sl = &s_slot[seq % NET_PING_WINDOW];
+    if (sl->seq != seq || sl->state == SLOT_FREE) { s_late++; return; }
+    if (sl->state != SLOT_SENT) { s_dups++; return; }
+    sl->rtt = now - sl->t_send;
+    sl->state = SLOT_REPLIED;
+}
+
+static bool ping_send(uint16_t seq, uint16_t size) {
+    s_pkt[0] = 8; s_pkt[1] = 0; s_pkt[2] = 0; s_pkt[3] = 0;
+    s_pkt[4] = (uint8_t)(s_ident >> 8); s_pkt[5] = (uint8_t)s_ident;
+    s_pkt[6] = (uint8_t)(seq >> 8);     s_pkt[7] = (uint8_t)seq;
+    uint16_t c = net_csum(s_pkt, (uint16_t)(8 + size));
+    s_pkt[2] = (uint8_t)(c >> 8); s_pkt[3] = (uint8_t)c;
+    ping_slot_t* sl = &s_slot[seq % NET_PING_WINDOW];
+    sl->seq = seq;
+    sl->state = SLOT_SENT;
+    sl->t_send = platform_time_us();
+    if (net_ipv4_send(s_dst, 1, s_pkt, (uint16_t)(8 + size))) return true;
+    sl->state = SLOT_FREE;
+    return false;
+}
+
+bool net_ping_run(uint32_t dst, const net_ping_opts_t* opts, net_ping_result_t* out, bool (*abort)(void)) {
+    net_ping_opts_t o;
+    if (opts) o = *opts; else net_ping_defaults(&o);
+    if (o.size > NET_PING_MAX_DATA) o.size = NET_PING_MAX_DATA;
+    if (o.timeout_ms == 0) o.timeout_ms = 1000;
+    if (netface_count() == 0) return false;
+
+    net_ping_result_t r;
+    uint8_t* pr = (uint8_t*)&r;
+    for (uint32_t i = 0; i < sizeof(r); i++) pr[i] = 0;
+    for (uint16_t i = 0; i < o.size; i++) s_pkt[8 + i] = (uint8_t)i;
+
+    s_ident++;
+    s_dst = dst;
+    s_dups = 0; s_late = 0;
+    for (int i = 0; i < NET_PING_WINDOW; i++) s_slot[i].state = SLOT_FREE;
+    s_active = true;
+
+    console_write("PING "); print_ip(dst);
+    console_write(": "); console_write_dec(o.size); console_write(" data bytes");
+    if (o.interval_ms == 0) console_write(", flood");
+    console_write("\n");
+
+    uint64_t sum = 0, jsum = 0;
+    uint32_t prev_rtt = 0, jn = 0;
+    uint32_t outstanding = 0;
+    uint16_t seq = 0;
+    uint32_t t0 = platform_time_us();
+    uint32_t last_send = t0, last_progress = t0;
+    uint32_t gap_us = o.interval_ms ? o.interval_ms * 1000u : 10000u;
+    uint32_t tmo_us = o.timeout_ms * 1000u;
+    bool first = true;
+
+    for (;;) {
+        if (abort && abort()) break;
+        uint32_t now = platform_time_us();
+        bool more = (o.count == 0 || r.sent < o.count);
+
+        if (more && (first || now - last_send >= gap_us || (o.interval_ms == 0 && outstanding == 0))) {
+            // Reusing a slot whose request never got an answer: that one is lost
+            ping_slot_t* sl = &s_slot[seq % NET_PING_WINDOW];
+            if (sl->state == SLOT_SENT) outstanding--;
+            if (ping_send(seq, o.size)) { r.sent++; outstanding++; }
+            else r.send_errors++;
+            seq++;
+            last_send = now;
+            first = false;
+        }
+
+        netface_poll();
+
+        // Collect replies in slot order, print and account them in main context
+        for (int i = 0; i < NET_PING_WINDOW; i++) {
+            ping_slot_t* sl = &s_slot[i];
+            if (sl->state == SLOT_SENT && now - sl->t_send > tmo_us && !more) {
+                sl->state = SLOT_DONE;   // timed out after the last send
+                outstanding--;
+                continue;
+            }
+            if (sl->state != SLOT_REPLIED) continue;
+            uint32_t rtt = sl->rtt;
+            sl->state = SLOT_DONE;
+            outstanding--;
+            r.received++;
+            if (r.received == 1 || rtt < r.min_us) r.min_us = rtt;
+            if (rtt > r.max_us) r.max_us = rtt;
+            sum += rtt;
+            if (r.received > 1) { jsum += (rtt > prev_rtt) ? rtt - prev_rtt : prev_rtt - rtt; jn++; }
+            prev_rtt = rtt;
+            if (!o.quiet) {
+                console_write("reply from "); print_ip(dst);
+                console_write(": seq="); console_write_dec(sl->seq);
+                console_write(" time="); print_ms(rtt); console_write(" ms\n");
+            }
+        }
+
+        if (o.quiet && now - last_progress >= 1000000u) {
+            last_progress = now;
+            console_write("  sent="); console_write_dec(r.sent);
+            console_write(" received="); console_write_dec(r.received); console_write("\n");
+        }
+
+        if (!more && (outstanding == 0 || now - last_send > tmo_us)) break;
+
+        // Flood spins on the NIC; interval mode sleeps until the next IRQ (tick or NIC)
+        if (o.interval_ms) cpuidle_idle();
+    }
+    s_active = false;
+
+    r.dups = s_dups;
+    r.late = s_late;
+    r.elapsed_ms = (platform_time_us() - t0) / 1000u;
+    if (r.received) r.avg_us = (uint32_t)(sum / r.received);
+    if (jn) r.jitter_us = (uint32_t)(jsum / jn);
+
+    console_write("--- "); print_ip(dst); console_write(" ping statistics ---\n");
+    console_write_dec(r.sent); console_write(" sent, ");
+    console_write_dec(r.received); console_write(" received, ");
+    console_write_dec(r.sent ? (r.sent - r.received) * 100u / r.sent : 0u); console_write("% loss");
+    if (r.dups) { console_write(", +"); console_write_dec(r.dups); console_write(" dups"); }
+    if (r.send_errors) { console_write(", "); console_write_dec(r.send_errors); console_write(" send errors"); }
+    console_write(", time "); console_write_dec(r.elapsed_ms); console_write(" ms\n");
+    if (r.received) {
+        console_write("rtt min/avg/max/jitter = ");
+        print_ms(r.min_us); console_write("/");
+        print_ms(r.avg_us); console_write("/");
+        print_ms(r.max_us); console_write("/");
+        print_ms(r.jitter_us); console_write(" ms\n");
+    }
+    if (out) *out = r;
+    return r.sent > 0;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "ipv4.h"
+
+// ICMP echo ("ping") with reply matching and RTT statistics.
+//
+// One session runs at a time. Requests carry a per-session identifier and an
+// incrementing sequence number; replies are matched against a window of the
+// last NET_PING_WINDOW outstanding requests, so several requests can be in
+// flight (interval shorter than the RTT, flood mode). Send and receive
+// timestamps come from platform_time_us() (sub-tick resolution).
+
+#define NET_PING_WINDOW   64
+#define NET_PING_MAX_DATA (NET_IPV4_MAX_PAYLOAD - 8)   // beyond 1472 bytes the request is fragmented
+
+typedef struct {
+    uint32_t count;        // requests to send (0 = until aborted)
+    uint32_t interval_ms;  // gap between requests; 0 = flood (next one as soon as
+                           // the previous reply is in, at least every 10 ms)
+    uint16_t size;         // ICMP payload bytes (default 56)
+    uint32_t timeout_ms;   // wait for outstanding replies after the last send
+    bool     quiet;        // summary only (flood prints one line per second)
+} net_ping_opts_t;
+
+typedef struct {
+    uint32_t sent, received;
+    uint32_t dups;         // replies for a sequence already answered
+    uint32_t late;         // replies older than the window or from earlier sessions
+    uint32_t send_errors;  // net_ipv4_send() refused the frame
+    uint32_t min_us, avg_us, max_us;
+    uint32_t jitter_us;    // mean |RTT(n) - RTT(n-1)| over consecutive replies
+    uint32_t elapsed_ms;
+} net_ping_result_t;
+
+// Fill opts with the defaults (count 4, 1000 ms interval, 56 bytes, 1000 ms timeout)
+void net_ping_defaults(net_ping_opts_t* opts);
+
+// Run a session against dst (big-endian). abort() is polled between sends and
+// may be NULL. Prints a line per reply unless quiet, then a summary.
+// Returns false if nothing could be sent (no interface/route).
+bool net_ping_run(uint32_t dst_be, const net_ping_opts_t* opts, net_ping_result_t* out, bool (*abort)(void));
+
+// RX hook from the IPv4 layer for ICMP type 0 (echo reply)
+void net_ping_on_reply(uint32_t src_be, const uint8_t* icmp, uint16_t icmp_len);
@@ -1,12 +1,26 @@
 #include "tcp_min.h"
 #include "ipv4.h"
+#include "csum.h"
+#include "netstat.h"
+#include "tcpopt.h"
+#include "../config.h"
 #include "../console.h"
+#include "../memory.h"
+#include "../platform.h"
 #include <stddef.h>
 #include "../drivers/fs/neelefs.h"
 
-// Single-connection, minimal TCP responder for HTTP/1.0 GET
+// Single-connection, minimal TCP responder for HTTP/1.0 GET and PUT.
+// Incoming data is queued in a CONFIG_NET_TCP_RCVBUF ring and consumed by
+// net_tcp_min_tick(); the advertised window is the ring's free space, so a
+// slow consumer (NeeleFS writes) closes the window instead of losing data.
 // States
 enum { T_CLOSED=0, T_LISTEN, T_SYN_RCVD, T_ESTABLISHED, T_LAST_ACK };
+// Request progress: header lines, PUT body, answered
+enum { H_REQ=0, H_BODY, H_DONE };
+
+#define RB_SIZE CONFIG_NET_TCP_RCVBUF
+#define TCP_MSS 1460u
 
 static int      s_state = T_CLOSED;
 static uint16_t s_listen_port = 80;
@@ -19,58 +33,88 @@ static char     s_http_body[512] = "<html><body><h1>Mezereon</h1><p>Hello.</p></
 static int      s_use_file = 1;              // default to file mode (NeeleFS)
 static char     s_file_path[128] = "/www/index"; // default path on NeeleFS
 
-static uint16_t ip_csum16(const void* data, uint32_t len){
-    const uint8_t* p=(const uint8_t*)data; uint32_t sum=0; while(len>1){ sum += ((uint16_t)p[0]<<8)|p[1]; p+=2; len-=2; }
-    if (len) sum += ((uint16_t)p[0]<<8);
-    while (sum>>16) sum = (sum & 0xFFFF) + (sum>>16);
-    return (uint16_t)~sum;
-}
-
-static uint16_t tcp_checksum(uint32_t src_be, uint32_t dst_be, const uint8_t* tcp, uint16_t tcp_len){
-    // Build checksum over pseudo-header + TCP header/payload using 16-bit words
-    uint32_t sum = 0;
-    // Pseudo-header: src IP, dst IP (each high16 then low16 in network order)
-    sum += (src_be >> 16) & 0xFFFF; sum += (src_be & 0xFFFF);
-    sum += (dst_be >> 16) & 0xFFFF; sum += (dst_be & 0xFFFF);
-    sum += 0x0006;                   // protocol (TCP)
-    sum += (uint32_t)tcp_len;        // TCP length
+// Negotiated options (tcpopt.h)
+static net_tcp_opts_t s_syn;        // peer's SYN options
+static uint16_t s_mss;              // payload per segment, after the timestamp option
+static uint8_t  s_snd_ws, s_rcv_ws; // window-scale shifts (peer's, ours)
+static uint32_t s_ts_recent;        // peer TSval to echo
 
-    // TCP segment (header + data), read as network-order 16-bit words
-    const uint8_t* p = tcp; uint16_t l = tcp_len;
-    while (l > 1) { sum += ((uint16_t)p[0] << 8) | p[1]; p += 2; l -= 2; }
-    if (l) sum += ((uint16_t)p[0] << 8); // odd byte
+// Receive ring and window bookkeeping
+static uint8_t* s_rb;
+static uint32_t s_rb_rd, s_rb_len;
+static uint32_t s_adv_edge;         // right window edge last advertised (rcv_nxt + window)
+static uint8_t  s_ack_pending;      // in-order segments not yet acknowledged
+static int      s_fin_rcvd;
+static uint32_t s_last_rx;          // ticks, idle timeout
 
-    while (sum >> 16) sum = (sum & 0xFFFF) + (sum >> 16);
-    return (uint16_t)~sum;
-}
+// HTTP request state
+static int      s_http = H_REQ;
+static char     s_req[1024];
+static uint16_t s_req_len;
+static uint32_t s_body_left;
+static int      s_put_ok;
+static neelefs_writer_t s_put;
+static char     s_put_dir[64];      // upload directory; empty: PUT refused
 
 void net_tcp_min_init(void){ s_state=T_CLOSED; s_listen_port=80; }
 void net_tcp_min_listen(uint16_t port){ s_listen_port = port?port:80; s_state=T_LISTEN; }
-void net_tcp_min_stop(void){ s_state=T_CLOSED; }
+void net_tcp_min_stop(void){ if (s_http==H_BODY && s_put_ok) neelefs_writer_abort(&s_put); s_http=H_DONE; s_state=T_CLOSED; }
 void net_tcp_min_set_http_body(const char* body){ if (!body) return; int i=0; while (body[i] && i<(int)sizeof(s_http_body)-1){ s_http_body[i]=body[i]; i++; } s_http_body[i]=0; }
+void net_tcp_min_set_put_dir(const char* dir){
+    int i=0; if (dir) for (; dir[i] && i<(int)sizeof(s_put_dir)-1; i++) s_put_dir[i]=dir[i];
+    while (i>1 && s_put_dir[i-1]=='/') i--;
+    s_put_dir[i]=0;
+}
 void net_tcp_min_set_file_path(const char* path){ if (!path) return; int i=0; for (; path[i] && i< (int)sizeof(s_file_path)-1; i++) s_file_path[i]=path[i]; s_file_path[i]=0; s_use_file=1; }
 void net_tcp_min_use_inline(void){ s_use_file=0; }
-void net_tcp_min_status(void){ console_write("http: "); console_write(s_state==T_LISTEN?"LISTEN":s_state==T_SYN_RCVD?"SYN_RCVD":s_state==T_ESTABLISHED?"ESTABLISHED":s_state==T_LAST_ACK?"LAST_ACK":"CLOSED"); console_write(" port="); console_write_dec(s_listen_port); console_write("\n"); }
+void net_tcp_min_status(void){
+    console_write("http: "); console_write(s_state==T_LISTEN?"LISTEN":s_state==T_SYN_RCVD?"SYN_RCVD":s_state==T_ESTABLISHED?"ESTABLISHED":s_state==T_LAST_ACK?"LAST_ACK":"CLOSED");
+    console_write(" port="); console_write_dec(s_listen_port);
+    console_write(" put="); console_write(s_put_dir[0] ? s_put_dir : "off");
+    if (s_state==T_ESTABLISHED || s_state==T_LAST_ACK) {
+        console_write(" mss="); console_write_dec(s_mss);
+        console_write(" wscale="); console_write_dec(s_snd_ws); console_write("/"); console_write_dec(s_rcv_ws);
+        console_write(s_syn.has_ts ? " ts" : ""); console_write(s_syn.sack_ok ? " sack-ok" : "");
+        console_write(" rcvq="); console_write_dec(s_rb_len); console_write("/"); console_write_dec(RB_SIZE);
+    }
+    console_write("\n");
+}
+
+// Free ring space in whole window-scale units: what we may advertise
+static uint32_t rcv_window(void){ return ((RB_SIZE - s_rb_len) >> s_rcv_ws) << s_rcv_ws; }
 
 static void send_tcp(uint32_t dst_ip_be, uint16_t src_port, uint16_t dst_port, uint32_t seq, uint32_t ack, uint8_t flags, const uint8_t* data, uint16_t dlen){
-    uint8_t seg[20+1460]; if (dlen>1460) dlen=1460;
+    static uint8_t seg[20+NET_TCP_OPT_SYN_MAX+TCP_MSS]; if (dlen>TCP_MSS) dlen=TCP_MSS;
+    // Options: negotiation on SYN, timestamps afterwards when agreed
+    uint8_t olen = 0;
+    if (flags & 0x02) olen = net_tcp_opts_syn(seg+20, TCP_MSS, &s_syn, s_rcv_ws, net_tcp_ts_now());
+    else if (s_syn.has_ts) olen = net_tcp_opts_ts(seg+20, net_tcp_ts_now(), s_ts_recent);
+    uint8_t hlen = (uint8_t)(20 + olen);
+    // Window: free ring space, unscaled on SYN
+    uint32_t w = rcv_window(); if (!(flags & 0x02)) w >>= s_rcv_ws; if (w > 0xFFFF) w = 0xFFFF;
+    if (flags & 0x10) s_adv_edge = ack + ((flags & 0x02) ? w : (w << s_rcv_ws));
     // TCP header
     seg[0]=(uint8_t)(src_port>>8); seg[1]=(uint8_t)src_port; seg[2]=(uint8_t)(dst_port>>8); seg[3]=(uint8_t)dst_port;
     seg[4]=(uint8_t)(seq>>24); seg[5]=(uint8_t)(seq>>16); seg[6]=(uint8_t)(seq>>8); seg[7]=(uint8_t)seq;
     seg[8]=(uint8_t)(ack>>24); seg[9]=(uint8_t)(ack>>16); seg[10]=(uint8_t)(ack>>8); seg[11]=(uint8_t)ack;
-    seg[12]= (uint8_t)((5<<4)); // data offset=5 (20 bytes), reserved=0
+    seg[12]= (uint8_t)((hlen/4)<<4); // data offset, reserved=0
     seg[13]= flags;
-    seg[14]= 0x10; seg[15]= 0x00; // window 4096
+    seg[14]= (uint8_t)(w>>8); seg[15]= (uint8_t)w;
     seg[16]= 0; seg[17]= 0; // checksum (to calc)
     seg[18]= 0; seg[19]= 0; // urgent ptr
-    for (uint16_t i=0;i<dlen;i++) seg[20+i]=data[i];
-    uint16_t tcp_len = (uint16_t)(20 + dlen);
-    // obtain our IP
-    uint32_t ip,mask,gw; net_ipv4_config_get(&ip,&mask,&gw);
-    uint16_t c = tcp_checksum(ip, dst_ip_be, seg, tcp_len); seg[16]=(uint8_t)(c>>8); seg[17]=(uint8_t)c;
-    (void)net_ipv4_send(dst_ip_be, 6, seg, tcp_len);
+    uint16_t tcp_len = (uint16_t)(hlen + dlen);
+    // our IP on the interface the segment is routed through
+    uint32_t ip = net_ipv4_source_for(dst_ip_be);
+    // Checksum: pseudo-header + header, then payload summed while it is copied in
+    uint32_t sum = net_csum_pseudo_ipv4(ip, dst_ip_be, 6, tcp_len);
+    sum = net_csum_partial(seg, hlen, sum);
+    if (dlen) sum = net_csum_copy(seg+hlen, data, dlen, sum);
+    uint16_t c = net_csum_fold(sum); seg[16]=(uint8_t)(c>>8); seg[17]=(uint8_t)c;
+    if (net_ipv4_send(dst_ip_be, 6, seg, tcp_len)) NET_STAT_INC(tcp_tx);
 }
 
+static void send_ack(void){ s_ack_pending=0; send_tcp(s_peer_ip, s_listen_port, s_peer_port, s_snd_nxt, s_rcv_nxt, 0x10, NULL, 0); }
+
 static int parse_tcp(const uint8_t* ip, uint16_t ip_len, uint16_t* sport, uint16_t* dport, uint32_t* seq, uint32_t* ack, uint8_t* flags, const uint8_t** data, uint16_t* dlen){
     if (ip_len < 20) return 0; uint8_t ihl = (uint8_t)((ip[0]&0x0F)*4); if (ip_len < ihl+20) return 0;
     const uint8_t* tcp = ip + ihl; uint16_t tcp_total = (uint16_t)(ip_len - ihl);
@@ -78,32 +122,192 @@ static int parse_tcp(const uint8_t* ip, uint16_t ip_len, uint16_t* sport, uint16
     *seq = ((uint32_t)tcp[4]<<24)|((uint32_t)tcp[5]<<16)|((uint32_t)tcp[6]<<8)|tcp[7];
     *ack = ((uint32_t)tcp[8]<<24)|((uint32_t)tcp[9]<<16)|((uint32_t)tcp[10]<<8)|tcp[11];
     uint8_t off = (uint8_t)((tcp[12]>>4)*4); *flags = tcp[13];
-    if (tcp_total < off) return 0; *data = tcp + off; *dlen = (uint16_t)(tcp_total - off); return 1;
+    if (off < 20 || tcp_total < off) return 0; *data = tcp + off; *dlen = (uint16_t)(tcp_total - off); return 1;
+}
+
+// Send a response in MSS-sized segments, then FIN
+static void http_send(const uint8_t* p, uint32_t n){
+    NET_STAT_ADD(http_tx_bytes, n);
+    while (n) {
+        uint16_t k = (uint16_t)(n < s_mss ? n : s_mss);
+        send_tcp(s_peer_ip, s_listen_port, s_peer_port, s_snd_nxt, s_rcv_nxt, 0x18, p, k); // PSH|ACK
+        s_snd_nxt += k; p += k; n -= k;
+    }
+    send_tcp(s_peer_ip, s_listen_port, s_peer_port, s_snd_nxt, s_rcv_nxt, 0x11, NULL, 0); // FIN|ACK
+    s_snd_nxt += 1; s_state = T_LAST_ACK; s_http = H_DONE; s_ack_pending = 0;
+}
+
+static int put_str(char* o, int p, const char* s){ while (*s) o[p++]=*s++; return p; }
+static int put_dec(char* o, int p, uint32_t v){ char tmp[10]; int ti=0; do { tmp[ti++]=(char)('0'+v%10); v/=10; } while (v); while (ti--) o[p++]=tmp[ti]; return p; }
+
+// emit HTTP/1.0 response: status line, headers, body (truncated to the buffer)
+static void http_reply(const char* status, const uint8_t* body, uint16_t body_len){
+    static uint8_t out[1460+256];
+    char* hdr = (char*)out; int p = put_str(hdr, 0, "HTTP/1.0 "); p = put_str(hdr, p, status); p = put_str(hdr, p, "\r\n");
+    p = put_str(hdr, p, "Content-Type: text/html\r\nConnection: close\r\nContent-Length: ");
+    if (body_len > sizeof(out) - 256) body_len = (uint16_t)(sizeof(out) - 256);
+    p = put_dec(hdr, p, body_len); p = put_str(hdr, p, "\r\n\r\n");
+    for (uint16_t i=0;i<body_len;i++) out[p+i]=body[i];
+    http_send(out, (uint32_t)(p + body_len));
 }
 
-static int starts_with_get(const uint8_t* d, uint16_t n){ return n>=3 && d[0]=='G' && d[1]=='E' && d[2]=='T'; }
+static void http_error(const char* status){
+    static char b[96]; int p = put_str(b, 0, "<html><body><h1>"); p = put_str(b, p, status); p = put_str(b, p, "</h1></body></html>\n");
+    http_reply(status, (const uint8_t*)b, (uint16_t)p);
+}
+
+static void http_get(void){
+    // Select body: from file or inline
+    static uint8_t bodybuf[1460];
+    uint32_t out_len=0;
+    if (!s_use_file) {
+        uint16_t n=0; while (s_http_body[n]) n++;
+        NET_STAT_INC(http_200); http_reply("200 OK", (const uint8_t*)s_http_body, n);
+    } else if (neelefs_read_text(s_file_path, (char*)bodybuf, sizeof(bodybuf), &out_len)) {
+        NET_STAT_INC(http_200); http_reply("200 OK", bodybuf, (uint16_t)out_len);
+    } else {
+        NET_STAT_INC(http_404); http_error("404 Not Found");
+    }
+}
+
+static void http_put_done(void){
+    int ok = s_put_ok && neelefs_writer_close(&s_put); s_put_ok = 0;
+    if (ok) { NET_STAT_INC(http_201); http_reply("201 Created", NULL, 0); }
+    else { NET_STAT_INC(http_err); http_error("500 Internal Server Error"); }
+}
+
+// PUT only lands below the configured directory and never climbs out via ".."
+static int http_put_allowed(const char* path){
+    if (!s_put_dir[0]) return 0;
+    for (const char* c = path; *c; c++) if (c[0]=='/' && c[1]=='.' && c[2]=='.' && (c[3]=='/' || !c[3])) return 0;
+    int i=0; while (s_put_dir[i] && path[i]==s_put_dir[i]) i++;
+    if (s_put_dir[i]) return 0;
+    if (i==1) return path[1]!=0;
+    return path[i]=='/' && path[i+1];
+}
+
+// Case-insensitive search for a header name at the start of a line
+static const char* http_header(const char* name){
+    for (const char* l = s_req; *l; ) {
+        int i=0; while (name[i] && ((l[i]|0x20) == (name[i]|0x20))) i++;
+        if (!name[i]) { l += i; while (*l==' ') l++; return l; }
+        while (*l && *l!='\n') l++;
+        if (*l) l++;
+    }
+    return NULL;
+}
+
+// A complete request header is in s_req
+static void http_request(void){
+    NET_STAT_INC(http_req);
+    if (s_req[0]=='G' && s_req[1]=='E' && s_req[2]=='T' && s_req[3]==' ') { http_get(); return; }
+    if (!(s_req[0]=='P' && s_req[1]=='U' && s_req[2]=='T' && s_req[3]==' ')) { NET_STAT_INC(http_err); http_error("501 Not Implemented"); return; }
+    NET_STAT_INC(http_put);
+    // Target path: the request URI, stored as-is on NeeleFS
+    static char path[128]; int n=0; const char* u = s_req + 4;
+    while (u[n] && u[n]!=' ' && u[n]!='\r' && n<(int)sizeof(path)-1) { path[n]=u[n]; n++; } path[n]=0;
+    if (path[0]=='/' && !http_put_allowed(path)) { NET_STAT_INC(http_err); http_error("403 Forbidden"); return; }
+    const char* cl = http_header("content-length:");
+    if (path[0]!='/' || !cl || *cl<'0' || *cl>'9') { NET_STAT_INC(http_err); http_error(path[0]!='/' ? "400 Bad Request" : "411 Length Required"); return; }
+    uint32_t len=0; while (*cl>='0' && *cl<='9') len = len*10u + (uint32_t)(*cl++ - '0');
+    s_put_ok = neelefs_writer_open(&s_put, path, len);
+    s_body_left = len; s_http = H_BODY;
+    const char* ex = http_header("expect:");
+    if (ex && (ex[0]|0x20)=='1' && ex[1]=='0' && ex[2]=='0') {
+        static const char cont[] = "HTTP/1.1 100 Continue\r\n\r\n";
+        send_tcp(s_peer_ip, s_listen_port, s_peer_port, s_snd_nxt, s_rcv_nxt, 0x18, (const uint8_t*)cont, sizeof(cont)-1);
+        s_snd_nxt += sizeof(cont)-1; s_ack_pending = 0;
+    }
+    if (!s_body_left) http_put_done();
+}
+
+// Consume queued data: request header byte by byte, PUT body in ring-contiguous runs
+static void http_drain(void){
+    while (s_rb_len && s_state==T_ESTABLISHED) {
+        if (s_http == H_REQ) {
+            char ch = (char)s_rb[s_rb_rd]; if (++s_rb_rd == RB_SIZE) s_rb_rd = 0; s_rb_len--;
+            s_req[s_req_len++] = ch; s_req[s_req_len] = 0;
+            if (s_req_len >= 4 && s_req[s_req_len-1]=='\n' && s_req[s_req_len-3]=='\n') { http_request(); continue; }
+            if (s_req_len == sizeof(s_req)-1) { NET_STAT_INC(http_err); http_error("400 Bad Request"); }
+        } else if (s_http == H_BODY) {
+            uint32_t n = RB_SIZE - s_rb_rd; if (n > s_rb_len) n = s_rb_len; if (n > s_body_left) n = s_body_left;
+            if (s_put_ok && !neelefs_writer_write(&s_put, s_rb + s_rb_rd, n)) { neelefs_writer_abort(&s_put); s_put_ok = 0; }
+            s_rb_rd += n; if (s_rb_rd == RB_SIZE) s_rb_rd = 0; s_rb_len -= n; s_body_left -= n;
+            NET_STAT_ADD(http_rx_bytes, n);
+            if (!s_body_left) http_put_done();
+        } else {
+            s_rb_rd = 0; s_rb_len = 0;   // answered: anything further is ignored
+        }
+    }
+}
+
+static void conn_reset(void){
+    if (s_http==H_BODY && s_put_ok) neelefs_writer_abort(&s_put);
+    s_put_ok = 0; s_http = H_DONE; s_state = T_LISTEN;
+}
+
+void net_tcp_min_tick(void){
+    if (s_state!=T_SYN_RCVD && s_state!=T_ESTABLISHED && s_state!=T_LAST_ACK) return;
+    uint32_t hz = platform_timer_get_hz(); if (!hz) hz = 100;
+    if (platform_ticks_get() - s_last_rx >= (uint32_t)CONFIG_NET_TCP_IDLE_SEC * hz) {
+        if (s_state==T_ESTABLISHED) send_tcp(s_peer_ip, s_listen_port, s_peer_port, s_snd_nxt, s_rcv_nxt, 0x14, NULL, 0); // RST|ACK
+        NET_STAT_INC(tcp_timeouts); conn_reset(); return;
+    }
+    if (s_state!=T_ESTABLISHED) return;
+    http_drain();
+    if (s_state!=T_ESTABLISHED) return;
+    if (s_fin_rcvd && s_http!=H_DONE) {
+        // Peer closed before the request was complete
+        if (s_http==H_BODY && s_put_ok) neelefs_writer_abort(&s_put);
+        s_put_ok = 0; NET_STAT_INC(http_err); http_send(NULL, 0); return;
+    }
+    // Acknowledge what is left over; announce the window once it opened by a
+    // segment or half the ring (receiver-side silly window avoidance)
+    uint32_t thresh = RB_SIZE/2 < s_mss ? RB_SIZE/2 : s_mss;
+    if (s_ack_pending) send_ack();
+    else if ((int32_t)(s_rcv_nxt + rcv_window() - s_adv_edge) >= (int32_t)thresh) { NET_STAT_INC(tcp_wnd_upd); send_ack(); }
+}
 
 void net_tcp_on_ipv4(const uint8_t* ip, uint16_t ip_len){
-    if (s_state==T_CLOSED) return;
+    if (s_state==T_CLOSED) { NET_STAT_INC(tcp_no_listener); return; }
     // build src/dst ip (big-endian 32-bit values)
     uint32_t src = ((uint32_t)ip[12]<<24)|((uint32_t)ip[13]<<16)|((uint32_t)ip[14]<<8)|((uint32_t)ip[15]);
-    uint32_t dst = ((uint32_t)ip[16]<<24)|((uint32_t)ip[17]<<16)|((uint32_t)ip[18]<<8)|((uint32_t)ip[19]); (void)dst;
     uint16_t sport,dport; uint32_t seq,ack; uint8_t fl; const uint8_t* data; uint16_t dlen;
-    if (!parse_tcp(ip, ip_len, &sport, &dport, &seq, &ack, &fl, &data, &dlen)) return;
-    if (dport != s_listen_port) return;
+    if (!parse_tcp(ip, ip_len, &sport, &dport, &seq, &ack, &fl, &data, &dlen)) { NET_STAT_INC(tcp_bad); return; }
+    if (dport != s_listen_port) { NET_STAT_INC(tcp_no_listener); return; }
+    const uint8_t* tcp = ip + (ip[0]&0x0F)*4; uint8_t off = (uint8_t)(data - tcp);
 
     if (s_state == T_LISTEN) {
-        if (fl & 0x02) { // SYN
+        if ((fl & 0x02) && !(fl & 0x14)) { // SYN
+            if (!s_rb) s_rb = (uint8_t*)memory_alloc(RB_SIZE);
+            if (!s_rb) return;
+            net_tcp_opts_parse(tcp, off, &s_syn);
+            s_snd_ws = s_syn.has_wscale ? s_syn.wscale : 0;
+            s_rcv_ws = s_syn.has_wscale ? net_tcp_wscale_for(RB_SIZE) : 0;
+            s_ts_recent = s_syn.ts_val;
+            s_mss = (uint16_t)(s_syn.mss < TCP_MSS ? s_syn.mss : TCP_MSS);
+            if (s_mss < 64) s_mss = 64;
+            if (s_syn.has_ts) s_mss = (uint16_t)(s_mss - NET_TCP_OPT_TS_LEN);
+            s_rb_rd = s_rb_len = 0; s_ack_pending = 0; s_fin_rcvd = 0;
+            s_http = H_REQ; s_req_len = 0; s_req[0] = 0; s_put_ok = 0;
             s_peer_ip = src; s_peer_port = sport; s_rcv_nxt = seq + 1; s_snd_nxt = s_snd_iss;
             send_tcp(s_peer_ip, s_listen_port, s_peer_port, s_snd_nxt, s_rcv_nxt, (uint8_t)(0x12), NULL, 0); // SYN|ACK
             s_snd_nxt++;
             s_state = T_SYN_RCVD;
+            s_last_rx = platform_ticks_get();
+            NET_STAT_INC(tcp_conns);
         }
         return;
     }
 
     // Only accept traffic from the recorded peer
-    if (sport != s_peer_port || src != s_peer_ip) return;
+    if (sport != s_peer_port || src != s_peer_ip) { NET_STAT_INC(tcp_not_peer); return; }
+    s_last_rx = platform_ticks_get();
+
+    if (fl & 0x04) { // RST: the peer gave up (e.g. an aborted upload)
+        if ((uint32_t)(seq - s_rcv_nxt) <= RB_SIZE) conn_reset();
+        return;
+    }
 
     if (s_state == T_SYN_RCVD) {
         if ((fl & 0x10) && ack == s_snd_nxt) { // ACK of our SYN
@@ -113,62 +317,26 @@ void net_tcp_on_ipv4(const uint8_t* ip, uint16_t ip_len){
     }
 
     if (s_state == T_ESTABLISHED) {
-        if (fl & 0x01) { // FIN from peer
-            s_rcv_nxt = seq + 1; // ack FIN
-            send_tcp(s_peer_ip, s_listen_port, s_peer_port, s_snd_nxt, s_rcv_nxt, 0x10, NULL, 0); // ACK
-            s_state = T_CLOSED; return;
-        }
-        if (dlen > 0) {
-            // advance receive next by payload length
-            s_rcv_nxt = seq + dlen;
-            // Select body: from file or inline
-            static uint8_t bodybuf[1460];
-            const uint8_t* bptr = (const uint8_t*)s_http_body;
-            uint16_t body_len = 0;
-            int status_200 = 1;
-            if (s_use_file) {
-                uint32_t out_len=0;
-                if (neelefs_read_text(s_file_path, (char*)bodybuf, sizeof(bodybuf), &out_len)) {
-                    bptr = bodybuf; body_len = (uint16_t)out_len; status_200 = 1;
-                } else {
-                    const char* nf="<html><body><h1>404 Not Found</h1></body></html>\n";
-                    int i=0; while (nf[i] && i<(int)sizeof(bodybuf)) { bodybuf[i]=(uint8_t)nf[i]; i++; }
-                    bptr = bodybuf; body_len = (uint16_t)i; status_200 = 0;
-                }
-            } else {
-                while (s_http_body[body_len] && body_len < sizeof(bodybuf)) body_len++;
-            }
-
-            // emit HTTP/1.0 response
-            char hdr[256]; int p=0; const char* h1 = status_200 ? "HTTP/1.0 200 OK\r\n" : "HTTP/1.0 404 Not Found\r\n";
-            while (h1[p]) { hdr[p]=h1[p]; p++; }
-            const char* ctype="Content-Type: text/html\r\n"; for (int i=0; ctype[i]; i++) hdr[p++]=ctype[i];
-            const char* conn="Connection: close\r\n"; for (int i=0; conn[i]; i++) hdr[p++]=conn[i];
-            const char* cl="Content-Length: "; for (int i=0; cl[i]; i++) hdr[p++]=cl[i];
-            // content length decimal
-            char num[12]; int ni=0; int v=body_len; if (v==0){ num[ni++]='0'; }
-            else { char tmp[10]; int ti=0; while (v>0){ tmp[ti++]=(char)('0'+(v%10)); v/=10; } while (ti--) num[ni++]=tmp[ti]; }
-            for (int i=0;i<ni;i++) hdr[p++]=num[i];
-            hdr[p++]='\r'; hdr[p++]='\n'; hdr[p++]='\r'; hdr[p++]='\n';
-            // build payload buffer
-            static uint8_t out[1460];
-            // ensure we don't exceed one TCP segment
-            uint16_t max_body = (uint16_t)(sizeof(out) - p);
-            if (body_len > max_body) body_len = max_body;
-            for (int i=0;i<p;i++) out[i]=(uint8_t)hdr[i]; for (uint16_t i=0;i<body_len;i++) out[p+i]=bptr[i];
-            uint16_t out_len=(uint16_t)(p+body_len);
-            send_tcp(s_peer_ip, s_listen_port, s_peer_port, s_snd_nxt, s_rcv_nxt, 0x18, out, out_len); // PSH|ACK
-            s_snd_nxt += out_len;
-            // FIN
-            send_tcp(s_peer_ip, s_listen_port, s_peer_port, s_snd_nxt, s_rcv_nxt, 0x11, NULL, 0); // FIN|ACK
-            s_snd_nxt += 1; s_state = T_LAST_ACK;
-            return;
+        if (!dlen && !(fl & 0x01)) return; // pure ACKs ignored
+        if (seq != s_rcv_nxt) {
+            // Retransmission or a gap: nothing is queued out of order, repeat our ACK
+            NET_STAT_INC(tcp_ooo); send_ack(); return;
         }
-        // pure ACKs ignored
+        if (s_syn.has_ts && off > 20) { net_tcp_opts_t o; net_tcp_opts_parse(tcp, off, &o); if (o.has_ts) s_ts_recent = o.ts_val; }
+        // Queue what fits the window; the rest is dropped and resent by the peer
+        uint32_t room = RB_SIZE - s_rb_len; uint16_t take = (uint16_t)(dlen < room ? dlen : room);
+        uint32_t wr = s_rb_rd + s_rb_len; if (wr >= RB_SIZE) wr -= RB_SIZE;
+        for (uint16_t i=0;i<take;i++) { s_rb[wr]=data[i]; if (++wr == RB_SIZE) wr = 0; }
+        s_rb_len += take; s_rcv_nxt += take;
+        if (take < dlen) NET_STAT_INC(tcp_ooo);
+        else if (fl & 0x01) { s_rcv_nxt++; s_fin_rcvd = 1; }
+        // Delayed ACK: every second segment here, the rest after the drain in net_tcp_min_tick()
+        if (++s_ack_pending >= 2 || take < dlen || s_fin_rcvd) send_ack();
         return;
     }
 
     if (s_state == T_LAST_ACK) {
+        if ((fl & 0x01) && seq + dlen == s_rcv_nxt) { s_rcv_nxt = seq + dlen + 1; send_ack(); } // peer's FIN
         if ((fl & 0x10) && ack == s_snd_nxt) { // final ACK for our FIN
             s_state = T_LISTEN; // ready for next connection
         }
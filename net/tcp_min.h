@@ -7,7 +7,13 @@ void net_tcp_min_stop(void);
 void net_tcp_min_set_http_body(const char* body);
 void net_tcp_min_set_file_path(const char* path);
 void net_tcp_min_use_inline(void);
+// Directory PUT may write below ("/dir"); NULL or "" disables uploads (default)
+void net_tcp_min_set_put_dir(const char* dir);
 void net_tcp_min_status(void);
 
+// Drain the receive ring (HTTP request/PUT body), send delayed ACKs and
+// window updates, reset idle connections (netface scheduler via net_ipv4_poll)
+void net_tcp_min_tick(void);
+
 // Called by IPv4 layer on incoming TCP packets
 void net_tcp_on_ipv4(const uint8_t* ip, uint16_t ip_len);
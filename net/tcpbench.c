@@ -0,0 +1,308 @@
+#include "tcpbench.h"
+#include "ipv4.h"
+#include "csum.h"
+#include "netstat.h"
+#include "tcpopt.h"
+#include "../config.h"
+#include "../console.h"
+#include "../platform.h"
+#include <stddef.h>
+
+#define TB_WINDOW   CONFIG_NET_TCPBENCH_WINDOW
+#define TB_MSS      1460u
+#define TB_RTO_MS   250u
+#define TB_LINGER_MS 1000u
+
+enum { TB_CLOSED = 0, TB_LISTEN, TB_SYN_RCVD, TB_ESTABLISHED, TB_LAST_ACK };
+
+// TCP flags
+#define F_FIN 0x01
+#define F_SYN 0x02
+#define F_RST 0x04
+#define F_PSH 0x08
+#define F_ACK 0x10
+
+typedef struct {
+    uint16_t port;
+    uint8_t  state;
+    uint8_t  chargen;
+    uint32_t peer_ip;
+    uint16_t peer_port;
+    uint16_t peer_mss;
+    uint32_t peer_wnd;       // scaled by the peer's window-scale shift
+    net_tcp_opts_t syn;      // options from the peer's SYN
+    uint8_t  snd_ws, rcv_ws; // window-scale shifts (peer's, ours), 0 = off
+    uint32_t ts_recent;      // peer TSval to echo, with syn.has_ts
+    uint32_t rcv_nxt;
+    uint32_t iss, snd_una, snd_nxt;
+    uint32_t t_start_us;
+    uint32_t t_progress;     // tick of the last ACK progress (RTO base)
+    uint32_t conn_bytes;
+    net_tcpbench_stats_t st;
+} tb_conn_t;
+
+static tb_conn_t s_tb[2] = {
+    { .port = NET_TCPBENCH_DISCARD_PORT, .chargen = 0 },
+    { .port = NET_TCPBENCH_CHARGEN_PORT, .chargen = 1 },
+};
+static uint32_t s_iss = 0x6d7a0000u;
+
+static uint32_t be32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static void put32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24); p[1] = (uint8_t)(v >> 16); p[2] = (uint8_t)(v >> 8); p[3] = (uint8_t)v;
+}
+
+static uint32_t tb_hz(void) { uint32_t hz = platform_timer_get_hz(); return hz ? hz : 100u; }
+
+// RFC 864: 72 characters per line from a 95-character ring, each line starting
+// one character later, followed by CRLF
+static void chargen_fill(uint8_t* dst, uint32_t off, uint16_t len) {
+    uint32_t line = off / 74u, col = off % 74u;
+    for (uint16_t i = 0; i < len; i++) {
+        if (col == 72u) dst[i] = '\r';
+        else if (col == 73u) dst[i] = '\n';
+        else dst[i] = (uint8_t)(' ' + (line + col) % 95u);
+        if (++col == 74u) { col = 0; line++; }
+    }
+}
+
+// Send one segment; chargen payload is generated for the stream offset of 'seq'
+static void tb_send(tb_conn_t* c, uint32_t seq, uint8_t flags, uint16_t dlen) {
+    static uint8_t seg[20 + NET_TCP_OPT_SYN_MAX + TB_MSS];
+    uint16_t hlen = 20;
+    if (flags & F_SYN) hlen = (uint16_t)(hlen + net_tcp_opts_syn(seg + 20, TB_MSS, &c->syn, c->rcv_ws, net_tcp_ts_now()));
+    else if (c->syn.has_ts) hlen = (uint16_t)(hlen + net_tcp_opts_ts(seg + 20, net_tcp_ts_now(), c->ts_recent));
+    // The window in a SYN is never scaled
+    uint32_t w = (flags & F_SYN) ? TB_WINDOW : (TB_WINDOW >> c->rcv_ws);
+    uint16_t wnd = (uint16_t)(w > 65535 ? 65535 : w);
+    seg[0] = (uint8_t)(c->port >> 8); seg[1] = (uint8_t)c->port;
+    seg[2] = (uint8_t)(c->peer_port >> 8); seg[3] = (uint8_t)c->peer_port;
+    put32(seg + 4, seq);
+    put32(seg + 8, c->rcv_nxt);
+    seg[12] = (uint8_t)((hlen / 4) << 4);
+    seg[13] = flags;
+    seg[14] = (uint8_t)(wnd >> 8); seg[15] = (uint8_t)wnd;
+    seg[16] = 0; seg[17] = 0; seg[18] = 0; seg[19] = 0;
+    if (dlen) chargen_fill(seg + hlen, seq - c->iss - 1u, dlen);
+    uint16_t tlen = (uint16_t)(hlen + dlen);
+    uint32_t src = net_ipv4_source_for(c->peer_ip);
+    uint16_t sum = net_csum_fold(net_csum_partial(seg, tlen, net_csum_pseudo_ipv4(src, c->peer_ip, 6, tlen)));
+    seg[16] = (uint8_t)(sum >> 8); seg[17] = (uint8_t)sum;
+    if (net_ipv4_send(c->peer_ip, 6, seg, tlen)) NET_STAT_INC(tcp_tx);
+}
+
+static void tb_close_stats(tb_conn_t* c) {
+    c->st.last_bytes = c->conn_bytes;
+    c->st.last_ms = (platform_time_us() - c->t_start_us) / 1000u;
+    c->state = TB_LISTEN;
+}
+
+// Fill the window: min(peer window, our cap), MSS-sized segments
+static void chargen_push(tb_conn_t* c) {
+    if (c->state != TB_ESTABLISHED) return;
+    uint32_t limit = c->peer_wnd < TB_WINDOW ? c->peer_wnd : TB_WINDOW;
+    uint16_t mss = c->peer_mss < TB_MSS ? c->peer_mss : (uint16_t)TB_MSS;
+    if (c->syn.has_ts) mss = (uint16_t)(mss - NET_TCP_OPT_TS_LEN);
+    for (;;) {
+        uint32_t inflight = c->snd_nxt - c->snd_una;
+        if (inflight >= limit) break;
+        uint32_t room = limit - inflight;
+        uint16_t n = (uint16_t)(room < mss ? room : mss);
+        // Avoid silly small segments unless nothing is in flight
+        if (n < mss && inflight) break;
+        tb_send(c, c->snd_nxt, F_ACK | F_PSH, n);
+        c->snd_nxt += n;
+    }
+}
+
+static tb_conn_t* tb_lookup(uint16_t port) {
+    for (int i = 0; i < 2; i++) if (s_tb[i].port == port) return &s_tb[i];
+    return NULL;
+}
+
+void net_tcpbench_start(void) {
+    for (int i = 0; i < 2; i++) if (s_tb[i].state == TB_CLOSED) s_tb[i].state = TB_LISTEN;
+}
+
+void net_tcpbench_stop(void) {
+    for (int i = 0; i < 2; i++) {
+        tb_conn_t* c = &s_tb[i];
+        if (c->state >= TB_SYN_RCVD) tb_send(c, c->snd_nxt, F_RST | F_ACK, 0);
+        c->state = TB_CLOSED;
+    }
+}
+
+bool net_tcpbench_running(void) { return s_tb[0].state != TB_CLOSED; }
+
+bool net_tcpbench_on_ipv4(const uint8_t* ip, uint16_t ip_len) {
+    uint8_t ihl = (uint8_t)((ip[0] & 0x0F) * 4);
+    if (ip_len < ihl + 20u) return false;
+    const uint8_t* t = ip + ihl;
+    uint16_t dport = (uint16_t)(((uint16_t)t[2] << 8) | t[3]);
+    tb_conn_t* c = tb_lookup(dport);
+    if (!c || c->state == TB_CLOSED) return false;
+
+    uint32_t src = be32(ip + 12);
+    uint16_t sport = (uint16_t)(((uint16_t)t[0] << 8) | t[1]);
+    uint32_t seq = be32(t + 4), ack = be32(t + 8);
+    uint8_t off = (uint8_t)((t[12] >> 4) * 4), fl = t[13];
+    uint16_t wnd = (uint16_t)(((uint16_t)t[14] << 8) | t[15]);
+    if (off < 20 || ip_len < ihl + off) { NET_STAT_INC(tcp_bad); return true; }
+    uint16_t dlen = (uint16_t)(ip_len - ihl - off);
+    // A corrupted segment must neither count as throughput nor move rcv_nxt
+    uint16_t tcp_len = (uint16_t)(ip_len - ihl);
+    uint32_t sum = net_csum_pseudo_ipv4(src, be32(ip + 16), 6, tcp_len);
+    if (net_csum_fold(net_csum_partial(t, tcp_len, sum)) != 0) { NET_STAT_INC(tcp_csum); return true; }
+
+    if (c->state == TB_LISTEN) {
+        if (!(fl & F_SYN) || (fl & (F_ACK | F_RST))) return true;
+        c->peer_ip = src; c->peer_port = sport;
+        net_tcp_opts_parse(t, off, &c->syn);
+        c->peer_mss = c->syn.mss < 64 ? 64 : c->syn.mss;
+        c->snd_ws = c->syn.has_wscale ? c->syn.wscale : 0;
+        c->rcv_ws = c->syn.has_wscale ? net_tcp_wscale_for(TB_WINDOW) : 0;
+        c->ts_recent = c->syn.ts_val;
+        c->peer_wnd = wnd;
+        c->rcv_nxt = seq + 1;
+        s_iss += 0x10000u;
+        c->iss = s_iss;
+        c->snd_una = c->iss;
+        tb_send(c, c->iss, F_SYN | F_ACK, 0);
+        c->snd_nxt = c->iss + 1;
+        c->conn_bytes = 0;
+        c->t_progress = platform_ticks_get();
+        c->state = TB_SYN_RCVD;
+        NET_STAT_INC(tcp_conns);
+        return true;
+    }
+
+    // Only the recorded peer; other clients get an RST-free silence
+    if (src != c->peer_ip || sport != c->peer_port) { NET_STAT_INC(tcp_not_peer); return true; }
+
+    if (fl & F_RST) {
+        c->st.resets++;
+        if (c->state >= TB_ESTABLISHED) tb_close_stats(c);
+        c->state = TB_LISTEN;
+        return true;
+    }
+    if (c->state == TB_SYN_RCVD && (fl & F_SYN)) {
+        tb_send(c, c->iss, F_SYN | F_ACK, 0);   // our SYN-ACK was lost
+        return true;
+    }
+
+    if (fl & F_ACK) {
+        if (c->state == TB_SYN_RCVD && ack == c->iss + 1) {
+            c->state = TB_ESTABLISHED;
+            c->snd_una = ack;
+            c->st.conns++;
+            c->t_start_us = platform_time_us();
+        }
+        // Cumulative ACK progress (ack within (snd_una, snd_nxt])
+        if ((int32_t)(ack - c->snd_una) > 0 && (int32_t)(ack - c->snd_nxt) <= 0) {
+            uint32_t adv = ack - c->snd_una;
+            if (c->chargen && c->state == TB_ESTABLISHED) { c->conn_bytes += adv; c->st.bytes += adv; }
+            c->snd_una = ack;
+            c->t_progress = platform_ticks_get();
+        }
+        c->peer_wnd = (uint32_t)wnd << c->snd_ws;
+        if (c->state == TB_LAST_ACK && ack == c->snd_nxt) { tb_close_stats(c); return true; }
+    }
+
+    if (c->state != TB_ESTABLISHED) return true;
+
+    bool need_ack = false;
+    if (dlen || (fl & F_FIN)) {
+        if (seq == c->rcv_nxt) {
+            if (c->syn.has_ts && off > 20) {
+                net_tcp_opts_t o;
+                net_tcp_opts_parse(t, off, &o);
+                if (o.has_ts) c->ts_recent = o.ts_val;
+            }
+            c->rcv_nxt += dlen;
+            if (!c->chargen) { c->conn_bytes += dlen; c->st.bytes += dlen; }
+        } else {
+            c->st.out_of_order++;
+        }
+        need_ack = true;
+    }
+
+    if ((fl & F_FIN) && seq + dlen == c->rcv_nxt) {
+        // Peer is done: acknowledge its FIN with ours and wait for the last ACK
+        c->rcv_nxt++;
+        tb_send(c, c->snd_nxt, F_FIN | F_ACK, 0);
+        c->snd_nxt++;
+        c->state = TB_LAST_ACK;
+        c->t_progress = platform_ticks_get();
+        return true;
+    }
+
+    if (c->chargen) chargen_push(c);
+    else if (need_ack) tb_send(c, c->snd_nxt, F_ACK, 0);
+    return true;
+}
+
+void net_tcpbench_tick(void) {
+    uint32_t now = platform_ticks_get();
+    uint32_t hz = tb_hz();
+    for (int i = 0; i < 2; i++) {
+        tb_conn_t* c = &s_tb[i];
+        if (c->state == TB_SYN_RCVD || c->state == TB_LAST_ACK) {
+            // Give up on half-open or lingering connections
+            if (now - c->t_progress >= TB_LINGER_MS * hz / 1000u) {
+                if (c->state == TB_LAST_ACK) tb_close_stats(c);
+                c->state = TB_LISTEN;
+            }
+            continue;
+        }
+        if (c->state != TB_ESTABLISHED || !c->chargen) continue;
+        if (c->snd_nxt != c->snd_una && now - c->t_progress >= TB_RTO_MS * hz / 1000u) {
+            // Go-back-N: resend from the first unacknowledged byte
+            c->snd_nxt = c->snd_una;
+            c->st.retransmits++;
+            c->t_progress = now;
+            if (c->peer_wnd == 0) c->peer_wnd = 1;   // zero-window probe
+        }
+        chargen_push(c);
+    }
+}
+
+void net_tcpbench_stats_get(uint16_t port, net_tcpbench_stats_t* out) {
+    tb_conn_t* c = tb_lookup(port);
+    if (!out) return;
+    if (c) *out = c->st;
+}
+
+static const char* tb_state_name(uint8_t s) {
+    switch (s) {
+        case TB_LISTEN: return "LISTEN";
+        case TB_SYN_RCVD: return "SYN_RCVD";
+        case TB_ESTABLISHED: return "ESTABLISHED";
+        case TB_LAST_ACK: return "LAST_ACK";
+        default: return "CLOSED";
+    }
+}
+
+void net_tcpbench_status(void) {
+    for (int i = 0; i < 2; i++) {
+        const tb_conn_t* c = &s_tb[i];
+        console_write(c->chargen ? "chargen" : "discard");
+        console_write(": port="); console_write_dec(c->port);
+        console_write(" "); console_write(tb_state_name(c->state));
+        console_write(" conns="); console_write_dec(c->st.conns);
+        console_write(" bytes="); console_write_dec(c->st.bytes);
+        if (c->chargen) { console_write(" rexmit="); console_write_dec(c->st.retransmits); }
+        else { console_write(" ooo="); console_write_dec(c->st.out_of_order); }
+        console_write(" rst="); console_write_dec(c->st.resets);
+        console_write("\n");
+        if (c->st.last_ms || c->st.last_bytes) {
+            uint32_t ms = c->st.last_ms ? c->st.last_ms : 1u;
+            console_write("  last: "); console_write_dec(c->st.last_bytes / 1024u);
+            console_write(" KiB in "); console_write_dec(c->st.last_ms);
+            console_write(" ms = "); console_write_dec((uint32_t)((uint64_t)c->st.last_bytes * 1000u / 1024u / ms));
+            console_write(" KiB/s\n");
+        }
+    }
+}
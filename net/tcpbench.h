@@ -0,0 +1,39 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+// TCP benchmark services: discard (RFC 863, port 9) swallows everything the
+// peer sends, chargen (RFC 864, port 19) streams the rotating 72-column
+// character pattern until the peer closes. One connection per service.
+//
+// Both are minimal TCPs of their own (next to the HTTP responder in
+// tcp_min.c): MSS option on SYN-ACK, cumulative ACKs, and for chargen a
+// go-back-N sender limited by the peer window and CONFIG_NET_TCPBENCH_WINDOW.
+// The chargen pattern is a function of the stream offset, so retransmission
+// needs no send buffer.
+
+#define NET_TCPBENCH_DISCARD_PORT 9
+#define NET_TCPBENCH_CHARGEN_PORT 19
+
+typedef struct {
+    uint32_t conns;           // completed handshakes
+    uint32_t bytes;           // payload received (discard) / acknowledged (chargen), all connections
+    uint32_t last_bytes;      // of the most recent connection
+    uint32_t last_ms;         // its duration (handshake to close)
+    uint32_t retransmits;     // chargen go-back-N restarts
+    uint32_t out_of_order;    // discard segments not at rcv_nxt (answered with a duplicate ACK)
+    uint32_t resets;          // RSTs received
+} net_tcpbench_stats_t;
+
+void net_tcpbench_start(void);
+void net_tcpbench_stop(void);
+bool net_tcpbench_running(void);
+
+// Called by the IPv4 layer for every TCP segment; returns true if consumed
+bool net_tcpbench_on_ipv4(const uint8_t* ip, uint16_t ip_len);
+
+// Retransmission timer and chargen refill (netface scheduler via net_ipv4_poll)
+void net_tcpbench_tick(void);
+
+void net_tcpbench_stats_get(uint16_t port, net_tcpbench_stats_t* out);
+void net_tcpbench_status(void);
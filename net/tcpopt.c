@@ -0,0 +1,83 @@
+#include "tcpopt.h"
+#include "../platform.h"
+
+static uint32_t be32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static void put32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24); p[1] = (uint8_t)(v >> 16); p[2] = (uint8_t)(v >> 8); p[3] = (uint8_t)v;
+}
+
+void net_tcp_opts_parse(const uint8_t* tcp, uint8_t hdr_len, net_tcp_opts_t* out) {
+    out->mss = NET_TCP_DEFAULT_MSS;
+    out->wscale = 0;
+    out->has_wscale = false;
+    out->sack_ok = false;
+    out->has_ts = false;
+    out->ts_val = out->ts_ecr = 0;
+    for (uint8_t o = 20; o < hdr_len; ) {
+        uint8_t kind = tcp[o];
+        if (kind == 0) break;                     // end of options
+        if (kind == 1) { o++; continue; }         // NOP
+        if (o + 1 >= hdr_len) break;
+        uint8_t len = tcp[o + 1];
+        if (len < 2 || o + len > hdr_len) break;  // malformed: ignore the rest
+        const uint8_t* v = tcp + o + 2;
+        if (kind == 2 && len == 4) {
+            out->mss = (uint16_t)(((uint16_t)v[0] << 8) | v[1]);
+            if (out->mss == 0) out->mss = NET_TCP_DEFAULT_MSS;
+        } else if (kind == 3 && len == 3) {
+            out->wscale = v[0] > 14 ? 14 : v[0];
+            out->has_wscale = true;
+        } else if (kind == 4 && len == 2) {
+            out->sack_ok = true;
+        } else if (kind == 8 && len == 10) {
+            out->has_ts = true;
+            out->ts_val = be32(v);
+            out->ts_ecr = be32(v + 4);
+        }
+        o = (uint8_t)(o + len);
+    }
+}
+
+uint8_t net_tcp_opts_syn(uint8_t* out, uint16_t mss, const net_tcp_opts_t* peer, uint8_t rcv_wscale, uint32_t ts_val) {
+    uint8_t n = 0;
+    out[n++] = 2; out[n++] = 4; out[n++] = (uint8_t)(mss >> 8); out[n++] = (uint8_t)mss;
+    if (peer && peer->has_wscale) {
+        out[n++] = 1; out[n++] = 3; out[n++] = 3; out[n++] = rcv_wscale;
+    }
+    if (peer && peer->has_ts) n = (uint8_t)(n + net_tcp_opts_ts(out + n, ts_val, peer->ts_val));
+    return n;
+}
+
+uint8_t net_tcp_opts_ts(uint8_t* out, uint32_t ts_val, uint32_t ts_ecr) {
+    out[0] = 1; out[1] = 1; out[2] = 8; out[3] = 10;
+    put32(out + 4, ts_val);
+    put32(out + 8, ts_ecr);
+    return NET_TCP_OPT_TS_LEN;
+}
+
+uint8_t net_tcp_wscale_for(uint32_t bytes) {
+    uint8_t s = 0;
+    while (s < 14 && (bytes >> s) > 0xFFFFu) s++;
+    return s;
+}
+
+// Built from PIT ticks rather than the 32-bit µs clock, which wraps after about
+// 71 minutes. The clock advances by tick deltas, so it stays monotonic across a
+// "timer hz" change and only wraps after 2^32 ms.
+static uint32_t s_ts_ticks;
+static uint32_t s_ts_ms;
+static uint32_t s_ts_rem;
+
+uint32_t net_tcp_ts_now(void) {
+    uint32_t hz = platform_timer_get_hz();
+    if (!hz) hz = 100u;
+    uint32_t now = platform_ticks_get();
+    uint64_t acc = (uint64_t)(now - s_ts_ticks) * 1000u + s_ts_rem;
+    s_ts_ticks = now;
+    s_ts_ms += (uint32_t)(acc / hz);
+    s_ts_rem = (uint32_t)(acc % hz);
+    return s_ts_ms;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+// TCP options shared by the HTTP responder (tcp_min.c) and the benchmark
+// services (tcpbench.c): MSS (RFC 9293), window scale and timestamps
+// (RFC 7323), SACK-permitted (RFC 2018).
+//
+// Window scale and timestamps are only used when the peer offered them on its
+// SYN; the SYN-ACK then carries them back. Once timestamps are on, every
+// segment carries one. SACK-permitted is recognised but not echoed: neither
+// responder keeps out-of-order data, so there is nothing to report in SACK
+// blocks.
+
+#define NET_TCP_DEFAULT_MSS 536u   // peer MSS when the SYN carries none
+#define NET_TCP_OPT_SYN_MAX 20u    // MSS + NOP/WS + NOP/NOP/TS
+#define NET_TCP_OPT_TS_LEN  12u    // NOP NOP TS on data segments
+
+typedef struct {
+    uint16_t mss;
+    uint8_t  wscale;               // shift (capped at 14), valid with has_wscale
+    bool     has_wscale;
+    bool     sack_ok;
+    bool     has_ts;
+    uint32_t ts_val, ts_ecr;
+} net_tcp_opts_t;
+
+// Parse the options of a TCP header of hdr_len bytes (20..60)
+void net_tcp_opts_parse(const uint8_t* tcp, uint8_t hdr_len, net_tcp_opts_t* out);
+
+// SYN-ACK options: our MSS, plus window scale (rcv_wscale) and a timestamp
+// when 'peer' offered them. Returns the length (multiple of 4).
+uint8_t net_tcp_opts_syn(uint8_t* out, uint16_t mss, const net_tcp_opts_t* peer, uint8_t rcv_wscale, uint32_t ts_val);
+
+// Timestamp option for established segments; returns NET_TCP_OPT_TS_LEN
+uint8_t net_tcp_opts_ts(uint8_t* out, uint32_t ts_val, uint32_t ts_ecr);
+
+// Smallest window-scale shift that lets 'bytes' be advertised in 16 bits
+uint8_t net_tcp_wscale_for(uint32_t bytes);
+
+// Timestamp clock (milliseconds, monotonic, derived from the PIT tick count)
+uint32_t net_tcp_ts_now(void);
@@ -0,0 +1,570 @@
+#include "tftp.h"
+#include "udp.h"
+#include "../config.h"
+#include "../netface.h"
+#include "../console.h"
+#include "../platform.h"
+#include "../cpuidle.h"
+#include "../drivers/fs/neelefs.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#define TFTP_PORT       69
+#define TFTP_RRQ        1
+#define TFTP_WRQ        2
+#define TFTP_DATA       3
+#define TFTP_ACK        4
+#define TFTP_ERROR      5
+#define TFTP_OACK       6
+#define TFTP_MAX_BLKSIZE (NET_UDP_FRAME_PAYLOAD - 4)
+#define TFTP_MAX_WINDOW  32
+#define TFTP_RETRIES     5
+
+#if CONFIG_NET_TFTP_BLKSIZE > TFTP_MAX_BLKSIZE
+#error "CONFIG_NET_TFTP_BLKSIZE exceeds one Ethernet frame"
+#endif
+
+enum { TS_IDLE = 0, TS_REQ, TS_OACK, TS_XFER, TS_DALLY, TS_DONE, TS_FAILED };
+
+typedef struct {
+    int      sock;
+    uint32_t peer_ip;
+    uint16_t peer_port;          // 0 until the peer's first packet fixes its TID
+    uint8_t  state;
+    uint8_t  sending;            // we send DATA (get on server side / put on client side)
+    uint8_t  retries;
+    uint8_t  dup_ack;            // one duplicate ACK (sender) / out-of-order ACK (receiver) sent
+    uint8_t  server;
+    uint16_t blksize, window;
+    uint32_t acked;              // send: blocks acknowledged; receive: blocks received in order
+    uint32_t last_block;         // send: final block once known
+    uint32_t last_len;           // send: payload of the final block
+    uint32_t t_start, t_last;
+    int      err;
+    const net_tftp_io_t* io;
+    void*    ctx;
+    net_tftp_result_t* res;
+    uint16_t ctl_len;            // last request/ACK/OACK, resent on timeout
+    uint8_t  ctl[512];
+} tftp_sess_t;
+
+typedef struct {
+    int      has_blksize, has_window, has_tsize;
+    uint32_t blksize, window, tsize;
+} tftp_opts_t;
+
+static uint8_t s_txbuf[4 + TFTP_MAX_BLKSIZE];
+
+// ---- small helpers ----
+
+static uint32_t tftp_hz(void) { uint32_t hz = platform_timer_get_hz(); return hz ? hz : 100u; }
+
+static int tftp_stricmp(const char* a, const char* b) {
+    while (*a && *b) {
+        char ca = *a, cb = *b;
+        if (ca >= 'A' && ca <= 'Z') ca = (char)(ca - 'A' + 'a');
+        if (cb >= 'A' && cb <= 'Z') cb = (char)(cb - 'A' + 'a');
+        if (ca != cb) return 1;
+        a++; b++;
+    }
+    return (*a || *b) ? 1 : 0;
+}
+
+static uint32_t tftp_atou(const char* s) {
+    uint32_t v = 0;
+    while (*s >= '0' && *s <= '9') { v = v * 10u + (uint32_t)(*s - '0'); s++; }
+    return v;
+}
+
+// Append a NUL-terminated string; returns new length or 0 on overflow
+static uint16_t tftp_put_str(uint8_t* buf, uint16_t at, uint16_t cap, const char* s) {
+    while (*s) { if (at >= cap) return 0; buf[at++] = (uint8_t)*s++; }
+    if (at >= cap) return 0;
+    buf[at++] = 0;
+    return at;
+}
+
+static uint16_t tftp_put_uint(uint8_t* buf, uint16_t at, uint16_t cap, uint32_t v) {
+    char tmp[11]; int n = 0;
+    do { tmp[n++] = (char)('0' + v % 10u); v /= 10u; } while (v && n < 10);
+    char s[11]; for (int i = 0; i < n; i++) s[i] = tmp[n - 1 - i]; s[n] = 0;
+    return tftp_put_str(buf, at, cap, s);
+}
+
+// Walk name/value pairs of a request or OACK (p..end, both strings NUL-terminated)
+static void tftp_parse_opts(const uint8_t* p, const uint8_t* end, tftp_opts_t* o) {
+    o->has_blksize = o->has_window = o->has_tsize = 0;
+    while (p < end) {
+        const char* name = (const char*)p;
+        while (p < end && *p) p++;
+        if (p >= end) return;
+        p++;
+        const char* val = (const char*)p;
+        while (p < end && *p) p++;
+        if (p >= end) return;
+        p++;
+        if (!tftp_stricmp(name, "blksize"))         { o->has_blksize = 1; o->blksize = tftp_atou(val); }
+        else if (!tftp_stricmp(name, "windowsize")) { o->has_window = 1;  o->window = tftp_atou(val); }
+        else if (!tftp_stricmp(name, "tsize"))      { o->has_tsize = 1;   o->tsize = tftp_atou(val); }
+    }
+}
+
+// ---- session engine (shared by client and server) ----
+
+static void tftp_send_raw(tftp_sess_t* t, const uint8_t* buf, uint16_t len) {
+    (void)net_udp_sendto(t->sock, t->peer_ip, t->peer_port ? t->peer_port : TFTP_PORT, buf, len);
+}
+
+static void tftp_send_ctl(tftp_sess_t* t) { tftp_send_raw(t, t->ctl, t->ctl_len); }
+
+static void tftp_ack(tftp_sess_t* t, uint32_t block) {
+    t->ctl[0] = 0; t->ctl[1] = TFTP_ACK;
+    t->ctl[2] = (uint8_t)(block >> 8); t->ctl[3] = (uint8_t)block;
+    t->ctl_len = 4;
+    tftp_send_ctl(t);
+}
+
+static void tftp_error_to(int sock, uint32_t ip, uint16_t port, uint16_t code, const char* msg) {
+    uint8_t b[80];
+    b[0] = 0; b[1] = TFTP_ERROR; b[2] = (uint8_t)(code >> 8); b[3] = (uint8_t)code;
+    uint16_t n = tftp_put_str(b, 4, sizeof(b), msg);
+    if (n) (void)net_udp_sendto(sock, ip, port, b, n);
+}
+
+static void tftp_finish(tftp_sess_t* t, bool ok) {
+    if (t->res) {
+        t->res->ticks = platform_ticks_get() - t->t_start;
+        t->res->blksize = t->blksize;
+        t->res->window = t->window;
+    }
+    if (t->io && t->io->end) t->io->end(t->ctx, ok);
+    // A receiving server lingers to re-ACK a retransmitted final block
+    t->state = ok ? ((t->server && !t->sending) ? TS_DALLY : TS_DONE) : TS_FAILED;
+    t->t_last = platform_ticks_get();
+}
+
+static void tftp_fail(tftp_sess_t* t, int err, uint16_t code, const char* msg) {
+    if (msg) tftp_error_to(t->sock, t->peer_ip, t->peer_port ? t->peer_port : TFTP_PORT, code, msg);
+    t->err = err;
+    tftp_finish(t, false);
+}
+
+static void tftp_apply_opts(tftp_sess_t* t, const tftp_opts_t* o) {
+    t->blksize = 512; t->window = 1;
+    if (o->has_blksize && o->blksize >= 8) t->blksize = (uint16_t)(o->blksize > TFTP_MAX_BLKSIZE ? TFTP_MAX_BLKSIZE : o->blksize);
+    if (o->has_window && o->window >= 1) t->window = (uint16_t)(o->window > TFTP_MAX_WINDOW ? TFTP_MAX_WINDOW : o->window);
+}
+
+static bool tftp_send_block(tftp_sess_t* t, uint32_t b) {
+    uint32_t n = t->io->read(t->ctx, (b - 1u) * t->blksize, s_txbuf + 4, t->blksize);
+    if (n > t->blksize) n = t->blksize;
+    s_txbuf[0] = 0; s_txbuf[1] = TFTP_DATA;
+    s_txbuf[2] = (uint8_t)(b >> 8); s_txbuf[3] = (uint8_t)b;
+    tftp_send_raw(t, s_txbuf, (uint16_t)(4 + n));
+    if (n < t->blksize) { t->last_block = b; t->last_len = n; }
+    return true;
+}
+
+// RFC 7440: send up to 'window' blocks after the last acknowledged one
+static void tftp_send_window(tftp_sess_t* t) {
+    for (uint32_t b = t->acked + 1u; b <= t->acked + t->window; b++) {
+        if (t->last_block && b > t->last_block) break;
+        tftp_send_block(t, b);
+        if (t->last_block == b) break;
+    }
+    t->t_last = platform_ticks_get();
+}
+
+static void tftp_on_data(tftp_sess_t* t, const uint8_t* pkt, uint16_t len) {
+    uint16_t b = (uint16_t)(((uint16_t)pkt[2] << 8) | pkt[3]);
+    uint16_t n = (uint16_t)(len - 4);
+    if (t->state == TS_DALLY || t->state == TS_DONE) {
+        if (b == (uint16_t)t->acked) tftp_send_ctl(t); // our final ACK got lost
+        return;
+    }
+    if (t->state == TS_REQ) {
+        // Server ignored our options: plain RFC 1350
+        t->blksize = 512; t->window = 1;
+        if (t->io->begin && !t->io->begin(t->ctx, 0)) { tftp_fail(t, NET_TFTP_EIO, 3, "Disk full or write failed"); return; }
+        t->state = TS_XFER;
+    }
+    if (n > t->blksize) { tftp_fail(t, NET_TFTP_EPROTO, 4, "Block too large"); return; }
+    if (b != (uint16_t)(t->acked + 1u)) {
+        // Gap or duplicate: acknowledge what we have once so the sender restarts from there
+        if (!t->dup_ack) { t->dup_ack = 1; tftp_ack(t, t->acked); }
+        return;
+    }
+    if (n && !t->io->write(t->ctx, pkt + 4, n)) { tftp_fail(t, NET_TFTP_EIO, 3, "Disk full or write failed"); return; }
+    t->acked++;
+    t->dup_ack = 0;
+    t->retries = 0;
+    t->t_last = platform_ticks_get();
+    if (t->res) { t->res->bytes += n; t->res->blocks++; }
+    if (n < t->blksize) { tftp_ack(t, t->acked); tftp_finish(t, true); return; }
+    if ((t->acked % t->window) == 0) tftp_ack(t, t->acked);
+}
+
+static void tftp_on_ack(tftp_sess_t* t, const uint8_t* pkt) {
+    uint16_t b = (uint16_t)(((uint16_t)pkt[2] << 8) | pkt[3]);
+    if (t->state == TS_REQ || t->state == TS_OACK) {
+        // Plain ACK 0 to our WRQ (no options) or to our OACK
+        if (b != 0) return;
+        if (t->state == TS_REQ) { t->blksize = 512; t->window = 1; }
+        t->state = TS_XFER;
+        t->acked = 0;
+        tftp_send_window(t);
+        return;
+    }
+    if (t->state != TS_XFER) return;
+    uint16_t delta = (uint16_t)(b - (uint16_t)t->acked);
+    if (delta == 0) {
+        // Receiver saw a gap right after 'acked': resend the window once per ACK round
+        if (!t->dup_ack) { t->dup_ack = 1; if (t->res) t->res->retransmits++; tftp_send_window(t); }
+        return;
+    }
+    if (delta > t->window) return; // stale
+    t->acked += delta;
+    t->dup_ack = 0;
+    t->retries = 0;
+    if (t->res) {
+        t->res->blocks = t->acked;
+        t->res->bytes = (t->last_block && t->acked >= t->last_block)
+            ? (t->last_block - 1u) * t->blksize + t->last_len
+            : t->acked * t->blksize;
+    }
+    if (t->last_block && t->acked >= t->last_block) { tftp_finish(t, true); return; }
+    tftp_send_window(t);
+}
+
+static void tftp_on_packet(tftp_sess_t* t, const uint8_t* pkt, uint16_t len, uint32_t src_ip, uint16_t src_port) {
+    if (t->state == TS_IDLE || t->state == TS_FAILED) return;
+    if (src_ip != t->peer_ip) return;
+    if (t->peer_port == 0) t->peer_port = src_port;          // server TID from its first reply
+    else if (src_port != t->peer_port) { tftp_error_to(t->sock, src_ip, src_port, 5, "Unknown transfer ID"); return; }
+    if (len < 4) return;
+    uint16_t op = (uint16_t)(((uint16_t)pkt[0] << 8) | pkt[1]);
+    switch (op) {
+        case TFTP_ERROR: {
+            if (t->res) {
+                uint16_t i = 0;
+                for (; i + 4u < len && pkt[4 + i] && i < sizeof(t->res->peer_error) - 1u; i++) t->res->peer_error[i] = (char)pkt[4 + i];
+                t->res->peer_error[i] = 0;
+            }
+            t->err = NET_TFTP_EPEER;
+            tftp_finish(t, false);
+            break;
+        }
+        case TFTP_OACK: {
+            if (t->state != TS_REQ) return;
+            tftp_opts_t o; tftp_parse_opts(pkt + 2, pkt + len, &o);
+            tftp_apply_opts(t, &o);
+            if (t->sending) {
+                t->state = TS_XFER; t->acked = 0;
+                tftp_send_window(t);
+            } else {
+                if (t->io->begin && !t->io->begin(t->ctx, o.has_tsize ? o.tsize : 0)) { tftp_fail(t, NET_TFTP_EIO, 3, "Disk full or write failed"); return; }
+                t->state = TS_XFER; t->acked = 0;
+                tftp_ack(t, 0);
+            }
+            break;
+        }
+        case TFTP_DATA: if (!t->sending) tftp_on_data(t, pkt, len); break;
+        case TFTP_ACK:  if (t->sending) tftp_on_ack(t, pkt); break;
+        default: tftp_fail(t, NET_TFTP_EPROTO, 4, "Illegal TFTP operation"); break;
+    }
+}
+
+static void tftp_on_timeout(tftp_sess_t* t) {
+    if (t->state == TS_DALLY) { t->state = TS_DONE; return; }
+    if (t->state != TS_REQ && t->state != TS_OACK && t->state != TS_XFER) return;
+    if (++t->retries > TFTP_RETRIES) { tftp_fail(t, NET_TFTP_ETIMEOUT, 0, "Timeout"); return; }
+    if (t->res) t->res->retransmits++;
+    if (t->sending && t->state == TS_XFER) tftp_send_window(t);
+    else { tftp_send_ctl(t); t->t_last = platform_ticks_get(); }
+}
+
+static void tftp_udp_handler(int sock, uint32_t src_ip, uint16_t src_port, const uint8_t* data, uint16_t len, void* ctx) {
+    (void)sock;
+    tftp_on_packet((tftp_sess_t*)ctx, data, len, src_ip, src_port);
+}
+
+static void tftp_sess_init(tftp_sess_t* t, int sock, uint32_t peer_ip, uint16_t peer_port, int sending,
+                           const net_tftp_io_t* io, void* ctx, net_tftp_result_t* res) {
+    t->sock = sock; t->peer_ip = peer_ip; t->peer_port = peer_port;
+    t->sending = (uint8_t)sending; t->retries = 0; t->dup_ack = 0;
+    t->blksize = 512; t->window = 1;
+    t->acked = 0; t->last_block = 0; t->last_len = 0;
+    t->err = 0; t->io = io; t->ctx = ctx; t->res = res;
+    t->t_start = t->t_last = platform_ticks_get();
+    if (res) {
+        res->bytes = 0; res->blocks = 0; res->retransmits = 0; res->ticks = 0;
+        res->blksize = 512; res->window = 1; res->peer_error[0] = 0;
+    }
+}
+
+// ---- client ----
+
+static uint16_t tftp_build_request(uint8_t* b, uint16_t cap, uint16_t op, const char* file, uint32_t tsize) {
+    b[0] = 0; b[1] = (uint8_t)op;
+    uint16_t n = 2;
+    if (!(n = tftp_put_str(b, n, cap, file))) return 0;
+    if (!(n = tftp_put_str(b, n, cap, "octet"))) return 0;
+    if (!(n = tftp_put_str(b, n, cap, "blksize"))) return 0;
+    if (!(n = tftp_put_uint(b, n, cap, CONFIG_NET_TFTP_BLKSIZE))) return 0;
+    if (CONFIG_NET_TFTP_WINDOW > 1) {
+        if (!(n = tftp_put_str(b, n, cap, "windowsize"))) return 0;
+        if (!(n = tftp_put_uint(b, n, cap, CONFIG_NET_TFTP_WINDOW))) return 0;
+    }
+    if (!(n = tftp_put_str(b, n, cap, "tsize"))) return 0;
+    if (!(n = tftp_put_uint(b, n, cap, tsize))) return 0;
+    return n;
+}
+
+static int tftp_client_run(uint16_t op, uint32_t server_be, const char* remote, uint32_t size,
+                           const net_tftp_io_t* io, void* ctx, net_tftp_result_t* res, bool (*abort)(void)) {
+    static tftp_sess_t t;
+    net_tftp_result_t local;
+    if (!res) res = &local;
+    int sock = net_udp_open(0);
+    if (sock < 0) return NET_TFTP_ENOSOCK;
+    tftp_sess_init(&t, sock, server_be, 0, op == TFTP_WRQ, io, ctx, res);
+    t.server = 0;
+    t.ctl_len = tftp_build_request(t.ctl, sizeof(t.ctl), op, remote, size);
+    if (!t.ctl_len) { net_udp_close(sock); return NET_TFTP_EPROTO; }
+    t.state = TS_REQ;
+    (void)net_udp_set_handler(sock, tftp_udp_handler, &t);
+    tftp_send_ctl(&t);
+    // Packets are handled in the RX path (handler); this loop only drives the stack and timeouts
+    uint32_t hz = tftp_hz();
+    while (t.state == TS_REQ || t.state == TS_XFER) {
+        if (abort && abort()) { tftp_fail(&t, NET_TFTP_EABORT, 0, "Transfer cancelled"); break; }
+        uint32_t acked = t.acked;
+        netface_poll();
+        if (platform_ticks_get() - t.t_last >= hz) tftp_on_timeout(&t);
+        // Nothing arrived: sleep until the NIC interrupt or the next tick
+        else if (t.acked == acked && (t.state == TS_REQ || t.state == TS_XFER)) cpuidle_idle();
+    }
+    net_udp_close(sock);
+    if (t.state == TS_FAILED && !t.err) t.err = NET_TFTP_EPROTO;
+    return t.state == TS_FAILED ? t.err : 0;
+}
+
+int net_tftp_get(uint32_t server_be, const char* remote, const net_tftp_io_t* io, void* ctx, net_tftp_result_t* res, bool (*abort)(void)) {
+    if (!io || !io->write) return NET_TFTP_EIO;
+    return tftp_client_run(TFTP_RRQ, server_be, remote, 0, io, ctx, res, abort);
+}
+
+int net_tftp_put(uint32_t server_be, const char* remote, uint32_t size, const net_tftp_io_t* io, void* ctx, net_tftp_result_t* res, bool (*abort)(void)) {
+    if (!io || !io->read) return NET_TFTP_EIO;
+    return tftp_client_run(TFTP_WRQ, server_be, remote, size, io, ctx, res, abort);
+}
+
+// ---- NeeleFS glue ----
+
+typedef struct {
+    const char*      path;
+    int              open;
+    neelefs_writer_t w;
+    neelefs_reader_t r;
+} tftp_fs_t;
+
+static bool fs_begin(void* ctx, uint32_t size) {
+    tftp_fs_t* f = (tftp_fs_t*)ctx;
+    if (f->open) return true;                    // server opened it before answering the WRQ
+    f->open = neelefs_writer_open(&f->w, f->path, size) ? 1 : 0;
+    return f->open != 0;
+}
+static bool fs_write(void* ctx, const uint8_t* data, uint32_t len) {
+    tftp_fs_t* f = (tftp_fs_t*)ctx;
+    return f->open && neelefs_writer_write(&f->w, data, len);
+}
+static uint32_t fs_read(void* ctx, uint32_t offset, uint8_t* buf, uint32_t len) {
+    return neelefs_reader_read(&((tftp_fs_t*)ctx)->r, offset, buf, len);
+}
+static void fs_end(void* ctx, bool ok) {
+    tftp_fs_t* f = (tftp_fs_t*)ctx;
+    if (!f->open) return;
+    f->open = 0;
+    if (ok) { if (!neelefs_writer_close(&f->w)) console_writeln("tftp: directory update failed"); }
+    else neelefs_writer_abort(&f->w);
+}
+
+static const net_tftp_io_t s_fs_sink   = { fs_begin, fs_write, NULL, fs_end };
+static const net_tftp_io_t s_fs_source = { NULL, NULL, fs_read, NULL };
+// Server side: the file is closed by net_tftp_server_poll(), not from the RX path
+static const net_tftp_io_t s_srv_sink  = { fs_begin, fs_write, NULL, NULL };
+
+int net_tftp_get_file(uint32_t server_be, const char* remote, const char* local_path, net_tftp_result_t* res, bool (*abort)(void)) {
+    static tftp_fs_t f;
+    f.path = local_path; f.open = 0;
+    return net_tftp_get(server_be, remote, &s_fs_sink, &f, res, abort);
+}
+
+int net_tftp_put_file(uint32_t server_be, const char* local_path, const char* remote, net_tftp_result_t* res, bool (*abort)(void)) {
+    static tftp_fs_t f;
+    f.path = local_path; f.open = 0;
+    if (!neelefs_reader_open(&f.r, local_path)) return NET_TFTP_EIO;
+    return net_tftp_put(server_be, remote, f.r.size, &s_fs_source, &f, res, abort);
+}
+
+void net_tftp_print_result(const net_tftp_result_t* res) {
+    uint32_t hz = tftp_hz();
+    uint32_t ticks = res->ticks ? res->ticks : 1u;
+    uint32_t ms = (uint32_t)(((uint64_t)ticks * 1000u) / hz);
+    uint32_t kibs = (uint32_t)(((uint64_t)res->bytes * hz) / ((uint64_t)ticks * 1024u));
+    console_write_dec(res->bytes); console_write(" bytes in ");
+    console_write_dec(ms / 1000u); console_write(".");
+    uint32_t frac = (ms % 1000u) / 10u; if (frac < 10) console_write("0"); console_write_dec(frac);
+    console_write(" s, "); console_write_dec(kibs); console_write(" KiB/s (blksize=");
+    console_write_dec(res->blksize); console_write(" window="); console_write_dec(res->window);
+    console_write(" retrans="); console_write_dec(res->retransmits); console_write(")\n");
+}
+
+// ---- server ----
+
+static int              s_srv_sock = -1;
+static char             s_srv_root[64] = "/";
+static tftp_sess_t      s_srv;
+static tftp_fs_t        s_srv_fs;
+static char             s_srv_path[160];
+static net_tftp_result_t s_srv_res;
+static uint32_t         s_srv_count;
+
+static int tftp_srv_busy(void) {
+    return s_srv.state == TS_REQ || s_srv.state == TS_OACK || s_srv.state == TS_XFER || s_srv.state == TS_DALLY;
+}
+
+// Main context only: finishes the NeeleFS file and prints the summary
+static void tftp_srv_release(void) {
+    if (s_srv_fs.open) { s_srv_fs.open = 0; neelefs_writer_abort(&s_srv_fs.w); }
+    if (s_srv.state != TS_IDLE && s_srv.sock >= 0) net_udp_close(s_srv.sock);
+    if (s_srv.state == TS_DONE) {
+        s_srv_count++;
+        console_write("tftp: "); console_write(s_srv.sending ? "sent " : "received ");
+        console_write(s_srv_path); console_write(", ");
+        net_tftp_print_result(&s_srv_res);
+    } else if (s_srv.state == TS_FAILED) {
+        console_write("tftp: transfer of "); console_write(s_srv_path); console_write(" failed\n");
+    }
+    s_srv.state = TS_IDLE; s_srv.sock = -1;
+}
+
+static void tftp_srv_request(int sock, uint32_t src_ip, uint16_t src_port, const uint8_t* pkt, uint16_t len, void* ctx) {
+    (void)ctx;
+    if (len < 4) return;
+    uint16_t op = (uint16_t)(((uint16_t)pkt[0] << 8) | pkt[1]);
+    if (op != TFTP_RRQ && op != TFTP_WRQ) { tftp_error_to(sock, src_ip, src_port, 4, "Illegal TFTP operation"); return; }
+    const uint8_t* end = pkt + len;
+    const char* file = (const char*)(pkt + 2);
+    const uint8_t* p = pkt + 2; while (p < end && *p) p++;
+    if (p >= end) return;
+    const char* mode = (const char*)++p; while (p < end && *p) p++;
+    if (p >= end) return;
+    p++;
+    if (tftp_stricmp(mode, "octet")) { tftp_error_to(sock, src_ip, src_port, 0, "Only octet mode supported"); return; }
+    // A finished transfer counts as busy until the shell loop has reported it
+    if (s_srv.state != TS_IDLE) { tftp_error_to(sock, src_ip, src_port, 0, "Server busy"); return; }
+
+    // Map the request into the NeeleFS root
+    uint32_t n = 0;
+    for (const char* r = s_srv_root; *r && n < sizeof(s_srv_path) - 1; r++) s_srv_path[n++] = *r;
+    if (n == 0 || s_srv_path[n - 1] != '/') s_srv_path[n++] = '/';
+    while (*file == '/') file++;
+    for (; *file && n < sizeof(s_srv_path) - 1; file++) s_srv_path[n++] = *file;
+    s_srv_path[n] = 0;
+
+    tftp_opts_t o; tftp_parse_opts(p, end, &o);
+    s_srv_fs.path = s_srv_path; s_srv_fs.open = 0;
+    uint32_t tsize = 0;
+    if (op == TFTP_RRQ) {
+        if (!neelefs_reader_open(&s_srv_fs.r, s_srv_path)) { tftp_error_to(sock, src_ip, src_port, 1, "File not found"); return; }
+        tsize = s_srv_fs.r.size;
+    } else {
+        if (!neelefs_writer_open(&s_srv_fs.w, s_srv_path, o.has_tsize ? o.tsize : 0)) { tftp_error_to(sock, src_ip, src_port, 2, "Cannot create file"); return; }
+        s_srv_fs.open = 1;
+    }
+    int ts = net_udp_open(0);
+    if (ts < 0) {
+        if (s_srv_fs.open) { neelefs_writer_abort(&s_srv_fs.w); s_srv_fs.open = 0; }
+        tftp_error_to(sock, src_ip, src_port, 0, "No socket");
+        return;
+    }
+    tftp_sess_init(&s_srv, ts, src_ip, src_port, op == TFTP_RRQ, op == TFTP_RRQ ? &s_fs_source : &s_srv_sink, &s_srv_fs, &s_srv_res);
+    s_srv.server = 1;
+    (void)net_udp_set_handler(ts, tftp_udp_handler, &s_srv);
+
+    if (o.has_blksize || o.has_window || o.has_tsize) {
+        tftp_apply_opts(&s_srv, &o);
+        uint8_t* b = s_srv.ctl; uint16_t m = 2; uint16_t cap = sizeof(s_srv.ctl);
+        b[0] = 0; b[1] = TFTP_OACK;
+        if (o.has_blksize) { m = tftp_put_str(b, m, cap, "blksize"); m = tftp_put_uint(b, m, cap, s_srv.blksize); }
+        if (o.has_window)  { m = tftp_put_str(b, m, cap, "windowsize"); m = tftp_put_uint(b, m, cap, s_srv.window); }
+        if (o.has_tsize)   { m = tftp_put_str(b, m, cap, "tsize"); m = tftp_put_uint(b, m, cap, op == TFTP_RRQ ? tsize : o.tsize); }
+        s_srv.ctl_len = m;
+        // RRQ: wait for ACK 0; WRQ: the OACK stands in for ACK 0
+        s_srv.state = (op == TFTP_RRQ) ? TS_OACK : TS_XFER;
+        tftp_send_ctl(&s_srv);
+    } else if (op == TFTP_RRQ) {
+        s_srv.state = TS_XFER;
+        tftp_send_window(&s_srv);
+    } else {
+        s_srv.state = TS_XFER;
+        tftp_ack(&s_srv, 0);
+    }
+}
+
+bool net_tftp_server_start(const char* root) {
+    if (root && *root) {
+        uint32_t i = 0;
+        for (; root[i] && i < sizeof(s_srv_root) - 1; i++) s_srv_root[i] = root[i];
+        s_srv_root[i] = 0;
+    }
+    if (s_srv_sock >= 0) return true;
+    s_srv.state = TS_IDLE; s_srv.sock = -1;
+    int sock = net_udp_open(TFTP_PORT);
+    if (sock < 0) return false;
+    (void)net_udp_set_handler(sock, tftp_srv_request, NULL);
+    s_srv_sock = sock;
+    return true;
+}
+
+void net_tftp_server_stop(void) {
+    netface_bh_disable();
+    if (s_srv.state != TS_IDLE) {
+        if (s_srv.state == TS_DALLY) s_srv.state = TS_DONE;   // file complete: keep it
+        else if (tftp_srv_busy()) tftp_fail(&s_srv, NET_TFTP_EIO, 0, "Server stopped");
+        net_tftp_server_poll();
+    }
+    if (s_srv_sock >= 0) { net_udp_close(s_srv_sock); s_srv_sock = -1; }
+    netface_bh_enable();
+}
+
+void net_tftp_server_status(void) {
+    console_write("tftp server: ");
+    console_write(s_srv_sock >= 0 ? "listening on 69" : "stopped");
+    console_write(" root="); console_write(s_srv_root);
+    console_write(" transfers="); console_write_dec(s_srv_count);
+    if (tftp_srv_busy()) {
+        console_write(" active="); console_write(s_srv_path);
+        console_write(" bytes="); console_write_dec(s_srv_res.bytes);
+    }
+    console_write("\n");
+}
+
+void net_tftp_tick(void) {
+    if (!tftp_srv_busy()) return;
+    if (platform_ticks_get() - s_srv.t_last >= tftp_hz()) tftp_on_timeout(&s_srv);
+}
+
+void net_tftp_server_poll(void) {
+    uint8_t st = s_srv.state;
+    // Close a received file as soon as the last block is in (the session may still dally)
+    if (s_srv_fs.open && (st == TS_DALLY || st == TS_DONE)) {
+        s_srv_fs.open = 0;
+        if (!neelefs_writer_close(&s_srv_fs.w)) {
+            console_writeln("tftp: directory update failed");
+            if (st == TS_DONE) s_srv.state = TS_FAILED;
+        }
+    }
+    if (st == TS_DONE || st == TS_FAILED) tftp_srv_release();
+}
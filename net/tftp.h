@@ -0,0 +1,63 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+// TFTP (RFC 1350, octet mode) over net/udp with option negotiation:
+// blksize (RFC 2348), tsize (RFC 2349) and windowsize (RFC 7440).
+//
+// The client calls block the caller (they poll the stack via netface_poll()
+// and sleep in cpuidle_idle() while nothing arrives) and are meant for the
+// shell or other main-context users. abort() is polled in the wait loop and
+// may be NULL; a cancelled transfer sends an ERROR to the peer. The server answers
+// from the RX path: requests on port 69 are served from / stored into NeeleFS
+// under a root directory, one transfer at a time. Finished transfers are
+// closed and reported by net_tftp_server_poll() from the shell loop.
+
+// Return codes (negative)
+#define NET_TFTP_ETIMEOUT  (-1)   // peer stopped answering
+#define NET_TFTP_EPEER     (-2)   // peer sent an ERROR packet
+#define NET_TFTP_EIO       (-3)   // local source/sink failed
+#define NET_TFTP_ENOSOCK   (-4)   // no UDP socket available
+#define NET_TFTP_EPROTO    (-5)   // malformed or unexpected packet
+#define NET_TFTP_EABORT    (-6)   // cancelled through abort()
+
+// Data source/sink for a transfer. Receive side uses begin/write, send side
+// uses read (random access: blocks are re-read on retransmission).
+typedef struct {
+    bool     (*begin)(void* ctx, uint32_t size);   // size from tsize, 0 = unknown
+    bool     (*write)(void* ctx, const uint8_t* data, uint32_t len);
+    uint32_t (*read)(void* ctx, uint32_t offset, uint8_t* buf, uint32_t len);
+    void     (*end)(void* ctx, bool ok);
+} net_tftp_io_t;
+
+typedef struct {
+    uint32_t bytes;
+    uint32_t blocks;
+    uint32_t retransmits;
+    uint32_t ticks;          // transfer duration in timer ticks
+    uint16_t blksize;        // negotiated values
+    uint16_t window;
+    char     peer_error[64]; // text of a received ERROR packet
+} net_tftp_result_t;
+
+// Client. 'size' for put is the number of bytes 'io->read' will provide.
+int net_tftp_get(uint32_t server_be, const char* remote, const net_tftp_io_t* io, void* ctx, net_tftp_result_t* res, bool (*abort)(void));
+int net_tftp_put(uint32_t server_be, const char* remote, uint32_t size, const net_tftp_io_t* io, void* ctx, net_tftp_result_t* res, bool (*abort)(void));
+
+// Client helpers streaming to/from NeeleFS paths
+int net_tftp_get_file(uint32_t server_be, const char* remote, const char* local_path, net_tftp_result_t* res, bool (*abort)(void));
+int net_tftp_put_file(uint32_t server_be, const char* local_path, const char* remote, net_tftp_result_t* res, bool (*abort)(void));
+
+// Print "N bytes in S.ss s, K KiB/s (blksize window retrans)"
+void net_tftp_print_result(const net_tftp_result_t* res);
+
+// Server (NeeleFS root directory, e.g. "/" or "/tftp")
+bool net_tftp_server_start(const char* root);
+void net_tftp_server_stop(void);
+void net_tftp_server_status(void);
+
+// Timeouts/retransmission for the server session; called from net_ipv4_poll()
+void net_tftp_tick(void);
+// Close the NeeleFS file of a finished server transfer and print its result.
+// Main context (shell idle loop); the next request waits until it has run.
+void net_tftp_server_poll(void);
@@ -0,0 +1,241 @@
+#include "udp.h"
+#include "ipv4.h"
+#include "csum.h"
+#include "../config.h"
+#include "../netface.h"
+#include "../console.h"
+#include "../memory.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#define UDP_NSOCK   CONFIG_NET_UDP_SOCKETS
+#define UDP_RING    CONFIG_NET_UDP_RX_RING
+#define UDP_HASH    16u
+#define UDP_EPH_LO  49152u
+
+typedef char udp_ring_align_check[(UDP_RING % 4 == 0 && UDP_RING >= 2048) ? 1 : -1];
+
+typedef struct {
+    uint8_t  used;
+    uint16_t port;
+    int8_t   next;             // hash chain
+    uint8_t* ring;             // CONFIG_NET_UDP_RX_RING bytes, kept across close/open
+    uint32_t head, tail;       // free-running byte offsets (head - tail = bytes queued)
+    uint32_t count;            // datagrams queued
+    net_udp_handler_t handler;
+    void*    ctx;
+} udp_sock_t;
+
+// Ring record header; payload follows, padded to 4 bytes
+typedef struct {
+    uint16_t len;
+    uint16_t port;
+    uint32_t ip;
+} udp_rec_t;
+
+static udp_sock_t s_sock[UDP_NSOCK];
+static int8_t     s_bucket[UDP_HASH];
+static uint16_t   s_next_eph = UDP_EPH_LO;
+static net_udp_stats_t s_stats;
+
+static inline uint32_t udp_hash(uint16_t port) { return (uint32_t)(port ^ (port >> 4) ^ (port >> 8)) & (UDP_HASH - 1u); }
+
+static udp_sock_t* udp_get(int sock) {
+    if (sock < 0 || sock >= UDP_NSOCK || !s_sock[sock].used) return NULL;
+    return &s_sock[sock];
+}
+
+static int udp_lookup(uint16_t port) {
+    for (int i = s_bucket[udp_hash(port)]; i >= 0; i = s_sock[i].next)
+        if (s_sock[i].port == port) return i;
+    return -1;
+}
+
+static void ring_put(udp_sock_t* s, const void* src, uint32_t len) {
+    uint32_t off = s->head % UDP_RING;
+    uint32_t first = UDP_RING - off; if (first > len) first = len;
+    const uint8_t* p = (const uint8_t*)src;
+    for (uint32_t i = 0; i < first; i++) s->ring[off + i] = p[i];
+    for (uint32_t i = first; i < len; i++) s->ring[i - first] = p[i];
+    s->head += len;
+}
+
+static void ring_get(udp_sock_t* s, uint32_t at, void* dst, uint32_t len) {
+    uint32_t off = at % UDP_RING;
+    uint32_t first = UDP_RING - off; if (first > len) first = len;
+    uint8_t* p = (uint8_t*)dst;
+    for (uint32_t i = 0; i < first; i++) p[i] = s->ring[off + i];
+    for (uint32_t i = first; i < len; i++) p[i] = s->ring[i - first];
+}
+
+void net_udp_init(void) {
+    for (int i = 0; i < UDP_NSOCK; i++) { s_sock[i].used = 0; s_sock[i].next = -1; }
+    for (uint32_t i = 0; i < UDP_HASH; i++) s_bucket[i] = -1;
+}
+
+int net_udp_open(uint16_t local_port) {
+    netface_bh_disable();
+    int rc = NET_UDP_ENOMEM;
+    if (local_port == 0) {
+        // Ephemeral range 49152..65535, skipping bound ports
+        for (uint32_t n = 0; n < 16384u; n++) {
+            uint16_t p = s_next_eph;
+            s_next_eph = (uint16_t)(s_next_eph == 0xFFFFu ? UDP_EPH_LO : s_next_eph + 1u);
+            if (udp_lookup(p) < 0) { local_port = p; break; }
+        }
+    } else if (udp_lookup(local_port) >= 0) {
+        rc = NET_UDP_EINUSE;
+        local_port = 0;
+    }
+    if (local_port) {
+        for (int i = 0; i < UDP_NSOCK; i++) {
+            udp_sock_t* s = &s_sock[i];
+            if (s->used) continue;
+            if (!s->ring) s->ring = (uint8_t*)memory_alloc(UDP_RING);
+            if (!s->ring) break;
+            s->used = 1; s->port = local_port;
+            s->head = s->tail = 0; s->count = 0;
+            s->handler = NULL; s->ctx = NULL;
+            uint32_t b = udp_hash(local_port);
+            s->next = s_bucket[b]; s_bucket[b] = (int8_t)i;
+            rc = i;
+            break;
+        }
+    }
+    netface_bh_enable();
+    return rc;
+}
+
+void net_udp_close(int sock) {
+    netface_bh_disable();
+    udp_sock_t* s = udp_get(sock);
+    if (s) {
+        int8_t* pp = &s_bucket[udp_hash(s->port)];
+        while (*pp >= 0 && *pp != sock) pp = &s_sock[*pp].next;
+        if (*pp == sock) *pp = s->next;
+        s->used = 0; s->next = -1; s->handler = NULL;
+    }
+    netface_bh_enable();
+}
+
+uint16_t net_udp_local_port(int sock) {
+    udp_sock_t* s = udp_get(sock);
+    return s ? s->port : 0;
+}
+
+int net_udp_set_handler(int sock, net_udp_handler_t fn, void* ctx) {
+    udp_sock_t* s = udp_get(sock);
+    if (!s) return NET_UDP_EBADF;
+    netface_bh_disable();
+    s->handler = fn; s->ctx = ctx;
+    netface_bh_enable();
+    return 0;
+}
+
+int net_udp_sendto(int sock, uint32_t dst_ip_be, uint16_t dst_port, const void* data, uint16_t len) {
+    udp_sock_t* s = udp_get(sock);
+    if (!s) return NET_UDP_EBADF;
+    if (len > NET_UDP_MAX_PAYLOAD || dst_ip_be == 0 || dst_port == 0 || (len && !data)) return NET_UDP_EINVAL;
+    uint8_t seg[8 + NET_UDP_MAX_PAYLOAD];
+    uint16_t ulen = (uint16_t)(8 + len);
+    seg[0] = (uint8_t)(s->port >> 8); seg[1] = (uint8_t)s->port;
+    seg[2] = (uint8_t)(dst_port >> 8); seg[3] = (uint8_t)dst_port;
+    seg[4] = (uint8_t)(ulen >> 8);     seg[5] = (uint8_t)ulen;
+    seg[6] = 0; seg[7] = 0;
+    uint32_t src_ip = net_ipv4_source_for(dst_ip_be);
+    uint32_t sum = net_csum_pseudo_ipv4(src_ip, dst_ip_be, 17, ulen);
+    sum = net_csum_partial(seg, 8, sum);
+    if (len) sum = net_csum_copy(seg + 8, data, len, sum);
+    uint16_t c = net_csum_fold(sum);
+    if (c == 0) c = 0xFFFF; // 0 means "no checksum" in UDP
+    seg[6] = (uint8_t)(c >> 8); seg[7] = (uint8_t)c;
+    netface_bh_disable();
+    bool ok = net_ipv4_send(dst_ip_be, 17, seg, ulen);
+    if (ok) { s_stats.tx++; s_stats.tx_bytes += len; }
+    netface_bh_enable();
+    return ok ? (int)len : NET_UDP_EAGAIN;
+}
+
+int net_udp_recvfrom(int sock, void* buf, uint16_t cap, uint32_t* src_ip_be, uint16_t* src_port) {
+    udp_sock_t* s = udp_get(sock);
+    if (!s) return NET_UDP_EBADF;
+    int rc = NET_UDP_EAGAIN;
+    netface_bh_disable();
+    if (s->count) {
+        udp_rec_t rec;
+        ring_get(s, s->tail, &rec, sizeof(rec));
+        uint16_t n = rec.len < cap ? rec.len : cap;
+        if (n && buf) ring_get(s, s->tail + sizeof(rec), buf, n);
+        s->tail += sizeof(rec) + (((uint32_t)rec.len + 3u) & ~3u);
+        s->count--;
+        if (src_ip_be) *src_ip_be = rec.ip;
+        if (src_port) *src_port = rec.port;
+        rc = n;
+    }
+    netface_bh_enable();
+    return rc;
+}
+
+int net_udp_pending(int sock) {
+    udp_sock_t* s = udp_get(sock);
+    return s ? (int)s->count : NET_UDP_EBADF;
+}
+
+void net_udp_on_ipv4(const uint8_t* ip, uint16_t ip_len) {
+    uint8_t ihl = (uint8_t)((ip[0] & 0x0F) * 4);
+    if (ip_len < ihl + 8) { s_stats.rx_short++; return; }
+    const uint8_t* udp = ip + ihl;
+    uint16_t ulen = (uint16_t)(((uint16_t)udp[4] << 8) | udp[5]);
+    if (ulen < 8 || ulen > ip_len - ihl) { s_stats.rx_short++; return; }
+    uint32_t src = ((uint32_t)ip[12] << 24) | ((uint32_t)ip[13] << 16) | ((uint32_t)ip[14] << 8) | ip[15];
+    uint32_t dst = ((uint32_t)ip[16] << 24) | ((uint32_t)ip[17] << 16) | ((uint32_t)ip[18] << 8) | ip[19];
+    if (udp[6] | udp[7]) {
+        uint32_t sum = net_csum_partial(udp, ulen, net_csum_pseudo_ipv4(src, dst, 17, ulen));
+        if (net_csum_fold(sum) != 0) { s_stats.rx_csum++; return; }
+    }
+    uint16_t sport = (uint16_t)(((uint16_t)udp[0] << 8) | udp[1]);
+    uint16_t dport = (uint16_t)(((uint16_t)udp[2] << 8) | udp[3]);
+    int idx = udp_lookup(dport);
+    if (idx < 0) { s_stats.rx_noport++; return; }
+    udp_sock_t* s = &s_sock[idx];
+    uint16_t dlen = (uint16_t)(ulen - 8);
+    if (s->handler) {
+        s_stats.rx++; s_stats.rx_bytes += dlen;
+        s->handler(idx, src, sport, udp + 8, dlen, s->ctx);
+        return;
+    }
+    uint32_t need = sizeof(udp_rec_t) + (((uint32_t)dlen + 3u) & ~3u);
+    if (UDP_RING - (s->head - s->tail) < need) { s_stats.rx_full++; return; }
+    udp_rec_t rec = { dlen, sport, src };
+    ring_put(s, &rec, sizeof(rec));
+    ring_put(s, udp + 8, dlen);
+    s->head = s->head - dlen + (((uint32_t)dlen + 3u) & ~3u);
+    s->count++;
+    s_stats.rx++; s_stats.rx_bytes += dlen;
+}
+
+void net_udp_stats_get(net_udp_stats_t* out) { if (out) *out = s_stats; }
+
+void net_udp_print(void) {
+    for (int i = 0; i < UDP_NSOCK; i++) {
+        const udp_sock_t* s = &s_sock[i];
+        if (!s->used) continue;
+        console_write("udp["); console_write_dec((uint32_t)i); console_write("] port=");
+        console_write_dec(s->port);
+        if (s->handler) console_write(" handler");
+        else {
+            console_write(" queued="); console_write_dec(s->count);
+            console_write(" bytes="); console_write_dec(s->head - s->tail);
+        }
+        console_write("\n");
+    }
+    console_write("udp: rx="); console_write_dec(s_stats.rx);
+    console_write(" tx="); console_write_dec(s_stats.tx);
+    console_write(" rx_bytes="); console_write_dec(s_stats.rx_bytes);
+    console_write(" tx_bytes="); console_write_dec(s_stats.tx_bytes);
+    console_write("\n     noport="); console_write_dec(s_stats.rx_noport);
+    console_write(" csum="); console_write_dec(s_stats.rx_csum);
+    console_write(" short="); console_write_dec(s_stats.rx_short);
+    console_write(" full="); console_write_dec(s_stats.rx_full);
+    console_write("\n");
+}
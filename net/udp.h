@@ -0,0 +1,59 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "ipv4.h"
+
+// UDP datagram sockets (RFC 768).
+//
+// Sockets are small integer handles. Received datagrams are demultiplexed by
+// local port through a hash table and stored in a per-socket RX ring of
+// CONFIG_NET_UDP_RX_RING bytes; send and receive never block. Kernel users may
+// install a handler instead, which is called from the RX path with the
+// datagram in place (no ring copy). Addresses are big-endian 32-bit values,
+// ports host order.
+
+#define NET_UDP_FRAME_PAYLOAD 1472                      // one Ethernet frame without fragmentation
+#define NET_UDP_MAX_PAYLOAD   (NET_IPV4_MAX_PAYLOAD - 8)  // larger datagrams are fragmented
+
+// Return codes (negative)
+#define NET_UDP_EAGAIN  (-1)       // nothing received / would block
+#define NET_UDP_EBADF   (-2)       // invalid socket handle
+#define NET_UDP_EINVAL  (-3)       // bad argument (size, address)
+#define NET_UDP_EINUSE  (-4)       // local port already bound
+#define NET_UDP_ENOMEM  (-5)       // no free socket or ring
+
+typedef void (*net_udp_handler_t)(int sock, uint32_t src_ip_be, uint16_t src_port,
+                                  const uint8_t* data, uint16_t len, void* ctx);
+
+typedef struct {
+    uint32_t rx, tx;               // datagrams delivered / sent
+    uint32_t rx_bytes, tx_bytes;
+    uint32_t rx_noport;            // no socket bound to the destination port
+    uint32_t rx_csum, rx_short;    // bad checksum / malformed header
+    uint32_t rx_full;              // dropped because the socket ring was full
+} net_udp_stats_t;
+
+void net_udp_init(void);
+
+// Bind a socket to 'local_port' (0 = pick an ephemeral port). Returns handle or error.
+int  net_udp_open(uint16_t local_port);
+void net_udp_close(int sock);
+uint16_t net_udp_local_port(int sock);
+
+// Deliver datagrams to 'fn' instead of the RX ring (NULL restores ring mode)
+int  net_udp_set_handler(int sock, net_udp_handler_t fn, void* ctx);
+
+// Returns bytes sent or error
+int  net_udp_sendto(int sock, uint32_t dst_ip_be, uint16_t dst_port, const void* data, uint16_t len);
+
+// Returns datagram length (truncated to 'cap'), NET_UDP_EAGAIN if the ring is empty
+int  net_udp_recvfrom(int sock, void* buf, uint16_t cap, uint32_t* src_ip_be, uint16_t* src_port);
+
+// Datagrams waiting in the RX ring
+int  net_udp_pending(int sock);
+
+// RX entry point from ipv4.c (ip points at the IPv4 header, ip_len = total length)
+void net_udp_on_ipv4(const uint8_t* ip, uint16_t ip_len);
+
+void net_udp_stats_get(net_udp_stats_t* out);
+void net_udp_print(void);
@@ -1,150 +1,341 @@
 #include "netface.h"
 #include "drivers/ne2000.h"
+#include "drivers/rtl8139.h"
 #include "console.h"
+#include "interrupts.h"
+#include "net/ipv4.h"
+#include "net/netstat.h"
+#include "net/pcap.h"
 #include <stdint.h>
+#include <stddef.h>
 
-// Minimal top-level NIC selector: NE2000 only for now
-typedef enum { NETDRV_NONE = 0, NETDRV_NE2000 } netdrv_t;
-static netdrv_t s_active = NETDRV_NONE;
-static bool s_ne2k_present = false;
-static bool s_ne2k_init_ok = false;
+// Known drivers in probe order: PCI bus-master NICs before ISA PIO ones.
+// A new driver only needs its ops table listed here.
+static const netface_ops_t* const s_drivers[] = {
+#if CONFIG_RTL8139
+    &rtl8139_netface_ops,
+#endif
+    &ne2000_netface_ops,
+};
+#define NETFACE_NDRV ((int)(sizeof(s_drivers) / sizeof(s_drivers[0])))
 
-/* console used for diagnostics */
+// Probe result per driver (for netinfo): 0 absent, 1 present/init failed, 2 registered
+static uint8_t s_probe[NETFACE_NDRV];
+
+// RX scheduling (NAPI-style): an RX interrupt masks NIC RX IRQs and schedules
+// polling; each poll drains at most one driver budget of frames. While the
+// budget keeps running out we stay in poll mode; once the ring is empty RX
+// IRQs are re-enabled. Polling only happens in netface_poll() (main context):
+// the protocol handlers print, write NeeleFS and transmit, none of which may
+// interrupt a half-finished console or driver update. The interrupt only
+// wakes the idle loop, which polls right after HLT returns; a command that
+// never polls holds off all receive processing until it returns.
+// Each interface keeps its own scheduler state.
+typedef struct {
+    const netface_ops_t* ops;
+    char name[6];
+    volatile bool rx_sched;
+    uint32_t napi_irqs, napi_polls, napi_full;
+} netface_if_t;
+
+static netface_if_t s_if[NETFACE_MAX];
+static int s_nif = 0;
+
+// Interface whose receive path is running (attributes netface_on_rx frames)
+static int s_rx_if = 0;
+
+// s_bh_depth > 0 means main context is using the NICs; the interrupt tail
+// then leaves the TX rings alone until the next call.
+static volatile uint32_t s_bh_depth = 0;
+
+static netface_if_t* if_get(int ifx) {
+    return (ifx >= 0 && ifx < s_nif) ? &s_if[ifx] : NULL;
+}
+
+int netface_register(const netface_ops_t* ops) {
+    if (!ops || s_nif >= NETFACE_MAX) return -1;
+    netface_if_t* nf = &s_if[s_nif];
+    nf->ops = ops;
+    nf->name[0]='e'; nf->name[1]='t'; nf->name[2]='h';
+    nf->name[3]=(char)('0' + s_nif); nf->name[4]=0;
+    nf->rx_sched = false;
+    nf->napi_irqs = nf->napi_polls = nf->napi_full = 0;
+    return s_nif++;
+}
 
 bool netface_init(void) {
-    // Probe NE2000 presence for diagnostics
-    s_ne2k_present = ne2000_present();
-
-    // Try NE2000 first (ISA)
-    if (s_ne2k_present) {
-        if (ne2000_init()) {
-            s_active = NETDRV_NE2000;
-            s_ne2k_init_ok = true;
-            return true;
+    for (int d = 0; d < NETFACE_NDRV; d++) {
+        const netface_ops_t* ops = s_drivers[d];
+        s_probe[d] = 0;
+        if (!ops->present()) continue;
+        s_probe[d] = 1;
+        if (s_nif >= NETFACE_MAX) continue;
+        if (!ops->init()) continue;
+        if (netface_register(ops) >= 0) s_probe[d] = 2;
+    }
+    return s_nif > 0;
+}
+
+int netface_count(void) { return s_nif; }
+
+const char* netface_name(int ifx) {
+    netface_if_t* nf = if_get(ifx);
+    return nf ? nf->name : "none";
+}
+
+int netface_find(const char* name) {
+    if (!name) return -1;
+    for (int i = 0; i < s_nif; i++) {
+        const char* a = s_if[i].name; const char* b = name;
+        while (*a && *a == *b) { a++; b++; }
+        if (*a == 0 && *b == 0) return i;
+    }
+    return -1;
+}
+
+const netface_ops_t* netface_ops(int ifx) {
+    netface_if_t* nf = if_get(ifx);
+    return nf ? nf->ops : NULL;
+}
+
+bool netface_if_get_mac(int ifx, uint8_t mac[6]) {
+    netface_if_t* nf = if_get(ifx);
+    return nf ? nf->ops->get_mac(mac) : false;
+}
+
+bool netface_if_send(int ifx, const uint8_t* frame, uint16_t len) {
+    netface_if_t* nf = if_get(ifx);
+    if (!nf) return false;
+    // Keep the interrupt tail off the NICs while the frame is copied out
+    s_bh_depth++;
+    bool ok = nf->ops->send(frame, len);
+    if (ok && g_net_pcap_on) net_pcap_hook(ifx, frame, len);
+    s_bh_depth--;
+    net_stats_nic_t* c = &g_net_stats.nic[ifx];
+    if (ok) { c->tx_frames++; c->tx_bytes += len; }
+    else c->tx_drops++;
+    return ok;
+}
+
+bool netface_if_stats(int ifx, netface_stats_t* out) {
+    netface_if_t* nf = if_get(ifx);
+    if (!nf || !out) return false;
+    nf->ops->stats(out);
+    return true;
+}
+
+uint8_t netface_if_irq_line(int ifx) {
+    netface_if_t* nf = if_get(ifx);
+    return nf ? nf->ops->irq_line() : 0;
+}
+
+// One scheduler pass over every interface: retire TX, pick up latched RX
+// events, poll one budget
+static void netface_work(void) {
+    if (s_nif == 0) return;
+    for (int i = 0; i < s_nif; i++) {
+        netface_if_t* nf = &s_if[i];
+        const netface_ops_t* ops = nf->ops;
+        ops->tx_reap();
+        if (ops->rx_irq_take() && !nf->rx_sched) {
+            ops->rx_irq_enable(false);
+            nf->rx_sched = true;
+        }
+        if (nf->rx_sched) {
+            s_rx_if = i;
+            int n = ops->rx_batch(ops->rx_budget, CONFIG_NET_RX_DEBUG);
+            nf->napi_polls++;
+            if (n < ops->rx_budget) {
+                // Ring empty: back to interrupt mode
+                nf->rx_sched = false;
+                ops->rx_irq_enable(true);
+            } else {
+                nf->napi_full++;
+            }
         }
-        s_ne2k_init_ok = false;
     }
-    s_active = NETDRV_NONE;
-    return false;
+    net_ipv4_poll();
 }
 
 void netface_poll(void) {
-    switch (s_active) {
-        case NETDRV_NE2000: ne2000_service(); break;
-        default: break;
-    }
+    // Explicit safe point: run even if the caller holds a bh-disabled section;
+    // the depth keeps the interrupt tail from touching the NICs meanwhile
+    s_bh_depth++;
+    netface_work();
+    s_bh_depth--;
 }
 
 void netface_poll_rx(void) {
-    switch (s_active) {
-        case NETDRV_NE2000: ne2000_poll_rx(); break;
-        default: break;
+    s_bh_depth++;
+    for (int i = 0; i < s_nif; i++) {
+        s_rx_if = i;
+        s_if[i].ops->poll_rx();
     }
+    s_bh_depth--;
 }
 
-bool netface_send_test(void) {
-    switch (s_active) {
-        case NETDRV_NE2000: return ne2000_send_test();
-        default: return false;
-    }
+void netface_softirq(void) {
+    if (s_nif == 0 || s_bh_depth) return;
+    // Only retire finished transmissions (starts the next queued NE2000 slot);
+    // received frames stay latched in the NIC ring for netface_poll()
+    for (int i = 0; i < s_nif; i++) s_if[i].ops->tx_reap();
 }
 
-void netface_irq(void) {
-    switch (s_active) {
-        case NETDRV_NE2000:
-            // Let the NE2000 driver acknowledge/latch its ISR bits
-            ne2000_irq();
-            break;
-        default: break;
+void netface_bh_disable(void) { s_bh_depth++; }
+
+void netface_bh_enable(void) {
+    if (s_bh_depth) s_bh_depth--;
+}
+
+void netface_shutdown(void) {
+    s_bh_depth++;
+    for (int i = 0; i < s_nif; i++) {
+        if (s_if[i].ops->shutdown) s_if[i].ops->shutdown();
     }
 }
 
-static const char* drv_name(netdrv_t d) {
-    switch (d) {
-        case NETDRV_NE2000: return "NE2000";
-        default: return "none";
+bool netface_send_test(void) {
+    netface_if_t* nf = if_get(0);
+    return nf ? nf->ops->send_test() : false;
+}
+
+void netface_irq(uint8_t irq) {
+    for (int i = 0; i < s_nif; i++) {
+        netface_if_t* nf = &s_if[i];
+        const netface_ops_t* ops = nf->ops;
+        if (ops->irq_line() != irq) continue;
+        // Let the driver acknowledge/latch its ISR bits
+        ops->irq();
+        // RX event: mask further RX IRQs and schedule polling
+        if (!nf->rx_sched && ops->rx_irq_take()) {
+            ops->rx_irq_enable(false);
+            nf->rx_sched = true;
+            nf->napi_irqs++;
+        }
     }
 }
 
-const char* netface_active_name(void) { return drv_name(s_active); }
+const char* netface_active_name(void) {
+    netface_if_t* nf = if_get(0);
+    return nf ? nf->ops->name : "none";
+}
 
 static void phex8(unsigned char v) {
     const char* hexd = "0123456789ABCDEF";
     char s[3]; s[0]=hexd[(v>>4)&0xF]; s[1]=hexd[v&0xF]; s[2]=0; console_write(s);
 }
 
-void netface_diag_print(void) {
-    // Active driver summary
-    console_write("netface: active=");
-    console_write(drv_name(s_active));
-    console_write("\n");
+static void print_mac(const unsigned char mac[6]) {
+    for (int i=0;i<6;i++){ if(i) console_write(":"); phex8(mac[i]); }
+}
+
+static void print_caps(uint32_t caps) {
+    if (!caps) { console_write("none"); return; }
+    const char* sep = "";
+    if (caps & NETFACE_CAP_BUSMASTER) { console_write(sep); console_write("dma"); sep = ","; }
+    if (caps & NETFACE_CAP_LINK)      { console_write(sep); console_write("link"); sep = ","; }
+    if (caps & NETFACE_CAP_CSUM_TX)   { console_write(sep); console_write("csum-tx"); sep = ","; }
+    if (caps & NETFACE_CAP_CSUM_RX)   { console_write(sep); console_write("csum-rx"); }
+}
 
-    // NE2000 diagnostic line
-    console_write("ne2000: present=");
-    console_write(s_ne2k_present ? "yes" : "no");
-    console_write(" init=");
-    console_write(s_ne2k_init_ok ? "ok" : "no");
-    console_write(" io=");
-    if (s_ne2k_present) {
-        unsigned short io = ne2000_io_base();
-        console_write_hex16(io);
-    } else {
-        console_write("----");
+void netface_diag_print(void) {
+    // Probe summary: one entry per known driver
+    console_write("netface: ifaces=");
+    console_write_dec((uint32_t)s_nif);
+    console_write(" default=");
+    console_write(netface_name(0));
+    console_write(" probe:");
+    for (int d = 0; d < NETFACE_NDRV; d++) {
+        console_write(" ");
+        console_write(s_drivers[d]->name);
+        console_write(s_probe[d] == 2 ? "=ok" : s_probe[d] == 1 ? "=fail" : "=absent");
     }
     console_write("\n");
 
-    if (s_active == NETDRV_NE2000) {
-        // MAC
+    for (int i = 0; i < s_nif; i++) {
+        netface_if_t* nf = &s_if[i];
+        const netface_ops_t* ops = nf->ops;
+        console_write(nf->name);
+        console_write(": drv=");
+        console_write(ops->name);
         unsigned char mac[6];
-        if (ne2000_get_mac(mac)) {
-            console_write("mac=");
-            for (int i=0;i<6;i++){ if(i) console_write(":"); phex8(mac[i]); }
-            console_write("\n");
+        if (ops->get_mac(mac)) {
+            console_write(" mac=");
+            print_mac(mac);
         }
-        // Promisc
-        console_write("promisc=");
-        console_write(ne2000_is_promisc()?"on":"off");
+        console_write(" caps=");
+        print_caps(ops->caps);
+        console_write("\n");
+        // Driver-specific lines (io/irq, promisc, link, tx/rx rings)
+        ops->diag();
+        // RX scheduler
+        console_write("sched: mode=");
+        console_write(nf->rx_sched ? "poll" : "irq");
+        console_write(" budget=");
+        console_write_dec((uint32_t)ops->rx_budget);
+        console_write(" irqs=");
+        console_write_dec(nf->napi_irqs);
+        console_write(" polls=");
+        console_write_dec(nf->napi_polls);
+        console_write(" full=");
+        console_write_dec(nf->napi_full);
         console_write("\n");
-        // Link/Speed (NE2000 class)
-        console_write("link=");
-        console_write("unknown");
-        console_write(" speed=");
-        console_write("10Mbps");
-        console_write(" (NE2000-class)\n");
     }
 }
 
 void netface_bootinfo_print(void) {
-    // One line: driver, mac, promisc, io
-    console_write("net: drv=");
-    console_write(drv_name(s_active));
-
-    if (s_active == NETDRV_NE2000) {
+    // One line per interface: driver, mac, promisc, io
+    if (s_nif == 0) {
+        console_write("net: drv=none\n");
+        return;
+    }
+    for (int i = 0; i < s_nif; i++) {
+        const netface_ops_t* ops = s_if[i].ops;
+        console_write("net: ");
+        console_write(s_if[i].name);
+        console_write(" drv=");
+        console_write(ops->name);
         unsigned char mac[6];
-        if (ne2000_get_mac(mac)) {
+        if (ops->get_mac(mac)) {
             console_write(" mac=");
-            for (int i=0;i<6;i++){ if(i) console_write(":"); phex8(mac[i]); }
+            print_mac(mac);
         }
-        console_write(" promisc=");
-        console_write(ne2000_is_promisc()?"on":"off");
-        console_write(" io=");
-        console_write_hex16(ne2000_io_base());
+        ops->bootinfo();
+        console_write("\n");
     }
-    console_write("\n");
 }
 
 bool netface_get_mac(unsigned char mac[6]) {
-    if (s_active == NETDRV_NE2000) return ne2000_get_mac(mac);
-    return false;
+    return netface_if_get_mac(0, mac);
 }
 
 bool netface_send(const unsigned char* frame, unsigned short len) {
-    if (s_active == NETDRV_NE2000) return ne2000_send(frame, len);
-    return false;
+    return netface_if_send(0, frame, len);
+}
+
+unsigned int netface_tx_pending(void) {
+    netface_if_t* nf = if_get(0);
+    return nf ? nf->ops->tx_pending() : 0;
+}
+
+unsigned int netface_tx_capacity(void) {
+    netface_if_t* nf = if_get(0);
+    return nf ? nf->ops->tx_capacity() : 0;
+}
+
+bool netface_rx_counters(uint32_t* frames, uint32_t* bytes) {
+    netface_stats_t st;
+    if (!netface_if_stats(0, &st)) return false;
+    if (frames) *frames = st.rx_frames;
+    if (bytes) *bytes = st.rx_bytes;
+    return true;
 }
 
 // Forward incoming frames to the IPv4/ARP stack (implemented in net_ipv4.c)
 void netface_on_rx(const unsigned char* frame, unsigned short len) {
-    extern void net_ipv4_on_frame(const uint8_t* frame, uint16_t len);
-    net_ipv4_on_frame((const uint8_t*)frame, (uint16_t)len);
+    net_stats_nic_t* c = &g_net_stats.nic[s_rx_if];
+    c->rx_frames++;
+    c->rx_bytes += len;
+    if (g_net_pcap_on) net_pcap_hook(s_rx_if, (const uint8_t*)frame, (uint16_t)len);
+    net_ipv4_on_frame(s_rx_if, (const uint8_t*)frame, (uint16_t)len);
 }
@@ -3,14 +3,81 @@
 #define NETFACE_H
 
 #include <stdbool.h>
+#include <stdint.h>
 
-// Top-level network interface abstraction.
+// Top-level network interface layer.
+//
+// Drivers describe themselves with a netface_ops_t table; netface_init()
+// probes every known driver and registers each NIC it finds as an interface
+// (eth0, eth1, ... in probe order). Interface 0 is the default: the
+// single-NIC calls below (netface_send, netface_get_mac, ...) act on it.
+// Receive scheduling, IRQ dispatch and the bottom-half lock are shared.
 
-// Initialize and select an active NIC driver (currently NE2000 only).
-// Returns true if a NIC was initialized and is usable.
+#define NETFACE_MAX CONFIG_NET_IFACES
+
+// Offload/feature capabilities (netface_ops_t.caps)
+#define NETFACE_CAP_BUSMASTER  0x0001u   // NIC DMAs frames itself (no PIO copy)
+#define NETFACE_CAP_LINK       0x0002u   // link state/speed can be read
+#define NETFACE_CAP_CSUM_TX    0x0004u   // inserts IPv4/TCP/UDP checksums on transmit
+#define NETFACE_CAP_CSUM_RX    0x0008u   // verifies checksums on receive
+
+typedef struct {
+    uint32_t rx_frames, rx_bytes;        // handed to the stack
+    uint32_t rx_errors;                  // dropped by the driver (bad header, overflow, ...)
+    uint32_t tx_ok, tx_err, tx_stalls;   // completions / failures / waits for a free slot
+} netface_stats_t;
+
+typedef struct {
+    const char* name;                    // driver name ("NE2000")
+    uint32_t caps;                       // NETFACE_CAP_*
+    int rx_budget;                       // frames per scheduler pass
+    bool (*present)(void);
+    bool (*init)(void);
+    // Transmit: queue a complete Ethernet frame, retire completions, queue depth
+    bool (*send)(const uint8_t* frame, uint16_t len);
+    void (*tx_reap)(void);
+    uint8_t (*tx_pending)(void);
+    uint8_t (*tx_capacity)(void);
+    // Receive: drain up to 'budget' frames via netface_on_rx(); RX IRQ gating
+    int  (*rx_batch)(int budget, int verbose);
+    void (*rx_irq_enable)(bool on);
+    bool (*rx_irq_take)(void);
+    // Interrupt ack/latch and the PIC line it arrives on (0 = none)
+    void (*irq)(void);
+    uint8_t (*irq_line)(void);
+    // Quiesce the NIC: interrupts off, receiver/DMA stopped (before a kernel handover)
+    void (*shutdown)(void);
+    bool (*get_mac)(uint8_t mac[6]);
+    void (*stats)(netface_stats_t* out);
+    // Diagnostics: verbose RX dump, test frame, driver lines for netinfo/boot
+    void (*poll_rx)(void);
+    bool (*send_test)(void);
+    void (*diag)(void);
+    void (*bootinfo)(void);
+} netface_ops_t;
+
+// Probe all drivers and register the NICs found.
+// Returns true if at least one interface is usable.
 bool netface_init(void);
 
-// Background progress/service function (drains RX rings, etc.).
+// Add an interface for an initialized driver; returns its index or -1 when full.
+int netface_register(const netface_ops_t* ops);
+
+// Registered interfaces
+int netface_count(void);
+const char* netface_name(int ifx);             // "eth0"
+int netface_find(const char* name);            // index or -1
+const netface_ops_t* netface_ops(int ifx);     // NULL if out of range
+bool netface_if_get_mac(int ifx, uint8_t mac[6]);
+bool netface_if_send(int ifx, const uint8_t* frame, uint16_t len);
+bool netface_if_stats(int ifx, netface_stats_t* out);
+uint8_t netface_if_irq_line(int ifx);
+
+// Background progress/service function (drains RX rings, runs the stack).
+// The only place received frames are processed: call it from main context
+// at points where console and NeeleFS are idle (shell idle loop, waits).
+// Nothing else runs the stack: RX stalls while main context does not poll.
+// Explicit safe point: also runs inside bh-disabled sections.
 void netface_poll(void);
 
 // Verbose RX dump (for shell command netrxdump).
@@ -19,25 +86,49 @@ void netface_poll_rx(void);
 // Send a small test frame (driver-provided implementation).
 bool netface_send_test(void);
 
-// IRQ handler hook (e.g., called from IRQ3 in this build).
-void netface_irq(void);
+// IRQ handler hook for PIC line 'irq': every interface on that line latches
+// its NIC events and switches RX to polling (NIC RX interrupts masked) when
+// frames arrive.
+void netface_irq(uint8_t irq);
 
-// Human-readable active driver name (e.g., "NE2000" or "none").
+// Interrupt tail (NIC IRQs and IRQ0 after EOI): retires finished
+// transmissions unless a bh-disabled section is active. Never runs the stack.
+void netface_softirq(void);
+
+// Stop every registered NIC (shutdown op) so none keeps DMAing into or
+// raising interrupts for memory the next kernel reuses (netboot run).
+void netface_shutdown(void);
+
+// Bracket main-context code that drives the NICs (shell commands, socket
+// calls) so the interrupt tail keeps off their registers. Nests.
+void netface_bh_disable(void);
+void netface_bh_enable(void);
+
+// Driver name of the default interface (e.g., "NE2000", "RTL8139" or "none").
 const char* netface_active_name(void);
 
 // Print a small diagnostic summary to the screen.
 void netface_diag_print(void);
 
-// Print a compact one-line summary at boot (driver, MAC, promisc, io if relevant).
+// Print a compact one-line summary per interface at boot (driver, MAC, promisc, io).
 void netface_bootinfo_print(void);
 
-// Get active NIC MAC (returns true if available)
+// Get default NIC MAC (returns true if available)
 bool netface_get_mac(unsigned char mac[6]);
 
-// Transmit a raw Ethernet frame (returns true on success)
+// Transmit a raw Ethernet frame on the default interface (returns true on success)
 bool netface_send(const unsigned char* frame, unsigned short len);
 
-// RX callback from drivers: deliver complete Ethernet frame (without FCS)
+// TX queue depth: frames queued or on the wire, and how many the NIC can hold.
+// netface_send() only blocks once pending == capacity.
+unsigned int netface_tx_pending(void);
+unsigned int netface_tx_capacity(void);
+
+// Cumulative RX counters of the default NIC (frames/bytes handed to the stack)
+bool netface_rx_counters(uint32_t* frames, uint32_t* bytes);
+
+// RX callback from drivers: deliver complete Ethernet frame (without FCS).
+// Attributed to the interface whose rx_batch/poll_rx is running.
 void netface_on_rx(const unsigned char* frame, unsigned short len);
 
 #endif // NETFACE_H
@@ -67,12 +67,14 @@ void platform_timer_set_hz(uint32_t hz) {
 uint32_t platform_timer_get_hz(void) { return g_timer_hz; }
 
 void platform_irq_set_mask(uint8_t irq, int masked) { pic_set_mask(irq, masked); }
+int platform_irq_routed(uint8_t irq) { return idt_irq_routed(irq); }
 void platform_irq_mask_all(void) { pic_mask_all(); }
 
 void platform_interrupts_enable(void) { interrupts_enable(); }
 void platform_interrupts_disable(void) { interrupts_disable(); }
 
 uint32_t platform_ticks_get(void) { return ticks_get(); }
+uint32_t platform_time_us(void) { return pit_time_us(); }
 
 void platform_delay_ms(uint32_t ms) {
     if (ms == 0) return;
@@ -22,6 +22,9 @@ uint32_t platform_timer_get_hz(void);
 void platform_irq_set_mask(uint8_t irq, int masked);
 static inline void platform_irq_unmask(uint8_t irq) { platform_irq_set_mask(irq, 0); }
 
+// Non-zero if an interrupt handler is installed for the line.
+int platform_irq_routed(uint8_t irq);
+
 // Mask all IRQ lines.
 void platform_irq_mask_all(void);
 
@@ -32,6 +35,10 @@ void platform_interrupts_disable(void);
 // Monotonic tick counter (if available)
 uint32_t platform_ticks_get(void);
 
+// Monotonic microseconds with sub-tick resolution (wraps after ~71 minutes;
+// compare with unsigned differences)
+uint32_t platform_time_us(void);
+
 /* Busy-wait for an approximate millisecond delay (uses PIT ticks if running) */
 void platform_delay_ms(uint32_t ms);
 
@@ -10,8 +10,17 @@
 #include "cpuidle.h"
 #include "interrupts.h"
 #include "net/ipv4.h"
+#include "net/arp.h"
+#include "net/udp.h"
+#include "net/tftp.h"
+#include "net/netboot.h"
+#include "net/ping.h"
+#include "net/tcpbench.h"
+#include "net/netstat.h"
+#include "net/pcap.h"
 #include "drivers/pcspeaker.h"
 #include "drivers/gpu/gpu.h"
+#include "drivers/gpu/gpu_stats.h"
 #include "drivers/pci.h"
 #include "apps/fbtest_color.h"
 #include "apps/gfx_probe.h"
@@ -74,17 +83,38 @@ static uint32_t shell_clamp_u64_to_u32(uint64_t v) {
     return (v > 0xFFFFFFFFu) ? 0xFFFFFFFFu : (uint32_t)v;
 }
 
+// Abort hook for long-running network commands: 'q' on the keyboard
+static bool shell_abort_q(void) {
+    int k = keyboard_poll_char();
+    return k == 'q' || k == 'Q';
+}
+
+// UDP echo service (RFC 862) for `udp echo`; runs in the network RX path
+static int s_udp_echo_sock = -1;
+static void shell_udp_echo(int sock, uint32_t src_ip, uint16_t src_port, const uint8_t* data, uint16_t len, void* ctx) {
+    (void)ctx;
+    (void)net_udp_sendto(sock, src_ip, src_port, data, len);
+}
+
 void shell_run(void) {
     char buf[128];
     int len = 0;
     print_prompt();
 
     for (;;) {
-        fb_accel_sync(); // Sync shadow buffer to hardware
+        console_fb_release(); // An app left double buffering on: the console takes the screen back
+        console_flush(); // Pending console text, then the shadow buffer to hardware
         interrupts_statusbar_poll();
         video_cursor_tick();
         int ch = keyboard_poll_char();
-        if (ch < 0) { netface_poll(); cpuidle_idle(); continue; }
+        if (ch < 0) {
+            netface_poll();
+            // Notices and file closes the RX path leaves to main context
+            net_arp_report();
+            net_tftp_server_poll();
+            cpuidle_idle();
+            continue;
+        }
 
         if (ch == '\r') ch = '\n';
         if (ch == '\n') {
@@ -92,6 +122,10 @@ void shell_run(void) {
             buf[len] = 0;
             shell_trim_in_place(buf, &len);
             if (len > 0) {
+                // Received frames are only processed by netface_poll() (idle loop, and waits
+                // inside commands as explicit safe points); keep the IRQ tail off the NICs
+                // while the command drives them.
+                netface_bh_disable();
                 if (streq(buf, "version")) {
                     console_write("Mezereon ");
                     console_write(CONFIG_KERNEL_VERSION);
@@ -101,7 +135,7 @@ void shell_run(void) {
                 } else if (streq(buf, "kbdump")) {
                     keyboard_debug_dump();
                 } else if (streq(buf, "help")) {
-                    console_write("Commands: version, clear, help, reboot, cpuinfo, meminfo, pciinfo, ticks, wakeups, idle [n], timer <show|hz N|off|on>, ata, atadump [lba], autofs [show|rescan|mount <n>], ip [show|set <ip> <mask} [gw]|ping <ip> [count]], neele mount [lba], neele ls [path], neele cat <name|/path>, neele mkfs, neele mkdir </path>, neele write </path> <text>, neele verify [verbose] [path], pad </path>, netinfo, netrxdump, gpuprobe [scan|noscan] [auto|noauto] [status] [debug <on|off>] [activate <chip> <WxHxB>], gpudump [regs [chip|all]|bank <bank> [offset] [len]|capture <bank> [offset] [len]], gpuinfo, fbtest, gfxprobe, beep [freq] [ms], keymusic, rotcube, app [ls|run </path|name>], http [start [port]|stop|status|body <text>]\n");
+                    console_write("Commands: version, clear, help, reboot, cpuinfo, meminfo, pciinfo, ticks, wakeups, idle [n], timer <show|hz N|off|on>, ata, atadump [lba], autofs [show|rescan|mount <n>], ip [show|set <ip> <mask> [gw] [dev <ethN>]|route <ip>|ping <ip> [count] [-i ms] [-s bytes] [-f]|arp [flush]], neele mount [lba], neele ls [path], neele cat <name|/path>, neele mkfs, neele mkdir </path>, neele write </path> <text>, neele verify [verbose] [path], pad </path>, netinfo, netstat [rates|reset], pcap [start [dev <ethN>] [type <hex>] [proto <p>] [port <n>] [snap <n>]|stop|status|save </path>|serial], netrxdump, netbench rx [sec], netbench tx [sec] [size], netbench tcp [start|stop|status], udp [echo [port|off]|send <ip> <port> <text>], tftp [get <ip> <remote> [/local]|put <ip> </local> [remote]|server [start [/root]|stop|status]], netboot [tftp <ip> <file> [write|run]|load </path> [write|run]|write|run|status], gpuprobe [scan|noscan] [auto|noauto] [status] [debug <on|off>] [activate <chip> <WxHxB>], gpudump [regs [chip|all]|bank <bank> [offset] [len]|capture <bank> [offset] [len]], gpuinfo, gpustats [reset], conbench [lines], fbtest, gfxprobe, beep [freq] [ms], keymusic, rotcube, app [ls|run </path|name>], http [start [port]|stop|status|body <text>|put </dir|off>]\n");
                 } else if (streq(buf, "reboot")) {
                     console_writeln("Rebooting...");
                     platform_delay_ms(100);
@@ -267,6 +301,87 @@ void shell_run(void) {
                     }
                 } else if (streq(buf, "netinfo")) {
                     netface_diag_print();
+                } else if (buf[0]=='n' && buf[1]=='e' && buf[2]=='t' && buf[3]=='s' && buf[4]=='t' && buf[5]=='a' && buf[6]=='t' && (buf[7]==0 || buf[7]==' ')) {
+                    int i=7; while (buf[i]==' ') i++;
+                    if (netface_count() == 0) { console_writeln("netstat: no NIC"); }
+                    else if (buf[i]==0) { net_stats_print(); }
+                    else if (buf[i]=='r' && buf[i+1]=='e' && buf[i+2]=='s') { net_stats_reset(); console_writeln("netstat: counters cleared"); }
+                    else if (buf[i]=='r' && buf[i+1]=='a' && buf[i+2]=='t') {
+                        // netstat rates — one line per second from the IRQ0 sampler until 'q'
+                        uint32_t hz = platform_timer_get_hz();
+                        if (!hz) { console_writeln("netstat: timer off, no rates"); }
+                        else {
+                            console_writeln("netstat rates ('q' stops)");
+                            uint32_t last = platform_ticks_get();
+                            while (!shell_abort_q()) {
+                                netface_poll();
+                                if (platform_ticks_get() - last >= hz) { last += hz; net_stats_print_rates(); }
+                                cpuidle_idle();
+                            }
+                        }
+                    } else { console_writeln("usage: netstat [rates|reset]"); }
+                } else if (buf[0]=='p' && buf[1]=='c' && buf[2]=='a' && buf[3]=='p' && (buf[4]==0 || buf[4]==' ')) {
+                    int i=4; while (buf[i]==' ') i++;
+                    if (buf[i]=='s' && buf[i+1]=='t' && buf[i+2]=='a' && buf[i+3]=='r' && buf[i+4]=='t') {
+                        // pcap start [dev <ethN>] [type <hex>] [proto icmp|tcp|udp|<n>] [port <n>] [snap <n>]
+                        i+=5;
+                        net_pcap_filter_t pf; net_pcap_filter_default(&pf);
+                        int bad=0;
+                        for (;;) {
+                            while (buf[i]==' ') i++;
+                            if (!buf[i]) break;
+                            char kw[8]={0}, val[16]={0}; int j=0;
+                            while (buf[i] && buf[i]!=' ' && j<7){ kw[j++]=buf[i++]; }
+                            while (buf[i]==' ') i++;
+                            j=0; while (buf[i] && buf[i]!=' ' && j<15){ val[j++]=buf[i++]; }
+                            uint32_t v=0; int any=0, k=0;
+                            if (streq(kw, "type")) {
+                                if (val[0]=='0' && (val[1]=='x' || val[1]=='X')) k=2;
+                                for (; val[k]; k++) {
+                                    char c=val[k]; uint32_t d;
+                                    if (c>='0'&&c<='9') d=(uint32_t)(c-'0');
+                                    else if (c>='a'&&c<='f') d=(uint32_t)(c-'a'+10);
+                                    else if (c>='A'&&c<='F') d=(uint32_t)(c-'A'+10);
+                                    else { any=0; break; }
+                                    v=(v<<4)|d; any=1;
+                                }
+                            } else {
+                                for (; val[k]>='0'&&val[k]<='9'; k++){ v=v*10+(uint32_t)(val[k]-'0'); any=1; }
+                                if (val[k]) any=0;
+                            }
+                            if (streq(kw, "dev")) { pf.ifx = netface_find(val); if (pf.ifx < 0) bad=1; }
+                            else if (streq(kw, "proto")) {
+                                if (streq(val, "icmp")) pf.proto = 1;
+                                else if (streq(val, "tcp")) pf.proto = 6;
+                                else if (streq(val, "udp")) pf.proto = 17;
+                                else if (any && v < 256) pf.proto = (uint8_t)v;
+                                else bad=1;
+                            }
+                            else if (!any || v > 0xFFFFu) bad=1;
+                            else if (streq(kw, "type")) pf.ethertype = (uint16_t)v;
+                            else if (streq(kw, "port")) pf.port = (uint16_t)v;
+                            else if (streq(kw, "snap")) pf.snaplen = (uint16_t)v;
+                            else bad=1;
+                            if (bad) break;
+                        }
+                        if (bad) console_writeln("usage: pcap start [dev <ethN>] [type <hex>] [proto icmp|tcp|udp|<n>] [port <n>] [snap <n>]");
+                        else if (!net_pcap_start(&pf)) console_writeln("pcap: no memory for the ring");
+                        else net_pcap_status();
+                    } else if (buf[i]=='s' && buf[i+1]=='t' && buf[i+2]=='o' && buf[i+3]=='p') {
+                        net_pcap_stop(); net_pcap_status();
+                    } else if (buf[i]=='s' && buf[i+1]=='a' && buf[i+2]=='v' && buf[i+3]=='e' && buf[i+4]==' ') {
+                        // pcap save </path> — pcap file on NeeleFS
+                        i+=5; while (buf[i]==' ') i++;
+                        if (buf[i]!='/') console_writeln("usage: pcap save </path>");
+                        else if (!net_pcap_save(buf+i)) console_writeln("pcap: save failed (nothing captured or NeeleFS not mounted)");
+                        else { console_write("pcap: saved "); console_writeln(buf+i); }
+                    } else if (buf[i]=='s' && buf[i+1]=='e' && buf[i+2]=='r') {
+                        console_writeln("pcap: dumping to COM2 ...");
+                        if (!net_pcap_serial()) console_writeln("pcap: nothing captured or no UART at COM2");
+                        else console_writeln("pcap: done");
+                    } else if (buf[i]==0 || (buf[i]=='s' && buf[i+1]=='t' && buf[i+2]=='a' && buf[i+3]=='t')) {
+                        net_pcap_status();
+                    } else { console_writeln("usage: pcap [start [filter]|stop|status|save </path>|serial]"); }
                 } else if (streq(buf, "netrxdump")) {
                     console_write("netrxdump: press 'q' to quit.\n");
                     for (;;) {
@@ -275,6 +390,77 @@ void shell_run(void) {
                         netface_poll_rx();
                         cpuidle_idle();
                     }
+                } else if (buf[0]=='n' && buf[1]=='e' && buf[2]=='t' && buf[3]=='b' && buf[4]=='e' && buf[5]=='n' && buf[6]=='c' && buf[7]=='h' && (buf[8]==0 || buf[8]==' ')) {
+                    int i=8; while (buf[i]==' ') i++;
+                    if (buf[i]=='r' && buf[i+1]=='x' && (buf[i+2]==0 || buf[i+2]==' ')) {
+                        // netbench rx [seconds] — count frames drained from the NIC while the host floods us
+                        i+=2; while (buf[i]==' ') i++;
+                        uint32_t secs=0; while (buf[i]>='0'&&buf[i]<='9'){ secs=secs*10+(uint32_t)(buf[i]-'0'); i++; }
+                        if (secs==0) secs=5;
+                        uint32_t f0=0, b0=0, f1=0, b1=0;
+                        if (!netface_rx_counters(&f0, &b0)) { console_writeln("netbench: no NIC"); }
+                        else {
+                            uint32_t hz = platform_timer_get_hz(); if (!hz) hz = 100;
+                            console_write("netbench rx: measuring "); console_write_dec(secs); console_writeln("s ('q' aborts)");
+                            uint32_t start = platform_ticks_get(); uint32_t dt = 0;
+                            while (dt < secs*hz) {
+                                int k = keyboard_poll_char(); if (k=='q' || k=='Q') break;
+                                netface_poll();
+                                dt = platform_ticks_get() - start;
+                            }
+                            (void)netface_rx_counters(&f1, &b1);
+                            uint32_t ms = dt * 1000u / hz; if (!ms) ms = 1;
+                            uint32_t frames = f1 - f0, bytes = b1 - b0;
+                            console_write("rx: "); console_write_dec(frames); console_write(" frames, ");
+                            console_write_dec(bytes/1024u); console_write(" KiB in "); console_write_dec(ms); console_write(" ms = ");
+                            console_write_dec((uint32_t)((uint64_t)frames * 1000u / ms)); console_write(" frames/s, ");
+                            console_write_dec((uint32_t)((uint64_t)bytes * 1000u / 1024u / ms)); console_writeln(" KiB/s");
+                        }
+                    } else if (buf[i]=='t' && buf[i+1]=='x' && (buf[i+2]==0 || buf[i+2]==' ')) {
+                        // netbench tx [seconds] [size] — broadcast frames back to back, compare NICs
+                        i+=2; while (buf[i]==' ') i++;
+                        uint32_t secs=0; while (buf[i]>='0'&&buf[i]<='9'){ secs=secs*10+(uint32_t)(buf[i]-'0'); i++; }
+                        while (buf[i]==' ') i++;
+                        uint32_t size=0; while (buf[i]>='0'&&buf[i]<='9'){ size=size*10+(uint32_t)(buf[i]-'0'); i++; }
+                        if (secs==0) secs=5;
+                        if (size==0) size=1514;
+                        if (size<60) size=60;
+                        if (size>1514) size=1514;
+                        static unsigned char tx_frame[1514];
+                        unsigned char mac[6];
+                        if (!netface_get_mac(mac)) { console_writeln("netbench: no NIC"); }
+                        else {
+                            // Ethernet broadcast, local experimental EtherType 0x88B5
+                            for (int k=0;k<6;k++){ tx_frame[k]=0xFF; tx_frame[6+k]=mac[k]; }
+                            tx_frame[12]=0x88; tx_frame[13]=0xB5;
+                            for (uint32_t k=14;k<size;k++) tx_frame[k]=(unsigned char)k;
+                            uint32_t hz = platform_timer_get_hz(); if (!hz) hz = 100;
+                            console_write("netbench tx: "); console_write(netface_active_name());
+                            console_write(", "); console_write_dec(size); console_write(" byte frames for ");
+                            console_write_dec(secs); console_writeln("s ('q' aborts)");
+                            uint32_t frames=0, fails=0;
+                            uint32_t start = platform_ticks_get(); uint32_t dt = 0;
+                            while (dt < secs*hz) {
+                                if ((frames & 63u) == 0) { int k = keyboard_poll_char(); if (k=='q' || k=='Q') break; }
+                                if (netface_send(tx_frame, (unsigned short)size)) frames++; else fails++;
+                                dt = platform_ticks_get() - start;
+                            }
+                            uint32_t ms = dt * 1000u / hz; if (!ms) ms = 1;
+                            uint64_t bytes = (uint64_t)frames * size;
+                            console_write("tx: "); console_write_dec(frames); console_write(" frames, ");
+                            console_write_dec((uint32_t)(bytes/1024u)); console_write(" KiB in "); console_write_dec(ms); console_write(" ms = ");
+                            console_write_dec((uint32_t)((uint64_t)frames * 1000u / ms)); console_write(" frames/s, ");
+                            console_write_dec((uint32_t)(bytes * 1000u / 1024u / ms)); console_write(" KiB/s");
+                            if (fails) { console_write(", failed="); console_write_dec(fails); }
+                            console_write("\n");
+                        }
+                    } else if (buf[i]=='t' && buf[i+1]=='c' && buf[i+2]=='p' && (buf[i+3]==0 || buf[i+3]==' ')) {
+                        // netbench tcp [start|stop|status] — discard (9) / chargen (19) services
+                        i+=3; while (buf[i]==' ') i++;
+                        if (buf[i]=='s' && buf[i+1]=='t' && buf[i+2]=='a' && buf[i+3]=='r') { net_tcpbench_start(); console_writeln("netbench tcp: discard on 9, chargen on 19"); }
+                        else if (buf[i]=='s' && buf[i+1]=='t' && buf[i+2]=='o') { net_tcpbench_stop(); console_writeln("netbench tcp: stopped"); }
+                        else net_tcpbench_status();
+                    } else { console_writeln("usage: netbench rx [seconds] | netbench tx [seconds] [size] | netbench tcp [start|stop|status]"); }
                 } else if (buf[0]=='a' && buf[1]=='u' && buf[2]=='t' && buf[3]=='o' && buf[4]=='f' && buf[5]=='s' && (buf[6]==' ' || buf[6]==0)) {
                     int i=6; while (buf[i]==' ') i++;
                     if (!buf[i] || (buf[i]=='s')) { // show default or 'show'
@@ -308,33 +494,61 @@ void shell_run(void) {
                     if (!buf[i]) { net_ipv4_print_config(); }
                     else if (buf[i]=='s' && buf[i+1]=='e' && buf[i+2]=='t') {
                         i+=3; while (buf[i]==' ') i++;
-                        // ip set <addr> <mask> [gw]
-                        char a[16]={0}, m[16]={0}, g[16]={0}; int j=0;
+                        // ip set <addr> <mask> [gw] [dev <ethN>]
+                        char a[16]={0}, m[16]={0}, g[16]={0}, dv[8]={0}; int j=0;
                         while (buf[i] && buf[i]!=' ' && j<15){ a[j++]=buf[i++]; }
                         while (buf[i]==' ') i++;
                         j=0; while (buf[i] && buf[i]!=' ' && j<15){ m[j++]=buf[i++]; }
                         while (buf[i]==' ') i++;
-                        j=0; while (buf[i] && buf[i]!=' ' && j<15){ g[j++]=buf[i++]; }
+                        if (!(buf[i]=='d' && buf[i+1]=='e' && buf[i+2]=='v' && buf[i+3]==' ')) {
+                            j=0; while (buf[i] && buf[i]!=' ' && j<15){ g[j++]=buf[i++]; }
+                            while (buf[i]==' ') i++;
+                        }
+                        if (buf[i]=='d' && buf[i+1]=='e' && buf[i+2]=='v' && buf[i+3]==' ') {
+                            i+=4; while (buf[i]==' ') i++;
+                            j=0; while (buf[i] && buf[i]!=' ' && j<7){ dv[j++]=buf[i++]; }
+                        }
                         const char* gp = (g[0]?g:0);
-                        if (!net_ipv4_set_from_strings(a,m,gp)) console_writeln("ip: bad address/mask/gw");
+                        int ifx = dv[0] ? netface_find(dv) : 0;
+                        if (ifx < 0) console_writeln("ip: unknown interface");
+                        else if (!net_ipv4_set_from_strings(ifx,a,m,gp)) console_writeln("ip: bad address/mask/gw");
                         else { net_ipv4_print_config(); console_status_set_left("ip: set"); }
+                    } else if (buf[i]=='r' && buf[i+1]=='o' && buf[i+2]=='u' && buf[i+3]=='t' && buf[i+4]=='e') {
+                        // ip route <addr> — show the interface/next hop the stack picks
+                        i+=5; while (buf[i]==' ') i++;
+                        uint32_t dst=0;
+                        if (!net_ipv4_parse_addr(buf+i, &dst)) console_writeln("usage: ip route <addr>");
+                        else net_ipv4_print_route(dst);
                     } else if (buf[i]=='p' && buf[i+1]=='i' && buf[i+2]=='n' && buf[i+3]=='g') {
-                        // ip ping <addr> [count]
+                        // ip ping <addr> [count] [-c n] [-i ms] [-s bytes] [-f]
                         i+=4; while (buf[i]==' ') i++;
                         char a[16]={0}; int j=0; while (buf[i] && buf[i]!=' ' && j<15){ a[j++]=buf[i++]; }
-                        while (buf[i]==' ') i++;
-                        uint32_t cnt=1; while (buf[i]>='0'&&buf[i]<='9'){ cnt=cnt*10+(uint32_t)(buf[i]-'0'); i++; }
-                        // parse dotted quad
-                        int okp=0; uint32_t ipbe=0; {
-                            const char* s=a; uint32_t acc=0; int part=0; uint32_t v=0; int d=0; okp=0;
-                            while (*s && part<4){ if (*s>='0'&&*s<='9'){ v=v*10+(*s-'0'); if (v>255) { okp=0; break; } d=1; }
-                                else if (*s=='.'){ if (!d){ okp=0; break; } acc=(acc<<8)|v; v=0; d=0; part++; }
-                                else { okp=0; break; } s++; }
-                            if (part==3 && d){ acc=(acc<<8)|v; ipbe = ((acc&0xFF)<<24)|((acc&0xFF00)<<8)|((acc&0xFF0000)>>8)|((acc>>24)&0xFF); okp=1; }
+                        net_ping_opts_t po; net_ping_defaults(&po);
+                        int bad=0;
+                        for (;;) {
+                            while (buf[i]==' ') i++;
+                            if (!buf[i]) break;
+                            char opt = 0;
+                            if (buf[i]=='-' && buf[i+1]) { opt = buf[i+1]; i+=2; while (buf[i]==' ') i++; }
+                            if (opt=='f') { po.interval_ms = 0; po.quiet = true; if (po.count==4) po.count = 1000; continue; }
+                            uint32_t v=0; int any=0;
+                            while (buf[i]>='0'&&buf[i]<='9'){ v=v*10+(uint32_t)(buf[i]-'0'); i++; any=1; }
+                            if (!any) { bad=1; break; }
+                            if (opt==0 || opt=='c') po.count = v;
+                            else if (opt=='i') po.interval_ms = v;
+                            else if (opt=='s') po.size = (uint16_t)(v > NET_PING_MAX_DATA ? NET_PING_MAX_DATA : v);
+                            else { bad=1; break; }
                         }
-                        if (!okp) console_writeln("ip ping: bad address");
-                        else { net_icmp_ping(ipbe, (int)cnt, 1000); }
-                    } else { console_writeln("usage: ip [show|set <ip> <mask> [gw]|ping <ip> [count]]"); }
+                        uint32_t ipbe=0;
+                        if (bad) console_writeln("usage: ip ping <ip> [count] [-c n] [-i ms] [-s bytes] [-f]  (count 0 = until 'q')");
+                        else if (!net_ipv4_parse_addr(a, &ipbe)) console_writeln("ip ping: bad address");
+                        else if (!net_ping_run(ipbe, &po, NULL, shell_abort_q)) console_writeln("ip ping: no interface");
+                    } else if (buf[i]=='a' && buf[i+1]=='r' && buf[i+2]=='p' && (buf[i+3]==0 || buf[i+3]==' ')) {
+                        // ip arp [flush]
+                        i+=3; while (buf[i]==' ') i++;
+                        if (buf[i]=='f') { net_arp_flush(); console_writeln("arp: flushed"); }
+                        else net_arp_print();
+                    } else { console_writeln("usage: ip [show|set <ip> <mask> [gw] [dev <ethN>]|route <ip>|ping <ip> [count] [-i ms] [-s bytes] [-f]|arp [flush]]"); }
                 } else if (buf[0]=='t' && buf[1]=='i' && buf[2]=='m' && buf[3]=='e' && buf[4]=='r' && (buf[5]==' ' || buf[5]==0)) {
                     int i=5; while (buf[i]==' ') i++;
                     if (!buf[i] || (buf[i]=='s')) { // show
@@ -384,6 +598,48 @@ void shell_run(void) {
                     } else {
                         console_writeln("usage: gpuinfo [detail]");
                     }
+                } else if (buf[0]=='g' && buf[1]=='p' && buf[2]=='u' && buf[3]=='s' && buf[4]=='t' && buf[5]=='a' && buf[6]=='t' && buf[7]=='s' && (buf[8]==0 || buf[8]==' ')) {
+                    // gpustats [reset] — per-adapter sync/upload/vblank counters (drivers/gpu/gpu_stats.c)
+                    int i=8; while (buf[i]==' ') i++;
+                    if (!buf[i]) gpu_stats_print();
+                    else if (buf[i]=='r' && buf[i+1]=='e' && buf[i+2]=='s') { gpu_stats_reset(); console_writeln("gpustats: counters cleared"); }
+                    else console_writeln("usage: gpustats [reset]");
+                } else if (buf[0]=='c' && buf[1]=='o' && buf[2]=='n' && buf[3]=='b' && buf[4]=='e' && buf[5]=='n' && buf[6]=='c' && buf[7]=='h' && (buf[8]==0 || buf[8]==' ')) {
+                    // conbench [lines] — print full-width lines through the console, report chars/s
+                    // drawing every character (flush rate 0) against deferred flushing
+                    int i=8; while (buf[i]==' ') i++;
+                    uint32_t lines=0; while (buf[i]>='0'&&buf[i]<='9'){ lines=lines*10+(uint32_t)(buf[i]-'0'); i++; }
+                    if (lines==0) lines=200;
+                    static char line[80];
+                    uint32_t hz = platform_timer_get_hz(); if (!hz) hz = 100;
+                    uint32_t rate = console_set_flush_rate(0);
+                    uint32_t deferred = rate ? rate : CONFIG_VIDEO_FLUSH_HZ;
+                    uint32_t chars = lines * 79u;
+                    uint32_t ms[2];
+                    for (int pass=0; pass<2; pass++) {
+                        console_set_flush_rate(pass ? deferred : 0);
+                        uint32_t start = platform_ticks_get();
+                        for (uint32_t n=0; n<lines; n++) {
+                            for (int k=0;k<78;k++) line[k]=(char)(' ' + 1 + (int)((n + (uint32_t)k) % 94u));
+                            line[78]='\n'; line[79]=0;
+                            console_write(line);
+                        }
+                        console_flush();
+                        uint32_t dt = platform_ticks_get() - start;
+                        ms[pass] = dt * 1000u / hz; if (!ms[pass]) ms[pass] = 1;
+                    }
+                    console_set_flush_rate(rate);
+                    for (int pass=0; pass<2; pass++) {
+                        console_write("conbench: "); console_write(pass ? "deferred " : "immediate ");
+                        console_write_dec(chars); console_write(" chars in ");
+                        console_write_dec(ms[pass]); console_write(" ms = ");
+                        console_write_dec((uint32_t)((uint64_t)chars * 1000u / ms[pass])); console_write(" chars/s");
+                        if (pass) { console_write(" at "); console_write_dec(deferred); console_write(" Hz"); }
+                        console_write("\n");
+                    }
+                    console_write("conbench: speedup x"); console_write_dec(ms[0] / ms[1]);
+                    console_write("."); console_write_dec((ms[0] * 10u / ms[1]) % 10u);
+                    console_write(" ("); console_write(console_fb_active() ? "framebuffer" : "text mode"); console_writeln(")");
                 } else if (buf[0]=='a' && buf[1]=='p' && buf[2]=='p' && (buf[3]==0 || buf[3]==' ')) {
                     int i=3; while (buf[i]==' ') i++;
                     if (!buf[i] || (buf[i]=='l' && buf[i+1]=='s')) {
@@ -428,6 +684,7 @@ void shell_run(void) {
                     extern void net_tcp_min_set_http_body(const char* body);
                     extern void net_tcp_min_set_file_path(const char* path);
                     extern void net_tcp_min_use_inline(void);
+                    extern void net_tcp_min_set_put_dir(const char* dir);
                     int i=4; while (buf[i]==' ') i++;
                     if (!buf[i] || (buf[i]=='s' && buf[i+1]=='t' && buf[i+2]=='a' && buf[i+3]=='t' && buf[i+4]=='u' && buf[i+5]=='s')) {
                         net_tcp_min_status();
@@ -447,7 +704,125 @@ void shell_run(void) {
                         if (!buf[i]) console_writeln("usage: http file </path>"); else { net_tcp_min_set_file_path(buf+i); console_writeln("http: file mode"); }
                     } else if (buf[i]=='i' && buf[i+1]=='n' && buf[i+2]=='l' && buf[i+3]=='i' && buf[i+4]=='n' && buf[i+5]=='e') {
                         net_tcp_min_use_inline(); console_writeln("http: inline mode");
-                    } else { console_writeln("usage: http [start [port]|stop|status|body <text>]"); }
+                    } else if (buf[i]=='p' && buf[i+1]=='u' && buf[i+2]=='t' && (buf[i+3]==0 || buf[i+3]==' ')) {
+                        i+=3; while (buf[i]==' ') i++;
+                        if (buf[i]=='o' && buf[i+1]=='f' && buf[i+2]=='f' && buf[i+3]==0) { net_tcp_min_set_put_dir(NULL); console_writeln("http: uploads off"); }
+                        else if (buf[i]=='/') { net_tcp_min_set_put_dir(buf+i); console_write("http: uploads below "); console_writeln(buf+i); }
+                        else console_writeln("usage: http put </dir|off>");
+                    } else { console_writeln("usage: http [start [port]|stop|status|body <text>|put </dir|off>]"); }
+                } else if (buf[0]=='u' && buf[1]=='d' && buf[2]=='p' && (buf[3]==0 || buf[3]==' ')) {
+                    int i=3; while (buf[i]==' ') i++;
+                    if (!buf[i]) { net_udp_print(); }
+                    else if (buf[i]=='e' && buf[i+1]=='c' && buf[i+2]=='h' && buf[i+3]=='o') {
+                        // udp echo [port|off]
+                        i+=4; while (buf[i]==' ') i++;
+                        if (s_udp_echo_sock >= 0) { net_udp_close(s_udp_echo_sock); s_udp_echo_sock = -1; }
+                        if (buf[i]=='o') { console_writeln("udp echo: off"); }
+                        else {
+                            uint32_t p=0; while (buf[i]>='0'&&buf[i]<='9'){ p=p*10+(uint32_t)(buf[i]-'0'); i++; }
+                            if (p==0 || p>65535) p=7;
+                            int sk = net_udp_open((uint16_t)p);
+                            if (sk < 0) console_writeln("udp echo: port busy or no socket");
+                            else {
+                                (void)net_udp_set_handler(sk, shell_udp_echo, NULL);
+                                s_udp_echo_sock = sk;
+                                console_write("udp echo: port "); console_write_dec(p); console_write("\n");
+                            }
+                        }
+                    } else if (buf[i]=='s' && buf[i+1]=='e' && buf[i+2]=='n' && buf[i+3]=='d') {
+                        // udp send <ip> <port> <text>
+                        i+=4; while (buf[i]==' ') i++;
+                        char a[16]={0}; int j=0; while (buf[i] && buf[i]!=' ' && j<15){ a[j++]=buf[i++]; }
+                        while (buf[i]==' ') i++;
+                        uint32_t p=0; while (buf[i]>='0'&&buf[i]<='9'){ p=p*10+(uint32_t)(buf[i]-'0'); i++; }
+                        while (buf[i]==' ') i++;
+                        uint32_t dst=0;
+                        if (!net_ipv4_parse_addr(a, &dst) || p==0 || p>65535) console_writeln("usage: udp send <ip> <port> <text>");
+                        else {
+                            int sk = net_udp_open(0);
+                            uint16_t n=0; while (buf[i+n]) n++;
+                            int rc = (sk < 0) ? sk : net_udp_sendto(sk, dst, (uint16_t)p, buf+i, n);
+                            if (sk >= 0) net_udp_close(sk);
+                            if (rc < 0) console_writeln("udp send: failed"); else console_writeln("udp send: ok");
+                        }
+                    } else { console_writeln("usage: udp [echo [port|off]|send <ip> <port> <text>]"); }
+                } else if (buf[0]=='t' && buf[1]=='f' && buf[2]=='t' && buf[3]=='p' && (buf[4]==0 || buf[4]==' ')) {
+                    int i=4; while (buf[i]==' ') i++;
+                    int is_get = (buf[i]=='g' && buf[i+1]=='e' && buf[i+2]=='t' && buf[i+3]==' ');
+                    int is_put = (buf[i]=='p' && buf[i+1]=='u' && buf[i+2]=='t' && buf[i+3]==' ');
+                    if (is_get || is_put) {
+                        // tftp get <ip> <remote> [/local] | tftp put <ip> </local> [remote]
+                        i+=4; while (buf[i]==' ') i++;
+                        char a[16]={0}, src[64]={0}, dst[64]={0}; int j=0;
+                        while (buf[i] && buf[i]!=' ' && j<15){ a[j++]=buf[i++]; }
+                        while (buf[i]==' ') i++;
+                        j=0; while (buf[i] && buf[i]!=' ' && j<63){ src[j++]=buf[i++]; }
+                        while (buf[i]==' ') i++;
+                        j=0; while (buf[i] && buf[i]!=' ' && j<63){ dst[j++]=buf[i++]; }
+                        uint32_t server=0;
+                        if (!net_ipv4_parse_addr(a, &server) || !src[0]) {
+                            console_writeln("usage: tftp get <ip> <remote> [/local] | tftp put <ip> </local> [remote]");
+                        } else {
+                            if (!dst[0]) {
+                                // default: same base name (under / for get)
+                                const char* base=src; for (const char* q=src; *q; q++) if (*q=='/') base=q+1;
+                                j=0; if (is_get) dst[j++]='/';
+                                while (*base && j<63) dst[j++]=*base++;
+                                dst[j]=0;
+                            }
+                            net_tftp_result_t res;
+                            int rc = is_get ? net_tftp_get_file(server, src, dst, &res, shell_abort_q) : net_tftp_put_file(server, src, dst, &res, shell_abort_q);
+                            if (rc == 0) { console_write(is_get ? "tftp get: " : "tftp put: "); net_tftp_print_result(&res); }
+                            else {
+                                console_write("tftp: failed (");
+                                console_write(rc==NET_TFTP_ETIMEOUT?"timeout":rc==NET_TFTP_EPEER?"peer error":rc==NET_TFTP_EIO?"file i/o":rc==NET_TFTP_ENOSOCK?"no socket":rc==NET_TFTP_EABORT?"cancelled":"protocol");
+                                if (rc==NET_TFTP_EPEER && res.peer_error[0]) { console_write(": "); console_write(res.peer_error); }
+                                console_write(")\n");
+                            }
+                        }
+                    } else if (buf[i]=='s' && buf[i+1]=='e' && buf[i+2]=='r' && buf[i+3]=='v' && buf[i+4]=='e' && buf[i+5]=='r') {
+                        // tftp server [start [/root]|stop|status]
+                        i+=6; while (buf[i]==' ') i++;
+                        if (buf[i]=='s' && buf[i+1]=='t' && buf[i+2]=='a' && buf[i+3]=='r' && buf[i+4]=='t') {
+                            i+=5; while (buf[i]==' ') i++;
+                            if (net_tftp_server_start(buf[i] ? buf+i : 0)) net_tftp_server_status();
+                            else console_writeln("tftp server: port 69 busy or no socket");
+                        } else if (buf[i]=='s' && buf[i+1]=='t' && buf[i+2]=='o' && buf[i+3]=='p') {
+                            net_tftp_server_stop(); console_writeln("tftp server: stopped");
+                        } else net_tftp_server_status();
+                    } else { console_writeln("usage: tftp [get <ip> <remote> [/local]|put <ip> </local> [remote]|server [start [/root]|stop|status]]"); }
+                } else if (buf[0]=='n' && buf[1]=='e' && buf[2]=='t' && buf[3]=='b' && buf[4]=='o' && buf[5]=='o' && buf[6]=='t' && (buf[7]==0 || buf[7]==' ')) {
+                    // netboot tftp <ip> <file> [write|run] | netboot load </path> [write|run] | netboot write|run|status
+                    int i=7; while (buf[i]==' ') i++;
+                    int is_tftp = (buf[i]=='t' && buf[i+1]=='f' && buf[i+2]=='t' && buf[i+3]=='p' && buf[i+4]==' ');
+                    int is_load = (buf[i]=='l' && buf[i+1]=='o' && buf[i+2]=='a' && buf[i+3]=='d' && buf[i+4]==' ');
+                    int rc = 0, staged = 0;
+                    const char* then = buf+i;
+                    if (is_tftp || is_load) {
+                        i+=5; while (buf[i]==' ') i++;
+                        char a[16]={0}, file[64]={0}; int j=0;
+                        if (is_tftp) { while (buf[i] && buf[i]!=' ' && j<15){ a[j++]=buf[i++]; } while (buf[i]==' ') i++; }
+                        j=0; while (buf[i] && buf[i]!=' ' && j<63){ file[j++]=buf[i++]; }
+                        while (buf[i]==' ') i++;
+                        then = buf+i;
+                        uint32_t server=0;
+                        if (!file[0] || (is_tftp && !net_ipv4_parse_addr(a, &server))) {
+                            console_writeln("usage: netboot tftp <ip> <file> [write|run] | netboot load </path> [write|run]");
+                            then = 0;
+                        } else if (is_tftp) {
+                            net_tftp_result_t res;
+                            rc = net_netboot_fetch_tftp(server, file, &res, shell_abort_q);
+                            if (rc == 0 || rc == NET_NETBOOT_ECRC || rc == NET_NETBOOT_EFORMAT) { console_write("netboot: tftp "); net_tftp_print_result(&res); }
+                        } else rc = net_netboot_load_file(file);
+                        staged = 1;
+                    }
+                    if (then && rc == 0) {
+                        if (then[0]=='w' && then[1]=='r' && then[2]=='i' && then[3]=='t' && then[4]=='e') rc = net_netboot_write_disk();
+                        else if (then[0]=='r' && then[1]=='u' && then[2]=='n') rc = net_netboot_run();
+                        else if (staged || !then[0] || (then[0]=='s' && then[1]=='t')) net_netboot_status();
+                        else console_writeln("usage: netboot [tftp <ip> <file> [write|run]|load </path> [write|run]|write|run|status]");
+                    }
+                    if (rc != 0) { console_write("netboot: "); console_writeln(net_netboot_strerror(rc)); }
                 } else if (buf[0]=='p' && buf[1]=='a' && buf[2]=='d' && (buf[3]==' ' || buf[3]==0)) {
                     int i=3; while (buf[i]==' ') i++;
                     if (!buf[i]) { console_write("usage: pad </path>\n"); }
@@ -488,6 +863,7 @@ void shell_run(void) {
                     console_write(buf);
                     console_write("\n");
                 }
+                netface_bh_enable();
             }
             len = 0;
             print_prompt();
@@ -516,8 +516,16 @@ vbe_probe_and_record:
     jne .after_score
     inc ah
 .after_score:
+    ; +1 for depths the kernel draws (8, 15, 16, 32), so 24bpp loses
     cmp al, 8
+    je .depth_ok
+    cmp al, 15
+    je .depth_ok
+    cmp al, 16
+    je .depth_ok
+    cmp al, 32
     jne .score_ready
+.depth_ok:
     inc ah
 .score_ready:
     cmp ah, [cs:vesa_match_level]
@@ -248,6 +248,24 @@ static bool stage3_load_kernel(const stage3_params_t *params, uint8_t *buffer) {
     return true;
 }
 
+/* Honour a kernel record written by the running kernel's netboot path. The
+ * record sector sits behind the kernel slot; anything unreadable or not
+ * matching this layout leaves the stage2 values untouched. */
+static void stage3_apply_kernel_record(stage3_params_t *params, uint8_t *scratch) {
+    if (!ata_read_lba28(params->kernel_lba + STAGE3_KERNEL_SLOT_SECTORS, 1, scratch)) {
+        return;
+    }
+    const stage3_kernel_record_t *rec = (const stage3_kernel_record_t *)scratch;
+    if (rec->magic != STAGE3_KERNEL_RECORD_MAGIC || rec->kernel_lba != params->kernel_lba) {
+        return;
+    }
+    if (rec->kernel_sectors == 0u || rec->kernel_sectors > STAGE3_KERNEL_SLOT_SECTORS) {
+        return;
+    }
+    params->kernel_sectors = rec->kernel_sectors;
+    stage3_console_putc('N');
+}
+
 static uint8_t serial_getc(void) {
     // Wait for Data Ready (bit 0 of LSR at offset 5)
     while ((inb(0x3F8 + 5) & 0x01) == 0);
@@ -268,7 +286,8 @@ static bool stage3_receive_serial_kernel(uint8_t *buffer, uint32_t *out_sectors)
     
     // We expect 4 bytes length
     uint32_t len = serial_get_u32();
-    if (len == 0 || len > 1024*1024) {
+    // The buffer ends where Stage 3 itself starts
+    if (len == 0 || len > STAGE3_KERNEL_SLOT_SECTORS * 512u) {
         stage3_console_write("Invalid length.\n");
         return false;
     }
@@ -379,6 +398,10 @@ void stage3_main(stage3_params_t *params, boot_info_t *bootinfo) {
         stage3_port_debug('!');
         stage3_panic("ksec");
     }
+    if (kernel_sectors > STAGE3_KERNEL_SLOT_SECTORS) {
+        stage3_port_debug('!');
+        stage3_panic("kslot");
+    }
     if (!kernel_buffer || !kernel_target) {
         stage3_port_debug('!');
         stage3_panic("kptr");
@@ -421,6 +444,8 @@ void stage3_main(stage3_params_t *params, boot_info_t *bootinfo) {
         kernel_preloaded = true;
     } else if (!kernel_preloaded) {
         stage3_console_putc('K');
+        stage3_apply_kernel_record(params, kernel_buffer);
+        kernel_sectors = params->kernel_sectors;
         if (!stage3_load_kernel(params, kernel_buffer)) {
             stage3_port_debug('!');
             stage3_panic("load");
@@ -478,6 +503,10 @@ void stage3_main(stage3_params_t *params, boot_info_t *bootinfo) {
     bootinfo->bios_conventional_kb = (uint32_t)snap_bios_conv_kb;
     bootinfo->bios_extended_kb = snap_bios_ext_kb;
     bootinfo->bios_mem_flags = (uint32_t)snap_bios_mem_flags;
+    if (!(params->flags & STAGE3_FLAG_SERIAL_BOOT)) {
+        bootinfo->kernel_lba = params->kernel_lba;
+        bootinfo->kernel_sectors = kernel_sectors;
+    }
 
     if (kernel_sectors > (UINT32_MAX / 512u)) {
         stage3_port_debug('!');
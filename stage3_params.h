@@ -32,4 +32,22 @@ typedef struct __attribute__((packed)) stage3_e820_entry {
     uint32_t attr;
 } stage3_e820_entry_t;
 
+/* Kernel slot on disk. Stage3 loads through KERNEL_BUFFER_LINEAR (0x20000) and
+ * runs from 0x80000, so a kernel can span at most 0x80000 - 0x20000 bytes
+ * (384 KiB); the Makefile refuses larger images. The sector right after the
+ * slot may hold a record written by the running kernel (netboot write); when
+ * it is valid its sector count replaces the one baked into stage2, so a kernel
+ * that grew since the disk image was built still loads completely. */
+#define STAGE3_KERNEL_SLOT_SECTORS 768u
+#define STAGE3_KERNEL_RECORD_MAGIC 0x524B5A4Du /* "MZKR" */
+
+typedef struct __attribute__((packed)) stage3_kernel_record {
+    uint32_t magic;
+    uint32_t kernel_lba;     /* must match params->kernel_lba */
+    uint32_t kernel_sectors; /* 1..STAGE3_KERNEL_SLOT_SECTORS */
+    uint32_t kernel_bytes;
+    uint32_t kernel_crc32;   /* zlib CRC32 of kernel_bytes */
+    uint32_t generation;     /* incremented on every write */
+} stage3_kernel_record_t;
+
 #endif // STAGE3_PARAMS_H
@@ -0,0 +1,40 @@
+#!/usr/bin/env python3
+"""
+Wrap kernel_payload.bin into a netboot image (kernel.net) for the kernel's
+"netboot" shell command. Layout matches net/netboot.h:
+
+  u32 magic 'MZKI' | u32 header size (16) | u32 kernel bytes | u32 CRC32
+  followed by the raw kernel.
+
+Usage:
+  python3 tools/mknetimg.py <kernel_payload.bin> <kernel.net>
+"""
+import os, sys, struct, zlib
+
+MAGIC = 0x494B5A4D        # "MZKI" little endian
+SLOT_SECTORS = 768        # STAGE3_KERNEL_SLOT_SECTORS in stage3_params.h
+
+
+def main(argv):
+    if len(argv) != 3:
+        print(__doc__.strip())
+        return 2
+    data = open(argv[1], "rb").read()
+    if not data:
+        print(f"error: {argv[1]} is empty")
+        return 1
+    if len(data) > SLOT_SECTORS * 512:
+        print(f"error: kernel is {len(data)} bytes, slot holds {SLOT_SECTORS * 512}")
+        return 1
+    crc = zlib.crc32(data) & 0xFFFFFFFF
+    tmp = argv[2] + ".tmp"
+    with open(tmp, "wb") as f:
+        f.write(struct.pack("<IIII", MAGIC, 16, len(data), crc))
+        f.write(data)
+    os.replace(tmp, argv[2])
+    print(f"{argv[2]}: {len(data)} bytes, crc32=0x{crc:08X}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
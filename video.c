@@ -37,6 +37,11 @@ static uint32_t g_fb_pitch = 0;
 static uint16_t g_fb_width = 0;
 static uint16_t g_fb_height = 0;
 static uint8_t g_fb_bpp = 0;
+static uint8_t g_fb_bytes = 0;      // bytes per pixel; 0 = packed 4bpp
+static display_pixel_format_t g_fb_format = DISPLAY_PIXEL_FORMAT_NONE;
+// Direct colour (15/16/32bpp): pixel value of every palette index, so text
+// attributes and the status gradient look as in the 8bpp modes
+static uint32_t g_fb_pixels[256];
 
 static int g_row = 1;
 static int g_col = 0;
@@ -50,9 +55,28 @@ static char status_line[TEXT_COLS];
 static uint8_t g_cursor_fb_visible = 1;
 static uint32_t g_cursor_fb_last_toggle = 0;
 
+// Deferred drawing (framebuffer target): writes only update g_cells and
+// record per text row the changed column span [x0, x1) plus the number of
+// whole-row scrolls not yet applied to the screen. video_flush_cells() turns
+// that into pixels: one scroll operation, then one span per row. Flushes
+// happen on video_flush(), from video_cursor_tick() and at the end of a write
+// once 1/g_flush_hz seconds have passed; g_flush_hz = 0 draws every character
+// as it is written.
+static uint8_t g_damage_x0[TEXT_ROWS];
+static uint8_t g_damage_x1[TEXT_ROWS];  // 0 = row unchanged
+static int g_damage_any = 0;
+static int g_damage_scroll = 0;
+static int g_cursor_drawn_row = -1;      // cell that shows the cursor on screen
+static int g_cursor_drawn_col = -1;
+static uint32_t g_flush_hz = CONFIG_VIDEO_FLUSH_HZ;
+static uint32_t g_flush_last = 0;
+// Double-buffered app frame (video_fb_acquire): console drawing is held back
+// (cells and damage still update) until video_fb_release
+static volatile uint8_t* g_present_buf = NULL;
+
 static void video_draw_cell_fb(int row, int col, const text_cell_t* cell);
 static void video_cursor_refresh_fb(void);
-static void video_cursor_hide_current_fb(void);
+static void video_flush_due(void);
 
 void video_print(const char* str);
 
@@ -93,34 +117,81 @@ static inline void video_write_text_cell_direct(int row, int col, const text_cel
     video[row * 80 + col] = value;
 }
 
-static inline void fb_write_pixel_4bpp(int x, int y, uint8_t color) {
-    if (!g_fb_ptr) return;
-    uint32_t offset = (uint32_t)y * g_fb_pitch + (uint32_t)(x >> 1);
-    volatile uint8_t* cell = g_fb_ptr + offset;
-    uint8_t current = *cell;
-    if (x & 1) {
-        current = (uint8_t)((current & 0xF0u) | (color & 0x0Fu));
-    } else {
-        current = (uint8_t)(((color & 0x0Fu) << 4) | (current & 0x0Fu));
-    }
-    *cell = current;
-}
-
 static void (*g_fb_set_bank_fn)(uint8_t bank) = NULL;
 static uint32_t g_fb_phys_base = 0;
 static uint8_t  g_fb_current_bank = 0xFF;
 
-static inline void fb_put_pixel_banked(uint32_t absolute_offset, uint8_t color) {
-    if (g_fb_set_bank_fn) {
-        uint8_t bank = (uint8_t)(absolute_offset >> 16);
-        uint16_t offset = (uint16_t)(absolute_offset & 0xFFFF);
-        if (bank != g_fb_current_bank) {
-            g_fb_set_bank_fn(bank);
-            g_fb_current_bank = bank;
+// Glyph row expansion: one nibble of font bits -> 4 pixel bytes of 0xFF/0x00,
+// leftmost pixel (bit 3) at the lowest address. Two lookups expand a font
+// row into two 32-bit masks; colour is then (fg & mask) | (bg & ~mask).
+static const uint32_t g_glyph_mask8[16] = {
+    0x00000000u, 0xFF000000u, 0x00FF0000u, 0xFFFF0000u,
+    0x0000FF00u, 0xFF00FF00u, 0x00FFFF00u, 0xFFFFFF00u,
+    0x000000FFu, 0xFF0000FFu, 0x00FF00FFu, 0xFFFF00FFu,
+    0x0000FFFFu, 0xFF00FFFFu, 0x00FFFFFFu, 0xFFFFFFFFu,
+};
+
+// 15/16bpp: one nibble of font bits -> 4 pixel words, two per dword
+static const uint32_t g_glyph_mask16[16][2] = {
+    { 0x00000000u, 0x00000000u }, { 0x00000000u, 0xFFFF0000u },
+    { 0x00000000u, 0x0000FFFFu }, { 0x00000000u, 0xFFFFFFFFu },
+    { 0xFFFF0000u, 0x00000000u }, { 0xFFFF0000u, 0xFFFF0000u },
+    { 0xFFFF0000u, 0x0000FFFFu }, { 0xFFFF0000u, 0xFFFFFFFFu },
+    { 0x0000FFFFu, 0x00000000u }, { 0x0000FFFFu, 0xFFFF0000u },
+    { 0x0000FFFFu, 0x0000FFFFu }, { 0x0000FFFFu, 0xFFFFFFFFu },
+    { 0xFFFFFFFFu, 0x00000000u }, { 0xFFFFFFFFu, 0xFFFF0000u },
+    { 0xFFFFFFFFu, 0x0000FFFFu }, { 0xFFFFFFFFu, 0xFFFFFFFFu },
+};
+
+// Packed 4bpp: one nibble of font bits -> 2 bytes, even pixel in the high nibble
+static const uint16_t g_glyph_mask4[16] = {
+    0x0000u, 0x0F00u, 0xF000u, 0xFF00u,
+    0x000Fu, 0x0F0Fu, 0xF00Fu, 0xFF0Fu,
+    0x00F0u, 0x0FF0u, 0xF0F0u, 0xFFF0u,
+    0x00FFu, 0x0FFFu, 0xF0FFu, 0xFFFFu,
+};
+
+// Status row background gradient, pre-expanded per cell when the mode changes
+// (8 words per cell: 4bpp uses one, 8bpp two, 16bpp four, 32bpp all)
+static uint32_t g_grad_row[TEXT_COLS * 8];
+
+static void video_build_gradient(void) {
+    if (!g_fb_width) return;
+    for (int col = 0; col < TEXT_COLS; col++) {
+        uint32_t* cell = &g_grad_row[col * 8];
+        for (int i = 0; i < 8; i++) cell[i] = 0;
+        for (int x = 0; x < CHAR_WIDTH; x++) {
+            uint32_t px = (uint32_t)(col * CHAR_WIDTH + x);
+            if (g_fb_bpp == 4) {
+                uint32_t color = (px * 15u / g_fb_width) & 0x0Fu;
+                cell[0] |= color << (8 * (x >> 1) + ((x & 1) ? 0 : 4));
+                continue;
+            }
+            uint32_t color = 240u + ((px * 16u / g_fb_width) & 0x0Fu);
+            if (g_fb_bytes == 1) {
+                cell[x >> 2] |= color << (8 * (x & 3));
+            } else if (g_fb_bytes == 2) {
+                cell[x >> 1] |= g_fb_pixels[color] << (16 * (x & 1));
+            } else {
+                cell[x] = g_fb_pixels[color];
+            }
         }
-        g_fb_ptr[offset] = color;
-    } else {
-        g_fb_ptr[absolute_offset] = color;
+    }
+}
+
+// Palette index -> pixel value for direct colour modes, from the colours
+// vga_dac_load_default_palette() gives the 8bpp modes
+static void video_build_pixels(void) {
+    display_pixel_layout_t layout;
+    if (!display_pixel_layout(g_fb_format, &layout)) return;
+    for (int i = 0; i < 256; i++) {
+        uint8_t rgb[3];
+        vga_dac_default_entry((uint8_t)i, rgb);
+        // 6-bit DAC values to 8 bits
+        g_fb_pixels[i] = display_pixel_pack(&layout,
+                                            (uint8_t)((rgb[0] << 2) | (rgb[0] >> 4)),
+                                            (uint8_t)((rgb[1] << 2) | (rgb[1] >> 4)),
+                                            (uint8_t)((rgb[2] << 2) | (rgb[2] >> 4)));
     }
 }
 
@@ -136,44 +207,96 @@ static void video_draw_cell_fb(int row, int col, const text_cell_t* cell) {
     const uint8_t* glyph = font8x16_get(cell->ch);
     int is_cursor = (row == g_row && col == g_col);
     int gradient_row = (row == 0);
+    int rows = (is_cursor && g_cursor_fb_visible) ? CHAR_HEIGHT - 2 : CHAR_HEIGHT;
 
     if (g_fb_bpp == 8) {
-        for (int y = 0; y < CHAR_HEIGHT; y++) {
-            uint8_t bits = glyph[y];
-            uint32_t line_offset = (uint32_t)(py + y) * g_fb_pitch + px;
-            for (int x = 0; x < CHAR_WIDTH; x++) {
-                uint8_t mask = (uint8_t)(0x80u >> x);
-                uint8_t color = bg;
-                if (gradient_row) {
-                    uint32_t step = ((uint32_t)(px + x) * 16u) / g_fb_width;
-                    color = (uint8_t)(240 + (step & 0x0F));
-                    if (bits & mask) color = 15;
-                } else {
-                    if (bits & mask) color = fg;
+        uint32_t fgw = (gradient_row ? 15u : fg) * 0x01010101u;
+        uint32_t bg0 = gradient_row ? g_grad_row[col * 8] : bg * 0x01010101u;
+        uint32_t bg1 = gradient_row ? g_grad_row[col * 8 + 1] : bg0;
+        uint32_t offset = (uint32_t)py * g_fb_pitch + (uint32_t)px;
+        uint32_t window = 0xFFFFFFFFu;
+        // Select the bank once per cell when its 16 lines share one window
+        int per_line = 0;
+        if (g_fb_set_bank_fn) {
+            uint32_t end = offset + (CHAR_HEIGHT - 1u) * g_fb_pitch + CHAR_WIDTH - 1u;
+            uint8_t bank = (uint8_t)(offset >> 16);
+            window = 0xFFFFu;
+            if ((uint8_t)(end >> 16) != bank) {
+                per_line = 1;
+            } else if (bank != g_fb_current_bank) {
+                g_fb_set_bank_fn(bank);
+                g_fb_current_bank = bank;
+            }
+        }
+        for (int y = 0; y < CHAR_HEIGHT; y++, offset += g_fb_pitch) {
+            uint32_t w0 = 0x0F0F0F0Fu, w1 = 0x0F0F0F0Fu;
+            if (y < rows) {
+                uint32_t m0 = g_glyph_mask8[glyph[y] >> 4];
+                uint32_t m1 = g_glyph_mask8[glyph[y] & 0x0Fu];
+                w0 = (fgw & m0) | (bg0 & ~m0);
+                w1 = (fgw & m1) | (bg1 & ~m1);
+            }
+            if (per_line) {
+                // 8-byte aligned rows never straddle a 64 KiB bank
+                uint8_t bank = (uint8_t)(offset >> 16);
+                if (bank != g_fb_current_bank) {
+                    g_fb_set_bank_fn(bank);
+                    g_fb_current_bank = bank;
                 }
-                if (is_cursor && g_cursor_fb_visible && y >= CHAR_HEIGHT - 2) color = 15;
-                fb_put_pixel_banked(line_offset + x, color);
             }
+            volatile uint32_t* dst = (volatile uint32_t*)(g_fb_ptr + (offset & window));
+            dst[0] = w0;
+            dst[1] = w1;
         }
-    } else {
-        for (int y = 0; y < CHAR_HEIGHT; y++) {
-            uint8_t bits = glyph[y];
+    } else if (g_fb_bytes == 2) {
+        // Two pixels per dword; direct colour framebuffers are never banked
+        uint32_t fgw = g_fb_pixels[gradient_row ? 15u : fg] * 0x00010001u;
+        uint32_t cursor = g_fb_pixels[15] * 0x00010001u;
+        uint32_t bgw[4];
+        for (int i = 0; i < 4; i++) bgw[i] = gradient_row ? g_grad_row[col * 8 + i] : g_fb_pixels[bg] * 0x00010001u;
+        volatile uint8_t* line = g_fb_ptr + (uint32_t)py * g_fb_pitch + (uint32_t)px * 2u;
+        for (int y = 0; y < CHAR_HEIGHT; y++, line += g_fb_pitch) {
+            volatile uint32_t* dst = (volatile uint32_t*)line;
+            if (y >= rows) {
+                dst[0] = dst[1] = dst[2] = dst[3] = cursor;
+                continue;
+            }
+            const uint32_t* m0 = g_glyph_mask16[glyph[y] >> 4];
+            const uint32_t* m1 = g_glyph_mask16[glyph[y] & 0x0Fu];
+            dst[0] = (fgw & m0[0]) | (bgw[0] & ~m0[0]);
+            dst[1] = (fgw & m0[1]) | (bgw[1] & ~m0[1]);
+            dst[2] = (fgw & m1[0]) | (bgw[2] & ~m1[0]);
+            dst[3] = (fgw & m1[1]) | (bgw[3] & ~m1[1]);
+        }
+    } else if (g_fb_bytes == 4) {
+        // One pixel per dword: each font bit widened to a full mask
+        uint32_t fgp = g_fb_pixels[gradient_row ? 15u : fg];
+        uint32_t cursor = g_fb_pixels[15];
+        uint32_t bgp[CHAR_WIDTH];
+        for (int i = 0; i < CHAR_WIDTH; i++) bgp[i] = gradient_row ? g_grad_row[col * 8 + i] : g_fb_pixels[bg];
+        volatile uint8_t* line = g_fb_ptr + (uint32_t)py * g_fb_pitch + (uint32_t)px * 4u;
+        for (int y = 0; y < CHAR_HEIGHT; y++, line += g_fb_pitch) {
+            volatile uint32_t* dst = (volatile uint32_t*)line;
+            uint32_t bits = (y < rows) ? glyph[y] : 0;
             for (int x = 0; x < CHAR_WIDTH; x++) {
-                uint8_t mask = (uint8_t)(0x80u >> x);
-                uint8_t color = bg & 0x0Fu;
-                if (gradient_row) {
-                    uint32_t step = ((uint32_t)(px + x) * 15u) / g_fb_width;
-                    color = (uint8_t)(step & 0x0Fu);
-                    if (bits & mask) color = fg & 0x0Fu;
-                } else if (bits & mask) {
-                    color = fg & 0x0Fu;
-                }
-                if (is_cursor && g_cursor_fb_visible && y >= CHAR_HEIGHT - 2) color = 0x0Fu;
-                fb_write_pixel_4bpp(px + x, py + y, color);
+                uint32_t m = 0u - ((bits >> (7 - x)) & 1u);
+                dst[x] = (y < rows) ? ((fgp & m) | (bgp[x] & ~m)) : cursor;
+            }
+        }
+    } else if (g_fb_bpp == 4) {
+        uint32_t fgw = (fg & 0x0Fu) * 0x11111111u;
+        uint32_t bgw = gradient_row ? g_grad_row[col * 8] : (bg & 0x0Fu) * 0x11111111u;
+        volatile uint8_t* line = g_fb_ptr + (uint32_t)py * g_fb_pitch + (uint32_t)(px >> 1);
+        for (int y = 0; y < CHAR_HEIGHT; y++, line += g_fb_pitch) {
+            uint32_t w = 0xFFFFFFFFu;
+            if (y < rows) {
+                uint32_t m = g_glyph_mask4[glyph[y] >> 4] | ((uint32_t)g_glyph_mask4[glyph[y] & 0x0Fu] << 16);
+                w = (fgw & m) | (bgw & ~m);
             }
+            *(volatile uint32_t*)line = w;
         }
     }
-    
+
     // Notify driver that this character's lines are now dirty
     fb_accel_mark_dirty(px, py, CHAR_WIDTH, CHAR_HEIGHT);
 }
@@ -184,11 +307,22 @@ static void video_cursor_refresh_fb(void) {
     video_draw_cell_fb(g_row, g_col, &g_cells[g_row][g_col]);
 }
 
-static void video_cursor_hide_current_fb(void) {
-    if (g_target != VIDEO_TARGET_FB) return;
-    if (g_row < 0 || g_row >= g_rows_current || g_col < 0 || g_col >= g_cols_current) return;
-    g_cursor_fb_visible = 0;
-    video_draw_cell_fb(g_row, g_col, &g_cells[g_row][g_col]);
+static void video_damage(int row, int x0, int x1) {
+    if (row < 0 || row >= g_rows_current || x0 >= x1) return;
+    if (g_damage_x1[row] == 0) {
+        g_damage_x0[row] = (uint8_t)x0;
+        g_damage_x1[row] = (uint8_t)x1;
+    } else {
+        if (x0 < g_damage_x0[row]) g_damage_x0[row] = (uint8_t)x0;
+        if (x1 > g_damage_x1[row]) g_damage_x1[row] = (uint8_t)x1;
+    }
+    g_damage_any = 1;
+}
+
+static void video_damage_reset(void) {
+    for (int y = 0; y < TEXT_ROWS; y++) g_damage_x1[y] = 0;
+    g_damage_any = 0;
+    g_damage_scroll = 0;
 }
 
 static void video_sync_cell(int row, int col) {
@@ -205,16 +339,55 @@ static void video_put_cell(int row, int col, char ch, uint8_t attr) {
     text_cell_t* cell = &g_cells[row][col];
     cell->ch = (uint8_t)ch;
     cell->attr = attr;
-    video_sync_cell(row, col);
+    if (g_target == VIDEO_TARGET_FB) {
+        video_damage(row, col, col + 1);
+    } else {
+        video_sync_cell(row, col);
+    }
+}
+
+// Drivers with a colour-expand engine take each run of equal attributes in a
+// text row as one monochrome blit (2 bytes per glyph line instead of 8 pixel
+// bytes). The status row keeps its gradient and the cursor cell is drawn on
+// top afterwards. Returns 0 if the span has to be drawn cell by cell.
+static int video_draw_span_expand(int row, int x0, int x1) {
+    static uint8_t bits[CHAR_HEIGHT][TEXT_COLS];
+    if (g_target != VIDEO_TARGET_FB || g_fb_bpp != 8 || row == 0) return 0;
+    if ((row + 1) * CHAR_HEIGHT > g_fb_height) return 0;
+    if (!(fb_accel_hw_ops() & FB_ACCEL_OP_COLOR_EXPAND)) return 0;
+    int col = x0;
+    while (col < x1) {
+        uint8_t attr = g_cells[row][col].attr;
+        int end = col;
+        for (; end < x1 && g_cells[row][end].attr == attr; end++) {
+            const uint8_t* glyph = font8x16_get(g_cells[row][end].ch);
+            for (int y = 0; y < CHAR_HEIGHT; y++) bits[y][end - col] = glyph[y];
+        }
+        if (!fb_accel_color_expand((uint16_t)(col * CHAR_WIDTH), (uint16_t)(row * CHAR_HEIGHT),
+                                   (uint16_t)((end - col) * CHAR_WIDTH), CHAR_HEIGHT,
+                                   &bits[0][0], TEXT_COLS, attr_fg(attr), attr_bg(attr))) {
+            return 0;
+        }
+        col = end;
+    }
+    if (row == g_row && g_col >= x0 && g_col < x1) {
+        video_draw_cell_fb(row, g_col, &g_cells[row][g_col]);
+    }
+    return 1;
+}
+
+static void video_draw_span(int row, int x0, int x1) {
+    if (video_draw_span_expand(row, x0, x1)) return;
+    for (int x = x0; x < x1; x++) {
+        video_sync_cell(row, x);
+    }
 }
 
 static void video_redraw_range(int row_start, int row_end) {
     if (row_start < 0) row_start = 0;
     if (row_end > g_rows_current) row_end = g_rows_current;
     for (int y = row_start; y < row_end; y++) {
-        for (int x = 0; x < g_cols_current; x++) {
-            video_sync_cell(y, x);
-        }
+        video_draw_span(y, 0, g_cols_current);
     }
 }
 
@@ -232,10 +405,10 @@ void video_status_draw_full(const char* text, int len) {
         for (int i = 0; i < len && i < TEXT_COLS; i++) status_line[i] = text[i];
     }
     video_status_redraw();
+    video_flush_due();
 }
 
 static void video_scroll(void) {
-    video_cursor_hide_current_fb();
     for (int y = 2; y < g_rows_current; y++) {
         for (int x = 0; x < g_cols_current; x++) {
             g_cells[y - 1][x] = g_cells[y][x];
@@ -245,13 +418,90 @@ static void video_scroll(void) {
         g_cells[g_rows_current - 1][x].ch = ' ';
         g_cells[g_rows_current - 1][x].attr = 0x07;
     }
-    video_redraw_range(1, g_rows_current);
-    video_status_redraw();
+    if (g_target == VIDEO_TARGET_FB) {
+        // The pixels move on the next flush: shift the damage with the text
+        for (int y = 1; y + 1 < g_rows_current; y++) {
+            g_damage_x0[y] = g_damage_x0[y + 1];
+            g_damage_x1[y] = g_damage_x1[y + 1];
+        }
+        g_damage_x1[g_rows_current - 1] = 0;
+        video_damage(g_rows_current - 1, 0, g_cols_current);
+        g_damage_scroll++;
+    } else {
+        video_redraw_range(1, g_rows_current);
+        video_status_redraw();
+    }
     g_row = g_rows_current - 1;
     g_col = 0;
     vga_hw_cursor_update_internal();
-    g_cursor_fb_visible = 1;
-    video_cursor_refresh_fb();
+}
+
+// Apply the pending scrolls in one step, then draw the damaged span of every
+// row; the old and the new cursor cell are always part of it
+static void video_flush_cells(void) {
+    if (g_target != VIDEO_TARGET_FB) {
+        video_damage_reset();
+        return;
+    }
+    if (g_present_buf) return;
+    const int k = g_damage_scroll;
+    const int body = g_rows_current - 1;    // text rows below the status row
+    if (k > 0 && k < body) {
+        // Hardware scrolling moves the whole frame, status row included; the
+        // blitter (or a move in the shadow/LFB) shifts text rows 1+k.. up.
+        // Rows uncovered at the bottom were damaged by video_scroll().
+        if ((uint32_t)g_rows_current * CHAR_HEIGHT == g_fb_height &&
+            fb_accel_scroll((uint16_t)(k * CHAR_HEIGHT))) {
+            video_damage(0, 0, g_cols_current);
+        } else if (!fb_accel_copy_rect(0, (uint16_t)((1 + k) * CHAR_HEIGHT), 0, CHAR_HEIGHT,
+                                       (uint16_t)(g_cols_current * CHAR_WIDTH),
+                                       (uint16_t)((body - k) * CHAR_HEIGHT))) {
+            for (int y = 1; y < g_rows_current; y++) video_damage(y, 0, g_cols_current);
+        }
+    }
+    int old_row = g_cursor_drawn_row - k;
+    if (old_row >= 1 && g_cursor_drawn_col >= 0 && g_cursor_drawn_col < g_cols_current) {
+        video_damage(old_row, g_cursor_drawn_col, g_cursor_drawn_col + 1);
+    }
+    if (g_col >= 0 && g_col < g_cols_current) {
+        video_damage(g_row, g_col, g_col + 1);
+    }
+    for (int y = 0; y < g_rows_current; y++) {
+        if (g_damage_x1[y] == 0) continue;
+        video_draw_span(y, g_damage_x0[y], g_damage_x1[y]);
+        g_damage_x1[y] = 0;
+    }
+    g_damage_any = 0;
+    g_damage_scroll = 0;
+    g_cursor_drawn_row = g_row;
+    g_cursor_drawn_col = g_col;
+}
+
+void video_flush(void) {
+    if (g_target != VIDEO_TARGET_FB || g_present_buf) return;
+    if (g_damage_any || g_damage_scroll) {
+        video_flush_cells();
+    }
+    g_flush_last = platform_ticks_get();
+    fb_accel_sync();
+}
+
+// Rate limit for bulk output: flush once a frame interval has passed
+static void video_flush_due(void) {
+    if (g_target != VIDEO_TARGET_FB || g_present_buf ||
+        !(g_damage_any || g_damage_scroll) || g_flush_hz == 0) return;
+    uint32_t hz = platform_timer_get_hz();
+    uint32_t interval = hz / g_flush_hz;
+    if (hz == 0 || (platform_ticks_get() - g_flush_last) >= interval) {
+        video_flush();
+    }
+}
+
+uint32_t video_set_flush_rate(uint32_t hz) {
+    uint32_t old = g_flush_hz;
+    video_flush();
+    g_flush_hz = hz;
+    return old;
 }
 
 void video_init() {
@@ -281,13 +531,19 @@ void video_clear() {
         }
     }
     g_row = 1; g_col = 0;
-    video_redraw_range(1, g_rows_current);
+    if (g_target == VIDEO_TARGET_FB) {
+        // Nothing on screen is worth scrolling any more
+        g_damage_scroll = 0;
+        for (int y = 1; y < g_rows_current; y++) video_damage(y, 0, g_cols_current);
+        video_flush_due();
+    } else {
+        video_redraw_range(1, g_rows_current);
+    }
 }
 
 void video_print(const char* str) {
     while (*str) {
         char c = *str++;
-        video_cursor_hide_current_fb();
         if (c == '\n') {
             g_row++; g_col = 0;
             if (g_row >= g_rows_current) video_scroll();
@@ -301,8 +557,14 @@ void video_print(const char* str) {
                 g_col++;
             }
         }
+        if (g_flush_hz == 0 && g_target == VIDEO_TARGET_FB) {
+            g_cursor_fb_visible = 1;
+            video_flush_cells();
+        }
+    }
+    if (g_target == VIDEO_TARGET_FB) {
         g_cursor_fb_visible = 1;
-        video_cursor_refresh_fb();
+        video_flush_due();
     }
 }
 
@@ -339,15 +601,29 @@ void video_switch_to_framebuffer(const display_mode_info_t* mode) {
     g_fb_width = mode->width;
     g_fb_height = mode->height;
     g_fb_bpp = mode->bpp;
+    g_fb_format = mode->pixel_format;
+    if (g_fb_format == DISPLAY_PIXEL_FORMAT_NONE) g_fb_format = display_pixel_format_for_bpp(g_fb_bpp);
+    g_fb_bytes = (g_fb_bpp == 4) ? 0 : (uint8_t)((g_fb_bpp + 7u) / 8u);
     g_fb_phys_base = mode->phys_base;
     g_fb_set_bank_fn = mode->set_bank;
     g_fb_current_bank = 0xFF; 
+    g_present_buf = NULL;
     g_target = VIDEO_TARGET_FB;
     g_cols_current = g_fb_width / 8;
     g_rows_current = g_fb_height / 16;
     if (g_cols_current > TEXT_COLS) g_cols_current = TEXT_COLS;
     if (g_rows_current > TEXT_ROWS) g_rows_current = TEXT_ROWS;
+    video_build_pixels();
+    // Software fallbacks of fb_accel need an unbanked surface of 1, 2 or 4
+    // bytes per pixel
+    int sw_ok = !g_fb_set_bank_fn && (g_fb_bytes == 1 || g_fb_bytes == 2 || g_fb_bytes == 4);
+    fb_accel_set_surface(sw_ok ? g_fb_ptr : NULL, g_fb_pitch, g_fb_width, g_fb_height,
+                         g_fb_bytes, g_fb_pixels);
+    video_build_gradient();
+    video_damage_reset();
     video_redraw_range(0, g_rows_current);
+    g_cursor_drawn_row = g_row;
+    g_cursor_drawn_col = g_col;
     
     // Force immediate sync of the initial screen content (Statusbar + existing text)
     fb_accel_sync();
@@ -355,14 +631,19 @@ void video_switch_to_framebuffer(const display_mode_info_t* mode) {
 
 void video_switch_to_text(void) {
     g_target = VIDEO_TARGET_TEXT;
+    g_present_buf = NULL;
     g_rows_current = 25;
     g_cols_current = 80;
     fb_accel_reset();
+    video_damage_reset();
     video_redraw_range(0, 25);
 }
 
 void video_cursor_tick(void) {
-    if (g_target != VIDEO_TARGET_FB) return;
+    if (g_target != VIDEO_TARGET_FB || g_present_buf) return;
+    video_flush_due();
+    // The cursor cell is drawn directly only while the screen is up to date
+    if (g_damage_any || g_damage_scroll) return;
     uint32_t now = platform_ticks_get();
     if ((now - g_cursor_fb_last_toggle) >= 10u) {
         g_cursor_fb_last_toggle = now;
@@ -373,12 +654,46 @@ void video_cursor_tick(void) {
 
 int video_fb_active(void) { return (g_target == VIDEO_TARGET_FB); }
 
+display_pixel_format_t video_fb_get_format(void) {
+    return (g_target == VIDEO_TARGET_FB) ? g_fb_format : DISPLAY_PIXEL_FORMAT_NONE;
+}
+
 const void* video_fb_get_info(uint32_t* pitch, uint16_t* width, uint16_t* height, uint8_t* bpp) {
+    // Callers draw straight into the frame: pending text goes first
+    video_flush();
     if (pitch) *pitch = g_fb_pitch;
     if (width) *width = g_fb_width;
     if (height) *height = g_fb_height;
     if (bpp) *bpp = g_fb_bpp;
-    return (const void*)g_fb_ptr;
+    return (const void*)(g_present_buf ? g_present_buf : g_fb_ptr);
+}
+
+const void* video_fb_acquire(uint32_t* pitch, uint16_t* width, uint16_t* height, uint8_t* bpp) {
+    // Apps need the whole frame in one linear buffer
+    if (g_target != VIDEO_TARGET_FB || g_fb_set_bank_fn) return NULL;
+    if (!g_present_buf) {
+        video_flush();
+        g_present_buf = fb_accel_present_begin(g_fb_ptr);
+    }
+    return video_fb_get_info(pitch, width, height, bpp);
+}
+
+int video_fb_present(int vsync) {
+    if (!g_present_buf) return FB_ACCEL_PRESENT_NONE;
+    int mode = fb_accel_present_mode();
+    volatile uint8_t* next = fb_accel_present(vsync);
+    if (next) g_present_buf = next;
+    return mode;
+}
+
+void video_fb_release(void) {
+    if (!g_present_buf) return;
+    fb_accel_present_end();
+    g_present_buf = NULL;
+    // The app drew over the console frame: scrolls held back meanwhile are moot
+    for (int y = 0; y < g_rows_current; y++) video_damage(y, 0, g_cols_current);
+    g_damage_scroll = 0;
+    video_flush();
 }
 
 void video_status_draw_full_legacy(const char* text, int len) { video_status_draw_full(text, len); }
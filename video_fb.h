@@ -6,7 +6,20 @@
 void video_switch_to_framebuffer(const display_mode_info_t* mode);
 void video_switch_to_text(void);
 void video_cursor_tick(void);
+// Draw pending console text and upload it (deferred drawing, see video.c)
+void video_flush(void);
+// Flush rate during bulk output in Hz, 0 = draw every character; returns the old rate
+uint32_t video_set_flush_rate(uint32_t hz);
 int  video_fb_active(void);
 const void* video_fb_get_info(uint32_t* pitch, uint16_t* width, uint16_t* height, uint8_t* bpp);
+// Pixel format of the framebuffer (DISPLAY_PIXEL_FORMAT_NONE in text mode)
+display_pixel_format_t video_fb_get_format(void);
+// Double buffering for full-screen apps (fb_accel_present_*): acquire returns
+// the buffer for the next frame and holds console drawing back, present shows
+// it (FB_ACCEL_PRESENT_FLIP/UPLOAD, 0 outside a session) and release hands
+// the screen back to the console, which redraws it
+const void* video_fb_acquire(uint32_t* pitch, uint16_t* width, uint16_t* height, uint8_t* bpp);
+int  video_fb_present(int vsync);
+void video_fb_release(void);
 
 #endif // VIDEO_FB_H